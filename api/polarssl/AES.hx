@@ -6,6 +6,7 @@ import hext.IllegalArgumentException;
 import hext.IllegalStateException;
 import polarssl.Loader;
 import polarssl.PolarSSLException;
+import polarssl.Segments;
 
 /**
  * Haxe FFI wrapper class for the PolarSSL AES implementation.
@@ -16,6 +17,7 @@ class AES
      * Stores the references to the FFI implementations of the functions.
      */
     private static var _crypt_cbc:AESContext->Int->Int->BytesData->BytesData->BytesData = Loader.load("hx_aes_crypt_cbc", 5);
+    private static var _crypt_cbcv:AESContext->Int->BytesData->Array<Dynamic>->BytesData = Loader.load("hx_aes_crypt_cbcv", 4);
     private static var _crypt_ecb:AESContext->Int->BytesData->BytesData = Loader.load("hx_aes_crypt_ecb", 3);
     private static var _free:AESContext->Void                           = Loader.load("hx_aes_free", 1);
     private static var _init:Void->AESContext                           = Loader.load("hx_aes_init", 0);
@@ -34,8 +36,21 @@ class AES
      *
      * @var Null<polarssl.AES.AESContext>
      */
+    @:allow(polarssl.CCM)
+    @:allow(polarssl.KeyCache)
     private var context:Null<AESContext>;
 
+    /**
+     * Either the context is a read-only schedule shared through the KeyCache or not.
+     *
+     * Shared contexts are never freed or re-keyed in place; setting a key detaches
+     * the instance onto a context of its own.
+     *
+     * @var Bool
+     */
+    @:allow(polarssl.KeyCache)
+    private var shared:Bool;
+
 
     /**
      * Constructor to initialize a new AES instance.
@@ -46,6 +61,7 @@ class AES
     {
         try {
             this.context = AES._init();
+            this.shared  = false;
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
         }
@@ -92,6 +108,54 @@ class AES
         }
     }
 
+    /**
+     * Puts the parts through the CBC cipher function as if they were concatenated, without
+     * copying them, and returns the resulting bytes.
+     *
+     * Only the total length has to be a multiple of 16, not the length of each part.
+     *
+     * @param Int                  mode      AES.DECRYPT or AES.ENCRYPT
+     * @param haxe.io.Bytes        iv        the initialization vector
+     * @param Array<haxe.io.Bytes> parts     the input Bytes, in order
+     * @param Array<Int>           positions the position to start reading at for each part (defaults to 0)
+     * @param Array<Int>           lengths   the number of bytes to read from each part (defaults to the rest)
+     *
+     * @return haxe.io.Bytes the crypted Bytes
+     *
+     * @throws hext.IllegalArgumentException if the mode is not supported
+     * @throws hext.IllegalArgumentException if the initialization vector is not 16 bytes long
+     * @throws hext.IllegalArgumentException if the arrays do not match or a range is outside of its Bytes
+     * @throws hext.IllegalArgumentException if the total length is not % 16 == 0
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function cryptCbcv(mode:Int, iv:Bytes, parts:Array<Bytes>, ?positions:Array<Int>, ?lengths:Array<Int>):Bytes
+    {
+        if (mode != AES.DECRYPT && mode != AES.ENCRYPT) {
+            throw new IllegalArgumentException("Provided AES mode is not supported.");
+        }
+        if (iv == null || iv.length != 16) {
+            throw new IllegalArgumentException("Initialization vector must be 16 bytes.");
+        }
+        var flat:Array<Dynamic> = Segments.flatten(parts, positions, lengths);
+        if ((Segments.totalLength(flat) % 16) != 0) {
+            throw new IllegalArgumentException("Input parts' total length must be a multiple of 16.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("No AES context available.");
+        }
+
+        // create a copy since it will be updated
+        var copy:Bytes = Bytes.alloc(iv.length);
+        copy.blit(0, iv, 0, iv.length);
+
+        try {
+            return Bytes.ofData(AES._crypt_cbcv(this.context, mode, copy.getData(), flat));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
     /**
      * Puts the input bytes through the cipher function and returns the resulting ones.
      *
@@ -139,7 +203,9 @@ class AES
         }
 
         try {
-            AES._free(this.context);
+            if (!this.shared) {
+                AES._free(this.context);
+            }
             this.context = null;
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
@@ -188,6 +254,10 @@ class AES
         }
 
         try {
+            if (this.shared) {
+                this.context = AES._init();
+                this.shared  = false;
+            }
             AES._setkey_dec(this.context, key.getData(), key.length * 8);
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
@@ -213,6 +283,10 @@ class AES
         }
 
         try {
+            if (this.shared) {
+                this.context = AES._init();
+                this.shared  = false;
+            }
             AES._setkey_enc(this.context, key.getData(), key.length * 8);
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
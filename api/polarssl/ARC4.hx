@@ -2,6 +2,7 @@ package polarssl;
 
 import haxe.io.Bytes;
 import haxe.io.BytesData;
+import hext.IllegalArgumentException;
 import hext.IllegalStateException;
 import polarssl.Loader;
 import polarssl.PolarSSLException;
@@ -15,10 +16,12 @@ class ARC4
      * Stores the references to the FFI implementations of the functions.
      */
     private static var _crypt:ARC4Context->Int->BytesData->BytesData = Loader.load("hx_arc4_crypt", 3);
+    private static var _crypt_into:ARC4Context->Array<Dynamic>->Int  = Loader.load("hx_arc4_crypt_into", 2);
     private static var _free:ARC4Context->Void                       = Loader.load("hx_arc4_free", 1);
     private static var _init:Void->ARC4Context                       = Loader.load("hx_arc4_init", 0);
     private static var _self_test:Bool->Int                          = Loader.load("hx_arc4_self_test", 1);
     private static var _setup:ARC4Context->BytesData->Int->Void      = Loader.load("hx_arc4_setup", 3);
+    private static var _skip:ARC4Context->Int->Void                  = Loader.load("hx_arc4_skip", 2);
 
     /**
      * Stores the native ARC4 context handle.
@@ -65,6 +68,39 @@ class ARC4
         }
     }
 
+    /**
+     * Runs 'length' bytes of 'input' starting at 'inPos' through the cipher function and
+     * writes the result into 'output' starting at 'outPos', without allocating new Bytes.
+     *
+     * @param haxe.io.Bytes input  the Bytes to read from
+     * @param Int           inPos  the position to start reading at
+     * @param Int           length the number of bytes to crypt
+     * @param haxe.io.Bytes output the Bytes to write to (may be 'input' at the same position for in-place crypting)
+     * @param Int           outPos the position to start writing at
+     *
+     * @throws hext.IllegalArgumentException if a range is outside of its Bytes
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call throws an error
+     */
+    public function cryptInto(input:Bytes, inPos:Int, length:Int, output:Bytes, outPos:Int):Void
+    {
+        if (input == null || output == null) {
+            throw new IllegalArgumentException("Input and output Bytes cannot be null.");
+        }
+        if (length < 0 || inPos < 0 || inPos > input.length || length > input.length - inPos || outPos < 0 || outPos > output.length || length > output.length - outPos) {
+            throw new IllegalArgumentException("Range is outside of the Bytes.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("No ARC4 context available.");
+        }
+
+        try {
+            ARC4._crypt_into(this.context, [ length, input.getData(), inPos, output.getData(), outPos ]);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
     /**
      * Frees all memory allocated for this ARC4 instance.
      *
@@ -130,6 +166,31 @@ class ARC4
             throw new PolarSSLException(ex);
         }
     }
+
+    /**
+     * Discards the next 'count' keystream bytes without producing output (RC4-drop[n]).
+     *
+     * @param Int count the number of keystream bytes to skip
+     *
+     * @throws hext.IllegalArgumentException if the count is negative
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call throws an error
+     */
+    public function skip(count:Int):Void
+    {
+        if (count < 0) {
+            throw new IllegalArgumentException("Count cannot be negative.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("No ARC4 context available.");
+        }
+
+        try {
+            ARC4._skip(this.context, count);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
 }
 
 
@@ -0,0 +1,110 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import polarssl.Loader;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for the native bcrypt (EksBlowfish) password hashing implementation.
+ *
+ * The hashing runs natively with the GC lock released, so other threads are not
+ * blocked for the (intentionally long) duration of a call.
+ */
+class BCrypt
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _hash:BytesData->Int->BytesData->Int->String = Loader.load("hx_bcrypt_hash", 4);
+    private static var _self_test:Bool->Int                         = Loader.load("hx_bcrypt_self_test", 1);
+    private static var _verify:BytesData->Int->String->Bool         = Loader.load("hx_bcrypt_verify", 3);
+
+    /**
+     * The supported range of the cost parameter (log2 of the number of rounds).
+     */
+    public static inline var MIN_COST:Int = 4;
+    public static inline var MAX_COST:Int = 31;
+
+
+    /**
+     * Hashes the password and returns the "$2b$..." modular crypt string.
+     *
+     * Attn: Only the first 72 bytes of the password are taken into account.
+     *
+     * @param haxe.io.Bytes       password the password to hash
+     * @param Int                 cost     the log2 of the number of rounds
+     * @param Null<haxe.io.Bytes> salt     16 random bytes (generated natively using HAVEGE if null)
+     *
+     * @return String the hash string to store
+     *
+     * @throws hext.IllegalArgumentException if the password is null, the cost is out of range or the salt is not 16 bytes long
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public static function hash(password:Bytes, cost:Int = 10, ?salt:Bytes):String
+    {
+        if (password == null) {
+            throw new IllegalArgumentException("Password cannot be null.");
+        }
+        if (cost < BCrypt.MIN_COST || cost > BCrypt.MAX_COST) {
+            throw new IllegalArgumentException("Cost must be between 4 and 31.");
+        }
+        if (salt != null && salt.length != 16) {
+            throw new IllegalArgumentException("Salt must be 16 bytes.");
+        }
+
+        try {
+            return BCrypt._hash(password.getData(), password.length, (salt != null) ? salt.getData() : null, cost);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Runs various health checks to ensure the BCrypt module works correctly.
+     *
+     * @param Bool verbose either to output debug information or not
+     *
+     * @return Bool
+     */
+    public static function selfTest(verbose:Bool = #if POLARSSL_DEBUG true #else false #end):Bool
+    {
+        var ret:Int;
+        try {
+            ret = BCrypt._self_test(verbose);
+        } catch (ex:Dynamic) {
+            #if POLARSSL_DEBUG
+                throw new PolarSSLException(ex);
+            #else
+                ret = 1;
+            #end
+        }
+
+        return ret == 0;
+    }
+
+    /**
+     * Checks if the password matches the stored hash string ($2a$, $2b$ or $2y$).
+     *
+     * @param haxe.io.Bytes password the password to check
+     * @param String        hash     the stored hash string
+     *
+     * @return Bool true if the password matches
+     *
+     * @throws hext.IllegalArgumentException if the password or hash is null
+     * @throws polarssl.PolarSSLException    if the hash string is malformed
+     */
+    public static function verify(password:Bytes, hash:String):Bool
+    {
+        if (password == null || hash == null) {
+            throw new IllegalArgumentException("Password and hash cannot be null.");
+        }
+
+        try {
+            return BCrypt._verify(password.getData(), password.length, hash);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+}
@@ -2,6 +2,7 @@ package polarssl;
 
 import haxe.io.Bytes;
 import haxe.io.BytesData;
+import hext.IllegalArgumentException;
 import polarssl.Loader;
 import polarssl.PolarSSLException;
 
@@ -13,24 +14,97 @@ class Base64
     /**
      * Stores the references to the FFI implementations of the functions.
      */
-    private static var _decode:BytesData->Int->BytesData = Loader.load("hx_base64_decode", 2);
-    private static var _encode:BytesData->Int->BytesData = Loader.load("hx_base64_encode", 2);
-    private static var _self_test:Bool->Int               = Loader.load("hx_base64_self_test", 1);
+    private static var _decode:BytesData->Int->Int->BytesData             = Loader.load("hx_base64_decode", 3);
+    private static var _decode_into:String->Int->BytesData->Int->Int->Int = Loader.load("hx_base64_decode_into", 5);
+    private static var _decode_string:String->Int->BytesData              = Loader.load("hx_base64_decode_string", 2);
+    private static var _encode:BytesData->Int->Int->Int->BytesData        = Loader.load("hx_base64_encode", 4);
+    private static var _encode_string:BytesData->Int->Int->Int->String    = Loader.load("hx_base64_encode_string", 4);
+    private static var _self_test:Bool->Int                               = Loader.load("hx_base64_self_test", 1);
+
+    /**
+     * Variant flags (can be combined with |).
+     *
+     * URL_SAFE uses '-' and '_' instead of '+' and '/' (RFC 4648 §5), NO_PADDING omits the
+     * trailing '=' (decoding then accepts input with or without it) and LF_ENDINGS breaks
+     * wrapped lines with "\n" instead of "\r\n".
+     */
+    public static inline var URL_SAFE:Int   = 0x01;
+    public static inline var NO_PADDING:Int = 0x02;
+    public static inline var LF_ENDINGS:Int = 0x04;
+
+    /**
+     * Common line lengths for wrapped output.
+     */
+    public static inline var MIME_LINE_LENGTH:Int = 76;
+    public static inline var PEM_LINE_LENGTH:Int  = 64;
 
 
     /**
      * Returns Bytes encoded within the Base64 Bytes.
      *
+     * Line breaks (LF or CRLF) in the input are skipped.
+     *
      * @param haxe.io.Bytes bytes the encoded Bytes
+     * @param Int           flags Base64.URL_SAFE and/or Base64.NO_PADDING
+     *
+     * @return haxe.io.Bytes the decoded Bytes
+     *
+     * @throws polarssl.PolarSSLException if the FFI call throws an error
+     */
+    public static function decode(bytes:Bytes, flags:Int = 0):Bytes
+    {
+        try {
+            return Bytes.ofData(Base64._decode(bytes.getData(), bytes.length, flags));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Decodes the Base64 String into the provided Bytes, starting at 'pos'.
+     *
+     * Attn: Nothing past the end of 'dst' is written, but if the decoding fails, the bytes
+     *       from 'pos' on are undefined.
+     *
+     * @param String        str   the Base64 String
+     * @param haxe.io.Bytes dst   the Bytes to write the decoded bytes to
+     * @param Int           pos   the position to start writing at
+     * @param Int           flags Base64.URL_SAFE and/or Base64.NO_PADDING
+     *
+     * @return Int the number of decoded bytes
+     *
+     * @throws hext.IllegalArgumentException if the position is outside of the Bytes
+     * @throws polarssl.PolarSSLException    if the input is invalid or does not fit
+     */
+    public static function decodeInto(str:String, dst:Bytes, pos:Int = 0, flags:Int = 0):Int
+    {
+        if (dst == null || pos < 0 || pos > dst.length) {
+            throw new IllegalArgumentException("Position is outside of the Bytes.");
+        }
+
+        try {
+            return Base64._decode_into(str, flags, dst.getData(), pos, dst.length - pos);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Returns Bytes encoded within the Base64 String.
+     *
+     * Saves the Bytes.ofString() copy decode() would need.
+     *
+     * @param String str   the Base64 String
+     * @param Int    flags Base64.URL_SAFE and/or Base64.NO_PADDING
      *
      * @return haxe.io.Bytes the decoded Bytes
      *
      * @throws polarssl.PolarSSLException if the FFI call throws an error
      */
-    public static function decode(bytes:Bytes):Bytes
+    public static function decodeString(str:String, flags:Int = 0):Bytes
     {
         try {
-            return Bytes.ofData(Base64._decode(bytes.getData(), bytes.length));
+            return Bytes.ofData(Base64._decode_string(str, flags));
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
         }
@@ -39,18 +113,54 @@ class Base64
     /**
      * Returns the Base64 encoding of the input bytes.
      *
-     * Attn: To get the encoded bytes as a String, use toHex() on the returned Bytes.
+     * Attn: To get the encoding as a String, use encodeToString().
+     *
+     * Example:
+     *   var mime = Base64.encode(bytes, 0, Base64.MIME_LINE_LENGTH);
+     *   var jwt  = Base64.encode(bytes, Base64.URL_SAFE | Base64.NO_PADDING);
      *
-     * @param haxe.io.Bytes bytes the Bytes to get the encoding for
+     * @param haxe.io.Bytes bytes      the Bytes to get the encoding for
+     * @param Int           flags      Base64.URL_SAFE, Base64.NO_PADDING and/or Base64.LF_ENDINGS
+     * @param Int           lineLength the characters per line (multiple of 4), 0 for no wrapping
      *
      * @return haxe.io.Bytes the encoded Bytes
      *
-     * @throws polarssl.PolarSSLException if the FFI call throws an error
+     * @throws hext.IllegalArgumentException if the line length is not a multiple of 4
+     * @throws polarssl.PolarSSLException    if the FFI call throws an error
+     */
+    public static function encode(bytes:Bytes, flags:Int = 0, lineLength:Int = 0):Bytes
+    {
+        if (lineLength < 0 || lineLength % 4 != 0) {
+            throw new IllegalArgumentException("Line length must be a non-negative multiple of 4.");
+        }
+
+        try {
+            return Bytes.ofData(Base64._encode(bytes.getData(), bytes.length, flags, lineLength));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Returns the Base64 encoding of the input bytes as a String.
+     *
+     * @param haxe.io.Bytes bytes      the Bytes to get the encoding for
+     * @param Int           flags      Base64.URL_SAFE, Base64.NO_PADDING and/or Base64.LF_ENDINGS
+     * @param Int           lineLength the characters per line (multiple of 4), 0 for no wrapping
+     *
+     * @return String the encoding
+     *
+     * @throws hext.IllegalArgumentException if the line length is not a multiple of 4
+     * @throws polarssl.PolarSSLException    if the FFI call throws an error
      */
-    public static function encode(bytes:Bytes):Bytes
+    public static function encodeToString(bytes:Bytes, flags:Int = 0, lineLength:Int = 0):String
     {
+        if (lineLength < 0 || lineLength % 4 != 0) {
+            throw new IllegalArgumentException("Line length must be a non-negative multiple of 4.");
+        }
+
         try {
-            return Bytes.ofData(Base64._encode(bytes.getData(), bytes.length));
+            return Base64._encode_string(bytes.getData(), bytes.length, flags, lineLength);
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
         }
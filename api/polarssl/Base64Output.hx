@@ -0,0 +1,157 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.Output;
+import hext.IllegalArgumentException;
+import hext.IllegalStateException;
+import polarssl.Base64Stream;
+
+/**
+ * haxe.io.Output filter Base64 encoding (or decoding) everything written to it
+ * before passing it on to the wrapped Output.
+ *
+ * Attn: close() must be called to emit the final (padded) quantum; it also closes
+ *       the wrapped Output.
+ *
+ * Example:
+ *   var out = new Base64Output(File.write("mail.b64"), Base64Stream.ENCODE, 0, Base64.MIME_LINE_LENGTH);
+ *   out.writeInput(File.read("attachment.bin"));
+ *   out.close();
+ */
+class Base64Output extends Output
+{
+    /**
+     * Number of single bytes (writeByte()) collected before they are processed.
+     */
+    private static inline var BUFFER_SIZE:Int = 4096;
+
+    /**
+     * Stores the buffered single bytes and the number of them.
+     *
+     * @var haxe.io.Bytes
+     * @var Int
+     */
+    private var buffer:Bytes;
+    private var buffered:Int;
+
+    /**
+     * Stores the wrapped Output, null once closed.
+     *
+     * @var Null<haxe.io.Output>
+     */
+    private var output:Null<Output>;
+
+    /**
+     * Stores the native codec stream.
+     *
+     * @var polarssl.Base64Stream
+     */
+    private var stream:Base64Stream;
+
+
+    /**
+     * Constructor to initialize a new Base64Output instance.
+     *
+     * @param haxe.io.Output output     the Output to write the encoded/decoded data to
+     * @param Int            mode       Base64Stream.ENCODE or Base64Stream.DECODE
+     * @param Int            flags      the polarssl.Base64 variant flags (URL_SAFE, NO_PADDING, LF_ENDINGS)
+     * @param Int            lineLength the characters per line when encoding (multiple of 4), 0 for no wrapping
+     *
+     * @throws hext.IllegalArgumentException if the output is null, the mode is not supported or the line length is invalid
+     * @throws polarssl.PolarSSLException    if the native stream init fails
+     */
+    public function new(output:Output, mode:Int = Base64Stream.ENCODE, flags:Int = 0, lineLength:Int = 0):Void
+    {
+        if (output == null) {
+            throw new IllegalArgumentException("Output cannot be null.");
+        }
+
+        this.output   = output;
+        this.stream   = new Base64Stream(mode, flags, lineLength);
+        this.buffer   = Bytes.alloc(Base64Output.BUFFER_SIZE);
+        this.buffered = 0;
+    }
+
+    /**
+     * Finishes the stream, writes the remaining output and closes the wrapped Output.
+     *
+     * @throws hext.IllegalStateException if the Output has already been closed
+     * @throws polarssl.PolarSSLException if the decoded input was truncated or invalid
+     */
+    override public function close():Void
+    {
+        this.flushBuffer();
+        this.writeOut(this.stream.finish());
+        this.output.close();
+        this.output = null;
+    }
+
+    /**
+     * Passes all pending output on to the wrapped Output and flushes it.
+     *
+     * Attn: An incomplete group/quantum stays in the stream until more data or close().
+     *
+     * @throws hext.IllegalStateException if the Output has already been closed
+     */
+    override public function flush():Void
+    {
+        this.flushBuffer();
+        this.output.flush();
+    }
+
+    /**
+     * Processes the buffered single bytes.
+     *
+     * @throws hext.IllegalStateException if the Output has already been closed
+     */
+    private function flushBuffer():Void
+    {
+        if (this.output == null) {
+            throw new IllegalStateException("Output has already been closed.");
+        }
+
+        if (this.buffered > 0) {
+            var len:Int   = this.buffered;
+            this.buffered = 0;
+            this.writeOut(this.stream.update(this.buffer, 0, len));
+        }
+    }
+
+    /**
+     * @{inherit}
+     */
+    override public function writeByte(c:Int):Void
+    {
+        if (this.output == null) {
+            throw new IllegalStateException("Output has already been closed.");
+        }
+
+        this.buffer.set(this.buffered++, c);
+        if (this.buffered == Base64Output.BUFFER_SIZE) {
+            this.flushBuffer();
+        }
+    }
+
+    /**
+     * @{inherit}
+     */
+    override public function writeBytes(s:Bytes, pos:Int, len:Int):Int
+    {
+        this.flushBuffer();
+        this.writeOut(this.stream.update(s, pos, len));
+
+        return len;
+    }
+
+    /**
+     * Writes the produced output to the wrapped Output.
+     *
+     * @param haxe.io.Bytes bytes the output produced by the stream
+     */
+    private function writeOut(bytes:Bytes):Void
+    {
+        if (bytes.length > 0) {
+            this.output.writeFullBytes(bytes, 0, bytes.length);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import polarssl.Loader;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for the native stateful Base64 encoder/decoder.
+ *
+ * Input can be fed in chunks of any size; incomplete 3 byte groups (encoding) and
+ * 4 character quanta (decoding) are carried over natively to the next chunk, so the
+ * whole input never has to be kept in memory.
+ *
+ * @see polarssl.Base64Output for a haxe.io.Output filter using this class
+ */
+class Base64Stream
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _finish:Base64StreamContext->BytesData                      = Loader.load("hx_base64_stream_finish", 1);
+    private static var _init:Int->Int->Int->Base64StreamContext                    = Loader.load("hx_base64_stream_init", 3);
+    private static var _update:Base64StreamContext->BytesData->Int->Int->BytesData = Loader.load("hx_base64_stream_update", 4);
+
+    /**
+     * Possible stream mode values.
+     */
+    public static inline var DECODE:Int = 0;
+    public static inline var ENCODE:Int = 1;
+
+    /**
+     * Stores the native stream state handle.
+     *
+     * @var polarssl.Base64Stream.Base64StreamContext
+     */
+    private var context:Base64StreamContext;
+
+    /**
+     * Either Base64Stream.DECODE or Base64Stream.ENCODE.
+     *
+     * @var Int
+     */
+    public var mode(default, null):Int;
+
+
+    /**
+     * Constructor to initialize a new Base64Stream instance.
+     *
+     * @param Int mode       Base64Stream.DECODE or Base64Stream.ENCODE
+     * @param Int flags      the polarssl.Base64 variant flags (URL_SAFE, NO_PADDING, LF_ENDINGS)
+     * @param Int lineLength the characters per line when encoding (multiple of 4), 0 for no wrapping
+     *
+     * @throws hext.IllegalArgumentException if the mode is not supported or the line length is invalid
+     * @throws polarssl.PolarSSLException    if the native stream init fails
+     */
+    public function new(mode:Int, flags:Int = 0, lineLength:Int = 0):Void
+    {
+        if (mode != Base64Stream.DECODE && mode != Base64Stream.ENCODE) {
+            throw new IllegalArgumentException("Provided Base64 stream mode is not supported.");
+        }
+        if (lineLength < 0 || lineLength % 4 != 0) {
+            throw new IllegalArgumentException("Line length must be a non-negative multiple of 4.");
+        }
+
+        this.mode = mode;
+        try {
+            this.context = Base64Stream._init(mode, flags, lineLength);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Ends the stream and returns the remaining output.
+     *
+     * When encoding, this is the (padded) encoding of the carried over bytes; when decoding,
+     * the input is checked to have ended on a complete quantum (with NO_PADDING, the bytes
+     * of an unpadded final quantum are returned). The stream can be used for new input afterwards.
+     *
+     * @return haxe.io.Bytes the remaining output (0 - 6 bytes)
+     *
+     * @throws polarssl.PolarSSLException if the decoded input was truncated or invalid
+     */
+    public function finish():Bytes
+    {
+        try {
+            return Bytes.ofData(Base64Stream._finish(this.context));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Encodes/decodes the next chunk and returns the output available so far.
+     *
+     * @param haxe.io.Bytes bytes  the Bytes to read from
+     * @param Int           pos    the position to start reading at
+     * @param Int           length the number of bytes to process
+     *
+     * @return haxe.io.Bytes the produced output (may be empty)
+     *
+     * @throws hext.IllegalArgumentException if the range is outside of the Bytes
+     * @throws polarssl.PolarSSLException    if the decoded input contains invalid characters
+     */
+    public function update(bytes:Bytes, pos:Int, length:Int):Bytes
+    {
+        if (bytes == null || pos < 0 || length < 0 || pos > bytes.length || length > bytes.length - pos) {
+            throw new IllegalArgumentException("Range is outside of the Bytes.");
+        }
+
+        try {
+            return Bytes.ofData(Base64Stream._update(this.context, bytes.getData(), pos, length));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+}
+
+
+/**
+ * Extern for native Base64 stream state handles wrapped by Neko/C++ value.
+ */
+private extern class Base64StreamContext {}
@@ -16,10 +16,13 @@ class Blowfish
      * Stores the references to the FFI implementations of the functions.
      */
     private static var _crypt_cbc:BlowfishContext->Int->Int->BytesData->BytesData->BytesData = Loader.load("hx_blowfish_crypt_cbc", 5);
+    private static var _crypt_cfb64:BlowfishContext->BlowfishStream->Int->Int->BytesData->BytesData = Loader.load("hx_blowfish_crypt_cfb64", 5);
+    private static var _crypt_ctr:BlowfishContext->BlowfishStream->Int->BytesData->BytesData = Loader.load("hx_blowfish_crypt_ctr", 4);
     private static var _crypt_ecb:BlowfishContext->Int->BytesData->BytesData = Loader.load("hx_blowfish_crypt_ecb", 3);
     private static var _free:BlowfishContext->Void                   = Loader.load("hx_blowfish_free", 1);
     private static var _init:Void->BlowfishContext                   = Loader.load("hx_blowfish_init", 0);
     private static var _setkey:BlowfishContext->BytesData->Int->Void = Loader.load("hx_blowfish_setkey", 3);
+    private static var _stream_init:BytesData->BlowfishStream        = Loader.load("hx_blowfish_stream_init", 1);
 
     /**
      * Possible Blowfish mode values.
@@ -34,6 +37,13 @@ class Blowfish
      */
     private var context:Null<BlowfishContext>;
 
+    /**
+     * Stores the native CTR/CFB64 stream state handle.
+     *
+     * @var Null<polarssl.Blowfish.BlowfishStream>
+     */
+    private var stream:Null<BlowfishStream>;
+
 
     /**
      * Constructor to initialize a new Blowfish instance.
@@ -90,6 +100,73 @@ class Blowfish
         }
     }
 
+    /**
+     * Puts the input bytes through the CFB64 cipher function, continuing the stream
+     * started with startStream(), and returns the resulting ones.
+     *
+     * @param Int           mode  Blowfish.DECRYPT or Blowfish.ENCRYPT
+     * @param haxe.io.Bytes bytes the input bytes (any length)
+     *
+     * @return haxe.io.Bytes the crypted Bytes
+     *
+     * @throws hext.IllegalArgumentException if the mode is not supported
+     * @throws hext.IllegalArgumentException if the input bytes are null
+     * @throws hext.IllegalStateException    if the instance has already been freed or no stream has been started
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function cryptCfb64(mode:Int, bytes:Bytes):Bytes
+    {
+        if (mode != Blowfish.DECRYPT && mode != Blowfish.ENCRYPT) {
+            throw new IllegalArgumentException("Provided Blowfish mode is not supported.");
+        }
+        if (bytes == null) {
+            throw new IllegalArgumentException("Input bytes cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("No Blowfish context available.");
+        }
+        if (this.stream == null) {
+            throw new IllegalStateException("No Blowfish stream started.");
+        }
+
+        try {
+            return Bytes.ofData(Blowfish._crypt_cfb64(this.context, this.stream, mode, bytes.length, bytes.getData()));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Puts the input bytes through the CTR cipher function, continuing the stream
+     * started with startStream(), and returns the resulting ones.
+     *
+     * @param haxe.io.Bytes bytes the input bytes (any length)
+     *
+     * @return haxe.io.Bytes the crypted Bytes
+     *
+     * @throws hext.IllegalArgumentException if the input bytes are null
+     * @throws hext.IllegalStateException    if the instance has already been freed or no stream has been started
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function cryptCtr(bytes:Bytes):Bytes
+    {
+        if (bytes == null) {
+            throw new IllegalArgumentException("Input bytes cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("No Blowfish context available.");
+        }
+        if (this.stream == null) {
+            throw new IllegalStateException("No Blowfish stream started.");
+        }
+
+        try {
+            return Bytes.ofData(Blowfish._crypt_ctr(this.context, this.stream, bytes.length, bytes.getData()));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
     /**
      * Puts the input bytes through the cipher function and returns the resulting ones.
      *
@@ -139,6 +216,7 @@ class Blowfish
         try {
             Blowfish._free(this.context);
             this.context = null;
+            this.stream  = null;
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
         }
@@ -168,6 +246,35 @@ class Blowfish
             throw new PolarSSLException(ex);
         }
     }
+
+    /**
+     * Starts a new CTR or CFB64 stream; the state is kept natively between
+     * cryptCtr()/cryptCfb64() calls, so input does not need to be block-aligned.
+     *
+     * Attn: Never reuse a nonce counter with the same key in CTR mode, and do not
+     *       mix CTR and CFB64 calls on the same stream.
+     *
+     * @param haxe.io.Bytes iv the initial IV (CFB64) or nonce counter block (CTR)
+     *
+     * @throws hext.IllegalArgumentException if the IV is not 8 bytes long
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function startStream(iv:Bytes):Void
+    {
+        if (iv == null || iv.length != 8) {
+            throw new IllegalArgumentException("Initialization vector must be 8 bytes.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("No Blowfish context available.");
+        }
+
+        try {
+            this.stream = Blowfish._stream_init(iv.getData());
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
 }
 
 
@@ -175,3 +282,9 @@ class Blowfish
  * Extern for native Blowfish context handles wrapped by Neko/C++ value.
  */
 private extern class BlowfishContext {}
+
+
+/**
+ * Extern for native Blowfish CTR/CFB64 stream state handles wrapped by Neko/C++ value.
+ */
+private extern class BlowfishStream {}
@@ -0,0 +1,169 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import hext.IllegalArgumentException;
+import hext.IllegalStateException;
+import polarssl.AES;
+import polarssl.Loader;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for Counter with CBC-MAC (CCM) authenticated encryption
+ * on top of an AES instance's key schedule.
+ *
+ * Attn: CCM only uses the forward cipher, so the AES instance must be keyed with
+ *       setEncryptionKey() for both, encryption and decryption.
+ */
+class CCM
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _auth_decrypt:Dynamic->Array<Dynamic>->Array<Dynamic>->Array<Dynamic>->Array<Dynamic>->Bool = Loader.load("hx_ccm_auth_decrypt", 5);
+    private static var _encrypt_and_tag:Dynamic->Array<Dynamic>->Array<Dynamic>->Array<Dynamic>->Array<Dynamic>->Int = Loader.load("hx_ccm_encrypt_and_tag", 5);
+
+    /**
+     * Stores the AES instance whose key schedule is used.
+     *
+     * @var polarssl.AES
+     */
+    private var aes:AES;
+
+
+    /**
+     * Constructor to initialize a new CCM instance.
+     *
+     * @param polarssl.AES aes the AES instance (keyed with setEncryptionKey()) to use
+     *
+     * @throws hext.IllegalArgumentException if the AES instance is null
+     */
+    public function new(aes:AES):Void
+    {
+        if (aes == null) {
+            throw new IllegalArgumentException("AES instance cannot be null.");
+        }
+
+        this.aes = aes;
+    }
+
+    /**
+     * Decrypts 'length' bytes of 'input' starting at 'inPos' into 'output' starting at 'outPos'
+     * and verifies the authentication tag.
+     *
+     * Attn: If the tag does not match, the output range is zeroed.
+     *
+     * @param haxe.io.Bytes       iv     the nonce (7 - 13 bytes)
+     * @param Null<haxe.io.Bytes> add    the additional authenticated data
+     * @param haxe.io.Bytes       input  the Bytes to read the ciphertext from
+     * @param Int                 inPos  the position to start reading at
+     * @param Int                 length the number of bytes to decrypt
+     * @param haxe.io.Bytes       output the Bytes to write the plaintext to (may be 'input')
+     * @param Int                 outPos the position to start writing at
+     * @param haxe.io.Bytes       tag    the Bytes to read the tag from
+     * @param Int                 tagPos the position of the tag
+     * @param Int                 tagLen the tag length (4, 6, 8, 10, 12, 14 or 16)
+     *
+     * @return Bool true if the data is authentic
+     *
+     * @throws hext.IllegalArgumentException if the nonce or tag length are invalid
+     * @throws hext.IllegalArgumentException if a range is outside of its Bytes
+     * @throws hext.IllegalStateException    if the AES instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function authDecrypt(iv:Bytes, add:Null<Bytes>, input:Bytes, inPos:Int, length:Int,
+        output:Bytes, outPos:Int, tag:Bytes, tagPos:Int, tagLen:Int):Bool
+    {
+        CCM.checkArguments(iv, input, inPos, length, output, outPos, tag, tagPos, tagLen);
+        if (this.aes.context == null) {
+            throw new IllegalStateException("AES context not available.");
+        }
+
+        try {
+            return CCM._auth_decrypt(this.aes.context, CCM.toArr(iv), CCM.toArr(add),
+                [ length, input.getData(), inPos, output.getData(), outPos ], [ tagLen, tag.getData(), tagPos ]);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Internal method to validate the arguments shared by authDecrypt() and encryptAndTag().
+     *
+     * @throws hext.IllegalArgumentException if an argument is invalid
+     */
+    private static function checkArguments(iv:Bytes, input:Bytes, inPos:Int, length:Int,
+        output:Bytes, outPos:Int, tag:Bytes, tagPos:Int, tagLen:Int):Void
+    {
+        if (iv == null || iv.length < 7 || iv.length > 13) {
+            throw new IllegalArgumentException("Nonce must be 7 to 13 bytes.");
+        }
+        if (tagLen < 4 || tagLen > 16 || (tagLen % 2) != 0) {
+            throw new IllegalArgumentException("Tag length must be an even number between 4 and 16.");
+        }
+        if (input == null || output == null || tag == null) {
+            throw new IllegalArgumentException("Input, output and tag Bytes cannot be null.");
+        }
+        if (length < 0 || inPos < 0 || inPos > input.length || length > input.length - inPos || outPos < 0 || outPos > output.length || length > output.length - outPos) {
+            throw new IllegalArgumentException("Range is outside of the Bytes.");
+        }
+        if (tagPos < 0 || tagPos > tag.length || tagLen > tag.length - tagPos) {
+            throw new IllegalArgumentException("Tag range is outside of the Bytes.");
+        }
+    }
+
+    /**
+     * Encrypts 'length' bytes of 'input' starting at 'inPos' into 'output' starting at 'outPos'
+     * and writes the authentication tag to 'tag' at 'tagPos'.
+     *
+     * @param haxe.io.Bytes       iv     the nonce (7 - 13 bytes), never reuse it with the same key
+     * @param Null<haxe.io.Bytes> add    the additional authenticated data
+     * @param haxe.io.Bytes       input  the Bytes to read the plaintext from
+     * @param Int                 inPos  the position to start reading at
+     * @param Int                 length the number of bytes to encrypt
+     * @param haxe.io.Bytes       output the Bytes to write the ciphertext to (may be 'input')
+     * @param Int                 outPos the position to start writing at
+     * @param haxe.io.Bytes       tag    the Bytes to write the tag to
+     * @param Int                 tagPos the position to write the tag at
+     * @param Int                 tagLen the tag length (4, 6, 8, 10, 12, 14 or 16)
+     *
+     * @throws hext.IllegalArgumentException if the nonce or tag length are invalid
+     * @throws hext.IllegalArgumentException if a range is outside of its Bytes
+     * @throws hext.IllegalStateException    if the AES instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function encryptAndTag(iv:Bytes, add:Null<Bytes>, input:Bytes, inPos:Int, length:Int,
+        output:Bytes, outPos:Int, tag:Bytes, tagPos:Int, tagLen:Int):Void
+    {
+        CCM.checkArguments(iv, input, inPos, length, output, outPos, tag, tagPos, tagLen);
+        if (this.aes.context == null) {
+            throw new IllegalStateException("AES context not available.");
+        }
+
+        try {
+            CCM._encrypt_and_tag(this.aes.context, CCM.toArr(iv), CCM.toArr(add),
+                [ length, input.getData(), inPos, output.getData(), outPos ], [ tagLen, tag.getData(), tagPos ]);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Packs the (nullable) Bytes into the [length, data] Array expected by the FFI functions.
+     *
+     * @param Null<haxe.io.Bytes> bytes the Bytes to pack
+     *
+     * @return Array<Dynamic>
+     */
+    private static function toArr(bytes:Null<Bytes>):Array<Dynamic>
+    {
+        if (bytes == null) {
+            bytes = Bytes.alloc(0);
+        }
+
+        var arr:Array<Dynamic> = new Array<Dynamic>();
+        arr[0] = bytes.length;
+        arr[1] = bytes.getData();
+
+        return arr;
+    }
+}
@@ -16,12 +16,15 @@ class Camellia
      * Stores the references to the FFI implementations of the functions.
      */
     private static var _crypt_cbc:CamelliaContext->Int->Int->BytesData->BytesData->BytesData = Loader.load("hx_camellia_crypt_cbc", 5);
+    private static var _crypt_cfb128:CamelliaContext->CamelliaStream->Int->Int->BytesData->BytesData = Loader.load("hx_camellia_crypt_cfb128", 5);
+    private static var _crypt_ctr:CamelliaContext->CamelliaStream->Int->BytesData->BytesData = Loader.load("hx_camellia_crypt_ctr", 4);
     private static var _crypt_ecb:CamelliaContext->Int->BytesData->BytesData = Loader.load("hx_camellia_crypt_ecb", 3);
     private static var _free:CamelliaContext->Void = Loader.load("hx_camellia_free", 1);
     private static var _init:Void->CamelliaContext = Loader.load("hx_camellia_init", 0);
     private static var _self_test:Bool->Int        = Loader.load("hx_camellia_self_test", 1);
     private static var _setkey_dec:CamelliaContext->BytesData->Int->Void = Loader.load("hx_camellia_setkey_dec", 3);
     private static var _setkey_enc:CamelliaContext->BytesData->Int->Void = Loader.load("hx_camellia_setkey_enc", 3);
+    private static var _stream_init:BytesData->CamelliaStream = Loader.load("hx_camellia_stream_init", 1);
 
     /**
      * Possible Camellia mode values.
@@ -34,8 +37,27 @@ class Camellia
      *
      * @var Null<polarssl.Camellia.CamelliaContext>
      */
+    @:allow(polarssl.KeyCache)
     private var context:Null<CamelliaContext>;
 
+    /**
+     * Either the context is a read-only schedule shared through the KeyCache or not.
+     *
+     * Shared contexts are never freed or re-keyed in place; setting a key detaches
+     * the instance onto a context of its own.
+     *
+     * @var Bool
+     */
+    @:allow(polarssl.KeyCache)
+    private var shared:Bool;
+
+    /**
+     * Stores the native CTR/CFB128 stream state handle.
+     *
+     * @var Null<polarssl.Camellia.CamelliaStream>
+     */
+    private var stream:Null<CamelliaStream>;
+
 
     /**
      * Constructor to initialize a new Camellia instance.
@@ -46,6 +68,7 @@ class Camellia
     {
         try {
             this.context = Camellia._init();
+            this.shared  = false;
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
         }
@@ -92,6 +115,79 @@ class Camellia
         }
     }
 
+    /**
+     * Puts the input bytes through the CFB128 cipher function, continuing the stream
+     * started with startStream(), and returns the resulting ones.
+     *
+     * Attn: CFB128 only uses the forward cipher, so the instance must be keyed with
+     *       setEncryptionKey() for both, encryption and decryption.
+     *
+     * @param Int           mode  Camellia.DECRYPT or Camellia.ENCRYPT
+     * @param haxe.io.Bytes bytes the input bytes (any length)
+     *
+     * @return haxe.io.Bytes the crypted Bytes
+     *
+     * @throws hext.IllegalArgumentException if the mode is not supported
+     * @throws hext.IllegalArgumentException if the input bytes are null
+     * @throws hext.IllegalStateException    if the instance has already been freed or no stream has been started
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function cryptCfb128(mode:Int, bytes:Bytes):Bytes
+    {
+        if (mode != Camellia.DECRYPT && mode != Camellia.ENCRYPT) {
+            throw new IllegalArgumentException("Provided Camellia mode is not supported.");
+        }
+        if (bytes == null) {
+            throw new IllegalArgumentException("Input bytes cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("No Camellia context available.");
+        }
+        if (this.stream == null) {
+            throw new IllegalStateException("No Camellia stream started.");
+        }
+
+        try {
+            return Bytes.ofData(Camellia._crypt_cfb128(this.context, this.stream, mode, bytes.length, bytes.getData()));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Puts the input bytes through the CTR cipher function, continuing the stream
+     * started with startStream(), and returns the resulting ones.
+     *
+     * Attn: CTR only uses the forward cipher, so the instance must be keyed with
+     *       setEncryptionKey() for both, encryption and decryption.
+     *
+     * @param haxe.io.Bytes bytes the input bytes (any length)
+     *
+     * @return haxe.io.Bytes the crypted Bytes
+     *
+     * @throws hext.IllegalArgumentException if the input bytes are null
+     * @throws hext.IllegalStateException    if the instance has already been freed or no stream has been started
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function cryptCtr(bytes:Bytes):Bytes
+    {
+        if (bytes == null) {
+            throw new IllegalArgumentException("Input bytes cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("No Camellia context available.");
+        }
+        if (this.stream == null) {
+            throw new IllegalStateException("No Camellia stream started.");
+        }
+
+        try {
+            return Bytes.ofData(Camellia._crypt_ctr(this.context, this.stream, bytes.length, bytes.getData()));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
     /**
      * Puts the input bytes through the cipher function and returns the resulting ones.
      *
@@ -139,8 +235,11 @@ class Camellia
         }
 
         try {
-            Camellia._free(this.context);
+            if (!this.shared) {
+                Camellia._free(this.context);
+            }
             this.context = null;
+            this.stream  = null;
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
         }
@@ -188,6 +287,10 @@ class Camellia
         }
 
         try {
+            if (this.shared) {
+                this.context = Camellia._init();
+                this.shared  = false;
+            }
             Camellia._setkey_dec(this.context, key.getData(), key.length * 8);
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
@@ -213,11 +316,44 @@ class Camellia
         }
 
         try {
+            if (this.shared) {
+                this.context = Camellia._init();
+                this.shared  = false;
+            }
             Camellia._setkey_enc(this.context, key.getData(), key.length * 8);
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
         }
     }
+
+    /**
+     * Starts a new CTR or CFB128 stream; the state is kept natively between
+     * cryptCtr()/cryptCfb128() calls, so input does not need to be block-aligned.
+     *
+     * Attn: Never reuse a nonce counter with the same key in CTR mode, and do not
+     *       mix CTR and CFB128 calls on the same stream.
+     *
+     * @param haxe.io.Bytes iv the initial IV (CFB128) or nonce counter block (CTR)
+     *
+     * @throws hext.IllegalArgumentException if the IV is not 16 bytes long
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function startStream(iv:Bytes):Void
+    {
+        if (iv == null || iv.length != 16) {
+            throw new IllegalArgumentException("Initialization vector must be 16 bytes.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("Camellia context not available.");
+        }
+
+        try {
+            this.stream = Camellia._stream_init(iv.getData());
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
 }
 
 
@@ -225,3 +361,9 @@ class Camellia
  * Extern for native Camellia context handles wrapped by Neko/C++ value.
  */
 private extern class CamelliaContext {}
+
+
+/**
+ * Extern for native Camellia CTR/CFB128 stream state handles wrapped by Neko/C++ value.
+ */
+private extern class CamelliaStream {}
@@ -0,0 +1,409 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import hext.IllegalStateException;
+import polarssl.Loader;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for the native ChaCha20-Poly1305 AEAD implementation (RFC 8439).
+ *
+ * The ChaCha20 keystream is generated by SSE2/AVX2 kernels when the CPU supports them.
+ * Messages can either be processed in one call (encryptAndTag()/authDecrypt()) or
+ * streamed chunk by chunk (starts(), updateAad(), update(), finish()).
+ */
+class ChaChaPoly
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _auth_decrypt:ChaChaPolyContext->Array<Dynamic>->Array<Dynamic>->Array<Dynamic>->Array<Dynamic>->Bool = Loader.load("hx_chachapoly_auth_decrypt", 5);
+    private static var _encrypt_and_tag:ChaChaPolyContext->Array<Dynamic>->Array<Dynamic>->Array<Dynamic>->Array<Dynamic>->Int = Loader.load("hx_chachapoly_encrypt_and_tag", 5);
+    private static var _finish:ChaChaPolyContext->BytesData                   = Loader.load("hx_chachapoly_finish", 1);
+    private static var _finish_verify:ChaChaPolyContext->BytesData->Int->Bool = Loader.load("hx_chachapoly_finish_verify", 3);
+    private static var _free:ChaChaPolyContext->Void                          = Loader.load("hx_chachapoly_free", 1);
+    private static var _init:Void->ChaChaPolyContext                          = Loader.load("hx_chachapoly_init", 0);
+    private static var _self_test:Bool->Int                                   = Loader.load("hx_chachapoly_self_test", 1);
+    private static var _setkey:ChaChaPolyContext->BytesData->Void             = Loader.load("hx_chachapoly_setkey", 2);
+    private static var _starts:ChaChaPolyContext->BytesData->Int->Int         = Loader.load("hx_chachapoly_starts", 3);
+    private static var _update:ChaChaPolyContext->Array<Dynamic>->Int         = Loader.load("hx_chachapoly_update", 2);
+    private static var _update_aad:ChaChaPolyContext->BytesData->Int->Int     = Loader.load("hx_chachapoly_update_aad", 3);
+
+    /**
+     * Possible ChaCha20-Poly1305 mode values.
+     */
+    public static inline var DECRYPT:Int = 0;
+    public static inline var ENCRYPT:Int = 1;
+
+    /**
+     * The key, nonce and tag lengths in bytes.
+     */
+    public static inline var KEY_LENGTH:Int = 32;
+    public static inline var IV_LENGTH:Int  = 12;
+    public static inline var TAG_LENGTH:Int = 16;
+
+    /**
+     * Stores the native ChaCha20-Poly1305 context handle.
+     *
+     * @var Null<polarssl.ChaChaPoly.ChaChaPolyContext>
+     */
+    private var context:Null<ChaChaPolyContext>;
+
+
+    /**
+     * Constructor to initialize a new ChaChaPoly instance.
+     *
+     * @throws polarssl.PolarSSLException if the ChaCha20-Poly1305 context init fails
+     */
+    public function new():Void
+    {
+        try {
+            this.context = ChaChaPoly._init();
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Decrypts 'length' bytes of 'input' starting at 'inPos' into 'output' starting at 'outPos'
+     * and verifies the authentication tag.
+     *
+     * Attn: If the tag does not match, the output range is zeroed.
+     *       A streamed message in progress is not affected by this call.
+     *
+     * @param haxe.io.Bytes       iv     the 12 bytes nonce
+     * @param Null<haxe.io.Bytes> add    the additional authenticated data
+     * @param haxe.io.Bytes       input  the Bytes to read the ciphertext from
+     * @param Int                 inPos  the position to start reading at
+     * @param Int                 length the number of bytes to decrypt
+     * @param haxe.io.Bytes       output the Bytes to write the plaintext to (may be 'input')
+     * @param Int                 outPos the position to start writing at
+     * @param haxe.io.Bytes       tag    the Bytes to read the 16 bytes tag from
+     * @param Int                 tagPos the position of the tag
+     *
+     * @return Bool true if the data is authentic
+     *
+     * @throws hext.IllegalArgumentException if the nonce is not 12 bytes long
+     * @throws hext.IllegalArgumentException if a range is outside of its Bytes
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error (e.g. no key set)
+     */
+    public function authDecrypt(iv:Bytes, add:Null<Bytes>, input:Bytes, inPos:Int, length:Int,
+        output:Bytes, outPos:Int, tag:Bytes, tagPos:Int):Bool
+    {
+        ChaChaPoly.checkArguments(iv, input, inPos, length, output, outPos, tag, tagPos);
+        if (this.context == null) {
+            throw new IllegalStateException("ChaCha20-Poly1305 context not available.");
+        }
+
+        try {
+            return ChaChaPoly._auth_decrypt(this.context, ChaChaPoly.toArr(iv), ChaChaPoly.toArr(add),
+                [ length, input.getData(), inPos, output.getData(), outPos ], [ ChaChaPoly.TAG_LENGTH, tag.getData(), tagPos ]);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Internal method to validate the arguments shared by authDecrypt() and encryptAndTag().
+     *
+     * @throws hext.IllegalArgumentException if an argument is invalid
+     */
+    private static function checkArguments(iv:Bytes, input:Bytes, inPos:Int, length:Int,
+        output:Bytes, outPos:Int, tag:Bytes, tagPos:Int):Void
+    {
+        if (iv == null || iv.length != ChaChaPoly.IV_LENGTH) {
+            throw new IllegalArgumentException("Nonce must be 12 bytes.");
+        }
+        if (tag == null || tagPos < 0 || tagPos > tag.length - ChaChaPoly.TAG_LENGTH) {
+            throw new IllegalArgumentException("Tag range is outside of the Bytes.");
+        }
+        ChaChaPoly.checkRange(input, inPos, length, output, outPos);
+    }
+
+    /**
+     * Internal method to validate an input/output range pair.
+     *
+     * @throws hext.IllegalArgumentException if a range is invalid
+     */
+    private static function checkRange(input:Bytes, inPos:Int, length:Int, output:Bytes, outPos:Int):Void
+    {
+        if (input == null || output == null) {
+            throw new IllegalArgumentException("Input and output Bytes cannot be null.");
+        }
+        if (length < 0 || inPos < 0 || inPos > input.length || length > input.length - inPos || outPos < 0 || outPos > output.length || length > output.length - outPos) {
+            throw new IllegalArgumentException("Range is outside of the Bytes.");
+        }
+    }
+
+    /**
+     * Encrypts 'length' bytes of 'input' starting at 'inPos' into 'output' starting at 'outPos'
+     * and writes the 16 bytes authentication tag to 'tag' at 'tagPos'.
+     *
+     * Attn: A streamed message in progress is not affected by this call.
+     *
+     * @param haxe.io.Bytes       iv     the 12 bytes nonce, never reuse it with the same key
+     * @param Null<haxe.io.Bytes> add    the additional authenticated data
+     * @param haxe.io.Bytes       input  the Bytes to read the plaintext from
+     * @param Int                 inPos  the position to start reading at
+     * @param Int                 length the number of bytes to encrypt
+     * @param haxe.io.Bytes       output the Bytes to write the ciphertext to (may be 'input')
+     * @param Int                 outPos the position to start writing at
+     * @param haxe.io.Bytes       tag    the Bytes to write the tag to
+     * @param Int                 tagPos the position to write the tag at
+     *
+     * @throws hext.IllegalArgumentException if the nonce is not 12 bytes long
+     * @throws hext.IllegalArgumentException if a range is outside of its Bytes
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error (e.g. no key set)
+     */
+    public function encryptAndTag(iv:Bytes, add:Null<Bytes>, input:Bytes, inPos:Int, length:Int,
+        output:Bytes, outPos:Int, tag:Bytes, tagPos:Int):Void
+    {
+        ChaChaPoly.checkArguments(iv, input, inPos, length, output, outPos, tag, tagPos);
+        if (this.context == null) {
+            throw new IllegalStateException("ChaCha20-Poly1305 context not available.");
+        }
+
+        try {
+            ChaChaPoly._encrypt_and_tag(this.context, ChaChaPoly.toArr(iv), ChaChaPoly.toArr(add),
+                [ length, input.getData(), inPos, output.getData(), outPos ], [ ChaChaPoly.TAG_LENGTH, tag.getData(), tagPos ]);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Finishes the streamed message and returns its authentication tag.
+     *
+     * Attn: When decrypting, use finishVerify() instead, which compares the tag in constant time.
+     *
+     * @return haxe.io.Bytes the 16 bytes tag
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if no message has been started
+     */
+    public function finish():Bytes
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("ChaCha20-Poly1305 context not available.");
+        }
+
+        try {
+            return Bytes.ofData(ChaChaPoly._finish(this.context));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Finishes the streamed message and compares its tag to the received one in constant time.
+     *
+     * Attn: The streamed plaintext must not be trusted (or used) before this returned true.
+     *
+     * @param haxe.io.Bytes tag the received 16 bytes tag
+     *
+     * @return Bool true if the streamed message is authentic
+     *
+     * @throws hext.IllegalArgumentException if the tag is not 16 bytes long
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if no message has been started
+     */
+    public function finishVerify(tag:Bytes):Bool
+    {
+        if (tag == null || tag.length != ChaChaPoly.TAG_LENGTH) {
+            throw new IllegalArgumentException("Tag must be 16 bytes.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("ChaCha20-Poly1305 context not available.");
+        }
+
+        try {
+            return ChaChaPoly._finish_verify(this.context, tag.getData(), tag.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Frees all memory allocated for this ChaChaPoly instance (wiping the key).
+     *
+     * Attn: The ChaChaPoly instance can no longer be used after calling this method.
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call throws an error
+     */
+    public function free():Void
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("No ChaCha20-Poly1305 context available.");
+        }
+
+        try {
+            ChaChaPoly._free(this.context);
+            this.context = null;
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Runs various health checks to ensure the ChaCha20-Poly1305 module works correctly.
+     *
+     * @param Bool verbose either to output debug information or not
+     *
+     * @return Bool
+     */
+    public static function selfTest(verbose:Bool = #if POLARSSL_DEBUG true #else false #end):Bool
+    {
+        var ret:Int;
+        try {
+            ret = ChaChaPoly._self_test(verbose);
+        } catch (ex:Dynamic) {
+            #if POLARSSL_DEBUG
+                throw new PolarSSLException(ex);
+            #else
+                ret = 1;
+            #end
+        }
+
+        return ret == 0;
+    }
+
+    /**
+     * Sets the 256 bit key.
+     *
+     * @param haxe.io.Bytes key the secret key to set
+     *
+     * @throws hext.IllegalArgumentException if the key is not 32 bytes long
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function setKey(key:Bytes):Void
+    {
+        if (key == null || key.length != ChaChaPoly.KEY_LENGTH) {
+            throw new IllegalArgumentException("Bytes are not a valid ChaCha20-Poly1305 key.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("ChaCha20-Poly1305 context not available.");
+        }
+
+        try {
+            ChaChaPoly._setkey(this.context, key.getData());
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Starts a new streamed message, discarding any unfinished one.
+     *
+     * @param Int           mode ChaChaPoly.DECRYPT or ChaChaPoly.ENCRYPT
+     * @param haxe.io.Bytes iv   the 12 bytes nonce, never reuse it with the same key
+     *
+     * @throws hext.IllegalArgumentException if the mode is not supported
+     * @throws hext.IllegalArgumentException if the nonce is not 12 bytes long
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error (e.g. no key set)
+     */
+    public function starts(mode:Int, iv:Bytes):Void
+    {
+        if (mode != ChaChaPoly.DECRYPT && mode != ChaChaPoly.ENCRYPT) {
+            throw new IllegalArgumentException("Provided ChaCha20-Poly1305 mode is not supported.");
+        }
+        if (iv == null || iv.length != ChaChaPoly.IV_LENGTH) {
+            throw new IllegalArgumentException("Nonce must be 12 bytes.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("ChaCha20-Poly1305 context not available.");
+        }
+
+        try {
+            ChaChaPoly._starts(this.context, iv.getData(), mode);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Packs the (nullable) Bytes into the [length, data] Array expected by the FFI functions.
+     *
+     * @param Null<haxe.io.Bytes> bytes the Bytes to pack
+     *
+     * @return Array<Dynamic>
+     */
+    private static function toArr(bytes:Null<Bytes>):Array<Dynamic>
+    {
+        if (bytes == null) {
+            bytes = Bytes.alloc(0);
+        }
+
+        var arr:Array<Dynamic> = new Array<Dynamic>();
+        arr[0] = bytes.length;
+        arr[1] = bytes.getData();
+
+        return arr;
+    }
+
+    /**
+     * Encrypts/decrypts the next chunk of the streamed message; chunks may have any length.
+     *
+     * @param haxe.io.Bytes input  the Bytes to read from
+     * @param Int           inPos  the position to start reading at
+     * @param Int           length the number of bytes to process
+     * @param haxe.io.Bytes output the Bytes to write to (may be 'input' with outPos == inPos)
+     * @param Int           outPos the position to start writing at
+     *
+     * @throws hext.IllegalArgumentException if a range is outside of its Bytes
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if no message has been started or it would exceed 256 GiB
+     */
+    public function update(input:Bytes, inPos:Int, length:Int, output:Bytes, outPos:Int):Void
+    {
+        ChaChaPoly.checkRange(input, inPos, length, output, outPos);
+        if (this.context == null) {
+            throw new IllegalStateException("ChaCha20-Poly1305 context not available.");
+        }
+
+        try {
+            ChaChaPoly._update(this.context, [ length, input.getData(), inPos, output.getData(), outPos ]);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Feeds the next chunk of additional authenticated data of the streamed message.
+     *
+     * Attn: All additional data must be fed before the first update() call.
+     *
+     * @param haxe.io.Bytes add the additional data
+     *
+     * @throws hext.IllegalArgumentException if the bytes are null
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if no message has been started or update() was already called
+     */
+    public function updateAad(add:Bytes):Void
+    {
+        if (add == null) {
+            throw new IllegalArgumentException("Additional data cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("ChaCha20-Poly1305 context not available.");
+        }
+
+        try {
+            ChaChaPoly._update_aad(this.context, add.getData(), add.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+}
+
+
+/**
+ * Extern for native ChaCha20-Poly1305 context handles wrapped by Neko/C++ value.
+ */
+private extern class ChaChaPolyContext {}
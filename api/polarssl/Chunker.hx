@@ -0,0 +1,232 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import hext.io.Path;
+import polarssl.Loader;
+import polarssl.MDType;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for a native content-defined chunker (FastCDC).
+ *
+ * Chunk boundaries depend on the content only, so inserting or removing data only
+ * changes the chunks around the edit, which makes the chunks suitable as units for
+ * deduplication. Each chunk is digested natively and all results are returned in
+ * one packed ChunkList.
+ *
+ * Example:
+ *   var chunker = new Chunker(2048, 8192, 65536, MDType.SHA256);
+ *   var chunks  = chunker.chunkFile("backup.tar");
+ *   for (i in 0...chunks.length) {
+ *       store.put(chunks.digestOf(i), chunks.offsetOf(i), chunks.lengthOf(i));
+ *   }
+ */
+class Chunker
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _bytes:ChunkerContext->BytesData->Int->Int->BytesData = Loader.load("hx_chunker_bytes", 4);
+    private static var _file:ChunkerContext->Path->BytesData                 = Loader.load("hx_chunker_file", 2);
+    private static var _init:Int->Int->Int->Int->ChunkerContext              = Loader.load("hx_chunker_init", 4);
+
+    /**
+     * Stores the native chunker handle.
+     *
+     * @var polarssl.Chunker.ChunkerContext
+     */
+    private var context:ChunkerContext;
+
+    /**
+     * The digest algorithm of the chunks.
+     *
+     * @var polarssl.MDType
+     */
+    public var type(default, null):MDType;
+
+
+    /**
+     * Constructor to initialize a new Chunker instance.
+     *
+     * @param Int             minSize the minimum chunk size (at least 64)
+     * @param Int             avgSize the targeted average chunk size
+     * @param Int             maxSize the maximum chunk size (at most 256 MiB)
+     * @param polarssl.MDType type    the chunks' digest algorithm (NONE, SHA1 or SHA256)
+     *
+     * @throws hext.IllegalArgumentException if the sizes are not ordered/in range or the algorithm is not supported
+     * @throws polarssl.PolarSSLException    if the native chunker init fails
+     */
+    public function new(minSize:Int, avgSize:Int, maxSize:Int, type:MDType = MDType.SHA256):Void
+    {
+        if (minSize < 64 || avgSize < minSize || maxSize < avgSize || maxSize > (1 << 28)) {
+            throw new IllegalArgumentException("Chunk sizes must satisfy 64 <= min <= avg <= max <= 256 MiB.");
+        }
+        if (type != MDType.NONE && type != MDType.SHA1 && type != MDType.SHA256) {
+            throw new IllegalArgumentException("Digest algorithm is not supported.");
+        }
+
+        this.type = type;
+        try {
+            this.context = Chunker._init(minSize, avgSize, maxSize, type);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Splits the input bytes into chunks; the last chunk ends at the end of the range.
+     *
+     * @param haxe.io.Bytes bytes  the Bytes to split
+     * @param Int           pos    the position to start reading at
+     * @param Null<Int>     length the number of bytes to split (defaults to the rest)
+     *
+     * @return polarssl.Chunker.ChunkList the chunks (offsets are relative to 'pos')
+     *
+     * @throws hext.IllegalArgumentException if the range is outside of the Bytes
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function chunkBytes(bytes:Bytes, pos:Int = 0, ?length:Int):ChunkList
+    {
+        if (bytes != null && length == null) {
+            length = bytes.length - pos;
+        }
+        if (bytes == null || pos < 0 || length < 0 || pos > bytes.length || length > bytes.length - pos) {
+            throw new IllegalArgumentException("Range is outside of the Bytes.");
+        }
+
+        try {
+            return new ChunkList(Bytes.ofData(Chunker._bytes(this.context, bytes.getData(), pos, length)), this.type);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Splits the file specified by 'path' into chunks natively.
+     *
+     * @param hext.io.Path path the file's path
+     *
+     * @return polarssl.Chunker.ChunkList the chunks
+     *
+     * @throws polarssl.PolarSSLException if the file cannot be read
+     */
+    public function chunkFile(path:Path):ChunkList
+    {
+        try {
+            return new ChunkList(Bytes.ofData(Chunker._file(this.context, path)), this.type);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+}
+
+
+/**
+ * Read-only view of the packed chunker results.
+ *
+ * Each record consists of the chunk's offset (64 bit), its length (32 bit), both
+ * little-endian, followed by its digest.
+ */
+class ChunkList
+{
+    /**
+     * The packed records.
+     *
+     * @var haxe.io.Bytes
+     */
+    public var data(default, null):Bytes;
+
+    /**
+     * The size of the chunk digests (0 if chunks are not digested).
+     *
+     * @var Int
+     */
+    public var digestSize(default, null):Int;
+
+    /**
+     * The number of chunks.
+     *
+     * @var Int
+     */
+    public var length(get, never):Int;
+
+    /**
+     * The size of one record.
+     *
+     * @var Int
+     */
+    private var recordSize:Int;
+
+
+    /**
+     * Constructor to initialize a new ChunkList instance.
+     *
+     * @param haxe.io.Bytes   data the packed records
+     * @param polarssl.MDType type the digest algorithm of the chunks
+     */
+    @:allow(polarssl.Chunker)
+    private function new(data:Bytes, type:MDType):Void
+    {
+        this.data       = data;
+        this.digestSize = (type == MDType.SHA256) ? 32 : (type == MDType.SHA1) ? 20 : 0;
+        this.recordSize = 12 + this.digestSize;
+    }
+
+    /**
+     * Returns the digest of the chunk at 'index'.
+     *
+     * @param Int index the chunk's index
+     *
+     * @return haxe.io.Bytes
+     */
+    public function digestOf(index:Int):Bytes
+    {
+        return this.data.sub(index * this.recordSize + 12, this.digestSize);
+    }
+
+    /**
+     * Getter for the 'length' property.
+     */
+    private function get_length():Int
+    {
+        return Std.int(this.data.length / this.recordSize);
+    }
+
+    /**
+     * Returns the length of the chunk at 'index'.
+     *
+     * @param Int index the chunk's index
+     *
+     * @return Int
+     */
+    public function lengthOf(index:Int):Int
+    {
+        return this.data.getInt32(index * this.recordSize + 8);
+    }
+
+    /**
+     * Returns the offset of the chunk at 'index'.
+     *
+     * @param Int index the chunk's index
+     *
+     * @return Float the offset (exact up to 2^53)
+     */
+    public function offsetOf(index:Int):Float
+    {
+        var pos:Int  = index * this.recordSize;
+        var lo:Float = this.data.getInt32(pos);
+        if (lo < 0) {
+            lo += 4294967296.0;
+        }
+
+        return this.data.getInt32(pos + 4) * 4294967296.0 + lo;
+    }
+}
+
+
+/**
+ * Extern for native chunker handles wrapped by Neko/C++ value.
+ */
+private extern class ChunkerContext {}
@@ -0,0 +1,402 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import hext.IllegalStateException;
+import polarssl.Loader;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for the PolarSSL generic cipher layer, which selects
+ * the algorithm and mode at runtime by name (e.g. "AES-128-CBC", "CAMELLIA-256-CTR").
+ *
+ * Input may be fed through update() in chunks of any length; partial blocks are
+ * buffered natively where the mode requires full blocks and flushed by finish().
+ */
+class Cipher
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _check_tag:CipherContext->BytesData->Int->Bool            = Loader.load("hx_cipher_check_tag", 3);
+    private static var _finish:CipherContext->BytesData                           = Loader.load("hx_cipher_finish", 1);
+    private static var _free:CipherContext->Void                                  = Loader.load("hx_cipher_free", 1);
+    private static var _get_block_size:CipherContext->Int                         = Loader.load("hx_cipher_get_block_size", 1);
+    private static var _get_iv_size:CipherContext->Int                            = Loader.load("hx_cipher_get_iv_size", 1);
+    private static var _get_key_size:CipherContext->Int                           = Loader.load("hx_cipher_get_key_size", 1);
+    private static var _init:String->CipherContext                                = Loader.load("hx_cipher_init", 1);
+    private static var _reset:CipherContext->Int                                  = Loader.load("hx_cipher_reset", 1);
+    private static var _set_iv:CipherContext->BytesData->Int->Int                 = Loader.load("hx_cipher_set_iv", 3);
+    private static var _set_padding:CipherContext->Int->Int                       = Loader.load("hx_cipher_set_padding", 2);
+    private static var _setkey:CipherContext->BytesData->Int->Int->Int            = Loader.load("hx_cipher_setkey", 4);
+    private static var _update:CipherContext->BytesData->Int->Int->BytesData      = Loader.load("hx_cipher_update", 4);
+    private static var _update_ad:CipherContext->BytesData->Int->Int              = Loader.load("hx_cipher_update_ad", 3);
+    private static var _write_tag:CipherContext->Int->BytesData                   = Loader.load("hx_cipher_write_tag", 2);
+
+    /**
+     * Possible cipher operation values.
+     */
+    public static inline var DECRYPT:Int = 0;
+    public static inline var ENCRYPT:Int = 1;
+
+    /**
+     * Possible padding scheme values (CBC mode only).
+     */
+    public static inline var PADDING_PKCS7:Int         = 0;
+    public static inline var PADDING_ONE_AND_ZEROS:Int = 1;
+    public static inline var PADDING_ZEROS_AND_LEN:Int = 2;
+    public static inline var PADDING_ZEROS:Int         = 3;
+    public static inline var PADDING_NONE:Int          = 4;
+
+    /**
+     * Stores the block size of the selected cipher in bytes.
+     *
+     * @var Int
+     */
+    public var blockSize(get, never):Int;
+
+    /**
+     * Stores the native cipher context handle.
+     *
+     * @var Null<polarssl.Cipher.CipherContext>
+     */
+    private var context:Null<CipherContext>;
+
+    /**
+     * Stores the IV/nonce size of the selected cipher in bytes.
+     *
+     * @var Int
+     */
+    public var ivSize(get, never):Int;
+
+    /**
+     * Stores the key size of the selected cipher in bits.
+     *
+     * @var Int
+     */
+    public var keySize(get, never):Int;
+
+
+    /**
+     * Constructor to initialize a new Cipher instance.
+     *
+     * @param String name the PolarSSL cipher name, e.g. "AES-256-GCM"
+     *
+     * @throws hext.IllegalArgumentException if the name is null
+     * @throws polarssl.PolarSSLException    if the cipher is not supported or the init fails
+     */
+    public function new(name:String):Void
+    {
+        if (name == null) {
+            throw new IllegalArgumentException("Cipher name cannot be null.");
+        }
+
+        try {
+            this.context = Cipher._init(name);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Verifies the authentication tag (GCM only). Must be called after finish().
+     *
+     * @param haxe.io.Bytes tag the expected tag
+     *
+     * @return Bool true if the tag matches
+     *
+     * @throws hext.IllegalArgumentException if the tag is null
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function checkTag(tag:Bytes):Bool
+    {
+        if (tag == null) {
+            throw new IllegalArgumentException("Tag cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("Cipher context not available.");
+        }
+
+        try {
+            return Cipher._check_tag(this.context, tag.getData(), tag.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Processes the still buffered input and returns the remaining output (including padding).
+     *
+     * @return haxe.io.Bytes the final output Bytes (may be empty)
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error (e.g. incomplete ECB block, bad padding)
+     */
+    public function finish():Bytes
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("Cipher context not available.");
+        }
+
+        try {
+            return Bytes.ofData(Cipher._finish(this.context));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Frees all memory allocated for this Cipher instance.
+     *
+     * Attn: The Cipher instance can no longer be used after calling this method.
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call throws an error
+     */
+    public function free():Void
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("Cipher context not available.");
+        }
+
+        try {
+            Cipher._free(this.context);
+            this.context = null;
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Getter for the 'blockSize' property.
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     */
+    private function get_blockSize():Int
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("Cipher context not available.");
+        }
+
+        return Cipher._get_block_size(this.context);
+    }
+
+    /**
+     * Getter for the 'ivSize' property.
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     */
+    private function get_ivSize():Int
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("Cipher context not available.");
+        }
+
+        return Cipher._get_iv_size(this.context);
+    }
+
+    /**
+     * Getter for the 'keySize' property.
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     */
+    private function get_keySize():Int
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("Cipher context not available.");
+        }
+
+        return Cipher._get_key_size(this.context);
+    }
+
+    /**
+     * Resets the cipher to start a new message with the same key (and discards buffered input).
+     *
+     * Attn: Call setIv() before reset() when the mode needs a new IV.
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function reset():Void
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("Cipher context not available.");
+        }
+
+        try {
+            Cipher._reset(this.context);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Sets the initialization vector/nonce for the next message.
+     *
+     * @param haxe.io.Bytes iv the initialization vector
+     *
+     * @throws hext.IllegalArgumentException if the IV is null
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function setIv(iv:Bytes):Void
+    {
+        if (iv == null) {
+            throw new IllegalArgumentException("Initialization vector cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("Cipher context not available.");
+        }
+
+        try {
+            Cipher._set_iv(this.context, iv.getData(), iv.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Sets the key and the direction the instance is used for.
+     *
+     * @param haxe.io.Bytes key       the secret key (keySize / 8 bytes)
+     * @param Int           operation Cipher.DECRYPT or Cipher.ENCRYPT
+     *
+     * @throws hext.IllegalArgumentException if the key is null or the operation is not supported
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function setKey(key:Bytes, operation:Int):Void
+    {
+        if (key == null) {
+            throw new IllegalArgumentException("Key cannot be null.");
+        }
+        if (operation != Cipher.DECRYPT && operation != Cipher.ENCRYPT) {
+            throw new IllegalArgumentException("Provided cipher operation is not supported.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("Cipher context not available.");
+        }
+
+        try {
+            Cipher._setkey(this.context, key.getData(), key.length, operation);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Sets the padding scheme (CBC mode only).
+     *
+     * @param Int padding one of the Cipher.PADDING_* values
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function setPadding(padding:Int):Void
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("Cipher context not available.");
+        }
+
+        try {
+            Cipher._set_padding(this.context, padding);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Feeds 'length' bytes of 'bytes' starting at 'pos' through the cipher.
+     *
+     * @param haxe.io.Bytes bytes  the input Bytes
+     * @param Int           pos    the position to start reading at
+     * @param Int           length the number of bytes to process (defaults to the rest of 'bytes')
+     *
+     * @return haxe.io.Bytes the output available so far (may be shorter than the input)
+     *
+     * @throws hext.IllegalArgumentException if the range is outside of the Bytes
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function update(bytes:Bytes, pos:Int = 0, length:Int = -1):Bytes
+    {
+        if (bytes == null) {
+            throw new IllegalArgumentException("Input bytes cannot be null.");
+        }
+        if (length == -1) {
+            length = bytes.length - pos;
+        }
+        if (pos < 0 || length < 0 || pos > bytes.length || length > bytes.length - pos) {
+            throw new IllegalArgumentException("Range is outside of the Bytes.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("Cipher context not available.");
+        }
+
+        try {
+            return Bytes.ofData(Cipher._update(this.context, bytes.getData(), pos, length));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Feeds additional authenticated data (GCM only). Must be called after reset() and before update().
+     *
+     * @param haxe.io.Bytes ad the additional data
+     *
+     * @throws hext.IllegalArgumentException if the data is null
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function updateAd(ad:Bytes):Void
+    {
+        if (ad == null) {
+            throw new IllegalArgumentException("Additional data cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("Cipher context not available.");
+        }
+
+        try {
+            Cipher._update_ad(this.context, ad.getData(), ad.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Returns the authentication tag (GCM only). Must be called after finish().
+     *
+     * @param Int length the tag length (4 - 16)
+     *
+     * @return haxe.io.Bytes the tag
+     *
+     * @throws hext.IllegalArgumentException if the length is invalid
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function writeTag(length:Int = 16):Bytes
+    {
+        if (length < 4 || length > 16) {
+            throw new IllegalArgumentException("Tag length must be between 4 and 16.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("Cipher context not available.");
+        }
+
+        try {
+            return Bytes.ofData(Cipher._write_tag(this.context, length));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+}
+
+
+/**
+ * Extern for native cipher context handles wrapped by Neko/C++ value.
+ */
+private extern class CipherContext {}
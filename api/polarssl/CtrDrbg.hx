@@ -0,0 +1,273 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import hext.IllegalStateException;
+import polarssl.Loader;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for the PolarSSL CTR_DRBG implementation.
+ *
+ * The generator is seeded once from PolarSSL's entropy pool and afterwards produces
+ * random bytes at block cipher speed. Instances can be assigned to the 'rng' property
+ * of the RSA, ECDSA, ECDH and DHM classes to be used instead of HAVEGE.
+ */
+class CtrDrbg
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _fill:CtrDrbgContext->BytesData->Int->Int->Int    = Loader.load("hx_ctr_drbg_fill", 4);
+    private static var _free:CtrDrbgContext->Void                        = Loader.load("hx_ctr_drbg_free", 1);
+    private static var _init:BytesData->Int->CtrDrbgContext              = Loader.load("hx_ctr_drbg_init", 2);
+    private static var _random:CtrDrbgContext->Int->BytesData            = Loader.load("hx_ctr_drbg_random", 2);
+    private static var _reseed:CtrDrbgContext->BytesData->Int->Int       = Loader.load("hx_ctr_drbg_reseed", 3);
+    private static var _self_test:Bool->Int                              = Loader.load("hx_ctr_drbg_self_test", 1);
+    private static var _set_prediction_resistance:CtrDrbgContext->Bool->Void = Loader.load("hx_ctr_drbg_set_prediction_resistance", 2);
+    private static var _set_reseed_interval:CtrDrbgContext->Int->Void    = Loader.load("hx_ctr_drbg_set_reseed_interval", 2);
+
+    /**
+     * Stores the native CTR_DRBG context handle.
+     *
+     * @var Null<polarssl.CtrDrbg.CtrDrbgContext>
+     */
+    private var context:Null<CtrDrbgContext>;
+
+
+    /**
+     * Constructor to initialize a new CtrDrbg instance.
+     *
+     * @param Null<haxe.io.Bytes> custom the personalization data (device specific identifiers)
+     *
+     * @throws polarssl.PolarSSLException if seeding the CTR_DRBG fails
+     */
+    public function new(?custom:Bytes):Void
+    {
+        if (custom == null) {
+            custom = Bytes.alloc(0);
+        }
+
+        try {
+            this.context = CtrDrbg._init(custom.getData(), custom.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Returns the native context handle of the (nullable) instance to pass to FFI calls.
+     *
+     * @param Null<polarssl.CtrDrbg> rng the instance to unwrap
+     *
+     * @return Dynamic the native handle or null (which selects HAVEGE)
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     */
+    @:allow(polarssl)
+    private static function contextOf(rng:Null<CtrDrbg>):Dynamic
+    {
+        if (rng == null) {
+            return null;
+        }
+        if (rng.context == null) {
+            throw new IllegalStateException("CTR_DRBG context not available.");
+        }
+
+        return rng.context;
+    }
+
+    /**
+     * Writes 'len' random bytes into 'bytes' starting at position 'pos'.
+     *
+     * Attn: Unlike random(), no new Bytes are allocated.
+     *
+     * @param haxe.io.Bytes bytes the Bytes to write into
+     * @param Int           pos   the position to start writing at
+     * @param Int           len   the number of random bytes to write
+     *
+     * @throws hext.IllegalArgumentException if the range is outside of the Bytes
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function fill(bytes:Bytes, pos:Int, len:Int):Void
+    {
+        if (bytes == null) {
+            throw new IllegalArgumentException("Bytes cannot be null.");
+        }
+        if (pos < 0 || len < 0 || pos > bytes.length || len > bytes.length - pos) {
+            throw new IllegalArgumentException("Range is outside of the Bytes.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("CTR_DRBG context not available.");
+        }
+
+        if (len != 0) {
+            try {
+                CtrDrbg._fill(this.context, bytes.getData(), pos, len);
+            } catch (ex:Dynamic) {
+                throw new PolarSSLException(ex);
+            }
+        }
+    }
+
+    /**
+     * Frees all memory allocated for this CtrDrbg instance.
+     *
+     * Attn: The CtrDrbg instance can no longer be used after calling this method.
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function free():Void
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("CTR_DRBG context not available.");
+        }
+
+        try {
+            CtrDrbg._free(this.context);
+            this.context = null;
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Generates 'nbytes' of random bytes.
+     *
+     * @param Int nbytes the number of randoms to generate
+     *
+     * @return haxe.io.Bytes the random Bytes
+     *
+     * @throws hext.IllegalArgumentException if the number of random Bytes to generate is less than zero
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function random(nbytes:Int):Bytes
+    {
+        if (nbytes < 0) {
+            throw new IllegalArgumentException("Number of bytes cannot be less than zero.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("CTR_DRBG context not available.");
+        }
+
+        var bytes:Bytes;
+        if (nbytes == 0) {
+            bytes = Bytes.alloc(0);
+        } else {
+            try {
+                bytes = Bytes.ofData(CtrDrbg._random(this.context, nbytes));
+            } catch (ex:Dynamic) {
+                throw new PolarSSLException(ex);
+            }
+        }
+
+        return bytes;
+    }
+
+    /**
+     * Reseeds the generator from the entropy pool.
+     *
+     * @param Null<haxe.io.Bytes> additional additional data to mix into the state
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function reseed(?additional:Bytes):Void
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("CTR_DRBG context not available.");
+        }
+
+        if (additional == null) {
+            additional = Bytes.alloc(0);
+        }
+
+        try {
+            CtrDrbg._reseed(this.context, additional.getData(), additional.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Runs various health checks to ensure the CTR_DRBG module works correctly.
+     *
+     * @param Bool verbose either to output debug information or not
+     *
+     * @return Bool
+     */
+    public static function selfTest(verbose:Bool = #if POLARSSL_DEBUG true #else false #end):Bool
+    {
+        var ret:Int;
+        try {
+            ret = CtrDrbg._self_test(verbose);
+        } catch (ex:Dynamic) {
+            #if POLARSSL_DEBUG
+                throw new PolarSSLException(ex);
+            #else
+                ret = 1;
+            #end
+        }
+
+        return ret == 0;
+    }
+
+    /**
+     * Enables or disables prediction resistance.
+     *
+     * Attn: With prediction resistance enabled, the generator reseeds from the
+     *       entropy pool before every request, which is considerably slower.
+     *
+     * @param Bool resistance either to enable prediction resistance or not
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function setPredictionResistance(resistance:Bool):Void
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("CTR_DRBG context not available.");
+        }
+
+        try {
+            CtrDrbg._set_prediction_resistance(this.context, resistance);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Sets the number of requests after which the generator reseeds automatically.
+     *
+     * @param Int interval the reseed interval
+     *
+     * @throws hext.IllegalArgumentException if the interval is less or equal to zero
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function setReseedInterval(interval:Int):Void
+    {
+        if (interval <= 0) {
+            throw new IllegalArgumentException("Reseed interval cannot be <= 0.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("CTR_DRBG context not available.");
+        }
+
+        try {
+            CtrDrbg._set_reseed_interval(this.context, interval);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+}
+
+
+/**
+ * Extern for native CTR_DRBG context handles wrapped by Neko/C++ value.
+ */
+private extern class CtrDrbgContext {}
@@ -0,0 +1,304 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import hext.IllegalStateException;
+import polarssl.CtrDrbg;
+import polarssl.Loader;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for the PolarSSL Diffie-Hellman-Merkle (DHM) implementation.
+ *
+ * Attn: Reuse one instance for subsequent exchanges within the same group;
+ *       the value PolarSSL precomputes for the modulus (R^2 mod P) is kept
+ *       and only rebuilt if the group changes. The blinding values used by
+ *       computeSecret() are not reused across exchanges: PolarSSL recomputes
+ *       them whenever the secret value X changes.
+ */
+class DHM
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _calc_secret:DHMContext->Dynamic->BytesData                = Loader.load("hx_dhm_calc_secret", 2);
+    private static var _free:DHMContext->Void                                     = Loader.load("hx_dhm_free", 1);
+    private static var _init:Void->DHMContext                                     = Loader.load("hx_dhm_init", 0);
+    private static var _make_params:DHMContext->Int->Dynamic->BytesData           = Loader.load("hx_dhm_make_params", 3);
+    private static var _make_public:DHMContext->Int->Dynamic->BytesData           = Loader.load("hx_dhm_make_public", 3);
+    private static var _read_params:DHMContext->BytesData->Int->Int               = Loader.load("hx_dhm_read_params", 3);
+    private static var _read_public:DHMContext->BytesData->Int->Int               = Loader.load("hx_dhm_read_public", 3);
+    private static var _self_test:Bool->Int                                       = Loader.load("hx_dhm_self_test", 1);
+    private static var _set_group:DHMContext->BytesData->Int->BytesData->Int->Int = Loader.load("hx_dhm_set_group", 5);
+    private static var _use_known_group:DHMContext->Int->Int                      = Loader.load("hx_dhm_use_known_group", 2);
+
+    /**
+     * Well-known group identifiers to use with useKnownGroup().
+     */
+    public static inline var RFC3526_MODP_2048:Int = 0;
+    public static inline var RFC3526_MODP_3072:Int = 1;
+    public static inline var RFC5114_MODP_2048:Int = 2;
+
+    /**
+     * Stores the native DHM context handle.
+     *
+     * @var Null<polarssl.DHM.DHMContext>
+     */
+    private var context:Null<DHMContext>;
+
+    /**
+     * The random number generator to use (HAVEGE if null).
+     *
+     * @var Null<polarssl.CtrDrbg>
+     */
+    public var rng:Null<CtrDrbg>;
+
+
+    /**
+     * Constructor to initialize a new DHM instance.
+     *
+     * @throws polarssl.PolarSSLException if the DHM context init fails
+     */
+    public function new():Void
+    {
+        try {
+            this.context = DHM._init();
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Derives the shared secret from our secret value and the peer's public value.
+     *
+     * @return haxe.io.Bytes the shared secret
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function computeSecret():Bytes
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("DHM context not available.");
+        }
+
+        var rng:Dynamic = CtrDrbg.contextOf(this.rng);
+
+        try {
+            return Bytes.ofData(DHM._calc_secret(this.context, rng));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Frees all memory allocated for this DHM instance.
+     *
+     * Attn: The DHM instance can no longer be used after calling this method.
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function free():Void
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("DHM context not available.");
+        }
+
+        try {
+            DHM._free(this.context);
+            this.context = null;
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Generates a new secret value and returns the ServerDHParams (P, G and our public value).
+     *
+     * @param Int xSize the size of the secret value in bytes (0 for the size of P)
+     *
+     * @return haxe.io.Bytes the TLS ServerDHParams encoded Bytes
+     *
+     * @throws hext.IllegalArgumentException if the size is negative
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function makeParams(xSize:Int = 0):Bytes
+    {
+        if (xSize < 0) {
+            throw new IllegalArgumentException("Secret value size cannot be negative.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("DHM context not available.");
+        }
+
+        var rng:Dynamic = CtrDrbg.contextOf(this.rng);
+
+        try {
+            return Bytes.ofData(DHM._make_params(this.context, xSize, rng));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Generates a new secret value and returns our public value (G^X mod P).
+     *
+     * @param Int xSize the size of the secret value in bytes (0 for the size of P)
+     *
+     * @return haxe.io.Bytes the public value
+     *
+     * @throws hext.IllegalArgumentException if the size is negative
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function makePublic(xSize:Int = 0):Bytes
+    {
+        if (xSize < 0) {
+            throw new IllegalArgumentException("Secret value size cannot be negative.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("DHM context not available.");
+        }
+
+        var rng:Dynamic = CtrDrbg.contextOf(this.rng);
+
+        try {
+            return Bytes.ofData(DHM._make_public(this.context, xSize, rng));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Parses the ServerDHParams (P, G and the peer's public value).
+     *
+     * @param haxe.io.Bytes params the TLS ServerDHParams encoded Bytes
+     *
+     * @throws hext.IllegalArgumentException if the params are null
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the params are invalid
+     */
+    public function readParams(params:Bytes):Void
+    {
+        if (params == null) {
+            throw new IllegalArgumentException("Params cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("DHM context not available.");
+        }
+
+        try {
+            DHM._read_params(this.context, params.getData(), params.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Imports the peer's public value.
+     *
+     * @param haxe.io.Bytes bytes the peer's public value
+     *
+     * @throws hext.IllegalArgumentException if the public value is null
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the public value is invalid
+     */
+    public function readPublic(bytes:Bytes):Void
+    {
+        if (bytes == null) {
+            throw new IllegalArgumentException("Public value cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("DHM context not available.");
+        }
+
+        try {
+            DHM._read_public(this.context, bytes.getData(), bytes.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Runs various health checks to ensure the DHM module works correctly.
+     *
+     * @param Bool verbose either to output debug information or not
+     *
+     * @return Bool
+     */
+    public static function selfTest(verbose:Bool = #if POLARSSL_DEBUG true #else false #end):Bool
+    {
+        var ret:Int;
+        try {
+            ret = DHM._self_test(verbose);
+        } catch (ex:Dynamic) {
+            #if POLARSSL_DEBUG
+                throw new PolarSSLException(ex);
+            #else
+                ret = 1;
+            #end
+        }
+
+        return ret == 0;
+    }
+
+    /**
+     * Sets the group parameters (prime modulus P and generator G).
+     *
+     * @param haxe.io.Bytes P the big-endian prime modulus
+     * @param haxe.io.Bytes G the big-endian generator
+     *
+     * @throws hext.IllegalArgumentException if P or G is null
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function setGroup(P:Bytes, G:Bytes):Void
+    {
+        if (P == null || G == null) {
+            throw new IllegalArgumentException("Group parameters cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("DHM context not available.");
+        }
+
+        try {
+            DHM._set_group(this.context, P.getData(), P.length, G.getData(), G.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Sets one of the well-known group parameters.
+     *
+     * @param Int group DHM.RFC3526_MODP_2048, DHM.RFC3526_MODP_3072 or DHM.RFC5114_MODP_2048
+     *
+     * @throws hext.IllegalArgumentException if the group is not supported
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function useKnownGroup(group:Int):Void
+    {
+        if (group != DHM.RFC3526_MODP_2048 && group != DHM.RFC3526_MODP_3072 && group != DHM.RFC5114_MODP_2048) {
+            throw new IllegalArgumentException("Provided DHM group is not supported.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("DHM context not available.");
+        }
+
+        try {
+            DHM._use_known_group(this.context, group);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+}
+
+
+/**
+ * Extern for native DHM context handles wrapped by Neko/C++ value.
+ */
+private extern class DHMContext {}
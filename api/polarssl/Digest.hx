@@ -0,0 +1,238 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import hext.io.Path;
+import polarssl.Loader;
+import polarssl.MDType;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for native running (streaming) message digests.
+ *
+ * The internal state can be saved to Bytes at any point and restored later, e.g. to
+ * keep a running sum of an append-only file across restarts by only hashing the
+ * data appended since the last checkpoint.
+ *
+ * Example:
+ *   var digest = (checkpoint == null) ? new Digest(MDType.SHA256) : Digest.restore(checkpoint);
+ *   digest.updateFromFile(journal, digest.length);
+ *   checkpoint = digest.save();
+ *   var sum    = digest.clone().finish();
+ */
+class Digest
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _clone:DigestContext->DigestContext              = Loader.load("hx_digest_clone", 1);
+    private static var _finish:DigestContext->BytesData                 = Loader.load("hx_digest_finish", 1);
+    private static var _init:Int->DigestContext                         = Loader.load("hx_digest_init", 1);
+    private static var _length:DigestContext->Float                     = Loader.load("hx_digest_length", 1);
+    private static var _restore:BytesData->Int->DigestContext           = Loader.load("hx_digest_restore", 2);
+    private static var _save:DigestContext->BytesData                   = Loader.load("hx_digest_save", 1);
+    private static var _update:DigestContext->BytesData->Int->Int->Void = Loader.load("hx_digest_update", 4);
+    private static var _update_file:DigestContext->Path->Float->Float   = Loader.load("hx_digest_update_file", 3);
+
+    /**
+     * Stores the native digest state handle.
+     *
+     * @var polarssl.Digest.DigestContext
+     */
+    private var context:DigestContext;
+
+    /**
+     * The number of bytes hashed since the digest was (re)started.
+     *
+     * @var Float
+     */
+    public var length(get, never):Float;
+
+    /**
+     * The digest algorithm.
+     *
+     * @var polarssl.MDType
+     */
+    public var type(default, null):MDType;
+
+
+    /**
+     * Constructor to initialize a new Digest instance.
+     *
+     * @param polarssl.MDType type the algorithm (MD5, SHA1, SHA224, SHA256, SHA384, SHA512 or RIPEMD160)
+     *
+     * @throws hext.IllegalArgumentException if the algorithm is not supported
+     * @throws polarssl.PolarSSLException    if the native digest init fails
+     */
+    public function new(type:MDType):Void
+    {
+        if (type == MDType.NONE || type == MDType.MD2 || type == MDType.MD4) {
+            throw new IllegalArgumentException("Digest algorithm is not supported.");
+        }
+
+        this.type = type;
+        try {
+            this.context = Digest._init(type);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Returns an independent copy of the digest.
+     *
+     * Useful to get the sum of the data hashed so far while continuing to hash.
+     *
+     * @return polarssl.Digest the copy
+     *
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function clone():Digest
+    {
+        try {
+            return Digest.wrap(Digest._clone(this.context), this.type);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Returns the sum of all hashed data and restarts the digest.
+     *
+     * @return haxe.io.Bytes the sum Bytes
+     *
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function finish():Bytes
+    {
+        try {
+            return Bytes.ofData(Digest._finish(this.context));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Getter for the 'length' property.
+     */
+    private function get_length():Float
+    {
+        return Digest._length(this.context);
+    }
+
+    /**
+     * Recreates a Digest from a state returned by save().
+     *
+     * Attn: The state is not authenticated; store it where it cannot be tampered with.
+     *
+     * @param haxe.io.Bytes state the saved state
+     *
+     * @return polarssl.Digest the restored digest
+     *
+     * @throws hext.IllegalArgumentException if the state is null or empty
+     * @throws polarssl.PolarSSLException    if the state is malformed
+     */
+    public static function restore(state:Bytes):Digest
+    {
+        if (state == null || state.length < 2) {
+            throw new IllegalArgumentException("Digest state is malformed.");
+        }
+
+        try {
+            return Digest.wrap(Digest._restore(state.getData(), state.length), state.get(1));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Serializes the internal state of the digest (at most 209 bytes).
+     *
+     * The state is portable between platforms and can be passed to Digest.restore().
+     *
+     * @return haxe.io.Bytes the state
+     *
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function save():Bytes
+    {
+        try {
+            return Bytes.ofData(Digest._save(this.context));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Hashes the next chunk of data.
+     *
+     * @param haxe.io.Bytes bytes  the Bytes to read from
+     * @param Int           pos    the position to start reading at
+     * @param Int           length the number of bytes to hash
+     *
+     * @throws hext.IllegalArgumentException if the range is outside of the Bytes
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function update(bytes:Bytes, pos:Int, length:Int):Void
+    {
+        if (bytes == null || pos < 0 || length < 0 || pos > bytes.length || length > bytes.length - pos) {
+            throw new IllegalArgumentException("Range is outside of the Bytes.");
+        }
+
+        try {
+            Digest._update(this.context, bytes.getData(), pos, length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Hashes the file specified by 'path' from 'offset' on to its end natively.
+     *
+     * Attn: If reading the file fails, the digest is left unchanged.
+     *
+     * @param hext.io.Path path   the file's path
+     * @param Float        offset the position to start reading at (e.g. the digest's length)
+     *
+     * @return Float the number of bytes hashed
+     *
+     * @throws hext.IllegalArgumentException if the offset is negative
+     * @throws polarssl.PolarSSLException    if the file cannot be read
+     */
+    public function updateFromFile(path:Path, offset:Float = 0):Float
+    {
+        if (offset < 0) {
+            throw new IllegalArgumentException("Offset cannot be negative.");
+        }
+
+        try {
+            return Digest._update_file(this.context, path, offset);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Internal method to create a Digest instance for an existing native handle.
+     *
+     * @param polarssl.Digest.DigestContext context the native handle
+     * @param polarssl.MDType               type    the handle's algorithm
+     *
+     * @return polarssl.Digest
+     */
+    private static function wrap(context:DigestContext, type:MDType):Digest
+    {
+        var digest:Digest = Type.createEmptyInstance(Digest);
+        digest.context    = context;
+        digest.type       = type;
+
+        return digest;
+    }
+}
+
+
+/**
+ * Extern for native digest state handles wrapped by Neko/C++ value.
+ */
+private extern class DigestContext {}
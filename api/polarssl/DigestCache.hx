@@ -0,0 +1,213 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import hext.IllegalStateException;
+import hext.io.Path;
+import polarssl.Loader;
+import polarssl.MDType;
+import polarssl.PolarSSLException;
+
+/**
+ * Statistics of a file digest cache.
+ *
+ * Hits, misses and evictions are counted per instance, size and capacity describe the index.
+ */
+typedef DigestCacheStats = {
+    var hits:Int;
+    var misses:Int;
+    var evictions:Int;
+    var size:Int;
+    var capacity:Int;
+}
+
+
+/**
+ * Haxe FFI wrapper class for a persistent cache of file digests.
+ *
+ * The sums are kept in a memory-mapped index file, keyed by the file's device, inode,
+ * size, modification and change time (in nanoseconds) plus the algorithm. As long as
+ * none of them changes, the cached sum is returned without reading the file, also
+ * across process restarts. Files modified less than 2 seconds before they are hashed
+ * are never cached.
+ *
+ * Attn: The index is in native byte order; use one index file per architecture. Writers
+ *       (also in other processes) are serialized with flock(). Not available on Windows.
+ *
+ * Example:
+ *   var cache = new DigestCache("build/.digests");
+ *   var sum   = cache.sumOfFile("assets/atlas.png", MDType.SHA256);
+ *   cache.close();
+ */
+class DigestCache
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _clear:DigestCacheContext->Void                    = Loader.load("hx_digestcache_clear", 1);
+    private static var _close:DigestCacheContext->Void                    = Loader.load("hx_digestcache_close", 1);
+    private static var _invalidate:DigestCacheContext->Path->Int          = Loader.load("hx_digestcache_invalidate", 2);
+    private static var _open:Path->Int->DigestCacheContext                = Loader.load("hx_digestcache_open", 2);
+    private static var _stats:DigestCacheContext->Array<Int>              = Loader.load("hx_digestcache_stats", 1);
+    private static var _sum_file:DigestCacheContext->Path->Int->BytesData = Loader.load("hx_digestcache_sum_file", 3);
+
+    /**
+     * Stores the native cache handle.
+     *
+     * @var polarssl.DigestCache.DigestCacheContext
+     */
+    private var context:DigestCacheContext;
+
+
+    /**
+     * Constructor to open (or create) the index file specified by 'path'.
+     *
+     * @param hext.io.Path path     the index file's path
+     * @param Int          capacity the number of entries of a new index (rounded up to a power of 2)
+     *
+     * @throws hext.IllegalArgumentException if the capacity is not positive
+     * @throws polarssl.PolarSSLException    if the index cannot be opened
+     */
+    public function new(path:Path, capacity:Int = 4096):Void
+    {
+        if (capacity <= 0) {
+            throw new IllegalArgumentException("Capacity must be positive.");
+        }
+
+        try {
+            this.context = DigestCache._open(path, capacity);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Removes all entries from the index.
+     *
+     * @throws hext.IllegalStateException if the cache has already been closed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function clear():Void
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("No DigestCache context available.");
+        }
+
+        try {
+            DigestCache._clear(this.context);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Flushes and closes the index.
+     *
+     * Attn: The DigestCache instance can no longer be used after calling this method.
+     *
+     * @throws hext.IllegalStateException if the cache has already been closed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function close():Void
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("No DigestCache context available.");
+        }
+
+        try {
+            DigestCache._close(this.context);
+            this.context = null;
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Removes the cached sums (of all algorithms) of the file specified by 'path'.
+     *
+     * @param hext.io.Path path the file's path
+     *
+     * @return Int the number of removed entries
+     *
+     * @throws hext.IllegalStateException if the cache has already been closed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function invalidate(path:Path):Int
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("No DigestCache context available.");
+        }
+
+        try {
+            return DigestCache._invalidate(this.context, path);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Returns the hit/miss statistics and the current fill level of the index.
+     *
+     * @return polarssl.DigestCache.DigestCacheStats
+     *
+     * @throws hext.IllegalStateException if the cache has already been closed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function stats():DigestCacheStats
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("No DigestCache context available.");
+        }
+
+        var arr:Array<Int>;
+        try {
+            arr = DigestCache._stats(this.context);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return {
+            hits:      arr[0],
+            misses:    arr[1],
+            evictions: arr[2],
+            size:      arr[3],
+            capacity:  arr[4]
+        };
+    }
+
+    /**
+     * Returns the sum of the file specified by 'path', from the index if the file is
+     * unchanged, else by hashing (and caching) it natively.
+     *
+     * @param hext.io.Path    path the file's path
+     * @param polarssl.MDType type the digest algorithm
+     *
+     * @return haxe.io.Bytes the sum Bytes
+     *
+     * @throws hext.IllegalArgumentException if the algorithm is NONE
+     * @throws hext.IllegalStateException    if the cache has already been closed
+     * @throws polarssl.PolarSSLException    if the file cannot be read or the algorithm is not available
+     */
+    public function sumOfFile(path:Path, type:MDType):Bytes
+    {
+        if (type == MDType.NONE) {
+            throw new IllegalArgumentException("Digest algorithm is not supported.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("No DigestCache context available.");
+        }
+
+        try {
+            return Bytes.ofData(DigestCache._sum_file(this.context, path, type));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+}
+
+
+/**
+ * Extern for native file digest cache handles wrapped by Neko/C++ value.
+ */
+private extern class DigestCacheContext {}
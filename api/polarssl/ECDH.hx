@@ -0,0 +1,167 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import hext.IllegalStateException;
+import polarssl.ECPGroup;
+import polarssl.CtrDrbg;
+import polarssl.Loader;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for the PolarSSL ECDH implementation.
+ *
+ * Attn: Reuse an instance across exchanges on the same curve; the comb table
+ *       PolarSSL precomputes for the curve's generator is stored within the
+ *       context and only rebuilt if the curve changes.
+ */
+class ECDH
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _compute_shared:ECDHContext->BytesData->Int->Dynamic->BytesData = Loader.load("hx_ecdh_compute_shared", 4);
+    private static var _free:ECDHContext->Void                                = Loader.load("hx_ecdh_free", 1);
+    private static var _gen_public:ECDHContext->ECPGroup->Dynamic->BytesData  = Loader.load("hx_ecdh_gen_public", 3);
+    private static var _init:Void->ECDHContext                                = Loader.load("hx_ecdh_init", 0);
+    private static var _self_test:Bool->Int                                   = Loader.load("hx_ecdh_self_test", 1);
+
+    /**
+     * Stores the native ECDH context handle.
+     *
+     * @var Null<polarssl.ECDH.ECDHContext>
+     */
+    private var context:Null<ECDHContext>;
+
+    /**
+     * The random number generator to use (HAVEGE if null).
+     *
+     * @var Null<polarssl.CtrDrbg>
+     */
+    public var rng:Null<CtrDrbg>;
+
+
+    /**
+     * Constructor to initialize a new ECDH instance.
+     *
+     * @throws polarssl.PolarSSLException if the ECDH context init fails
+     */
+    public function new():Void
+    {
+        try {
+            this.context = ECDH._init();
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Computes the shared secret between our keypair and the peer's public key.
+     *
+     * @param haxe.io.Bytes point the peer's public point (uncompressed format)
+     *
+     * @return haxe.io.Bytes the shared secret (padded to the curve's size)
+     *
+     * @throws hext.IllegalArgumentException if the point is null
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the point is invalid or no keypair has been generated
+     */
+    public function computeShared(point:Bytes):Bytes
+    {
+        if (point == null) {
+            throw new IllegalArgumentException("Peer's public key cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("ECDH context not available.");
+        }
+
+        var rng:Dynamic = CtrDrbg.contextOf(this.rng);
+
+        try {
+            return Bytes.ofData(ECDH._compute_shared(this.context, point.getData(), point.length, rng));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Frees all memory allocated for this ECDH instance.
+     *
+     * Attn: The ECDH instance can no longer be used after calling this method.
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function free():Void
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("ECDH context not available.");
+        }
+
+        try {
+            ECDH._free(this.context);
+            this.context = null;
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Generates a new ephemeral keypair on the given curve.
+     *
+     * @param polarssl.ECPGroup group the named curve to use
+     *
+     * @return haxe.io.Bytes our public point (uncompressed format) to send to the peer
+     *
+     * @throws hext.IllegalArgumentException if no curve is selected
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function generatePublic(group:ECPGroup):Bytes
+    {
+        if (group == ECPGroup.NONE) {
+            throw new IllegalArgumentException("A named curve must be selected.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("ECDH context not available.");
+        }
+
+        var rng:Dynamic = CtrDrbg.contextOf(this.rng);
+
+        try {
+            return Bytes.ofData(ECDH._gen_public(this.context, group, rng));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Runs various health checks to ensure the ECDH module works correctly.
+     *
+     * @param Bool verbose either to output debug information or not
+     *
+     * @return Bool
+     */
+    public static function selfTest(verbose:Bool = #if POLARSSL_DEBUG true #else false #end):Bool
+    {
+        var ret:Int;
+        try {
+            ret = ECDH._self_test(verbose);
+        } catch (ex:Dynamic) {
+            #if POLARSSL_DEBUG
+                throw new PolarSSLException(ex);
+            #else
+                ret = 1;
+            #end
+        }
+
+        return ret == 0;
+    }
+}
+
+
+/**
+ * Extern for native ECDH context handles wrapped by Neko/C++ value.
+ */
+private extern class ECDHContext {}
@@ -0,0 +1,327 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import hext.IllegalStateException;
+import polarssl.ECPGroup;
+import polarssl.CtrDrbg;
+import polarssl.Loader;
+import polarssl.MDType;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for the PolarSSL ECDSA implementation.
+ *
+ * Attn: Keep an instance around for as long as the same curve is used; PolarSSL
+ *       precomputes a comb table for the curve's generator on first use and
+ *       stores it within the context, so subsequent key generations and
+ *       signatures on that curve are considerably cheaper.
+ */
+class ECDSA
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _free:ECDSAContext->Void                                 = Loader.load("hx_ecdsa_free", 1);
+    private static var _genkey:ECDSAContext->ECPGroup->Dynamic->Int             = Loader.load("hx_ecdsa_genkey", 3);
+    private static var _get_private:ECDSAContext->BytesData                     = Loader.load("hx_ecdsa_get_private", 1);
+    private static var _get_public:ECDSAContext->BytesData                      = Loader.load("hx_ecdsa_get_public", 1);
+    private static var _init:Void->ECDSAContext                                 = Loader.load("hx_ecdsa_init", 0);
+    private static var _self_test:Bool->Int                                     = Loader.load("hx_ecdsa_self_test", 1);
+    private static var _set_private:ECDSAContext->ECPGroup->BytesData->Int->Dynamic->Int = Loader.load("hx_ecdsa_set_private", 5);
+    private static var _set_public:ECDSAContext->ECPGroup->BytesData->Int->Int  = Loader.load("hx_ecdsa_set_public", 4);
+    private static var _sign:ECDSAContext->MDType->BytesData->Int->BytesData    = Loader.load("hx_ecdsa_sign", 4);
+    private static var _verify:ECDSAContext->BytesData->Int->BytesData->Int->Int = Loader.load("hx_ecdsa_verify", 5);
+
+    /**
+     * Stores the native ECDSA context handle.
+     *
+     * @var Null<polarssl.ECDSA.ECDSAContext>
+     */
+    private var context:Null<ECDSAContext>;
+
+    /**
+     * The random number generator to use (HAVEGE if null).
+     *
+     * @var Null<polarssl.CtrDrbg>
+     */
+    public var rng:Null<CtrDrbg>;
+
+    /**
+     * Property to access the private key (the secret scalar d).
+     *
+     * @var haxe.io.Bytes
+     */
+    public var privateKey(get, never):Bytes;
+
+    /**
+     * Property to access the public key (the point Q, uncompressed format).
+     *
+     * @var haxe.io.Bytes
+     */
+    public var publicKey(get, never):Bytes;
+
+
+    /**
+     * Constructor to initialize a new ECDSA instance.
+     *
+     * @throws polarssl.PolarSSLException if the ECDSA context init fails
+     */
+    public function new():Void
+    {
+        try {
+            this.context = ECDSA._init();
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Frees all memory allocated for this ECDSA instance.
+     *
+     * Attn: The ECDSA instance can no longer be used after calling this method.
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function free():Void
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("ECDSA context not available.");
+        }
+
+        try {
+            ECDSA._free(this.context);
+            this.context = null;
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Generates a new ECDSA keypair on the given curve and associates it to the current instance.
+     *
+     * @param polarssl.ECPGroup group the named curve to use
+     *
+     * @throws hext.IllegalArgumentException if no curve is selected
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function generateKeys(group:ECPGroup):Void
+    {
+        if (group == ECPGroup.NONE) {
+            throw new IllegalArgumentException("A named curve must be selected.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("ECDSA context not available.");
+        }
+
+        var rng:Dynamic = CtrDrbg.contextOf(this.rng);
+
+        try {
+            ECDSA._genkey(this.context, group, rng);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Internal getter method for the 'privateKey' property.
+     *
+     * @return haxe.io.Bytes
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    private function get_privateKey():Bytes
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("ECDSA context not available.");
+        }
+
+        try {
+            return Bytes.ofData(ECDSA._get_private(this.context));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Internal getter method for the 'publicKey' property.
+     *
+     * @return haxe.io.Bytes
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    private function get_publicKey():Bytes
+    {
+        if (this.context == null) {
+            throw new IllegalStateException("ECDSA context not available.");
+        }
+
+        try {
+            return Bytes.ofData(ECDSA._get_public(this.context));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Runs various health checks to ensure the ECP module ECDSA is built on works correctly.
+     *
+     * @param Bool verbose either to output debug information or not
+     *
+     * @return Bool
+     */
+    public static function selfTest(verbose:Bool = #if POLARSSL_DEBUG true #else false #end):Bool
+    {
+        var ret:Int;
+        try {
+            ret = ECDSA._self_test(verbose);
+        } catch (ex:Dynamic) {
+            #if POLARSSL_DEBUG
+                throw new PolarSSLException(ex);
+            #else
+                ret = 1;
+            #end
+        }
+
+        return ret == 0;
+    }
+
+    /**
+     * Imports the private key and derives the matching public key from it.
+     *
+     * @param polarssl.ECPGroup group the named curve the key belongs to
+     * @param haxe.io.Bytes     key   the big-endian secret scalar
+     *
+     * @throws hext.IllegalArgumentException if no curve is selected or the key is null
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the key is invalid for the curve
+     */
+    public function setPrivateKey(group:ECPGroup, key:Bytes):Void
+    {
+        if (group == ECPGroup.NONE) {
+            throw new IllegalArgumentException("A named curve must be selected.");
+        }
+        if (key == null) {
+            throw new IllegalArgumentException("Private key cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("ECDSA context not available.");
+        }
+
+        var rng:Dynamic = CtrDrbg.contextOf(this.rng);
+
+        try {
+            ECDSA._set_private(this.context, group, key.getData(), key.length, rng);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Imports the public key used to verify signatures.
+     *
+     * @param polarssl.ECPGroup group the named curve the point belongs to
+     * @param haxe.io.Bytes     point the public point in uncompressed format
+     *
+     * @throws hext.IllegalArgumentException if no curve is selected or the point is null
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the point is invalid for the curve
+     */
+    public function setPublicKey(group:ECPGroup, point:Bytes):Void
+    {
+        if (group == ECPGroup.NONE) {
+            throw new IllegalArgumentException("A named curve must be selected.");
+        }
+        if (point == null) {
+            throw new IllegalArgumentException("Public key cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("ECDSA context not available.");
+        }
+
+        try {
+            ECDSA._set_public(this.context, group, point.getData(), point.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Signs the message digest and returns the DER encoded signature.
+     *
+     * Signatures are deterministic (RFC 6979), the MD type is used to derive the nonce.
+     *
+     * @param polarssl.MDType type the MD type/algorithm the hash was computed with
+     * @param haxe.io.Bytes   hash the message digest to sign
+     *
+     * @return haxe.io.Bytes the signature Bytes
+     *
+     * @throws hext.IllegalArgumentException if MDType.NONE is used or the hash is null
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function sign(type:MDType, hash:Bytes):Bytes
+    {
+        if (type == MDType.NONE) {
+            throw new IllegalArgumentException("Deterministic signatures require a MD type.");
+        }
+        if (hash == null) {
+            throw new IllegalArgumentException("Hash cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("ECDSA context not available.");
+        }
+
+        try {
+            return Bytes.ofData(ECDSA._sign(this.context, type, hash.getData(), hash.length));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Verifies the signature is valid for the message digest.
+     *
+     * @param haxe.io.Bytes hash      the message digest that was signed
+     * @param haxe.io.Bytes signature the DER encoded signature to verify
+     *
+     * @return Bool true if signature is valid
+     *
+     * @throws hext.IllegalArgumentException if the hash or signature is null
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function verify(hash:Bytes, signature:Bytes):Bool
+    {
+        if (hash == null || signature == null) {
+            throw new IllegalArgumentException("Hash and signature cannot be null.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("ECDSA context not available.");
+        }
+
+        var ret:Int;
+        try {
+            ret = ECDSA._verify(this.context, hash.getData(), hash.length, signature.getData(), signature.length);
+        } catch (ex:Dynamic) {
+            #if POLARSSL_DEBUG
+                throw new PolarSSLException(ex);
+            #else
+                ret = 1;
+            #end
+        }
+
+        return ret == 0;
+    }
+}
+
+
+/**
+ * Extern for native ECDSA context handles wrapped by Neko/C++ value.
+ */
+private extern class ECDSAContext {}
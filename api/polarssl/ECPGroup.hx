@@ -0,0 +1,21 @@
+package polarssl;
+
+/**
+ * Named elliptic curves (ecp_group_id) usable with ECDSA and ECDH.
+ */
+@:enum
+abstract ECPGroup(Int) from Int to Int
+{
+    var NONE      = 0;
+    var SECP192R1 = 1;
+    var SECP224R1 = 2;
+    var SECP256R1 = 3;
+    var SECP384R1 = 4;
+    var SECP521R1 = 5;
+    var BP256R1   = 6;
+    var BP384R1   = 7;
+    var BP512R1   = 8;
+    var SECP192K1 = 13;
+    var SECP224K1 = 14;
+    var SECP256K1 = 15;
+}
@@ -9,15 +9,22 @@ import polarssl.PolarSSLException;
 
 /**
  * Haxe FFI wrapper class for the PolarSSL HAVEGE implementation.
+ *
+ * Attn: Each instance keeps a native pool of prefetched random bytes, so
+ *       fill(), nextInt() and nextFloat() are cheap enough to be called
+ *       for every single nonce or identifier.
  */
 class HAVEGE
 {
     /**
      * Stores the references to the FFI implementations of the functions.
      */
-    private static var _free:HS->Void             = Loader.load("hx_havege_free", 1);
-    private static var _init:Void->HS             = Loader.load("hx_havege_init", 0);
-    private static var _random:HS->Int->BytesData = Loader.load("hx_havege_random", 2);
+    private static var _fill:HS->BytesData->Int->Int->Void = Loader.load("hx_havege_fill", 4);
+    private static var _free:HS->Void                      = Loader.load("hx_havege_free", 1);
+    private static var _init:Void->HS                      = Loader.load("hx_havege_init", 0);
+    private static var _next_float:HS->Float               = Loader.load("hx_havege_next_float", 1);
+    private static var _next_int:HS->Int                   = Loader.load("hx_havege_next_int", 1);
+    private static var _random:HS->Int->BytesData          = Loader.load("hx_havege_random", 2);
 
     /**
      * Stores the wrapped HAVEGE state.
@@ -41,6 +48,40 @@ class HAVEGE
         }
     }
 
+    /**
+     * Writes 'len' random bytes into 'bytes' starting at position 'pos'.
+     *
+     * Attn: Unlike random(), no new Bytes are allocated.
+     *
+     * @param haxe.io.Bytes bytes the Bytes to write into
+     * @param Int           pos   the position to start writing at
+     * @param Int           len   the number of random bytes to write
+     *
+     * @throws hext.IllegalArgumentException if the range is outside of the Bytes
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call throws an error
+     */
+    public function fill(bytes:Bytes, pos:Int, len:Int):Void
+    {
+        if (bytes == null) {
+            throw new IllegalArgumentException("Bytes cannot be null.");
+        }
+        if (pos < 0 || len < 0 || pos > bytes.length || len > bytes.length - pos) {
+            throw new IllegalArgumentException("Range is outside of the Bytes.");
+        }
+        if (this.state == null) {
+            throw new IllegalStateException("No HAVEGE state available.");
+        }
+
+        if (len != 0) {
+            try {
+                HAVEGE._fill(this.state, bytes.getData(), pos, len);
+            } catch (ex:Dynamic) {
+                throw new PolarSSLException(ex);
+            }
+        }
+    }
+
     /**
      * Frees the HAVEGE state by removing all memory allocated for it.
      *
@@ -63,6 +104,49 @@ class HAVEGE
         }
     }
 
+    /**
+     * Returns a random Float in the range [0, 1).
+     *
+     * @return Float
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call throws an error
+     */
+    public function nextFloat():Float
+    {
+        if (this.state == null) {
+            throw new IllegalStateException("No HAVEGE state available.");
+        }
+
+        try {
+            return HAVEGE._next_float(this.state);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Returns a random, non-negative Int between 0 and 2^30 - 1 (on all targets, as
+     * Neko Ints only hold 31 bits); use fill() for full 32 bit values.
+     *
+     * @return Int
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call throws an error
+     */
+    public function nextInt():Int
+    {
+        if (this.state == null) {
+            throw new IllegalStateException("No HAVEGE state available.");
+        }
+
+        try {
+            return HAVEGE._next_int(this.state);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
     /**
      * Generates 'nbytes' of random bytes.
      *
@@ -0,0 +1,174 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import polarssl.Loader;
+import polarssl.MDType;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for the HMAC-based Extract-and-Expand Key Derivation Function (RFC 5869),
+ * built on top of PolarSSL's generic message digest HMAC implementation.
+ */
+class HKDF
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _derive:MDType->Array<Dynamic>->Array<Dynamic>->Array<Array<Dynamic>>->Array<Int>->BytesData = Loader.load("hx_hkdf", 5);
+    private static var _expand:MDType->Array<Dynamic>->Array<Dynamic>->Int->BytesData = Loader.load("hx_hkdf_expand", 4);
+    private static var _extract:MDType->Array<Dynamic>->Array<Dynamic>->BytesData     = Loader.load("hx_hkdf_extract", 3);
+    private static var _self_test:Bool->Int                                           = Loader.load("hx_hkdf_self_test", 1);
+
+
+    /**
+     * Derives one output per info label/length pair from the input keying material,
+     * extracting the pseudorandom key only once and returning all outputs concatenated.
+     *
+     * Attn: Use Bytes.sub() with the running sum of 'lengths' to split the result.
+     *
+     * @param polarssl.MDType      type    the MD type/algorithm to use for HMAC
+     * @param Null<haxe.io.Bytes>  salt    the optional salt
+     * @param haxe.io.Bytes        ikm     the input keying material
+     * @param Array<haxe.io.Bytes> infos   the context/application specific info labels
+     * @param Array<Int>           lengths the number of bytes to derive per label
+     *
+     * @return haxe.io.Bytes the concatenated output keying material
+     *
+     * @throws hext.IllegalArgumentException if MDType.NONE is used
+     * @throws hext.IllegalArgumentException if the IKM, infos or lengths are null or their sizes differ
+     * @throws hext.IllegalArgumentException if a length is negative
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public static function deriveAll(type:MDType, salt:Null<Bytes>, ikm:Bytes, infos:Array<Bytes>, lengths:Array<Int>):Bytes
+    {
+        if (type == MDType.NONE) {
+            throw new IllegalArgumentException("HKDF requires a MD type.");
+        }
+        if (ikm == null) {
+            throw new IllegalArgumentException("Input keying material cannot be null.");
+        }
+        if (infos == null || lengths == null || infos.length != lengths.length) {
+            throw new IllegalArgumentException("Each info label requires a length.");
+        }
+
+        var infoArrs:Array<Array<Dynamic>> = new Array<Array<Dynamic>>();
+        for (i in 0...infos.length) {
+            if (lengths[i] < 0) {
+                throw new IllegalArgumentException("Length cannot be negative.");
+            }
+            infoArrs.push(HKDF.toArr(infos[i]));
+        }
+
+        try {
+            return Bytes.ofData(HKDF._derive(type, HKDF.toArr(salt), HKDF.toArr(ikm), infoArrs, lengths));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Expands the pseudorandom key into 'length' bytes of output keying material.
+     *
+     * @param polarssl.MDType     type   the MD type/algorithm to use for HMAC
+     * @param haxe.io.Bytes       prk    the pseudorandom key (usually from extract())
+     * @param Null<haxe.io.Bytes> info   the optional context/application specific info
+     * @param Int                 length the number of bytes to derive
+     *
+     * @return haxe.io.Bytes the output keying material
+     *
+     * @throws hext.IllegalArgumentException if MDType.NONE is used
+     * @throws hext.IllegalArgumentException if the PRK is null or the length is negative
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public static function expand(type:MDType, prk:Bytes, info:Null<Bytes>, length:Int):Bytes
+    {
+        if (type == MDType.NONE) {
+            throw new IllegalArgumentException("HKDF requires a MD type.");
+        }
+        if (prk == null) {
+            throw new IllegalArgumentException("Pseudorandom key cannot be null.");
+        }
+        if (length < 0) {
+            throw new IllegalArgumentException("Length cannot be negative.");
+        }
+
+        try {
+            return Bytes.ofData(HKDF._expand(type, HKDF.toArr(prk), HKDF.toArr(info), length));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Extracts a pseudorandom key from the input keying material.
+     *
+     * @param polarssl.MDType     type the MD type/algorithm to use for HMAC
+     * @param Null<haxe.io.Bytes> salt the optional salt
+     * @param haxe.io.Bytes       ikm  the input keying material
+     *
+     * @return haxe.io.Bytes the pseudorandom key
+     *
+     * @throws hext.IllegalArgumentException if MDType.NONE is used or the IKM is null
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public static function extract(type:MDType, salt:Null<Bytes>, ikm:Bytes):Bytes
+    {
+        if (type == MDType.NONE) {
+            throw new IllegalArgumentException("HKDF requires a MD type.");
+        }
+        if (ikm == null) {
+            throw new IllegalArgumentException("Input keying material cannot be null.");
+        }
+
+        try {
+            return Bytes.ofData(HKDF._extract(type, HKDF.toArr(salt), HKDF.toArr(ikm)));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Runs the RFC 5869 test vectors to ensure the HKDF implementation works correctly.
+     *
+     * @param Bool verbose either to output debug information or not
+     *
+     * @return Bool
+     */
+    public static function selfTest(verbose:Bool = #if POLARSSL_DEBUG true #else false #end):Bool
+    {
+        var ret:Int;
+        try {
+            ret = HKDF._self_test(verbose);
+        } catch (ex:Dynamic) {
+            #if POLARSSL_DEBUG
+                throw new PolarSSLException(ex);
+            #else
+                ret = 1;
+            #end
+        }
+
+        return ret == 0;
+    }
+
+    /**
+     * Packs the (nullable) Bytes into the [length, data] Array expected by the FFI functions.
+     *
+     * @param Null<haxe.io.Bytes> bytes the Bytes to pack
+     *
+     * @return Array<Dynamic>
+     */
+    private static function toArr(bytes:Null<Bytes>):Array<Dynamic>
+    {
+        if (bytes == null) {
+            bytes = Bytes.alloc(0);
+        }
+
+        var arr:Array<Dynamic> = new Array<Dynamic>();
+        arr[0] = bytes.length;
+        arr[1] = bytes.getData();
+
+        return arr;
+    }
+}
@@ -0,0 +1,69 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import polarssl.Loader;
+import polarssl.PolarSSLException;
+
+/**
+ * Native (SSE2 accelerated) hex encoding and decoding.
+ *
+ * Faster and less allocation heavy than Bytes.toHex() and parsing a String
+ * digit by digit in Haxe, especially on Neko.
+ */
+class Hex
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _decode:String->BytesData      = Loader.load("hx_hex_decode", 1);
+    private static var _encode:BytesData->Int->String = Loader.load("hx_hex_encode", 2);
+
+
+    /**
+     * Returns the Bytes encoded within the hex String.
+     *
+     * @param String str the hex String (upper- or lowercase digits)
+     *
+     * @return haxe.io.Bytes the decoded Bytes
+     *
+     * @throws hext.IllegalArgumentException if the String is null or has an odd length
+     * @throws polarssl.PolarSSLException    if the String contains non hex digits
+     */
+    public static function decode(str:String):Bytes
+    {
+        if (str == null || (str.length % 2) != 0) {
+            throw new IllegalArgumentException("String is not a valid hex encoding.");
+        }
+
+        try {
+            return Bytes.ofData(Hex._decode(str));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Returns the lowercase hex encoding of the Bytes (same as Bytes.toHex()).
+     *
+     * @param haxe.io.Bytes bytes the Bytes to encode
+     *
+     * @return String the hex String
+     *
+     * @throws hext.IllegalArgumentException if the Bytes are null
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public static function encode(bytes:Bytes):String
+    {
+        if (bytes == null) {
+            throw new IllegalArgumentException("Bytes cannot be null.");
+        }
+
+        try {
+            return Hex._encode(bytes.getData(), bytes.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+}
@@ -0,0 +1,215 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import hext.IllegalArgumentException;
+import polarssl.AES;
+import polarssl.Camellia;
+import polarssl.Loader;
+import polarssl.PolarSSLException;
+
+/**
+ * Statistics of the native key schedule cache.
+ */
+typedef KeyCacheStats = {
+    var hits:Int;
+    var misses:Int;
+    var evictions:Int;
+    var size:Int;
+    var capacity:Int;
+}
+
+/**
+ * Timings (nanoseconds per operation) of KeyCache.benchmark().
+ */
+typedef KeyCacheBenchmark = {
+    var hit:Float;
+    var setkey:Float;
+}
+
+
+/**
+ * Haxe FFI wrapper class for the native LRU cache of expanded AES and Camellia key schedules.
+ *
+ * Instances returned for a cached key share the already expanded, read-only schedule,
+ * so neither the key expansion nor a context allocation runs again as long as the key
+ * stays in the cache. Keys are looked up by a SipHash of the key (or of a caller-supplied
+ * key ID) under a per-process secret. The cache is shared process-wide and split into
+ * independently locked shards.
+ *
+ * Attn: Cached schedules are secret key material kept in native memory until they
+ *       are evicted or clear() is called and no instance uses them anymore.
+ */
+class KeyCache
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _aes:Dynamic->Int->Int->String->Dynamic      = Loader.load("hx_keycache_aes", 4);
+    private static var _benchmark:Int->Array<Float>                 = Loader.load("hx_keycache_benchmark", 1);
+    private static var _camellia:Dynamic->Int->Int->String->Dynamic = Loader.load("hx_keycache_camellia", 4);
+    private static var _clear:Void->Void                            = Loader.load("hx_keycache_clear", 0);
+    private static var _set_capacity:Int->Void                      = Loader.load("hx_keycache_set_capacity", 1);
+    private static var _stats:Void->Array<Int>                      = Loader.load("hx_keycache_stats", 0);
+
+
+    /**
+     * Returns an AES instance keyed with 'key' for the given direction.
+     *
+     * Attn: The instance shares the cached schedule; setting another key on it
+     *       detaches it onto a context of its own.
+     *
+     * @param haxe.io.Bytes key   the secret key (16, 24 or 32 bytes)
+     * @param Int           mode  AES.DECRYPT or AES.ENCRYPT
+     * @param Null<String>  keyId an opaque ID always naming this key (skips hashing the key itself)
+     *
+     * @return polarssl.AES the keyed AES instance
+     *
+     * @throws hext.IllegalArgumentException if the bytes are not a valid AES key or the mode is not supported
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public static function aes(key:Bytes, mode:Int, ?keyId:String):AES
+    {
+        if (key == null || (key.length != 16 && key.length != 24 && key.length != 32)) {
+            throw new IllegalArgumentException("Bytes are not a valid AES key.");
+        }
+        if (mode != AES.DECRYPT && mode != AES.ENCRYPT) {
+            throw new IllegalArgumentException("Provided AES mode is not supported.");
+        }
+
+        var aes:AES = Type.createEmptyInstance(AES);
+        try {
+            aes.context = KeyCache._aes(key.getData(), key.length * 8, mode, keyId);
+            aes.shared  = true;
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return aes;
+    }
+
+    /**
+     * Times cache hits against fresh key expansions of the same AES-256 decryption key.
+     *
+     * @param Int iterations the number of lookups and expansions to time
+     *
+     * @return polarssl.KeyCache.KeyCacheBenchmark the nanoseconds per operation
+     *
+     * @throws hext.IllegalArgumentException if the number of iterations is not positive
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public static function benchmark(iterations:Int = 100000):KeyCacheBenchmark
+    {
+        if (iterations <= 0) {
+            throw new IllegalArgumentException("Number of iterations must be positive.");
+        }
+
+        var arr:Array<Float>;
+        try {
+            arr = KeyCache._benchmark(iterations);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return {
+            hit:    arr[0],
+            setkey: arr[1]
+        };
+    }
+
+    /**
+     * Returns a Camellia instance keyed with 'key' for the given direction.
+     *
+     * Attn: The instance shares the cached schedule; setting another key on it
+     *       detaches it onto a context of its own.
+     *
+     * @param haxe.io.Bytes key   the secret key (16, 24 or 32 bytes)
+     * @param Int           mode  Camellia.DECRYPT or Camellia.ENCRYPT
+     * @param Null<String>  keyId an opaque ID always naming this key (skips hashing the key itself)
+     *
+     * @return polarssl.Camellia the keyed Camellia instance
+     *
+     * @throws hext.IllegalArgumentException if the bytes are not a valid Camellia key or the mode is not supported
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public static function camellia(key:Bytes, mode:Int, ?keyId:String):Camellia
+    {
+        if (key == null || (key.length != 16 && key.length != 24 && key.length != 32)) {
+            throw new IllegalArgumentException("Bytes are not a valid Camellia key.");
+        }
+        if (mode != Camellia.DECRYPT && mode != Camellia.ENCRYPT) {
+            throw new IllegalArgumentException("Provided Camellia mode is not supported.");
+        }
+
+        var camellia:Camellia = Type.createEmptyInstance(Camellia);
+        try {
+            camellia.context = KeyCache._camellia(key.getData(), key.length * 8, mode, keyId);
+            camellia.shared  = true;
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return camellia;
+    }
+
+    /**
+     * Removes (and wipes) all cached key schedules.
+     *
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public static function clear():Void
+    {
+        try {
+            KeyCache._clear();
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Sets the maximum number of cached key schedules (default 256).
+     *
+     * Attn: Shrinking the capacity evicts the least recently used entries; 0 disables caching.
+     *
+     * @param Int capacity the maximum number of entries
+     *
+     * @throws hext.IllegalArgumentException if the capacity is negative
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public static function setCapacity(capacity:Int):Void
+    {
+        if (capacity < 0) {
+            throw new IllegalArgumentException("Capacity cannot be negative.");
+        }
+
+        try {
+            KeyCache._set_capacity(capacity);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Returns the hit/miss statistics and the current fill level of the cache.
+     *
+     * @return polarssl.KeyCache.KeyCacheStats
+     *
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public static function stats():KeyCacheStats
+    {
+        var arr:Array<Int>;
+        try {
+            arr = KeyCache._stats();
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return {
+            hits:      arr[0],
+            misses:    arr[1],
+            evictions: arr[2],
+            size:      arr[3],
+            capacity:  arr[4]
+        };
+    }
+}
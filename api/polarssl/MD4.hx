@@ -14,9 +14,10 @@ class MD4
     /**
      * Stores the references to the FFI implementations of the functions.
      */
-    private static var _self_test:Bool->Int           = Loader.load("hx_md4_self_test", 1);
-    private static var _sum:BytesData->Int->BytesData = Loader.load("hx_md4", 2);
-    private static var _sum_file:Path->BytesData      = Loader.load("hx_md4_file", 1);
+    private static var _self_test:Bool->Int            = Loader.load("hx_md4_self_test", 1);
+    private static var _sum:BytesData->Int->BytesData  = Loader.load("hx_md4", 2);
+    private static var _sum_file:Path->BytesData       = Loader.load("hx_md4_file", 1);
+    private static var _sum_hex:BytesData->Int->String = Loader.load("hx_md4_hex", 2);
 
 
     /**
@@ -45,7 +46,7 @@ class MD4
     /**
      * Returns the MD4 sum of the input bytes.
      *
-     * Attn: To get the sum as a String, use toHex() on the returned Bytes.
+     * Attn: To get the sum as a (hex) String, use sumHex().
      *
      * @param haxe.io.Bytes bytes the Bytes to get the sum for
      *
@@ -62,6 +63,24 @@ class MD4
         }
     }
 
+    /**
+     * Returns the MD4 sum of the input bytes as a lowercase hex String.
+     *
+     * @param haxe.io.Bytes bytes the Bytes to get the sum for
+     *
+     * @return String the hex encoded sum
+     *
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public static function sumHex(bytes:Bytes):String
+    {
+        try {
+            return MD4._sum_hex(bytes.getData(), bytes.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
     /**
      * Returns the MD4 sum of the file specified by 'path'.
      *
@@ -5,6 +5,7 @@ import haxe.io.BytesData;
 import hext.io.Path;
 import polarssl.Loader;
 import polarssl.PolarSSLException;
+import polarssl.Segments;
 
 /**
  * Haxe FFI wrapper class for the PolarSSL MD5 implementation.
@@ -14,9 +15,11 @@ class MD5
     /**
      * Stores the references to the FFI implementations of the functions.
      */
-    private static var _self_test:Bool->Int           = Loader.load("hx_md5_self_test", 1);
-    private static var _sum:BytesData->Int->BytesData = Loader.load("hx_md5", 2);
-    private static var _sum_file:Path->BytesData      = Loader.load("hx_md5_file", 1);
+    private static var _self_test:Bool->Int            = Loader.load("hx_md5_self_test", 1);
+    private static var _sum:BytesData->Int->BytesData  = Loader.load("hx_md5", 2);
+    private static var _sum_file:Path->BytesData       = Loader.load("hx_md5_file", 1);
+    private static var _sum_hex:BytesData->Int->String = Loader.load("hx_md5_hex", 2);
+    private static var _sumv:Array<Dynamic>->BytesData = Loader.load("hx_md5v", 1);
 
 
     /**
@@ -45,7 +48,7 @@ class MD5
     /**
      * Returns the MD5 sum of the input bytes.
      *
-     * Attn: To get the sum as a String, use toHex() on the returned Bytes.
+     * Attn: To get the sum as a (hex) String, use sumHex().
      *
      * @param haxe.io.Bytes bytes the Bytes to get the sum for
      *
@@ -62,6 +65,24 @@ class MD5
         }
     }
 
+    /**
+     * Returns the MD5 sum of the input bytes as a lowercase hex String.
+     *
+     * @param haxe.io.Bytes bytes the Bytes to get the sum for
+     *
+     * @return String the hex encoded sum
+     *
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public static function sumHex(bytes:Bytes):String
+    {
+        try {
+            return MD5._sum_hex(bytes.getData(), bytes.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
     /**
      * Returns the MD5 sum of the file specified by 'path'.
      *
@@ -81,4 +102,26 @@ class MD5
             throw new PolarSSLException(ex);
         }
     }
+
+    /**
+     * Returns the MD5 sum of the parts as if they were concatenated, without copying them.
+     *
+     * @param Array<haxe.io.Bytes> parts     the Bytes to get the sum for, in order
+     * @param Array<Int>           positions the position to start reading at for each part (defaults to 0)
+     * @param Array<Int>           lengths   the number of bytes to read from each part (defaults to the rest)
+     *
+     * @return haxe.io.Bytes the sum Bytes
+     *
+     * @throws hext.IllegalArgumentException if the arrays do not match or a range is outside of its Bytes
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public static function sumv(parts:Array<Bytes>, ?positions:Array<Int>, ?lengths:Array<Int>):Bytes
+    {
+        var flat:Array<Dynamic> = Segments.flatten(parts, positions, lengths);
+        try {
+            return Bytes.ofData(MD5._sumv(flat));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
 }
@@ -0,0 +1,567 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import hext.IllegalStateException;
+import polarssl.Loader;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for the PolarSSL multi-precision integer (bignum) implementation.
+ *
+ * The arithmetic methods store their result in the instance they are called on
+ * (which may also be one of the operands) and return it, so intermediate values
+ * never leave native memory:
+ *
+ *   var x:MPI = new MPI();
+ *   x.mul(a, b).mod(x, n);
+ */
+class MPI
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _add:MPIContext->MPIContext->MPIContext->Int                     = Loader.load("hx_mpi_add", 3);
+    private static var _add_int:MPIContext->MPIContext->Int->Int                        = Loader.load("hx_mpi_add_int", 3);
+    private static var _bitlen:MPIContext->Int                                          = Loader.load("hx_mpi_bitlen", 1);
+    private static var _cmp:MPIContext->MPIContext->Int                                 = Loader.load("hx_mpi_cmp", 2);
+    private static var _copy:MPIContext->MPIContext->Int                                = Loader.load("hx_mpi_copy", 2);
+    private static var _exp_mod:MPIContext->MPIContext->MPIContext->MPIContext->Int     = Loader.load("hx_mpi_exp_mod", 4);
+    private static var _free:MPIContext->Void                                           = Loader.load("hx_mpi_free", 1);
+    private static var _gcd:MPIContext->MPIContext->MPIContext->Int                     = Loader.load("hx_mpi_gcd", 3);
+    private static var _init:Void->MPIContext                                           = Loader.load("hx_mpi_init", 0);
+    private static var _inv_mod:MPIContext->MPIContext->MPIContext->Int                 = Loader.load("hx_mpi_inv_mod", 3);
+    private static var _lset:MPIContext->Int->Int                                       = Loader.load("hx_mpi_lset", 2);
+    private static var _mod:MPIContext->MPIContext->MPIContext->Int                     = Loader.load("hx_mpi_mod", 3);
+    private static var _mul:MPIContext->MPIContext->MPIContext->Int                     = Loader.load("hx_mpi_mul", 3);
+    private static var _mul_int:MPIContext->MPIContext->Int->Int                        = Loader.load("hx_mpi_mul_int", 3);
+    private static var _read_binary:MPIContext->BytesData->Int->Int                     = Loader.load("hx_mpi_read_binary", 3);
+    private static var _read_string:MPIContext->Int->String->Int                        = Loader.load("hx_mpi_read_string", 3);
+    private static var _self_test:Bool->Int                                             = Loader.load("hx_mpi_self_test", 1);
+    private static var _sub:MPIContext->MPIContext->MPIContext->Int                     = Loader.load("hx_mpi_sub", 3);
+    private static var _sub_int:MPIContext->MPIContext->Int->Int                        = Loader.load("hx_mpi_sub_int", 3);
+    private static var _write_binary:MPIContext->BytesData                              = Loader.load("hx_mpi_write_binary", 1);
+    private static var _write_string:MPIContext->Int->String                            = Loader.load("hx_mpi_write_string", 2);
+
+    /**
+     * Stores the native MPI handle.
+     *
+     * @var Null<polarssl.MPI.MPIContext>
+     */
+    private var context:Null<MPIContext>;
+
+    /**
+     * Property to access the number of significant bits.
+     *
+     * @var Int
+     */
+    public var bitLength(get, never):Int;
+
+
+    /**
+     * Constructor to initialize a new MPI instance.
+     *
+     * @param Int value the initial value
+     *
+     * @throws polarssl.PolarSSLException if the MPI init fails
+     */
+    public function new(value:Int = 0):Void
+    {
+        try {
+            this.context = MPI._init();
+            if (value != 0) {
+                MPI._lset(this.context, value);
+            }
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Sets this = a + b.
+     *
+     * @param polarssl.MPI a the first operand
+     * @param polarssl.MPI b the second operand
+     *
+     * @return polarssl.MPI this instance
+     *
+     * @throws hext.IllegalStateException if one of the instances has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function add(a:MPI, b:MPI):MPI
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            MPI._add(x, MPI.handle(a), MPI.handle(b));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return this;
+    }
+
+    /**
+     * Sets this = a + b.
+     *
+     * @param polarssl.MPI a the first operand
+     * @param Int          b the integer to add
+     *
+     * @return polarssl.MPI this instance
+     *
+     * @throws hext.IllegalStateException if one of the instances has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function addInt(a:MPI, b:Int):MPI
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            MPI._add_int(x, MPI.handle(a), b);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return this;
+    }
+
+    /**
+     * Compares this instance with the other one.
+     *
+     * @param polarssl.MPI other the MPI to compare with
+     *
+     * @return Int 1 if this > other, -1 if this < other and 0 if both are equal
+     *
+     * @throws hext.IllegalStateException if one of the instances has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function compare(other:MPI):Int
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            return MPI._cmp(x, MPI.handle(other));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Sets this = other.
+     *
+     * @param polarssl.MPI other the MPI to copy
+     *
+     * @return polarssl.MPI this instance
+     *
+     * @throws hext.IllegalStateException if one of the instances has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function copy(other:MPI):MPI
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            MPI._copy(x, MPI.handle(other));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return this;
+    }
+
+    /**
+     * Sets this = a^e mod n.
+     *
+     * @param polarssl.MPI a the base
+     * @param polarssl.MPI e the exponent
+     * @param polarssl.MPI n the (odd) modulus
+     *
+     * @return polarssl.MPI this instance
+     *
+     * @throws hext.IllegalStateException if one of the instances has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error (e.g. even modulus)
+     */
+    public function expMod(a:MPI, e:MPI, n:MPI):MPI
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            MPI._exp_mod(x, MPI.handle(a), MPI.handle(e), MPI.handle(n));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return this;
+    }
+
+    /**
+     * Frees all memory allocated for this MPI instance.
+     *
+     * Attn: The MPI instance can no longer be used after calling this method.
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function free():Void
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            MPI._free(x);
+            this.context = null;
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Creates a new MPI from the unsigned big-endian Bytes.
+     *
+     * @param haxe.io.Bytes bytes the big-endian Bytes
+     *
+     * @return polarssl.MPI
+     *
+     * @throws hext.IllegalArgumentException if the Bytes are null
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public static function fromBytes(bytes:Bytes):MPI
+    {
+        if (bytes == null) {
+            throw new IllegalArgumentException("Bytes cannot be null.");
+        }
+
+        var mpi:MPI = new MPI();
+        try {
+            MPI._read_binary(mpi.context, bytes.getData(), bytes.length);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return mpi;
+    }
+
+    /**
+     * Creates a new MPI from its String representation.
+     *
+     * @param String str   the (optionally negative) number
+     * @param Int    radix the radix the number is written in (2 - 16)
+     *
+     * @return polarssl.MPI
+     *
+     * @throws hext.IllegalArgumentException if the String is null or the radix is not supported
+     * @throws polarssl.PolarSSLException    if the String is not a valid number
+     */
+    public static function fromString(str:String, radix:Int = 10):MPI
+    {
+        if (str == null) {
+            throw new IllegalArgumentException("String cannot be null.");
+        }
+        if (radix < 2 || radix > 16) {
+            throw new IllegalArgumentException("Radix must be between 2 and 16.");
+        }
+
+        var mpi:MPI = new MPI();
+        try {
+            MPI._read_string(mpi.context, radix, str);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return mpi;
+    }
+
+    /**
+     * Sets this = gcd(a, b).
+     *
+     * @param polarssl.MPI a the first operand
+     * @param polarssl.MPI b the second operand
+     *
+     * @return polarssl.MPI this instance
+     *
+     * @throws hext.IllegalStateException if one of the instances has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function gcd(a:MPI, b:MPI):MPI
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            MPI._gcd(x, MPI.handle(a), MPI.handle(b));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return this;
+    }
+
+    /**
+     * Internal getter method for the 'bitLength' property.
+     *
+     * @return Int
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    private function get_bitLength():Int
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            return MPI._bitlen(x);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Returns the native handle of the MPI.
+     *
+     * @param polarssl.MPI mpi the MPI to get the handle for
+     *
+     * @return polarssl.MPI.MPIContext
+     *
+     * @throws hext.IllegalArgumentException if the MPI is null
+     * @throws hext.IllegalStateException    if the MPI has already been freed
+     */
+    private static inline function handle(mpi:MPI):MPIContext
+    {
+        if (mpi == null) {
+            throw new IllegalArgumentException("MPI cannot be null.");
+        }
+        if (mpi.context == null) {
+            throw new IllegalStateException("MPI context not available.");
+        }
+
+        return mpi.context;
+    }
+
+    /**
+     * Sets this = a^-1 mod n.
+     *
+     * @param polarssl.MPI a the value to invert
+     * @param polarssl.MPI n the modulus
+     *
+     * @return polarssl.MPI this instance
+     *
+     * @throws hext.IllegalStateException if one of the instances has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error (e.g. no inverse exists)
+     */
+    public function invMod(a:MPI, n:MPI):MPI
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            MPI._inv_mod(x, MPI.handle(a), MPI.handle(n));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return this;
+    }
+
+    /**
+     * Sets this = a mod n (with 0 <= this < n).
+     *
+     * @param polarssl.MPI a the dividend
+     * @param polarssl.MPI n the modulus
+     *
+     * @return polarssl.MPI this instance
+     *
+     * @throws hext.IllegalStateException if one of the instances has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error (e.g. division by zero)
+     */
+    public function mod(a:MPI, n:MPI):MPI
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            MPI._mod(x, MPI.handle(a), MPI.handle(n));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return this;
+    }
+
+    /**
+     * Sets this = a * b.
+     *
+     * @param polarssl.MPI a the first operand
+     * @param polarssl.MPI b the second operand
+     *
+     * @return polarssl.MPI this instance
+     *
+     * @throws hext.IllegalStateException if one of the instances has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function mul(a:MPI, b:MPI):MPI
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            MPI._mul(x, MPI.handle(a), MPI.handle(b));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return this;
+    }
+
+    /**
+     * Sets this = a * b.
+     *
+     * @param polarssl.MPI a the first operand
+     * @param Int          b the (non-negative) integer to multiply with
+     *
+     * @return polarssl.MPI this instance
+     *
+     * @throws hext.IllegalArgumentException if b is negative
+     * @throws hext.IllegalStateException    if one of the instances has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function mulInt(a:MPI, b:Int):MPI
+    {
+        if (b < 0) {
+            throw new IllegalArgumentException("Integer multiplier cannot be negative.");
+        }
+
+        var x:MPIContext = MPI.handle(this);
+        try {
+            MPI._mul_int(x, MPI.handle(a), b);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return this;
+    }
+
+    /**
+     * Runs various health checks to ensure the bignum module works correctly.
+     *
+     * @param Bool verbose either to output debug information or not
+     *
+     * @return Bool
+     */
+    public static function selfTest(verbose:Bool = #if POLARSSL_DEBUG true #else false #end):Bool
+    {
+        var ret:Int;
+        try {
+            ret = MPI._self_test(verbose);
+        } catch (ex:Dynamic) {
+            #if POLARSSL_DEBUG
+                throw new PolarSSLException(ex);
+            #else
+                ret = 1;
+            #end
+        }
+
+        return ret == 0;
+    }
+
+    /**
+     * Sets this = value.
+     *
+     * @param Int value the value to set
+     *
+     * @return polarssl.MPI this instance
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function set(value:Int):MPI
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            MPI._lset(x, value);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return this;
+    }
+
+    /**
+     * Sets this = a - b.
+     *
+     * @param polarssl.MPI a the first operand
+     * @param polarssl.MPI b the second operand
+     *
+     * @return polarssl.MPI this instance
+     *
+     * @throws hext.IllegalStateException if one of the instances has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function sub(a:MPI, b:MPI):MPI
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            MPI._sub(x, MPI.handle(a), MPI.handle(b));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return this;
+    }
+
+    /**
+     * Sets this = a - b.
+     *
+     * @param polarssl.MPI a the first operand
+     * @param Int          b the integer to subtract
+     *
+     * @return polarssl.MPI this instance
+     *
+     * @throws hext.IllegalStateException if one of the instances has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function subInt(a:MPI, b:Int):MPI
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            MPI._sub_int(x, MPI.handle(a), b);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+
+        return this;
+    }
+
+    /**
+     * Returns the absolute value as unsigned big-endian Bytes.
+     *
+     * @return haxe.io.Bytes
+     *
+     * @throws hext.IllegalStateException if the instance has already been freed
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public function toBytes():Bytes
+    {
+        var x:MPIContext = MPI.handle(this);
+        try {
+            return Bytes.ofData(MPI._write_binary(x));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Returns the String representation in the given radix.
+     *
+     * @param Int radix the radix to use (2 - 16)
+     *
+     * @return String
+     *
+     * @throws hext.IllegalArgumentException if the radix is not supported
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function toString(radix:Int = 10):String
+    {
+        if (radix < 2 || radix > 16) {
+            throw new IllegalArgumentException("Radix must be between 2 and 16.");
+        }
+
+        var x:MPIContext = MPI.handle(this);
+        try {
+            return MPI._write_string(x, radix);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+}
+
+
+/**
+ * Extern for native MPI handles wrapped by Neko/C++ value.
+ */
+private extern class MPIContext {}
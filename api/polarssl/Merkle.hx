@@ -0,0 +1,153 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import hext.io.Path;
+import polarssl.Loader;
+import polarssl.MDType;
+import polarssl.PolarSSLException;
+
+/**
+ * Result of building a Merkle tree.
+ *
+ * If requested, 'levels' holds the concatenated digests of each level, from the
+ * leaves (index 0) up to the root, e.g. to generate inclusion proofs.
+ */
+typedef MerkleTree = {
+    var root:Bytes;
+    var levels:Null<Array<Bytes>>;
+}
+
+
+/**
+ * Haxe FFI wrapper class for a native, multi-threaded Merkle tree builder.
+ *
+ * The input is split into leaves of a fixed size (the last one may be shorter) which
+ * are hashed in parallel; pairs of nodes are hashed up to the root, an odd last node
+ * being promoted to the next level unchanged. With 'prefixed' enabled, leaves and nodes
+ * are prefixed with 0x00/0x01 as described by RFC 6962.
+ *
+ * Example:
+ *   var merkle = new Merkle(1 << 20, MDType.SHA256);
+ *   var root   = merkle.hashFile("object.bin").root;
+ */
+class Merkle
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _bytes:MerkleContext->BytesData->Int->Int->Bool->Array<BytesData> = Loader.load("hx_merkle_bytes", 5);
+    private static var _file:MerkleContext->Path->Bool->Array<BytesData>                 = Loader.load("hx_merkle_file", 3);
+    private static var _init:Int->Int->Bool->Int->MerkleContext                          = Loader.load("hx_merkle_init", 4);
+
+    /**
+     * Stores the native builder handle.
+     *
+     * @var polarssl.Merkle.MerkleContext
+     */
+    private var context:MerkleContext;
+
+
+    /**
+     * Constructor to initialize a new Merkle instance.
+     *
+     * @param Int             leafSize the number of bytes per leaf (64 to 1 GiB)
+     * @param polarssl.MDType type     the digest algorithm
+     * @param Bool            prefixed either to prefix leaves and nodes as described by RFC 6962 or not
+     * @param Int             threads  the number of worker threads (0 for one per core, at most 64)
+     *
+     * @throws hext.IllegalArgumentException if an argument is out of range
+     * @throws polarssl.PolarSSLException    if the algorithm is not available
+     */
+    public function new(leafSize:Int, type:MDType = MDType.SHA256, prefixed:Bool = false, threads:Int = 0):Void
+    {
+        if (leafSize < 64 || leafSize > (1 << 30)) {
+            throw new IllegalArgumentException("Leaf size must be between 64 bytes and 1 GiB.");
+        }
+        if (type == MDType.NONE) {
+            throw new IllegalArgumentException("Digest algorithm is not supported.");
+        }
+        if (threads < 0 || threads > 64) {
+            throw new IllegalArgumentException("Number of threads must be between 0 and 64.");
+        }
+
+        try {
+            this.context = Merkle._init(leafSize, type, prefixed, threads);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Builds the Merkle tree over the input bytes.
+     *
+     * @param haxe.io.Bytes bytes  the Bytes to hash
+     * @param Int           pos    the position to start reading at
+     * @param Null<Int>     length the number of bytes to hash (defaults to the rest)
+     * @param Bool          levels either to return all levels or only the root
+     *
+     * @return polarssl.Merkle.MerkleTree
+     *
+     * @throws hext.IllegalArgumentException if the range is outside of the Bytes
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function hashBytes(bytes:Bytes, pos:Int = 0, ?length:Int, levels:Bool = false):MerkleTree
+    {
+        if (bytes != null && length == null) {
+            length = bytes.length - pos;
+        }
+        if (bytes == null || pos < 0 || length < 0 || pos > bytes.length || length > bytes.length - pos) {
+            throw new IllegalArgumentException("Range is outside of the Bytes.");
+        }
+
+        try {
+            return Merkle.toTree(Merkle._bytes(this.context, bytes.getData(), pos, length, levels), levels);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Builds the Merkle tree over the file specified by 'path' (memory-mapped natively).
+     *
+     * @param hext.io.Path path   the file's path
+     * @param Bool         levels either to return all levels or only the root
+     *
+     * @return polarssl.Merkle.MerkleTree
+     *
+     * @throws polarssl.PolarSSLException if the file cannot be read
+     */
+    public function hashFile(path:Path, levels:Bool = false):MerkleTree
+    {
+        try {
+            return Merkle.toTree(Merkle._file(this.context, path, levels), levels);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Internal method to convert the native levels into a MerkleTree.
+     *
+     * @param Array<haxe.io.BytesData> data   the levels (or only the root)
+     * @param Bool                     levels either all levels were requested or not
+     *
+     * @return polarssl.Merkle.MerkleTree
+     */
+    private static function toTree(data:Array<BytesData>, levels:Bool):MerkleTree
+    {
+        var all:Array<Bytes> = [for (level in data) Bytes.ofData(level)];
+
+        return {
+            root:   all[all.length - 1],
+            levels: (levels) ? all : null
+        };
+    }
+}
+
+
+/**
+ * Extern for native Merkle builder handles wrapped by Neko/C++ value.
+ */
+private extern class MerkleContext {}
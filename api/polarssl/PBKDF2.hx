@@ -0,0 +1,95 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import haxe.io.BytesData;
+import hext.IllegalArgumentException;
+import polarssl.Loader;
+import polarssl.MDType;
+import polarssl.PolarSSLException;
+
+/**
+ * Haxe FFI wrapper class for the PolarSSL PBKDF2 (PKCS#5) implementation.
+ *
+ * Attn: The derivation does not block the garbage collector, so other threads
+ *       keep running while a (slow) key is being derived.
+ */
+class PBKDF2
+{
+    /**
+     * Stores the references to the FFI implementations of the functions.
+     */
+    private static var _hmac:MDType->Array<Dynamic>->Array<Dynamic>->Int->Int->BytesData = Loader.load("hx_pbkdf2_hmac", 5);
+    private static var _self_test:Bool->Int                                               = Loader.load("hx_pbkdf2_self_test", 1);
+
+
+    /**
+     * Derives a 'keyLen' bytes long key from the password and salt using PBKDF2-HMAC.
+     *
+     * Attn: Keys longer than the digest size are computed in parallel (one output block per thread).
+     *
+     * @param polarssl.MDType type       the MD type/algorithm to use for HMAC
+     * @param haxe.io.Bytes   password   the password to derive the key from
+     * @param haxe.io.Bytes   salt       the salt
+     * @param Int             iterations the number of iterations
+     * @param Int             keyLen     the number of key bytes to derive
+     *
+     * @return haxe.io.Bytes the derived key
+     *
+     * @throws hext.IllegalArgumentException if MDType.NONE is used
+     * @throws hext.IllegalArgumentException if the password or salt is null
+     * @throws hext.IllegalArgumentException if the iterations or key length are <= 0
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public static function derive(type:MDType, password:Bytes, salt:Bytes, iterations:Int, keyLen:Int):Bytes
+    {
+        if (type == MDType.NONE) {
+            throw new IllegalArgumentException("PBKDF2 requires a MD type.");
+        }
+        if (password == null || salt == null) {
+            throw new IllegalArgumentException("Password and salt cannot be null.");
+        }
+        if (iterations <= 0) {
+            throw new IllegalArgumentException("Iterations cannot be <= 0.");
+        }
+        if (keyLen <= 0) {
+            throw new IllegalArgumentException("Key length cannot be <= 0.");
+        }
+
+        var pwdArr:Array<Dynamic> = new Array<Dynamic>();
+        pwdArr[0] = password.length;
+        pwdArr[1] = password.getData();
+
+        var saltArr:Array<Dynamic> = new Array<Dynamic>();
+        saltArr[0] = salt.length;
+        saltArr[1] = salt.getData();
+
+        try {
+            return Bytes.ofData(PBKDF2._hmac(type, pwdArr, saltArr, iterations, keyLen));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
+    /**
+     * Runs various health checks to ensure the PKCS#5 module works correctly.
+     *
+     * @param Bool verbose either to output debug information or not
+     *
+     * @return Bool
+     */
+    public static function selfTest(verbose:Bool = #if POLARSSL_DEBUG true #else false #end):Bool
+    {
+        var ret:Int;
+        try {
+            ret = PBKDF2._self_test(verbose);
+        } catch (ex:Dynamic) {
+            #if POLARSSL_DEBUG
+                throw new PolarSSLException(ex);
+            #else
+                ret = 1;
+            #end
+        }
+
+        return ret == 0;
+    }
+}
@@ -6,6 +6,7 @@ import hext.IllegalArgumentException;
 import hext.IllegalStateException;
 import polarssl.MDType;
 import polarssl.PKCS;
+import polarssl.CtrDrbg;
 import polarssl.Loader;
 import polarssl.PolarSSLException;
 
@@ -22,16 +23,16 @@ class RSA
     // private static var _copy:RSAContext->RSAContext->Int = Loader.load("hx_rsa_copy", 2);
     // private static var _export_pubkey:RSAContext->String = Loader.load("hx_rsa_export_pubkey", 1);
     private static var _free:RSAContext->Void             = Loader.load("hx_rsa_free", 1);
-    private static var _gen_key:RSAContext->Int->Int->Int = Loader.load("hx_rsa_gen_key", 3);
+    private static var _gen_key:RSAContext->Int->Int->Dynamic->Int = Loader.load("hx_rsa_gen_key", 4);
     private static var _getD:RSAContext->BytesData        = Loader.load("hx_rsa_get_D", 1);
     private static var _getE:RSAContext->BytesData        = Loader.load("hx_rsa_get_E", 1);
     private static var _getN:RSAContext->BytesData        = Loader.load("hx_rsa_get_N", 1);
     private static var _getP:RSAContext->BytesData        = Loader.load("hx_rsa_get_P", 1);
     private static var _getQ:RSAContext->BytesData        = Loader.load("hx_rsa_get_Q", 1);
     private static var _init:PKCS->Int->RSAContext        = Loader.load("hx_rsa_init", 2);
-    private static var _pkcs1_decrypt:RSAContext->Int->BytesData->BytesData = Loader.load("hx_rsa_pkcs1_decrypt", 3);
-    private static var _pkcs1_encrypt:RSAContext->Int->BytesData->Int->BytesData = Loader.load("hx_rsa_pkcs1_encrypt", 4);
-    private static var _pkcs1_sign:RSAContext->Int->MDType->Int->BytesData->BytesData = Loader.load("hx_rsa_pkcs1_sign", 5);
+    private static var _pkcs1_decrypt:RSAContext->Int->BytesData->Dynamic->BytesData = Loader.load("hx_rsa_pkcs1_decrypt", 4);
+    private static var _pkcs1_encrypt:RSAContext->Int->BytesData->Int->Dynamic->BytesData = Loader.load("hx_rsa_pkcs1_encrypt", 5);
+    private static var _pkcs1_sign:RSAContext->Int->MDType->Array<Dynamic>->Dynamic->BytesData = Loader.load("hx_rsa_pkcs1_sign", 5);
     private static var _pkcs1_verify:RSAContext->Int->MDType->Array<Dynamic>->BytesData->Int = Loader.load("hx_rsa_pkcs1_verify", 5);
     private static var _self_test:Bool->Int                     = Loader.load("hx_rsa_self_test", 1);
     private static var _set_padding:RSAContext->PKCS->Int->Void = Loader.load("hx_rsa_set_padding", 3);
@@ -49,6 +50,13 @@ class RSA
      */
     private var context:Null<RSAContext>;
 
+    /**
+     * The random number generator to use (HAVEGE if null).
+     *
+     * @var Null<polarssl.CtrDrbg>
+     */
+    public var rng:Null<CtrDrbg>;
+
     /**
      * Property to access the private exponent.
      *
@@ -199,8 +207,10 @@ class RSA
             throw new IllegalStateException("RSA context not available.");
         }
 
+        var rng:Dynamic = CtrDrbg.contextOf(this.rng);
+
         try {
-            return Bytes.ofData(RSA._pkcs1_decrypt(this.context, mode, bytes.getData()));
+            return Bytes.ofData(RSA._pkcs1_decrypt(this.context, mode, bytes.getData(), rng));
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
         }
@@ -227,8 +237,10 @@ class RSA
             throw new IllegalStateException("RSA context not available.");
         }
 
+        var rng:Dynamic = CtrDrbg.contextOf(this.rng);
+
         try {
-            return Bytes.ofData(RSA._pkcs1_encrypt(this.context, mode, bytes.getData(), bytes.length));
+            return Bytes.ofData(RSA._pkcs1_encrypt(this.context, mode, bytes.getData(), bytes.length, rng));
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
         }
@@ -297,8 +309,10 @@ class RSA
             throw new IllegalStateException("RSA context not available.");
         }
 
+        var rng:Dynamic = CtrDrbg.contextOf(this.rng);
+
         try {
-            RSA._gen_key(this.context, nbits, exponent) /* == 0? */;
+            RSA._gen_key(this.context, nbits, exponent, rng) /* == 0? */;
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
         }
@@ -439,8 +453,14 @@ class RSA
             hash = Bytes.alloc(0);
         }
 
+        var hashArr:Array<Dynamic> = new Array<Dynamic>();
+        hashArr[0] = hash.length;
+        hashArr[1] = hash.getData();
+
+        var rng:Dynamic = CtrDrbg.contextOf(this.rng);
+
         try {
-            return Bytes.ofData(RSA._pkcs1_sign(this.context, mode, type, hash.length, hash.getData()));
+            return Bytes.ofData(RSA._pkcs1_sign(this.context, mode, type, hashArr, rng));
         } catch (ex:Dynamic) {
             throw new PolarSSLException(ex);
         }
@@ -5,6 +5,7 @@ import haxe.io.BytesData;
 import hext.io.Path;
 import polarssl.Loader;
 import polarssl.PolarSSLException;
+import polarssl.Segments;
 
 /**
  * Haxe FFI wrapper class for the PolarSSL SHA-512 implementation.
@@ -14,9 +15,11 @@ class SHA512
     /**
      * Stores the references to the FFI implementations of the functions.
      */
-    private static var _self_test:Bool->Int                = Loader.load("hx_sha512_self_test", 1);
-    private static var _sum:BytesData->Int->Int->BytesData = Loader.load("hx_sha512", 3);
-    private static var _sum_file:Path->Int->BytesData      = Loader.load("hx_sha512_file", 2);
+    private static var _self_test:Bool->Int                 = Loader.load("hx_sha512_self_test", 1);
+    private static var _sum:BytesData->Int->Int->BytesData  = Loader.load("hx_sha512", 3);
+    private static var _sum_file:Path->Int->BytesData       = Loader.load("hx_sha512_file", 2);
+    private static var _sum_hex:BytesData->Int->Int->String = Loader.load("hx_sha512_hex", 3);
+    private static var _sumv:Array<Dynamic>->Int->BytesData = Loader.load("hx_sha512v", 2);
 
 
     /**
@@ -45,7 +48,7 @@ class SHA512
     /**
      * Returns the SHA-512 sum of the input bytes.
      *
-     * Attn: To get the sum as a String, use toHex() on the returned Bytes.
+     * Attn: To get the sum as a (hex) String, use sumHex().
      *
      * @param haxe.io.Bytes bytes the Bytes to get the sum of
      * @param Bool          is384 either 384 bit SHA should be used or not
@@ -70,6 +73,25 @@ class SHA512
         return sum;
     }
 
+    /**
+     * Returns the SHA-512 sum of the input bytes as a lowercase hex String.
+     *
+     * @param haxe.io.Bytes bytes the Bytes to get the sum for
+     * @param Bool          is384 either 384 bit SHA should be used or not
+     *
+     * @return String the hex encoded sum
+     *
+     * @throws polarssl.PolarSSLException if the FFI call raises an error
+     */
+    public static function sumHex(bytes:Bytes, is384:Bool = false):String
+    {
+        try {
+            return SHA512._sum_hex(bytes.getData(), bytes.length, (is384) ? 1 : 0);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
     /**
      * Returns the SHA-512 sum of the file specified by 'path'.
      *
@@ -97,4 +119,27 @@ class SHA512
 
         return sum;
     }
+
+    /**
+     * Returns the SHA-512 sum of the parts as if they were concatenated, without copying them.
+     *
+     * @param Array<haxe.io.Bytes> parts     the Bytes to get the sum for, in order
+     * @param Array<Int>           positions the position to start reading at for each part (defaults to 0)
+     * @param Array<Int>           lengths   the number of bytes to read from each part (defaults to the rest)
+     * @param Bool                 is384     either 384 bit SHA should be used or not
+     *
+     * @return haxe.io.Bytes the sum Bytes (truncated to 48 bytes for the 384 bit variant)
+     *
+     * @throws hext.IllegalArgumentException if the arrays do not match or a range is outside of its Bytes
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public static function sumv(parts:Array<Bytes>, ?positions:Array<Int>, ?lengths:Array<Int>, is384:Bool = false):Bytes
+    {
+        var flat:Array<Dynamic> = Segments.flatten(parts, positions, lengths);
+        try {
+            return Bytes.ofData(SHA512._sumv(flat, (is384) ? 1 : 0));
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
 }
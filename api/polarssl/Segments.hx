@@ -0,0 +1,75 @@
+package polarssl;
+
+import haxe.io.Bytes;
+import hext.IllegalArgumentException;
+
+/**
+ * Helper to pass a list of (ranges of) Bytes to native functions that process them
+ * as one logical stream, e.g. a message's header, body and trailer, without
+ * concatenating them into a new buffer first.
+ */
+class Segments
+{
+    /**
+     * Validates the segments and flattens them into the (BytesData, pos, length) triples
+     * expected by the native functions.
+     *
+     * @param Array<haxe.io.Bytes> parts     the Bytes to process in order
+     * @param Null<Array<Int>>     positions the position to start reading at for each part (defaults to 0)
+     * @param Null<Array<Int>>     lengths   the number of bytes to read from each part (defaults to the rest)
+     *
+     * @return Array<Dynamic> the flattened segments
+     *
+     * @throws hext.IllegalArgumentException if the arrays do not match or a range is outside of its Bytes
+     */
+    @:allow(polarssl)
+    private static function flatten(parts:Array<Bytes>, ?positions:Array<Int>, ?lengths:Array<Int>):Array<Dynamic>
+    {
+        if (parts == null) {
+            throw new IllegalArgumentException("Parts cannot be null.");
+        }
+        if ((positions != null && positions.length != parts.length) || (lengths != null && lengths.length != parts.length)) {
+            throw new IllegalArgumentException("Positions and lengths must match the parts.");
+        }
+
+        var flat:Array<Dynamic> = new Array<Dynamic>();
+        for (i in 0...parts.length) {
+            var bytes:Bytes = parts[i];
+            if (bytes == null) {
+                throw new IllegalArgumentException("Parts cannot contain null.");
+            }
+
+            var pos:Int    = (positions == null) ? 0 : positions[i];
+            var length:Int = (lengths == null) ? bytes.length - pos : lengths[i];
+            if (pos < 0 || length < 0 || pos > bytes.length || length > bytes.length - pos) {
+                throw new IllegalArgumentException("Range is outside of the Bytes.");
+            }
+
+            flat.push(bytes.getData());
+            flat.push(pos);
+            flat.push(length);
+        }
+
+        return flat;
+    }
+
+    /**
+     * Returns the total number of bytes of flattened segments.
+     *
+     * @param Array<Dynamic> flat the segments returned by flatten()
+     *
+     * @return Int
+     */
+    @:allow(polarssl)
+    private static function totalLength(flat:Array<Dynamic>):Int
+    {
+        var total:Int = 0;
+        var i:Int     = 2;
+        while (i < flat.length) {
+            total += flat[i];
+            i     += 3;
+        }
+
+        return total;
+    }
+}
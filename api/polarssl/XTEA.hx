@@ -16,7 +16,9 @@ class XTEA
      * Stores the references to the FFI implementations of the functions.
      */
     private static var _crypt_cbc:XTEAContext->Int->Int->BytesData->BytesData->BytesData = Loader.load("hx_xtea_crypt_cbc", 5);
+    private static var _crypt_cbc_batch:XTEAContext->Int->Array<Int>->Array<Dynamic>->Array<Dynamic>->Int = Loader.load("hx_xtea_crypt_cbc_batch", 5);
     private static var _crypt_ecb:XTEAContext->Int->BytesData->BytesData = Loader.load("hx_xtea_crypt_ecb", 3);
+    private static var _crypt_ecb_into:XTEAContext->Int->Array<Dynamic>->Int = Loader.load("hx_xtea_crypt_ecb_into", 3);
     private static var _free:XTEAContext->Void             = Loader.load("hx_xtea_free", 1);
     private static var _init:Void->XTEAContext             = Loader.load("hx_xtea_init", 0);
     private static var _self_test:Bool->Int                = Loader.load("hx_xtea_self_test", 1);
@@ -91,6 +93,64 @@ class XTEA
         }
     }
 
+    /**
+     * Decrypts/encrypts a batch of independent CBC frames, each with its own IV, in a single FFI call.
+     *
+     * The frames are read back-to-back from 'input' starting at 'inPos' and written back-to-back
+     * to 'output' starting at 'outPos'; frame i uses the 8 bytes IV at ivPos + 8 * i in 'ivs'.
+     * The IVs are not modified.
+     *
+     * @param Int           mode    XTEA.DECRYPT or XTEA.ENCRYPT
+     * @param haxe.io.Bytes ivs     the Bytes holding the IVs
+     * @param Int           ivPos   the position of the first IV
+     * @param Array<Int>    lengths the length of each frame (each must be % 8 == 0)
+     * @param haxe.io.Bytes input   the Bytes to read the frames from
+     * @param Int           inPos   the position of the first frame
+     * @param haxe.io.Bytes output  the Bytes to write to (may be 'input' at the same position)
+     * @param Int           outPos  the position to start writing at
+     *
+     * @throws hext.IllegalArgumentException if the mode is not supported
+     * @throws hext.IllegalArgumentException if a frame length is not % 8 == 0
+     * @throws hext.IllegalArgumentException if a range is outside of its Bytes
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function cryptCbcBatch(mode:Int, ivs:Bytes, ivPos:Int, lengths:Array<Int>, input:Bytes, inPos:Int, output:Bytes, outPos:Int):Void
+    {
+        if (mode != XTEA.DECRYPT && mode != XTEA.ENCRYPT) {
+            throw new IllegalArgumentException("Provided XTEA mode is not supported");
+        }
+        if (ivs == null || lengths == null || input == null || output == null) {
+            throw new IllegalArgumentException("IVs, lengths, input and output cannot be null.");
+        }
+
+        var total:Int = 0;
+        for (length in lengths) {
+            if (length < 0 || (length % 8) != 0) {
+                throw new IllegalArgumentException("Frame lengths must be a multiple of 8.");
+            }
+            if (length > input.length - total) {
+                throw new IllegalArgumentException("Range is outside of the Bytes.");
+            }
+            total += length;
+        }
+        if (ivPos < 0 || ivPos > ivs.length || lengths.length > Std.int((ivs.length - ivPos) / 8)) {
+            throw new IllegalArgumentException("IV range is outside of the Bytes.");
+        }
+        if (inPos < 0 || inPos > input.length || total > input.length - inPos || outPos < 0 || outPos > output.length || total > output.length - outPos) {
+            throw new IllegalArgumentException("Range is outside of the Bytes.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("No XTEA context available.");
+        }
+
+        try {
+            XTEA._crypt_cbc_batch(this.context, mode, lengths, [ ivs.getData(), ivPos ], [ total, input.getData(), inPos, output.getData(), outPos ]);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
     /**
      * Puts the input bytes through the cipher function and returns the resulting ones.
      *
@@ -123,6 +183,48 @@ class XTEA
         }
     }
 
+    /**
+     * Puts 'length' bytes (any number of blocks) of 'input' starting at 'inPos' through the
+     * ECB cipher function and writes the result into 'output' starting at 'outPos'.
+     *
+     * @param Int           mode   XTEA.DECRYPT or XTEA.ENCRYPT
+     * @param haxe.io.Bytes input  the Bytes to read from
+     * @param Int           inPos  the position to start reading at
+     * @param Int           length the number of bytes to crypt (must be % 8 == 0)
+     * @param haxe.io.Bytes output the Bytes to write to (may be 'input' at the same position)
+     * @param Int           outPos the position to start writing at
+     *
+     * @throws hext.IllegalArgumentException if the mode is not supported
+     * @throws hext.IllegalArgumentException if the length is not % 8 == 0
+     * @throws hext.IllegalArgumentException if a range is outside of its Bytes
+     * @throws hext.IllegalStateException    if the instance has already been freed
+     * @throws polarssl.PolarSSLException    if the FFI call raises an error
+     */
+    public function cryptEcbInto(mode:Int, input:Bytes, inPos:Int, length:Int, output:Bytes, outPos:Int):Void
+    {
+        if (mode != XTEA.DECRYPT && mode != XTEA.ENCRYPT) {
+            throw new IllegalArgumentException("Provided XTEA mode is not supported");
+        }
+        if (input == null || output == null) {
+            throw new IllegalArgumentException("Input and output Bytes cannot be null.");
+        }
+        if (length < 0 || (length % 8) != 0) {
+            throw new IllegalArgumentException("Input length must be a multiple of 8.");
+        }
+        if (inPos < 0 || inPos > input.length || length > input.length - inPos || outPos < 0 || outPos > output.length || length > output.length - outPos) {
+            throw new IllegalArgumentException("Range is outside of the Bytes.");
+        }
+        if (this.context == null) {
+            throw new IllegalStateException("No XTEA context available.");
+        }
+
+        try {
+            XTEA._crypt_ecb_into(this.context, mode, [ length, input.getData(), inPos, output.getData(), outPos ]);
+        } catch (ex:Dynamic) {
+            throw new PolarSSLException(ex);
+        }
+    }
+
     /**
      * Frees all memory allocated for this XTEA instance.
      *
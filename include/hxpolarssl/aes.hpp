@@ -41,6 +41,29 @@ DECLARE_KIND(k_aes_context);
 value hx_aes_crypt_cbc(value aes_context, value mode, value length, value iv, value input);
 
 
+/**
+ * AES CBC cipher function over segments processed as if they were concatenated
+ * (the segments themselves need not be multiples of AES_BLOCKSIZE).
+ *
+ * See:
+ *   https://polarssl.org/api/aes_8h.html
+ *
+ * Example:
+ *   value enc = hx_aes_crypt_cbcv(alloc_aes_context(aes_context), alloc_int(AES_ENCRYPT), buffer_val(iv), segments);
+ *
+ * Parameters:
+ *   value[k_aes_context]     aes_context the AES context to use
+ *   value[Int]               mode        AES_ENCRYPT or AES_DECRYPT
+ *   value[haxe.io.BytesData] iv          the initialization vector (.length == AES_BLOCKSIZE), updated in place
+ *   value[Array<Dynamic>]    segments    the (BytesData, pos, length) triples (total must be % AES_BLOCKSIZE == 0)
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the crypted Bytes
+ *   or in case of an error, its code [Int] (and a Neko error is raised).
+ */
+value hx_aes_crypt_cbcv(value aes_context, value mode, value iv, value segments);
+
+
 /**
  * AES ECB cipher function.
  *
@@ -42,6 +42,28 @@ DECLARE_KIND(k_arc4_context);
 value hx_arc4_crypt(value arc4_context, value length, value input);
 
 
+/*
+ * Runs 'length' bytes of 'input' starting at 'inPos' through the cipher function,
+ * writing the result into 'output' starting at 'outPos' (no new buffer is allocated).
+ *
+ * Attn: The input and output ranges may be identical (in-place crypt), but must not otherwise overlap.
+ *
+ * See:
+ *   https://polarssl.org/api/arc4_8h.html
+ *
+ * Example:
+ *   hx_arc4_crypt_into(arc4, [ alloc_int(len), buffer_val(buf), alloc_int(0), buffer_val(buf), alloc_int(0) ]);
+ *
+ * Parameters:
+ *   value[k_arc4_context] arc4_context the ARCFOUR context with which to cipher
+ *   value[Array]          ioArr        [length:Int, input:BytesData, inPos:Int, output:BytesData, outPos:Int]
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_arc4_crypt_into(value arc4_context, value ioArr);
+
+
 /*
  * Frees the ARCFOUR context and all resources allocated for it.
  *
@@ -117,6 +139,22 @@ value hx_arc4_self_test(value verbose);
 value hx_arc4_setup(value arc4_context, value key, value keylen);
 
 
+/*
+ * Advances the keystream by 'count' bytes without producing any output (RC4-drop[n]).
+ *
+ * Example:
+ *   hx_arc4_skip(alloc_arc4_context(arc4_context), alloc_int(3072));
+ *
+ * Parameters:
+ *   value[k_arc4_context] arc4_context the ARCFOUR context to advance
+ *   value[Int]            count        the number of keystream bytes to discard
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_arc4_skip(value arc4_context, value count);
+
+
 /*
  * Finalizes the ARCFOUR context by freeing associated memory.
  *
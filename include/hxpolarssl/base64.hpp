@@ -5,44 +5,155 @@
 extern "C" {
 #endif
 
+/*
+ * Possible Base64 stream mode values.
+ */
+#define BASE64_DECODE  0
+#define BASE64_ENCODE  1
+
+/*
+ * Base64 variant flags (can be combined).
+ */
+#define BASE64_URLSAFE  0x01  /* URL and filename safe alphabet ('-' and '_', RFC 4648 §5) */
+#define BASE64_NOPAD    0x02  /* omit the '=' padding; decoding accepts input with or without it */
+#define BASE64_LF       0x04  /* break wrapped lines with LF instead of CRLF */
+
+
+/*
+ * Internal structure holding the state carried between the chunks of a stream.
+ */
+typedef struct {
+    int           mode;
+    int           flags;       /* BASE64_URLSAFE | BASE64_NOPAD | BASE64_LF */
+    size_t        line_length; /* encoder: characters per line (multiple of 4), 0 = no wrapping */
+    size_t        column;      /* encoder: characters written to the current line */
+    unsigned char pending[3];  /* encoder: bytes of the incomplete 3 byte group */
+    size_t        pending_len;
+    uint32_t      bits;        /* decoder: bits of the incomplete quantum */
+    int           chars;       /* decoder: characters of the incomplete quantum */
+    int           pad;         /* decoder: '=' of the incomplete quantum */
+    int           finished;    /* decoder: padding seen, only line breaks may follow */
+    int           failed;      /* decoder: invalid input seen */
+} s_base64_stream;
+
+
+DECLARE_KIND(k_base64_stream);
+
+
+#define alloc_base64_stream(v)      alloc_abstract(k_base64_stream, v)
+#define malloc_base64_stream()      ((s_base64_stream*)alloc_private(sizeof(s_base64_stream)))
+#define val_base64_stream(v)        ((s_base64_stream*)val_data(v))
+#define val_check_base64_stream(v)  val_check_kind(v, k_base64_stream)
+#define val_is_base64_stream(v)     val_is_kind(v, k_base64_stream)
+
+
 /*
  * Decodes the encoded bytes back to unencoded ones.
  *
+ * Attn: Line breaks (LF or CRLF) are skipped; the input must consist of complete
+ *       (padded) 4 character quanta unless BASE64_NOPAD is set. Uses SSSE3/AVX2 kernels
+ *       when the CPU supports them.
+ *
  * See:
  *   https://polarssl.org/api/base64_8h.html
  *
  * Example:
- *   value decoded = hx_base64_decode(buffer_val(buf), buffer_size(buf));
+ *   value decoded = hx_base64_decode(buffer_val(buf), buffer_size(buf), alloc_int(BASE64_URLSAFE));
  *
  * Parameters:
  *   value[haxe.io.BytesData] bytes  the bytes to decode
  *   value[Int]               length the number of bytes to decode
+ *   value[Int]               flags  BASE64_URLSAFE and/or BASE64_NOPAD (or 0)
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the decoded bytes
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_base64_decode(value bytes, value length, value flags);
+
+
+/*
+ * Decodes the Base64 String into the provided BytesData, starting at 'pos'.
+ *
+ * Attn: Nothing past 'pos' + 'size' is written; in case of an error, the bytes within
+ *       that range are undefined.
+ *
+ * Example:
+ *   value written = hx_base64_decode_into(alloc_string("QUJD"), alloc_int(0), buffer_val(buf), alloc_int(0), buffer_size(buf));
+ *
+ * Parameters:
+ *   value[String]            str   the Base64 String to decode
+ *   value[Int]               flags BASE64_URLSAFE and/or BASE64_NOPAD (or 0)
+ *   value[haxe.io.BytesData] bytes the BytesData to write the decoded bytes to
+ *   value[Int]               pos   the position to start writing at
+ *   value[Int]               size  the number of bytes available from 'pos' on
+ *
+ * Returns:
+ *   value[Int] the number of decoded bytes
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_base64_decode_into(value str, value flags, value bytes, value pos, value size);
+
+
+/*
+ * Decodes the Base64 String without converting it to BytesData first.
+ *
+ * Example:
+ *   value decoded = hx_base64_decode_string(alloc_string("QUJD"), alloc_int(0));
+ *
+ * Parameters:
+ *   value[String] str   the Base64 String to decode
+ *   value[Int]    flags BASE64_URLSAFE and/or BASE64_NOPAD (or 0)
  *
  * Returns:
  *   value[haxe.io.BytesData] the decoded bytes
  *   or in case of an error [Int] the error code (and a Neko error is raised).
  */
-value hx_base64_decode(value bytes, value length);
+value hx_base64_decode_string(value str, value flags);
 
 
 /*
  * Encodes the provided bytes.
  *
+ * Attn: Uses SSSE3/AVX2 kernels when the CPU supports them. Line breaks are inserted
+ *       between lines only (no trailing one); the line length is rounded down to a
+ *       multiple of 4.
+ *
  * See:
  *   https://polarssl.org/api/base64_8h.html
  *
  * Example:
- *   value encoded = hx_base64_encode(buffer_val(buf), buffer_size(buf));
+ *   value encoded = hx_base64_encode(buffer_val(buf), buffer_size(buf), alloc_int(0), alloc_int(76));
  *
  * Parameters:
- *   value[haxe.io.BytesData] bytes  the bytes to encode
- *   value[Int]               length the number of bytes to encode
+ *   value[haxe.io.BytesData] bytes       the bytes to encode
+ *   value[Int]               length      the number of bytes to encode
+ *   value[Int]               flags       BASE64_URLSAFE, BASE64_NOPAD and/or BASE64_LF (or 0)
+ *   value[Int]               line_length the characters per line (e.g. 76 for MIME), 0 = no wrapping
  *
  * Returns:
  *   value[haxe.io.BytesData] the encoded bytes
  *   or in case of an error [Int] the error code (and a Neko error is raised).
  */
-value hx_base64_encode(value bytes, value length);
+value hx_base64_encode(value bytes, value length, value flags, value line_length);
+
+
+/*
+ * Encodes the provided bytes directly into a String (see hx_base64_encode()).
+ *
+ * Example:
+ *   value encoded = hx_base64_encode_string(buffer_val(buf), buffer_size(buf), alloc_int(0), alloc_int(0));
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] bytes       the bytes to encode
+ *   value[Int]               length      the number of bytes to encode
+ *   value[Int]               flags       BASE64_URLSAFE, BASE64_NOPAD and/or BASE64_LF (or 0)
+ *   value[Int]               line_length the characters per line (e.g. 76 for MIME), 0 = no wrapping
+ *
+ * Returns:
+ *   value[String] the encoded String
+ */
+value hx_base64_encode_string(value bytes, value length, value flags, value line_length);
 
 
 /*
@@ -66,6 +177,76 @@ value hx_base64_encode(value bytes, value length);
  */
 value hx_base64_self_test(value verbose);
 
+
+/*
+ * Ends the stream: returns the (padded) encoding of the kept bytes (encoder) or checks
+ * that the input ended on a complete quantum (decoder; with BASE64_NOPAD the bytes of an
+ * unpadded final quantum are returned). The stream can then be reused.
+ *
+ * Example:
+ *   value tail = hx_base64_stream_finish(stream);
+ *
+ * Parameters:
+ *   value[k_base64_stream] stream the stream to finish
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the remaining output (0 - 6 characters; 0 - 2 bytes when decoding)
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_base64_stream_finish(value stream);
+
+
+/*
+ * Initializes and returns a new Base64 encoder or decoder stream.
+ *
+ * Example:
+ *   value stream = hx_base64_stream_init(alloc_int(BASE64_ENCODE), alloc_int(0), alloc_int(76));
+ *
+ * Parameters:
+ *   value[Int] mode        BASE64_ENCODE or BASE64_DECODE
+ *   value[Int] flags       BASE64_URLSAFE, BASE64_NOPAD and/or BASE64_LF (or 0)
+ *   value[Int] line_length the characters per line when encoding, 0 = no wrapping
+ *
+ * Returns:
+ *   value[k_base64_stream] the initialized stream
+ */
+value hx_base64_stream_init(value mode, value flags, value line_length);
+
+
+/*
+ * Encodes/decodes the next chunk (any length) of the stream.
+ *
+ * Attn: Bytes of an incomplete group (encoder) or characters of an incomplete quantum
+ *       (decoder) are kept in the stream and emitted by the next call. A decoder stream
+ *       that raised an error keeps failing until it is finished.
+ *
+ * Example:
+ *   value out = hx_base64_stream_update(stream, buffer_val(buf), alloc_int(0), buffer_size(buf));
+ *
+ * Parameters:
+ *   value[k_base64_stream]   stream the stream to use
+ *   value[haxe.io.BytesData] bytes  the input bytes
+ *   value[Int]               pos    the position to start reading at
+ *   value[Int]               length the number of bytes to process
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the output produced by this chunk (possibly empty)
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_base64_stream_update(value stream, value bytes, value pos, value length);
+
+
+/*
+ * Finalizes the Base64 stream by wiping it.
+ *
+ * Example:
+ *   finalize_base64_stream(stream);
+ *
+ * Parameters:
+ *   value[k_base64_stream] stream the stream to finalize
+ */
+void finalize_base64_stream(value stream);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,83 @@
+#ifndef __HX_POLARSSL_BCRYPT_HPP
+#define __HX_POLARSSL_BCRYPT_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BCRYPT_SALT_LENGTH     16
+#define BCRYPT_HASH_LENGTH     24 /* the encrypted "OrpheanBeholderScryDoubt" */
+#define BCRYPT_STRING_LENGTH   60 /* "$2b$" + 2 cost digits + "$" + 22 salt + 31 hash chars */
+#define BCRYPT_MAX_KEY_LENGTH  72
+#define BCRYPT_MIN_COST        4
+#define BCRYPT_MAX_COST        31
+
+
+/*
+ * Hashes the password with bcrypt (EksBlowfish) and returns the modular crypt string.
+ *
+ * Attn: The work is done with the GC lock released, so other Haxe threads keep running.
+ *       Passwords longer than 72 bytes are truncated, as done by all bcrypt implementations.
+ *
+ * See:
+ *   https://www.usenix.org/legacy/events/usenix99/provos/provos.pdf
+ *
+ * Example:
+ *   value hash = hx_bcrypt_hash(buffer_val(pwd), buffer_size(pwd), buffer_val(salt), alloc_int(10));
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] password the password bytes
+ *   value[Int]               length   the password length
+ *   value[haxe.io.BytesData] salt     the random salt (.length == BCRYPT_SALT_LENGTH)
+ *                                     or null to generate one natively (per-call HAVEGE)
+ *   value[Int]               cost     the log2 of the number of rounds (4 - 31)
+ *
+ * Returns:
+ *   value[String] the "$2b$..." hash string
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_bcrypt_hash(value password, value length, value salt, value cost);
+
+
+/*
+ * Runs the known-answer tests of the bcrypt implementation.
+ *
+ * Example:
+ *   value ret = hx_bcrypt_self_test(alloc_bool(true));
+ *
+ * Parameters:
+ *   value[Bool] verbose either to output debug information or not
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_bcrypt_self_test(value verbose);
+
+
+/*
+ * Checks the password against an existing bcrypt hash string ($2a$, $2b$ or $2y$).
+ *
+ * Attn: The work is done with the GC lock released; the hashes are compared in constant time.
+ *
+ * See:
+ *   https://www.usenix.org/legacy/events/usenix99/provos/provos.pdf
+ *
+ * Example:
+ *   value ok = hx_bcrypt_verify(buffer_val(pwd), buffer_size(pwd), alloc_string(hash));
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] password the password bytes
+ *   value[Int]               length   the password length
+ *   value[String]            hash     the hash string to check against
+ *
+ * Returns:
+ *   value[Bool] true if the password matches
+ *   or the error code [Int] if the hash string is malformed (and a Neko error is raised).
+ */
+value hx_bcrypt_verify(value password, value length, value hash);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_BCRYPT_HPP */
@@ -18,6 +18,27 @@ DECLARE_KIND(k_blowfish_context);
 #define val_is_blowfish_context(v)     val_is_kind(v, k_blowfish_context)
 
 
+/*
+ * Internal structure holding the resumable state of a CTR or CFB64 stream, so
+ * non-block-aligned input can be processed over several calls.
+ */
+typedef struct {
+    size_t        offset;
+    unsigned char iv[BLOWFISH_BLOCKSIZE];
+    unsigned char stream_block[BLOWFISH_BLOCKSIZE];
+} s_blowfish_stream;
+
+
+DECLARE_KIND(k_blowfish_stream);
+
+
+#define alloc_blowfish_stream(v)      alloc_abstract(k_blowfish_stream, v)
+#define malloc_blowfish_stream()      ((s_blowfish_stream*)alloc_private(sizeof(s_blowfish_stream)))
+#define val_blowfish_stream(v)        ((s_blowfish_stream*)val_data(v))
+#define val_check_blowfish_stream(v)  val_check_kind(v, k_blowfish_stream)
+#define val_is_blowfish_stream(v)     val_is_kind(v, k_blowfish_stream)
+
+
 /**
  * Blowfish CBC cipher function.
  *
@@ -41,6 +62,51 @@ DECLARE_KIND(k_blowfish_context);
 value hx_blowfish_crypt_cbc(value blowfish_context, value mode, value length, value iv, value input);
 
 
+/*
+ * Blowfish CFB64 cipher function, continuing at the position stored in the stream state.
+ *
+ * See:
+ *   https://polarssl.org/api/blowfish_8h.html
+ *
+ * Example:
+ *   value enc = hx_blowfish_crypt_cfb64(alloc_blowfish_context(blowfish_context), alloc_blowfish_stream(stream), alloc_int(BLOWFISH_ENCRYPT), buffer_size(buf), buffer_val(buf));
+ *
+ * Parameters:
+ *   value[k_blowfish_context] blowfish_context the Blowfish context to use
+ *   value[k_blowfish_stream]  stream           the stream state (updated in place)
+ *   value[Int]                mode             BLOWFISH_ENCRYPT or BLOWFISH_DECRYPT
+ *   value[Int]                length           the number of input bytes (any length)
+ *   value[haxe.io.BytesData]  input            the input bytes
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the crypted Bytes
+ *   or in case of an error, its code [Int] (and a Neko error is raised).
+ */
+value hx_blowfish_crypt_cfb64(value blowfish_context, value stream, value mode, value length, value input);
+
+
+/*
+ * Blowfish CTR cipher function, continuing at the position stored in the stream state.
+ *
+ * See:
+ *   https://polarssl.org/api/blowfish_8h.html
+ *
+ * Example:
+ *   value enc = hx_blowfish_crypt_ctr(alloc_blowfish_context(blowfish_context), alloc_blowfish_stream(stream), buffer_size(buf), buffer_val(buf));
+ *
+ * Parameters:
+ *   value[k_blowfish_context] blowfish_context the Blowfish context to use
+ *   value[k_blowfish_stream]  stream           the stream state (updated in place)
+ *   value[Int]                length           the number of input bytes (any length)
+ *   value[haxe.io.BytesData]  input            the input bytes
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the crypted Bytes
+ *   or in case of an error, its code [Int] (and a Neko error is raised).
+ */
+value hx_blowfish_crypt_ctr(value blowfish_context, value stream, value length, value input);
+
+
 /**
  * Blowfish ECB cipher function.
  *
@@ -116,6 +182,21 @@ value hx_blowfish_init(void);
 value hx_blowfish_setkey(value blowfish_context, value key, value keysize);
 
 
+/*
+ * Initializes and returns a new CTR/CFB64 stream state starting at the given IV/nonce counter.
+ *
+ * Example:
+ *   value stream = hx_blowfish_stream_init(buffer_val(iv));
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] iv the initial IV (CFB64) or nonce counter block (CTR), 8 bytes
+ *
+ * Returns:
+ *   value[k_blowfish_stream] the initialized stream state
+ */
+value hx_blowfish_stream_init(value iv);
+
+
 /*
  * Finalizes the Blowfish context by freeing associated memory.
  *
@@ -127,6 +208,18 @@ value hx_blowfish_setkey(value blowfish_context, value key, value keysize);
  */
 void finalize_blowfish_context(value blowfish_context);
 
+
+/*
+ * Finalizes the stream state by wiping it.
+ *
+ * Example:
+ *   finalize_blowfish_stream(alloc_blowfish_stream(stream));
+ *
+ * Parameters:
+ *   value[k_blowfish_stream] stream the stream state to finalize
+ */
+void finalize_blowfish_stream(value stream);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -18,6 +18,27 @@ DECLARE_KIND(k_camellia_context);
 #define val_is_camellia_context(v)     val_is_kind(v, k_camellia_context)
 
 
+/*
+ * Internal structure holding the resumable state of a CTR or CFB128 stream, so
+ * non-block-aligned input can be processed over several calls.
+ */
+typedef struct {
+    size_t        offset;
+    unsigned char iv[CAMELLIA_BLOCKSIZE];
+    unsigned char stream_block[CAMELLIA_BLOCKSIZE];
+} s_camellia_stream;
+
+
+DECLARE_KIND(k_camellia_stream);
+
+
+#define alloc_camellia_stream(v)      alloc_abstract(k_camellia_stream, v)
+#define malloc_camellia_stream()      ((s_camellia_stream*)alloc_private(sizeof(s_camellia_stream)))
+#define val_camellia_stream(v)        ((s_camellia_stream*)val_data(v))
+#define val_check_camellia_stream(v)  val_check_kind(v, k_camellia_stream)
+#define val_is_camellia_stream(v)     val_is_kind(v, k_camellia_stream)
+
+
 /**
  * Camellia CBC cipher function.
  *
@@ -41,6 +62,57 @@ DECLARE_KIND(k_camellia_context);
 value hx_camellia_crypt_cbc(value camellia_context, value mode, value length, value iv, value input);
 
 
+/*
+ * Camellia CFB128 cipher function, continuing at the position stored in the stream state.
+ *
+ * Attn: CFB128 only uses the forward cipher, so the context must be keyed with
+ *       hx_camellia_setkey_enc() for both, encryption and decryption.
+ *
+ * See:
+ *   https://polarssl.org/api/camellia_8h.html
+ *
+ * Example:
+ *   value enc = hx_camellia_crypt_cfb128(alloc_camellia_context(camellia_context), alloc_camellia_stream(stream), alloc_int(CAMELLIA_ENCRYPT), buffer_size(buf), buffer_val(buf));
+ *
+ * Parameters:
+ *   value[k_camellia_context] camellia_context the Camellia context to use
+ *   value[k_camellia_stream]  stream           the stream state (updated in place)
+ *   value[Int]                mode             CAMELLIA_ENCRYPT or CAMELLIA_DECRYPT
+ *   value[Int]                length           the number of input bytes (any length)
+ *   value[haxe.io.BytesData]  input            the input bytes
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the crypted Bytes
+ *   or in case of an error, its code [Int] (and a Neko error is raised).
+ */
+value hx_camellia_crypt_cfb128(value camellia_context, value stream, value mode, value length, value input);
+
+
+/*
+ * Camellia CTR cipher function, continuing at the position stored in the stream state.
+ *
+ * Attn: CTR only uses the forward cipher, so the context must be keyed with
+ *       hx_camellia_setkey_enc() for both, encryption and decryption.
+ *
+ * See:
+ *   https://polarssl.org/api/camellia_8h.html
+ *
+ * Example:
+ *   value enc = hx_camellia_crypt_ctr(alloc_camellia_context(camellia_context), alloc_camellia_stream(stream), buffer_size(buf), buffer_val(buf));
+ *
+ * Parameters:
+ *   value[k_camellia_context] camellia_context the Camellia context to use
+ *   value[k_camellia_stream]  stream           the stream state (updated in place)
+ *   value[Int]                length           the number of input bytes (any length)
+ *   value[haxe.io.BytesData]  input            the input bytes
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the crypted Bytes
+ *   or in case of an error, its code [Int] (and a Neko error is raised).
+ */
+value hx_camellia_crypt_ctr(value camellia_context, value stream, value length, value input);
+
+
 /**
  * Camellia ECB cipher function.
  *
@@ -159,6 +231,21 @@ value hx_camellia_setkey_dec(value camellia_context, value key, value keylen);
 value hx_camellia_setkey_enc(value camellia_context, value key, value keylen);
 
 
+/*
+ * Initializes and returns a new CTR/CFB128 stream state starting at the given IV/nonce counter.
+ *
+ * Example:
+ *   value stream = hx_camellia_stream_init(buffer_val(iv));
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] iv the initial IV (CFB128) or nonce counter block (CTR), 16 bytes
+ *
+ * Returns:
+ *   value[k_camellia_stream] the initialized stream state
+ */
+value hx_camellia_stream_init(value iv);
+
+
 /*
  * Finalizes the Camellia context by freeing associated memory.
  *
@@ -170,6 +257,18 @@ value hx_camellia_setkey_enc(value camellia_context, value key, value keylen);
  */
 void finalize_camellia_context(value camellia_context);
 
+
+/*
+ * Finalizes the stream state by wiping it.
+ *
+ * Example:
+ *   finalize_camellia_stream(alloc_camellia_stream(stream));
+ *
+ * Parameters:
+ *   value[k_camellia_stream] stream the stream state to finalize
+ */
+void finalize_camellia_stream(value stream);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,76 @@
+#ifndef __HX_POLARSSL_CCM_HPP
+#define __HX_POLARSSL_CCM_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Error codes matching the ones of PolarSSL's own CCM module (ccm.h).
+ */
+#ifndef POLARSSL_ERR_CCM_BAD_INPUT
+    #define POLARSSL_ERR_CCM_BAD_INPUT  -0x000D
+#endif
+
+
+/*
+ * Decrypts and authenticates the input using CCM on top of an AES key schedule.
+ *
+ * Attn: CCM only ever uses the forward cipher, so the AES context must be keyed
+ *       with aes_setkey_enc() for decryption as well.
+ *
+ * See:
+ *   https://polarssl.org/api/ccm_8h.html
+ *
+ * Example:
+ *   value ivArr  = "Array with [0] = length & [1] = nonce
+ *   value addArr = "Array with [0] = length & [1] = additional data
+ *   value ioArr  = "Array with [0] = length & [1] = input & [2] = input offset & [3] = output & [4] = output offset
+ *   value tagArr = "Array with [0] = tag length & [1] = tag & [2] = tag offset
+ *   value ok     = hx_ccm_auth_decrypt(alloc_aes_context(aes_context), ivArr, addArr, ioArr, tagArr);
+ *
+ * Parameters:
+ *   value[k_aes_context]  aes_context the AES context holding the encryption key schedule
+ *   value[Array<Dynamic>] ivArr       Array with [0] = nonce length [Int] (7 - 13) and [1] = nonce [haxe.io.BytesData]
+ *   value[Array<Dynamic>] addArr      Array with [0] = additional data length [Int] and [1] = additional data [haxe.io.BytesData]
+ *   value[Array<Dynamic>] ioArr       Array with [0] = length [Int], [1] = input [haxe.io.BytesData], [2] = input offset [Int],
+ *                                       [3] = output [haxe.io.BytesData] and [4] = output offset [Int]
+ *   value[Array<Dynamic>] tagArr      Array with [0] = tag length [Int] (4 - 16, even), [1] = tag [haxe.io.BytesData] and [2] = tag offset [Int]
+ *
+ * Returns:
+ *   value[Bool] true if the tag is authentic (the output is zeroed otherwise)
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_ccm_auth_decrypt(value aes_context, value ivArr, value addArr, value ioArr, value tagArr);
+
+
+/*
+ * Encrypts and authenticates the input using CCM on top of an AES key schedule.
+ *
+ * Attn: The output is written in place into the provided output buffer (which may be
+ *       the input buffer), and so is the tag.
+ *
+ * See:
+ *   https://polarssl.org/api/ccm_8h.html
+ *
+ * Example:
+ *   value ret = hx_ccm_encrypt_and_tag(alloc_aes_context(aes_context), ivArr, addArr, ioArr, tagArr);
+ *
+ * Parameters:
+ *   value[k_aes_context]  aes_context the AES context holding the encryption key schedule
+ *   value[Array<Dynamic>] ivArr       Array with [0] = nonce length [Int] (7 - 13) and [1] = nonce [haxe.io.BytesData]
+ *   value[Array<Dynamic>] addArr      Array with [0] = additional data length [Int] and [1] = additional data [haxe.io.BytesData]
+ *   value[Array<Dynamic>] ioArr       Array with [0] = length [Int], [1] = input [haxe.io.BytesData], [2] = input offset [Int],
+ *                                       [3] = output [haxe.io.BytesData] and [4] = output offset [Int]
+ *   value[Array<Dynamic>] tagArr      Array with [0] = tag length [Int] (4 - 16, even), [1] = tag [haxe.io.BytesData] and [2] = tag offset [Int]
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_ccm_encrypt_and_tag(value aes_context, value ivArr, value addArr, value ioArr, value tagArr);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_CCM_HPP */
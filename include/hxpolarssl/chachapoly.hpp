@@ -0,0 +1,284 @@
+#ifndef __HX_POLARSSL_CHACHAPOLY_HPP
+#define __HX_POLARSSL_CHACHAPOLY_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHACHA20_BLOCKSIZE      64
+#define CHACHAPOLY_KEY_LENGTH   32
+#define CHACHAPOLY_IV_LENGTH    12
+#define CHACHAPOLY_TAG_LENGTH   16
+
+/*
+ * Maximum length of a message's plain-/ciphertext (256 GiB - 64 bytes); the 32 bit
+ * block counter would wrap around beyond it.
+ */
+#define CHACHAPOLY_MAX_TEXT_LENGTH  ((uint64_t)0xFFFFFFFF * CHACHA20_BLOCKSIZE)
+
+/*
+ * Possible ChaCha20-Poly1305 mode values.
+ */
+#define CHACHAPOLY_DECRYPT  0
+#define CHACHAPOLY_ENCRYPT  1
+
+/*
+ * Error codes matching the ones of the ChaCha20-Poly1305 module of PolarSSL's successor (chachapoly.h).
+ */
+#ifndef POLARSSL_ERR_CHACHAPOLY_BAD_INPUT
+    #define POLARSSL_ERR_CHACHAPOLY_BAD_INPUT    -0x0051
+#endif
+#ifndef POLARSSL_ERR_CHACHAPOLY_BAD_STATE
+    #define POLARSSL_ERR_CHACHAPOLY_BAD_STATE    -0x0054
+#endif
+#ifndef POLARSSL_ERR_CHACHAPOLY_AUTH_FAILED
+    #define POLARSSL_ERR_CHACHAPOLY_AUTH_FAILED  -0x0056
+#endif
+
+
+/*
+ * Internal Poly1305 state (26 bit limbs).
+ */
+typedef struct {
+    uint32_t      r[5];
+    uint32_t      h[5];
+    uint32_t      pad[4];
+    size_t        leftover;
+    unsigned char buffer[16];
+    unsigned char final;
+} s_poly1305;
+
+/*
+ * Internal structure holding the key and the state of the message currently being processed.
+ */
+typedef struct {
+    uint32_t      state[16]; /* constants, key, block counter, nonce */
+    unsigned char keystream[CHACHA20_BLOCKSIZE];
+    size_t        keystream_used;
+    s_poly1305    poly;
+    uint64_t      aad_len;
+    uint64_t      text_len;
+    int           mode;
+    int           stage;
+} s_chachapoly;
+
+
+DECLARE_KIND(k_chachapoly_context);
+
+
+#define alloc_chachapoly_context(v)      alloc_abstract(k_chachapoly_context, v)
+#define malloc_chachapoly_context()      ((s_chachapoly*)alloc_private(sizeof(s_chachapoly)))
+#define val_chachapoly_context(v)        ((s_chachapoly*)val_data(v))
+#define val_check_chachapoly_context(v)  val_check_kind(v, k_chachapoly_context)
+#define val_is_chachapoly_context(v)     val_is_kind(v, k_chachapoly_context)
+
+
+/*
+ * Decrypts and authenticates the input in one call (RFC 8439, section 2.8).
+ *
+ * Attn: Uses its own message state, so a streamed message in progress is not affected.
+ *
+ * See:
+ *   https://tools.ietf.org/html/rfc8439
+ *
+ * Example:
+ *   value ok = hx_chachapoly_auth_decrypt(ctx, [ alloc_int(12), nonce ], [ alloc_int(alen), aad ], [ alloc_int(len), in, alloc_int(0), out, alloc_int(0) ], [ alloc_int(16), tag, alloc_int(0) ]);
+ *
+ * Parameters:
+ *   value[k_chachapoly_context] chachapoly_context the keyed ChaCha20-Poly1305 context
+ *   value[Array]                ivArr              [length:Int, nonce:BytesData] (length == CHACHAPOLY_IV_LENGTH)
+ *   value[Array]                addArr             [length:Int, aad:BytesData]
+ *   value[Array]                ioArr              [length:Int, input:BytesData, inPos:Int, output:BytesData, outPos:Int]
+ *   value[Array]                tagArr             [length:Int, tag:BytesData, tagPos:Int] (length == CHACHAPOLY_TAG_LENGTH)
+ *
+ * Returns:
+ *   value[Bool] true if the data is authentic (the output is zeroed otherwise)
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_chachapoly_auth_decrypt(value chachapoly_context, value ivArr, value addArr, value ioArr, value tagArr);
+
+
+/*
+ * Encrypts and authenticates the input in one call (RFC 8439, section 2.8).
+ *
+ * Attn: Uses its own message state, so a streamed message in progress is not affected.
+ *
+ * See:
+ *   https://tools.ietf.org/html/rfc8439
+ *
+ * Example:
+ *   hx_chachapoly_encrypt_and_tag(ctx, [ alloc_int(12), nonce ], [ alloc_int(alen), aad ], [ alloc_int(len), in, alloc_int(0), out, alloc_int(0) ], [ alloc_int(16), tag, alloc_int(0) ]);
+ *
+ * Parameters:
+ *   value[k_chachapoly_context] chachapoly_context the keyed ChaCha20-Poly1305 context
+ *   value[Array]                ivArr              [length:Int, nonce:BytesData] (length == CHACHAPOLY_IV_LENGTH)
+ *   value[Array]                addArr             [length:Int, aad:BytesData]
+ *   value[Array]                ioArr              [length:Int, input:BytesData, inPos:Int, output:BytesData, outPos:Int]
+ *   value[Array]                tagArr             [length:Int, tag:BytesData, tagPos:Int] (length == CHACHAPOLY_TAG_LENGTH)
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_chachapoly_encrypt_and_tag(value chachapoly_context, value ivArr, value addArr, value ioArr, value tagArr);
+
+
+/*
+ * Finishes the streamed message and returns its authentication tag.
+ *
+ * Example:
+ *   value tag = hx_chachapoly_finish(alloc_chachapoly_context(chachapoly_context));
+ *
+ * Parameters:
+ *   value[k_chachapoly_context] chachapoly_context the ChaCha20-Poly1305 context to use
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the 16 bytes tag
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_chachapoly_finish(value chachapoly_context);
+
+
+/*
+ * Finishes the streamed message and compares its authentication tag to 'tag' in constant time.
+ *
+ * Example:
+ *   value ok = hx_chachapoly_finish_verify(alloc_chachapoly_context(chachapoly_context), buffer_val(tag), buffer_size(tag));
+ *
+ * Parameters:
+ *   value[k_chachapoly_context] chachapoly_context the ChaCha20-Poly1305 context to use
+ *   value[haxe.io.BytesData]    tag                the received tag
+ *   value[Int]                  length             the tag length (== CHACHAPOLY_TAG_LENGTH)
+ *
+ * Returns:
+ *   value[Bool] true if the streamed message is authentic
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_chachapoly_finish_verify(value chachapoly_context, value tag, value length);
+
+
+/*
+ * Wipes the key and message state.
+ *
+ * Example:
+ *   hx_chachapoly_free(alloc_chachapoly_context(chachapoly_context));
+ *
+ * Parameters:
+ *   value[k_chachapoly_context] chachapoly_context the ChaCha20-Poly1305 context to free
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_chachapoly_free(value chachapoly_context);
+
+
+/*
+ * Initializes and returns a new ChaCha20-Poly1305 context.
+ *
+ * Example:
+ *   value chachapoly_context = hx_chachapoly_init();
+ *
+ * Returns:
+ *   value[k_chachapoly_context] the initialized context
+ */
+value hx_chachapoly_init(void);
+
+
+/*
+ * Runs the RFC 8439 known-answer tests (ChaCha20 block, Poly1305 and AEAD).
+ *
+ * Example:
+ *   value ret = hx_chachapoly_self_test(alloc_bool(true));
+ *
+ * Parameters:
+ *   value[Bool] verbose either to output debug information or not
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_chachapoly_self_test(value verbose);
+
+
+/*
+ * Sets the 256 bit key.
+ *
+ * Example:
+ *   hx_chachapoly_setkey(alloc_chachapoly_context(chachapoly_context), buffer_val(key));
+ *
+ * Parameters:
+ *   value[k_chachapoly_context] chachapoly_context the ChaCha20-Poly1305 context to use
+ *   value[haxe.io.BytesData]    key                the key (.length == CHACHAPOLY_KEY_LENGTH)
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_chachapoly_setkey(value chachapoly_context, value key);
+
+
+/*
+ * Starts a new streamed message with the given nonce.
+ *
+ * Example:
+ *   hx_chachapoly_starts(alloc_chachapoly_context(chachapoly_context), buffer_val(nonce), alloc_int(CHACHAPOLY_ENCRYPT));
+ *
+ * Parameters:
+ *   value[k_chachapoly_context] chachapoly_context the keyed ChaCha20-Poly1305 context
+ *   value[haxe.io.BytesData]    nonce              the nonce (.length == CHACHAPOLY_IV_LENGTH)
+ *   value[Int]                  mode               CHACHAPOLY_ENCRYPT or CHACHAPOLY_DECRYPT
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_chachapoly_starts(value chachapoly_context, value nonce, value mode);
+
+
+/*
+ * Encrypts/decrypts the next chunk (any length) of the streamed message.
+ *
+ * Attn: Fails once the message would exceed CHACHAPOLY_MAX_TEXT_LENGTH bytes.
+ *
+ * Example:
+ *   hx_chachapoly_update(ctx, [ alloc_int(len), in, alloc_int(0), out, alloc_int(0) ]);
+ *
+ * Parameters:
+ *   value[k_chachapoly_context] chachapoly_context the ChaCha20-Poly1305 context to use
+ *   value[Array]                ioArr              [length:Int, input:BytesData, inPos:Int, output:BytesData, outPos:Int]
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_chachapoly_update(value chachapoly_context, value ioArr);
+
+
+/*
+ * Feeds the next chunk of additional authenticated data; only valid before the first hx_chachapoly_update().
+ *
+ * Example:
+ *   hx_chachapoly_update_aad(alloc_chachapoly_context(chachapoly_context), buffer_val(aad), buffer_size(aad));
+ *
+ * Parameters:
+ *   value[k_chachapoly_context] chachapoly_context the ChaCha20-Poly1305 context to use
+ *   value[haxe.io.BytesData]    aad                the additional data
+ *   value[Int]                  length             the number of additional data bytes
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_chachapoly_update_aad(value chachapoly_context, value aad, value length);
+
+
+/*
+ * Finalizes the ChaCha20-Poly1305 context by wiping it.
+ *
+ * Example:
+ *   finalize_chachapoly_context(alloc_chachapoly_context(chachapoly_context));
+ *
+ * Parameters:
+ *   value[k_chachapoly_context] chachapoly_context the context to finalize
+ */
+void finalize_chachapoly_context(value chachapoly_context);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_CHACHAPOLY_HPP */
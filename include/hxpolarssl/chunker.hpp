@@ -0,0 +1,118 @@
+#ifndef __HX_POLARSSL_CHUNKER_HPP
+#define __HX_POLARSSL_CHUNKER_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bounds of the chunk size parameters.
+ */
+#define CHUNKER_MIN_SIZE  64
+#define CHUNKER_MAX_SIZE  (1 << 28)
+
+/*
+ * Size of a result record without the digest: offset (uint64) and length (uint32),
+ * both little-endian.
+ */
+#define CHUNKER_RECORD_HEADER  12
+
+
+/*
+ * Internal structure holding the parameters of a content-defined (FastCDC) chunker.
+ */
+typedef struct {
+    uint32_t  min_size;
+    uint32_t  avg_size;
+    uint32_t  max_size;
+    uint64_t  mask_s;  /* stricter mask used below the average size */
+    uint64_t  mask_l;  /* looser mask used above it */
+    md_type_t type;    /* POLARSSL_MD_NONE, POLARSSL_MD_SHA1 or POLARSSL_MD_SHA256 */
+} s_chunker;
+
+
+DECLARE_KIND(k_chunker);
+
+
+#define alloc_chunker(v)      alloc_abstract(k_chunker, v)
+#define malloc_chunker()      ((s_chunker*)alloc_private(sizeof(s_chunker)))
+#define val_chunker(v)        ((s_chunker*)val_data(v))
+#define val_check_chunker(v)  val_check_kind(v, k_chunker)
+#define val_is_chunker(v)     val_is_kind(v, k_chunker)
+
+
+/*
+ * Splits the input bytes into content-defined chunks (the last chunk ends at the end
+ * of the input) and digests each of them.
+ *
+ * Example:
+ *   value chunks = hx_chunker_bytes(chunker, buffer_val(buf), alloc_int(0), buffer_size(buf));
+ *
+ * Parameters:
+ *   value[k_chunker]         chunker the chunker to use
+ *   value[haxe.io.BytesData] bytes   the bytes to split
+ *   value[Int]               pos     the position to start reading at
+ *   value[Int]               length  the number of bytes to split
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the packed records: offset, length and digest of each chunk
+ */
+value hx_chunker_bytes(value chunker, value bytes, value pos, value length);
+
+
+/*
+ * Splits the file specified by 'path' into content-defined chunks and digests each of
+ * them, without passing its content through Haxe.
+ *
+ * Example:
+ *   value chunks = hx_chunker_file(chunker, alloc_string("/some/path"));
+ *
+ * Parameters:
+ *   value[k_chunker] chunker the chunker to use
+ *   value[String]    path    the file path
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the packed records: offset, length and digest of each chunk
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_chunker_file(value chunker, value path);
+
+
+/*
+ * Creates a FastCDC chunker with normalized chunking around the average size.
+ *
+ * See:
+ *   https://www.usenix.org/conference/atc16/technical-sessions/presentation/xia
+ *
+ * Example:
+ *   value chunker = hx_chunker_init(alloc_int(2048), alloc_int(8192), alloc_int(65536), alloc_int(POLARSSL_MD_SHA256));
+ *
+ * Parameters:
+ *   value[Int] min_size the minimum chunk size (>= CHUNKER_MIN_SIZE)
+ *   value[Int] avg_size the average chunk size (>= min_size)
+ *   value[Int] max_size the maximum chunk size (>= avg_size, <= CHUNKER_MAX_SIZE)
+ *   value[Int] type     the md_type_t of the chunk digests (NONE, SHA1 or SHA256)
+ *
+ * Returns:
+ *   value[k_chunker] the chunker
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_chunker_init(value min_size, value avg_size, value max_size, value type);
+
+
+/*
+ * Finalizes the chunker by wiping its parameters.
+ *
+ * Example:
+ *   finalize_chunker(chunker);
+ *
+ * Parameters:
+ *   value[k_chunker] chunker the chunker to finalize
+ */
+void finalize_chunker(value chunker);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_CHUNKER_HPP */
@@ -0,0 +1,318 @@
+#ifndef __HX_POLARSSL_CIPHER_HPP
+#define __HX_POLARSSL_CIPHER_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Maximum length of an authentication tag (GCM).
+ */
+#define CIPHER_MAX_TAG_LENGTH  16
+
+/*
+ * Internal structure bundling the generic cipher context with a partial block buffer.
+ *
+ * PolarSSL's cipher_update() only accepts exactly one block per call in ECB mode and
+ * multiples of the block size (until the last call) in GCM mode; for those modes input
+ * is collected here until a full block is available, so arbitrary-length input can be
+ * streamed through every cipher/mode alike.
+ */
+typedef struct {
+    cipher_context_t cipher;
+    unsigned char    buffer[POLARSSL_MAX_BLOCK_LENGTH];
+    size_t           buffer_len;
+} s_cipher;
+
+
+DECLARE_KIND(k_cipher_context);
+
+
+#define alloc_cipher_context(v)      alloc_abstract(k_cipher_context, v)
+#define malloc_cipher_context()      ((s_cipher*)alloc_private(sizeof(s_cipher)))
+#define val_cipher_context(v)        ((s_cipher*)val_data(v))
+#define val_check_cipher_context(v)  val_check_kind(v, k_cipher_context)
+#define val_is_cipher_context(v)     val_is_kind(v, k_cipher_context)
+
+
+/*
+ * Verifies the authentication tag (GCM only), to be called after hx_cipher_finish().
+ *
+ * See:
+ *   https://polarssl.org/api/cipher_8h.html
+ *
+ * Example:
+ *   value ok = hx_cipher_check_tag(alloc_cipher_context(cipher_context), buffer_val(tag), buffer_size(tag));
+ *
+ * Parameters:
+ *   value[k_cipher_context]  cipher_context the cipher context to use
+ *   value[haxe.io.BytesData] tag            the expected tag
+ *   value[Int]               length         the tag length
+ *
+ * Returns:
+ *   value[Bool] true if the tag matches
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_cipher_check_tag(value cipher_context, value tag, value length);
+
+
+/*
+ * Processes the input still buffered and returns the final output (including padding).
+ *
+ * See:
+ *   https://polarssl.org/api/cipher_8h.html
+ *
+ * Example:
+ *   value out = hx_cipher_finish(alloc_cipher_context(cipher_context));
+ *
+ * Parameters:
+ *   value[k_cipher_context] cipher_context the cipher context to use
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the remaining output bytes
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_cipher_finish(value cipher_context);
+
+
+/*
+ * Frees the cipher context and all resources allocated for it.
+ *
+ * See:
+ *   https://polarssl.org/api/cipher_8h.html
+ *
+ * Example:
+ *   hx_cipher_free(alloc_cipher_context(cipher_context));
+ *
+ * Parameters:
+ *   value[k_cipher_context] cipher_context the cipher context to free
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_cipher_free(value cipher_context);
+
+
+/*
+ * Returns the block size of the selected cipher in bytes (1 for stream ciphers).
+ *
+ * Example:
+ *   value size = hx_cipher_get_block_size(alloc_cipher_context(cipher_context));
+ *
+ * Parameters:
+ *   value[k_cipher_context] cipher_context the cipher context to query
+ *
+ * Returns:
+ *   value[Int] the block size
+ */
+value hx_cipher_get_block_size(value cipher_context);
+
+
+/*
+ * Returns the IV/nonce size of the selected cipher in bytes.
+ *
+ * Example:
+ *   value size = hx_cipher_get_iv_size(alloc_cipher_context(cipher_context));
+ *
+ * Parameters:
+ *   value[k_cipher_context] cipher_context the cipher context to query
+ *
+ * Returns:
+ *   value[Int] the IV size (0 if the mode does not use one)
+ */
+value hx_cipher_get_iv_size(value cipher_context);
+
+
+/*
+ * Returns the key size of the selected cipher in bits.
+ *
+ * Example:
+ *   value size = hx_cipher_get_key_size(alloc_cipher_context(cipher_context));
+ *
+ * Parameters:
+ *   value[k_cipher_context] cipher_context the cipher context to query
+ *
+ * Returns:
+ *   value[Int] the key size in bits
+ */
+value hx_cipher_get_key_size(value cipher_context);
+
+
+/*
+ * Initializes and returns a cipher context for the cipher/mode identified by 'name'.
+ *
+ * See:
+ *   https://polarssl.org/api/cipher_8h.html
+ *
+ * Example:
+ *   value cipher_context = hx_cipher_init(alloc_string("AES-256-CBC"));
+ *
+ * Parameters:
+ *   value[String] name the PolarSSL cipher name (e.g. "AES-128-CTR", "CAMELLIA-256-CBC", "ARC4-128")
+ *
+ * Returns:
+ *   value[k_cipher_context] the initialized cipher context
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_cipher_init(value name);
+
+
+/*
+ * Resets the cipher (and the partial block buffer) to start a new message with the same key.
+ *
+ * See:
+ *   https://polarssl.org/api/cipher_8h.html
+ *
+ * Example:
+ *   value ret = hx_cipher_reset(alloc_cipher_context(cipher_context));
+ *
+ * Parameters:
+ *   value[k_cipher_context] cipher_context the cipher context to reset
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_cipher_reset(value cipher_context);
+
+
+/*
+ * Sets the initialization vector/nonce for the next message.
+ *
+ * See:
+ *   https://polarssl.org/api/cipher_8h.html
+ *
+ * Example:
+ *   value ret = hx_cipher_set_iv(alloc_cipher_context(cipher_context), buffer_val(iv), buffer_size(iv));
+ *
+ * Parameters:
+ *   value[k_cipher_context]  cipher_context the cipher context to use
+ *   value[haxe.io.BytesData] iv             the initialization vector
+ *   value[Int]               length         the IV length
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_cipher_set_iv(value cipher_context, value iv, value length);
+
+
+/*
+ * Sets the padding scheme (CBC mode only).
+ *
+ * See:
+ *   https://polarssl.org/api/cipher_8h.html
+ *
+ * Example:
+ *   value ret = hx_cipher_set_padding(alloc_cipher_context(cipher_context), alloc_int(POLARSSL_PADDING_PKCS7));
+ *
+ * Parameters:
+ *   value[k_cipher_context] cipher_context the cipher context to use
+ *   value[Int]              padding        the cipher_padding_t to use
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_cipher_set_padding(value cipher_context, value padding);
+
+
+/*
+ * Sets the key and the direction the cipher context is used for.
+ *
+ * See:
+ *   https://polarssl.org/api/cipher_8h.html
+ *
+ * Example:
+ *   value ret = hx_cipher_setkey(alloc_cipher_context(cipher_context), buffer_val(key), buffer_size(key), alloc_int(POLARSSL_ENCRYPT));
+ *
+ * Parameters:
+ *   value[k_cipher_context]  cipher_context the cipher context to use
+ *   value[haxe.io.BytesData] key            the key bytes
+ *   value[Int]               length         the key length in bytes
+ *   value[Int]               operation      POLARSSL_ENCRYPT or POLARSSL_DECRYPT
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_cipher_setkey(value cipher_context, value key, value length, value operation);
+
+
+/*
+ * Feeds 'length' bytes of 'input' starting at 'pos' through the cipher.
+ *
+ * Attn: Input that does not fill a complete block is buffered (where the mode requires it)
+ *       and returned by a later call or hx_cipher_finish().
+ *
+ * See:
+ *   https://polarssl.org/api/cipher_8h.html
+ *
+ * Example:
+ *   value out = hx_cipher_update(alloc_cipher_context(cipher_context), buffer_val(in), alloc_int(0), buffer_size(in));
+ *
+ * Parameters:
+ *   value[k_cipher_context]  cipher_context the cipher context to use
+ *   value[haxe.io.BytesData] input          the input bytes
+ *   value[Int]               pos            the offset to start reading at
+ *   value[Int]               length         the number of bytes to process
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the output bytes available so far (may be empty)
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_cipher_update(value cipher_context, value input, value pos, value length);
+
+
+/*
+ * Feeds additional authenticated data (GCM only), to be called after reset and before update.
+ *
+ * See:
+ *   https://polarssl.org/api/cipher_8h.html
+ *
+ * Example:
+ *   value ret = hx_cipher_update_ad(alloc_cipher_context(cipher_context), buffer_val(ad), buffer_size(ad));
+ *
+ * Parameters:
+ *   value[k_cipher_context]  cipher_context the cipher context to use
+ *   value[haxe.io.BytesData] ad             the additional data
+ *   value[Int]               length         the number of additional data bytes
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_cipher_update_ad(value cipher_context, value ad, value length);
+
+
+/*
+ * Returns the authentication tag (GCM only), to be called after hx_cipher_finish().
+ *
+ * See:
+ *   https://polarssl.org/api/cipher_8h.html
+ *
+ * Example:
+ *   value tag = hx_cipher_write_tag(alloc_cipher_context(cipher_context), alloc_int(16));
+ *
+ * Parameters:
+ *   value[k_cipher_context] cipher_context the cipher context to use
+ *   value[Int]              length         the tag length (0 to CIPHER_MAX_TAG_LENGTH)
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the tag
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_cipher_write_tag(value cipher_context, value length);
+
+
+/*
+ * Finalizes the cipher context by freeing associated memory.
+ *
+ * Example:
+ *   finalize_cipher_context(alloc_cipher_context(cipher_context));
+ *
+ * Parameters:
+ *   value[k_cipher_context] cipher_context the cipher context to finalize
+ */
+void finalize_cipher_context(value cipher_context);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_CIPHER_HPP */
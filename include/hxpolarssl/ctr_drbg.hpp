@@ -0,0 +1,244 @@
+#ifndef __HX_POLARSSL_CTR_DRBG_HPP
+#define __HX_POLARSSL_CTR_DRBG_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Internal structure bundling the CTR_DRBG with the entropy pool it is seeded from.
+ *
+ * The DRBG keeps a pointer to the entropy context, so the structure is malloc'ed
+ * (and never moved) rather than allocated on the GC heap.
+ */
+typedef struct {
+    entropy_context  entropy;
+    ctr_drbg_context ctr_drbg;
+} s_ctr_drbg;
+
+
+/*
+ * Internal structure describing the random number generator to pass to PolarSSL.
+ *
+ * Uses the CTR_DRBG if one is provided and falls back to HAVEGE otherwise.
+ */
+typedef struct {
+    int   (*f_rng)(void*, unsigned char*, size_t);
+    void* p_rng;
+    int   has_havege;
+    havege_state havege;
+} s_rng;
+
+
+DECLARE_KIND(k_ctr_drbg_context);
+
+
+#define alloc_ctr_drbg_context(v)      alloc_abstract(k_ctr_drbg_context, v)
+#define malloc_ctr_drbg_context()      ((s_ctr_drbg*)malloc(sizeof(s_ctr_drbg)))
+#define val_ctr_drbg_context(v)        ((s_ctr_drbg*)val_data(v))
+#define val_check_ctr_drbg_context(v)  val_check_kind(v, k_ctr_drbg_context)
+#define val_is_ctr_drbg_context(v)     val_is_kind(v, k_ctr_drbg_context)
+
+
+/*
+ * Writes 'length' random bytes into 'bytes' starting at offset 'pos'.
+ *
+ * Attn: No new Bytes are allocated; the caller's buffer is modified in place.
+ *
+ * See:
+ *   https://polarssl.org/api/ctr__drbg_8h.html
+ *
+ * Example:
+ *   hx_ctr_drbg_fill(alloc_ctr_drbg_context(ctr_drbg_context), buffer_val(buf), alloc_int(0), alloc_int(16));
+ *
+ * Parameters:
+ *   value[k_ctr_drbg_context] ctr_drbg_context the CTR_DRBG context to use
+ *   value[haxe.io.BytesData]  bytes            the buffer to write into
+ *   value[Int]                pos              the offset to start writing at
+ *   value[Int]                length           the number of random bytes to write
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_ctr_drbg_fill(value ctr_drbg_context, value bytes, value pos, value length);
+
+
+/*
+ * Frees the CTR_DRBG context and all resources allocated for it.
+ *
+ * See:
+ *   https://polarssl.org/api/ctr__drbg_8h.html
+ *
+ * Example:
+ *   hx_ctr_drbg_free(alloc_ctr_drbg_context(ctr_drbg_context));
+ *
+ * Parameters:
+ *   value[k_ctr_drbg_context] ctr_drbg_context the CTR_DRBG context to free
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_ctr_drbg_free(value ctr_drbg_context);
+
+
+/*
+ * Initializes an entropy pool and returns a CTR_DRBG context seeded from it.
+ *
+ * See:
+ *   https://polarssl.org/api/ctr__drbg_8h.html
+ *
+ * Example:
+ *   value ctr_drbg_context = hx_ctr_drbg_init(buffer_val(custom), buffer_size(custom));
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] custom the personalization data (device specific identifiers)
+ *   value[Int]               length the number of personalization bytes
+ *
+ * Returns:
+ *   value[k_ctr_drbg_context] the initialized CTR_DRBG context
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_ctr_drbg_init(value custom, value length);
+
+
+/*
+ * Returns an 'nbytes' long series of random bytes.
+ *
+ * See:
+ *   https://polarssl.org/api/ctr__drbg_8h.html
+ *
+ * Example:
+ *   value rand = hx_ctr_drbg_random(alloc_ctr_drbg_context(ctr_drbg_context), alloc_int(32));
+ *
+ * Parameters:
+ *   value[k_ctr_drbg_context] ctr_drbg_context the CTR_DRBG context to use
+ *   value[Int]                nbytes           the number of random bytes to generate
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the generated bytes
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_ctr_drbg_random(value ctr_drbg_context, value nbytes);
+
+
+/*
+ * Reseeds the CTR_DRBG from the entropy pool (and optional additional data).
+ *
+ * See:
+ *   https://polarssl.org/api/ctr__drbg_8h.html
+ *
+ * Example:
+ *   value ret = hx_ctr_drbg_reseed(alloc_ctr_drbg_context(ctr_drbg_context), buffer_val(add), buffer_size(add));
+ *
+ * Parameters:
+ *   value[k_ctr_drbg_context] ctr_drbg_context the CTR_DRBG context to reseed
+ *   value[haxe.io.BytesData]  additional       the additional data
+ *   value[Int]                length           the number of additional bytes
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_ctr_drbg_reseed(value ctr_drbg_context, value additional, value length);
+
+
+/*
+ * Runs various health checks to ensure the CTR_DRBG module works correctly.
+ *
+ * See:
+ *   https://polarssl.org/api/ctr__drbg_8h.html
+ *
+ * Example:
+ *   value ret = hx_ctr_drbg_self_test(alloc_bool(false));
+ *   if (val_int(ret) == 0) {
+ *       // everthing good
+ *   }
+ *
+ * Parameters:
+ *   value[Bool] verbose output debug information or not
+ *
+ * Returns:
+ *   value[Int] the self test's return code (0 = OK).
+ *     In case of an error, a Neko error is raised too.
+ */
+value hx_ctr_drbg_self_test(value verbose);
+
+
+/*
+ * Enables or disables prediction resistance (reseeding before every request).
+ *
+ * See:
+ *   https://polarssl.org/api/ctr__drbg_8h.html
+ *
+ * Example:
+ *   hx_ctr_drbg_set_prediction_resistance(alloc_ctr_drbg_context(ctr_drbg_context), alloc_bool(true));
+ *
+ * Parameters:
+ *   value[k_ctr_drbg_context] ctr_drbg_context the CTR_DRBG context to configure
+ *   value[Bool]               resistance       to enable prediction resistance or not
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_ctr_drbg_set_prediction_resistance(value ctr_drbg_context, value resistance);
+
+
+/*
+ * Sets the number of requests after which the CTR_DRBG reseeds automatically.
+ *
+ * See:
+ *   https://polarssl.org/api/ctr__drbg_8h.html
+ *
+ * Example:
+ *   hx_ctr_drbg_set_reseed_interval(alloc_ctr_drbg_context(ctr_drbg_context), alloc_int(10000));
+ *
+ * Parameters:
+ *   value[k_ctr_drbg_context] ctr_drbg_context the CTR_DRBG context to configure
+ *   value[Int]                interval         the reseed interval
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_ctr_drbg_set_reseed_interval(value ctr_drbg_context, value interval);
+
+
+/*
+ * Finalizes the CTR_DRBG context by freeing associated memory.
+ *
+ * Example:
+ *   finalize_ctr_drbg_context(alloc_ctr_drbg_context(ctr_drbg_context));
+ *
+ * Parameters:
+ *   value[k_ctr_drbg_context] ctr_drbg_context the CTR_DRBG context to finalize
+ */
+void finalize_ctr_drbg_context(value ctr_drbg_context);
+
+
+/*
+ * Resolves the random number generator to use from the (nullable) Haxe value.
+ *
+ * Example:
+ *   s_rng rng;
+ *   rng_fromHaxe(rng_value, &rng);
+ *   ret = rsa_gen_key(context, rng.f_rng, rng.p_rng, 2048, 65537);
+ *   rng_free(&rng);
+ *
+ * Parameters:
+ *   value[k_ctr_drbg_context] rng the CTR_DRBG context to use, or null for HAVEGE
+ *   s_rng*                    out the structure to initialize
+ */
+void rng_fromHaxe(value rng, s_rng* out);
+
+
+/*
+ * Frees the resources allocated by rng_fromHaxe().
+ *
+ * Parameters:
+ *   s_rng* rng the structure initialized by rng_fromHaxe()
+ */
+void rng_free(s_rng* rng);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_CTR_DRBG_HPP */
@@ -0,0 +1,241 @@
+#ifndef __HX_POLARSSL_DHM_HPP
+#define __HX_POLARSSL_DHM_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Identifiers of the well-known groups accepted by hx_dhm_use_known_group().
+ */
+#define DHM_GROUP_RFC3526_MODP_2048  0
+#define DHM_GROUP_RFC3526_MODP_3072  1
+#define DHM_GROUP_RFC5114_MODP_2048  2
+
+
+DECLARE_KIND(k_dhm_context);
+
+
+#define alloc_dhm_context(v)      alloc_abstract(k_dhm_context, v)
+#define malloc_dhm_context()      ((dhm_context*)alloc_private(sizeof(dhm_context)))
+#define val_dhm_context(v)        ((dhm_context*)val_data(v))
+#define val_check_dhm_context(v)  val_check_kind(v, k_dhm_context)
+#define val_is_dhm_context(v)     val_is_kind(v, k_dhm_context)
+
+
+/*
+ * Derives the shared secret from our secret value and the peer's public value.
+ *
+ * Attn: The blinding values are kept within the context and cheaply updated on further
+ *       calls with the same secret value X; a new X (i.e. a new exchange) recomputes them.
+ *
+ * See:
+ *   https://polarssl.org/api/dhm_8h.html
+ *
+ * Example:
+ *   value K = hx_dhm_calc_secret(alloc_dhm_context(dhm_context), alloc_null());
+ *
+ * Parameters:
+ *   value[k_dhm_context] dhm_context the DHM context to use
+ *   value[k_ctr_drbg_context|null] rng the random number generator to use for blinding (null for HAVEGE)
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the shared secret
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_dhm_calc_secret(value dhm_context, value rng);
+
+
+/*
+ * Frees the DHM context and all resources allocated for it.
+ *
+ * See:
+ *   https://polarssl.org/api/dhm_8h.html
+ *
+ * Example:
+ *   hx_dhm_free(alloc_dhm_context(dhm_context));
+ *
+ * Parameters:
+ *   value[k_dhm_context] dhm_context the DHM context to free
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_dhm_free(value dhm_context);
+
+
+/*
+ * Initializes and returns a DHM context.
+ *
+ * See:
+ *   https://polarssl.org/api/dhm_8h.html
+ *
+ * Example:
+ *   value dhm_context = hx_dhm_init();
+ *
+ * Returns:
+ *   value[k_dhm_context] the initialized DHM context
+ */
+value hx_dhm_init(void);
+
+
+/*
+ * Generates a new secret value and returns the ServerDHParams (P, G and our public value).
+ *
+ * See:
+ *   https://polarssl.org/api/dhm_8h.html
+ *
+ * Example:
+ *   value params = hx_dhm_make_params(alloc_dhm_context(dhm_context), alloc_int(0), alloc_null());
+ *
+ * Parameters:
+ *   value[k_dhm_context] dhm_context the DHM context to use (its group must be set)
+ *   value[Int]           x_size      the size of the secret value in bytes (<= 0 for the size of P)
+ *   value[k_ctr_drbg_context|null] rng the random number generator to use (null for HAVEGE)
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the TLS ServerDHParams encoded bytes
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_dhm_make_params(value dhm_context, value x_size, value rng);
+
+
+/*
+ * Generates a new secret value and returns our public value (G^X mod P).
+ *
+ * See:
+ *   https://polarssl.org/api/dhm_8h.html
+ *
+ * Example:
+ *   value GX = hx_dhm_make_public(alloc_dhm_context(dhm_context), alloc_int(0), alloc_null());
+ *
+ * Parameters:
+ *   value[k_dhm_context] dhm_context the DHM context to use (its group must be set)
+ *   value[Int]           x_size      the size of the secret value in bytes (<= 0 for the size of P)
+ *   value[k_ctr_drbg_context|null] rng the random number generator to use (null for HAVEGE)
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the public value (padded to the size of P)
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_dhm_make_public(value dhm_context, value x_size, value rng);
+
+
+/*
+ * Parses the ServerDHParams (P, G and the peer's public value).
+ *
+ * Attn: The cached group values are only dropped if the received P differs from the current one.
+ *
+ * See:
+ *   https://polarssl.org/api/dhm_8h.html
+ *
+ * Example:
+ *   value ret = hx_dhm_read_params(alloc_dhm_context(dhm_context), buffer_val(params), buffer_size(params));
+ *
+ * Parameters:
+ *   value[k_dhm_context]     dhm_context the DHM context to use
+ *   value[haxe.io.BytesData] params      the TLS ServerDHParams encoded bytes
+ *   value[Int]               length      the number of params bytes
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_dhm_read_params(value dhm_context, value params, value length);
+
+
+/*
+ * Imports the peer's public value.
+ *
+ * See:
+ *   https://polarssl.org/api/dhm_8h.html
+ *
+ * Example:
+ *   value ret = hx_dhm_read_public(alloc_dhm_context(dhm_context), buffer_val(GY), buffer_size(GY));
+ *
+ * Parameters:
+ *   value[k_dhm_context]     dhm_context the DHM context to use
+ *   value[haxe.io.BytesData] input       the peer's public value
+ *   value[Int]               length      the number of input bytes
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_dhm_read_public(value dhm_context, value input, value length);
+
+
+/*
+ * Runs various health checks to ensure the DHM module works correctly.
+ *
+ * See:
+ *   https://polarssl.org/api/dhm_8h.html
+ *
+ * Example:
+ *   value ret = hx_dhm_self_test(alloc_bool(false));
+ *   if (val_int(ret) == 0) {
+ *       // everthing good
+ *   }
+ *
+ * Parameters:
+ *   value[Bool] verbose output debug information or not
+ *
+ * Returns:
+ *   value[Int] the self test's return code (0 = OK).
+ *     In case of an error, a Neko error is raised too.
+ */
+value hx_dhm_self_test(value verbose);
+
+
+/*
+ * Sets the group parameters (prime modulus P and generator G).
+ *
+ * Attn: Setting the group the context already uses is a no-op, so the precomputed
+ *       Montgomery value (R^2 mod P) stays cached.
+ *
+ * Example:
+ *   value ret = hx_dhm_set_group(alloc_dhm_context(dhm_context), buffer_val(P), buffer_size(P), buffer_val(G), buffer_size(G));
+ *
+ * Parameters:
+ *   value[k_dhm_context]     dhm_context the DHM context to use
+ *   value[haxe.io.BytesData] P           the big-endian prime modulus
+ *   value[Int]               Plen        the number of P bytes
+ *   value[haxe.io.BytesData] G           the big-endian generator
+ *   value[Int]               Glen        the number of G bytes
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_dhm_set_group(value dhm_context, value P, value Plen, value G, value Glen);
+
+
+/*
+ * Sets one of the well-known group parameters (see DHM_GROUP_*).
+ *
+ * Example:
+ *   value ret = hx_dhm_use_known_group(alloc_dhm_context(dhm_context), alloc_int(DHM_GROUP_RFC3526_MODP_2048));
+ *
+ * Parameters:
+ *   value[k_dhm_context] dhm_context the DHM context to use
+ *   value[Int]           group_id    the DHM_GROUP_* identifier
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_dhm_use_known_group(value dhm_context, value group_id);
+
+
+/*
+ * Finalizes the DHM context by freeing associated memory.
+ *
+ * Example:
+ *   finalize_dhm_context(alloc_dhm_context(dhm_context));
+ *
+ * Parameters:
+ *   value[k_dhm_context] dhm_context the DHM context to free
+ */
+void finalize_dhm_context(value dhm_context);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_DHM_HPP */
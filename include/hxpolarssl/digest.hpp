@@ -0,0 +1,194 @@
+#ifndef __HX_POLARSSL_DIGEST_HPP
+#define __HX_POLARSSL_DIGEST_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Version of the serialized digest state layout (first byte of a saved state).
+ */
+#define DIGEST_STATE_VERSION  1
+
+
+/*
+ * Internal structure holding a running digest of any of the supported algorithms.
+ */
+typedef struct {
+    md_type_t type;
+    union {
+        md5_context       md5;
+        sha1_context      sha1;
+        sha256_context    sha256;
+        sha512_context    sha512;
+        ripemd160_context ripemd160;
+    } ctx;
+} s_digest;
+
+
+DECLARE_KIND(k_digest_context);
+
+
+#define alloc_digest_context(v)      alloc_abstract(k_digest_context, v)
+#define malloc_digest_context()      ((s_digest*)alloc_private(sizeof(s_digest)))
+#define val_digest_context(v)        ((s_digest*)val_data(v))
+#define val_check_digest_context(v)  val_check_kind(v, k_digest_context)
+#define val_is_digest_context(v)     val_is_kind(v, k_digest_context)
+
+
+/*
+ * Returns an independent copy of the running digest, e.g. to get the sum of the data
+ * hashed so far while continuing to hash.
+ *
+ * Example:
+ *   value copy = hx_digest_clone(digest);
+ *   value sum  = hx_digest_finish(copy);
+ *
+ * Parameters:
+ *   value[k_digest_context] digest the digest to copy
+ *
+ * Returns:
+ *   value[k_digest_context] the copy
+ */
+value hx_digest_clone(value digest);
+
+
+/*
+ * Returns the sum of all data hashed and restarts the digest.
+ *
+ * See:
+ *   https://polarssl.org/api/md_8h.html
+ *
+ * Example:
+ *   value sum = hx_digest_finish(digest);
+ *
+ * Parameters:
+ *   value[k_digest_context] digest the digest to finish
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the sum (truncated for SHA-224 and SHA-384)
+ */
+value hx_digest_finish(value digest);
+
+
+/*
+ * Initializes and returns a new running digest.
+ *
+ * Example:
+ *   value digest = hx_digest_init(alloc_int(POLARSSL_MD_SHA256));
+ *
+ * Parameters:
+ *   value[Int] type the md_type_t algorithm (MD5, SHA1, SHA224, SHA256, SHA384, SHA512 or RIPEMD160)
+ *
+ * Returns:
+ *   value[k_digest_context] the initialized digest
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_digest_init(value type);
+
+
+/*
+ * Returns the number of bytes hashed since the digest was started.
+ *
+ * Example:
+ *   value length = hx_digest_length(digest);
+ *
+ * Parameters:
+ *   value[k_digest_context] digest the digest to query
+ *
+ * Returns:
+ *   value[Float] the number of bytes hashed
+ */
+value hx_digest_length(value digest);
+
+
+/*
+ * Recreates a running digest from a state returned by hx_digest_save().
+ *
+ * Attn: The state is portable between platforms and builds, but only covers the
+ *       hashed data; it is not authenticated.
+ *
+ * Example:
+ *   value digest = hx_digest_restore(buffer_val(state), buffer_size(state));
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] state  the saved state
+ *   value[Int]               length the length of the state
+ *
+ * Returns:
+ *   value[k_digest_context] the restored digest
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_digest_restore(value state, value length);
+
+
+/*
+ * Serializes the internal state (midstate, bit count and buffered tail) of the digest.
+ *
+ * The layout is: version (1 byte), md_type_t (1 byte), hashed length, the chaining
+ * state words and the bytes of the incomplete block (all big-endian); at most 209 bytes.
+ *
+ * Example:
+ *   value state = hx_digest_save(digest);
+ *
+ * Parameters:
+ *   value[k_digest_context] digest the digest to save
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the state
+ */
+value hx_digest_save(value digest);
+
+
+/*
+ * Hashes the next chunk of data.
+ *
+ * Example:
+ *   hx_digest_update(digest, buffer_val(buf), alloc_int(0), buffer_size(buf));
+ *
+ * Parameters:
+ *   value[k_digest_context]  digest the digest to update
+ *   value[haxe.io.BytesData] bytes  the bytes to hash
+ *   value[Int]               pos    the position to start reading at
+ *   value[Int]               length the number of bytes to hash
+ */
+value hx_digest_update(value digest, value bytes, value pos, value length);
+
+
+/*
+ * Hashes the file specified by 'path' from 'offset' on to its end, without passing its
+ * content through Haxe.
+ *
+ * Attn: If reading the file fails, the digest is left unchanged.
+ *
+ * Example:
+ *   value hashed = hx_digest_update_file(digest, alloc_string("journal.log"), hx_digest_length(digest));
+ *
+ * Parameters:
+ *   value[k_digest_context] digest the digest to update
+ *   value[String]           path   the file path
+ *   value[Float]            offset the position to start reading at
+ *
+ * Returns:
+ *   value[Float] the number of bytes hashed
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_digest_update_file(value digest, value path, value offset);
+
+
+/*
+ * Finalizes the digest by wiping its state.
+ *
+ * Example:
+ *   finalize_digest_context(digest);
+ *
+ * Parameters:
+ *   value[k_digest_context] digest the digest to finalize
+ */
+void finalize_digest_context(value digest);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_DIGEST_HPP */
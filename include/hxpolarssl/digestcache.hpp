@@ -0,0 +1,200 @@
+#ifndef __HX_POLARSSL_DIGESTCACHE_HPP
+#define __HX_POLARSSL_DIGESTCACHE_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Magic/version of the on-disk index, its default number of slots and the slots probed
+ * per lookup before the home slot of a key gets evicted.
+ */
+#define DIGESTCACHE_MAGIC             0x43445848  /* "HXDC" in little-endian */
+#define DIGESTCACHE_VERSION           2
+#define DIGESTCACHE_DEFAULT_CAPACITY  4096
+#define DIGESTCACHE_MAX_CAPACITY      (1 << 24)
+#define DIGESTCACHE_PROBES            16
+
+/*
+ * Files modified (or changed) less than this many nanoseconds before they are hashed
+ * are not cached, as a further write within the file system's timestamp granularity
+ * would go unnoticed.
+ */
+#define DIGESTCACHE_RACY_NS  2000000000LL
+
+
+/*
+ * Header at the start of the index file.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;   /* number of slots, a power of 2 */
+    uint32_t entries;    /* number of used slots */
+    uint32_t slot_size;  /* sizeof(s_digestcache_slot), guards against layout changes */
+    unsigned char reserved[44];
+} s_digestcache_header;
+
+/*
+ * Index slot holding the digest of one file for one algorithm.
+ */
+typedef struct {
+    uint64_t      dev;
+    uint64_t      ino;
+    uint64_t      size;
+    int64_t       mtime_ns;
+    int64_t       ctime_ns;
+    uint32_t      check;    /* checksum over the other fields, detects torn writes */
+    uint8_t       type;     /* md_type_t, 0 = unused slot */
+    uint8_t       sum_len;
+    uint8_t       reserved[2];
+    unsigned char sum[64];
+} s_digestcache_slot;
+
+/*
+ * Internal structure holding an opened (memory-mapped) index.
+ */
+typedef struct {
+    int                   fd;
+    unsigned char*        map;
+    size_t                map_size;
+    s_digestcache_header* header;
+    s_digestcache_slot*   slots;
+    uint64_t              hits;
+    uint64_t              misses;
+    uint64_t              evictions;
+} s_digestcache;
+
+
+DECLARE_KIND(k_digestcache);
+
+
+#define alloc_digestcache(v)      alloc_abstract(k_digestcache, v)
+#define malloc_digestcache()      ((s_digestcache*)alloc_private(sizeof(s_digestcache)))
+#define val_digestcache(v)        ((s_digestcache*)val_data(v))
+#define val_check_digestcache(v)  val_check_kind(v, k_digestcache)
+#define val_is_digestcache(v)     val_is_kind(v, k_digestcache)
+
+
+/*
+ * Removes all entries from the index (holding an flock() on the index file).
+ *
+ * Example:
+ *   hx_digestcache_clear(cache);
+ *
+ * Parameters:
+ *   value[k_digestcache] cache the cache to clear
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_digestcache_clear(value cache);
+
+
+/*
+ * Flushes and unmaps the index; the cache cannot be used afterwards.
+ *
+ * Example:
+ *   hx_digestcache_close(cache);
+ *
+ * Parameters:
+ *   value[k_digestcache] cache the cache to close
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_digestcache_close(value cache);
+
+
+/*
+ * Removes the entries (of all algorithms) of the file specified by 'path' (holding an
+ * flock() on the index file).
+ *
+ * Example:
+ *   value removed = hx_digestcache_invalidate(cache, alloc_string("/some/path"));
+ *
+ * Parameters:
+ *   value[k_digestcache] cache the cache to update
+ *   value[String]        path  the file path
+ *
+ * Returns:
+ *   value[Int] the number of removed entries (0 if the file does not exist)
+ */
+value hx_digestcache_invalidate(value cache, value path);
+
+
+/*
+ * Opens (or creates) the index file specified by 'path' and maps it into memory.
+ *
+ * Attn: An existing index keeps its capacity; a corrupt one (or one written by a
+ *       build with a different layout) is reinitialized. Not supported on Windows.
+ *
+ * Example:
+ *   value cache = hx_digestcache_open(alloc_string("/var/cache/digests.idx"), alloc_int(4096));
+ *
+ * Parameters:
+ *   value[String] path     the index file path
+ *   value[Int]    capacity the number of slots for a new index (rounded up to a power of 2)
+ *
+ * Returns:
+ *   value[k_digestcache] the opened cache
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_digestcache_open(value path, value capacity);
+
+
+/*
+ * Returns the cache statistics.
+ *
+ * Example:
+ *   value stats = hx_digestcache_stats(cache);
+ *
+ * Parameters:
+ *   value[k_digestcache] cache the cache to query
+ *
+ * Returns:
+ *   value[Array<Int>] [hits, misses, evictions, size, capacity] (hits to evictions are per process)
+ */
+value hx_digestcache_stats(value cache);
+
+
+/*
+ * Returns the digest of the file specified by 'path', from the index if the file's
+ * device, inode, size, modification and change time are unchanged, or by hashing (and caching) it.
+ *
+ * Attn: The index file is locked with flock() while the sum is stored.
+ *
+ * See:
+ *   https://polarssl.org/api/md_8h.html
+ *
+ * Example:
+ *   value sum = hx_digestcache_sum_file(cache, alloc_string("/some/path"), alloc_int(POLARSSL_MD_SHA256));
+ *
+ * Parameters:
+ *   value[k_digestcache] cache the cache to use
+ *   value[String]        path  the file path
+ *   value[Int]           type  the md_type_t algorithm
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the digest of the file
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_digestcache_sum_file(value cache, value path, value type);
+
+
+/*
+ * Finalizes the cache by closing it (if not already done).
+ *
+ * Example:
+ *   finalize_digestcache(cache);
+ *
+ * Parameters:
+ *   value[k_digestcache] cache the cache to finalize
+ */
+void finalize_digestcache(value cache);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_DIGESTCACHE_HPP */
@@ -0,0 +1,134 @@
+#ifndef __HX_POLARSSL_ECDH_HPP
+#define __HX_POLARSSL_ECDH_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+DECLARE_KIND(k_ecdh_context);
+
+
+#define alloc_ecdh_context(v)      alloc_abstract(k_ecdh_context, v)
+#define malloc_ecdh_context()      ((ecdh_context*)alloc_private(sizeof(ecdh_context)))
+#define val_ecdh_context(v)        ((ecdh_context*)val_data(v))
+#define val_check_ecdh_context(v)  val_check_kind(v, k_ecdh_context)
+#define val_is_ecdh_context(v)     val_is_kind(v, k_ecdh_context)
+
+
+/*
+ * Computes the shared secret between the context's private key and the peer's public key.
+ *
+ * See:
+ *   https://polarssl.org/api/ecdh_8h.html
+ *
+ * Example:
+ *   value z = hx_ecdh_compute_shared(alloc_ecdh_context(ecdh_context), buffer_val(point), buffer_size(point), alloc_null());
+ *
+ * Parameters:
+ *   value[k_ecdh_context]    ecdh_context the ECDH context holding our keypair
+ *   value[haxe.io.BytesData] point        the peer's public point (uncompressed format)
+ *   value[Int]               length       the number of point bytes
+ *   value[k_ctr_drbg_context|null] rng   the random number generator to use for blinding (null for HAVEGE)
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the shared secret (padded to the curve's size)
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_ecdh_compute_shared(value ecdh_context, value point, value length, value rng);
+
+
+/*
+ * Frees the ECDH context and all resources allocated for it.
+ *
+ * See:
+ *   https://polarssl.org/api/ecdh_8h.html
+ *
+ * Example:
+ *   hx_ecdh_free(alloc_ecdh_context(ecdh_context));
+ *
+ * Parameters:
+ *   value[k_ecdh_context] ecdh_context the ECDH context to free
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_ecdh_free(value ecdh_context);
+
+
+/*
+ * Generates a new ephemeral keypair on the curve identified by 'grp_id'.
+ *
+ * Attn: If the context is already bound to the same curve, the group (and the
+ *       comb table PolarSSL precomputed for its generator) is kept and reused.
+ *
+ * See:
+ *   https://polarssl.org/api/ecdh_8h.html
+ *
+ * Example:
+ *   value Q = hx_ecdh_gen_public(alloc_ecdh_context(ecdh_context), alloc_int(POLARSSL_ECP_DP_SECP256R1), alloc_null());
+ *
+ * Parameters:
+ *   value[k_ecdh_context] ecdh_context the ECDH context for which a keypair should be generated
+ *   value[Int]            grp_id       the ecp_group_id of the curve to use
+ *   value[k_ctr_drbg_context|null] rng the random number generator to use (null for HAVEGE)
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the generated public point (uncompressed format)
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_ecdh_gen_public(value ecdh_context, value grp_id, value rng);
+
+
+/*
+ * Initializes and returns an ECDH context.
+ *
+ * See:
+ *   https://polarssl.org/api/ecdh_8h.html
+ *
+ * Example:
+ *   value ecdh_context = hx_ecdh_init();
+ *
+ * Returns:
+ *   value[k_ecdh_context] the initialized ECDH context
+ */
+value hx_ecdh_init(void);
+
+
+/*
+ * Runs various health checks to ensure the ECDH module works correctly.
+ *
+ * See:
+ *   https://polarssl.org/api/ecdh_8h.html
+ *
+ * Example:
+ *   value ret = hx_ecdh_self_test(alloc_bool(false));
+ *   if (val_int(ret) == 0) {
+ *       // everthing good
+ *   }
+ *
+ * Parameters:
+ *   value[Bool] verbose output debug information or not
+ *
+ * Returns:
+ *   value[Int] the self test's return code (0 = OK).
+ *     In case of an error, a Neko error is raised too.
+ */
+value hx_ecdh_self_test(value verbose);
+
+
+/*
+ * Finalizes the ECDH context by freeing associated memory.
+ *
+ * Example:
+ *   finalize_ecdh_context(alloc_ecdh_context(ecdh_context));
+ *
+ * Parameters:
+ *   value[k_ecdh_context] ecdh_context the ECDH context to free
+ */
+void finalize_ecdh_context(value ecdh_context);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_ECDH_HPP */
@@ -0,0 +1,235 @@
+#ifndef __HX_POLARSSL_ECDSA_HPP
+#define __HX_POLARSSL_ECDSA_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ECDSA_SIGNATURE_MAXSIZE  (3 + 2 * (3 + POLARSSL_ECP_MAX_BYTES)) /* DER encoded (r, s) */
+
+
+DECLARE_KIND(k_ecdsa_context);
+
+
+#define alloc_ecdsa_context(v)      alloc_abstract(k_ecdsa_context, v)
+#define malloc_ecdsa_context()      ((ecdsa_context*)alloc_private(sizeof(ecdsa_context)))
+#define val_ecdsa_context(v)        ((ecdsa_context*)val_data(v))
+#define val_check_ecdsa_context(v)  val_check_kind(v, k_ecdsa_context)
+#define val_is_ecdsa_context(v)     val_is_kind(v, k_ecdsa_context)
+
+
+/*
+ * Frees the ECDSA context and all resources allocated for it.
+ *
+ * See:
+ *   https://polarssl.org/api/ecdsa_8h.html
+ *
+ * Example:
+ *   hx_ecdsa_free(alloc_ecdsa_context(ecdsa_context));
+ *
+ * Parameters:
+ *   value[k_ecdsa_context] ecdsa_context the ECDSA context to free
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_ecdsa_free(value ecdsa_context);
+
+
+/*
+ * Generates a new ECDSA keypair on the curve identified by 'grp_id'.
+ *
+ * Attn: If the context is already bound to the same curve, the group (and the
+ *       comb table PolarSSL precomputed for its generator) is kept and reused.
+ *
+ * See:
+ *   https://polarssl.org/api/ecdsa_8h.html
+ *
+ * Example:
+ *   value ret = hx_ecdsa_genkey(alloc_ecdsa_context(ecdsa_context), alloc_int(POLARSSL_ECP_DP_SECP256R1), alloc_null());
+ *   if (val_int(ret) == 0) {
+ *       // everything good
+ *   }
+ *
+ * Parameters:
+ *   value[k_ecdsa_context] ecdsa_context the ECDSA context for which a keypair should be generated
+ *   value[Int]             grp_id        the ecp_group_id of the curve to use
+ *   value[k_ctr_drbg_context|null] rng  the random number generator to use (null for HAVEGE)
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_ecdsa_genkey(value ecdsa_context, value grp_id, value rng);
+
+
+/*
+ * Returns the ECDSA context's private key (the secret scalar d).
+ *
+ * Example:
+ *   value d = hx_ecdsa_get_private(alloc_ecdsa_context(ecdsa_context));
+ *
+ * Parameters:
+ *   value[k_ecdsa_context] ecdsa_context the ECDSA context for which the private key should be returned
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the private key in bytes
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_ecdsa_get_private(value ecdsa_context);
+
+
+/*
+ * Returns the ECDSA context's public key (the point Q) in uncompressed format.
+ *
+ * Example:
+ *   value Q = hx_ecdsa_get_public(alloc_ecdsa_context(ecdsa_context));
+ *
+ * Parameters:
+ *   value[k_ecdsa_context] ecdsa_context the ECDSA context for which the public key should be returned
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the public key in bytes
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_ecdsa_get_public(value ecdsa_context);
+
+
+/*
+ * Initializes and returns an ECDSA context.
+ *
+ * See:
+ *   https://polarssl.org/api/ecdsa_8h.html
+ *
+ * Example:
+ *   value ecdsa_context = hx_ecdsa_init();
+ *
+ * Returns:
+ *   value[k_ecdsa_context] the initialized ECDSA context
+ */
+value hx_ecdsa_init(void);
+
+
+/*
+ * Runs various health checks to ensure the ECP module ECDSA is built on works correctly.
+ *
+ * See:
+ *   https://polarssl.org/api/ecp_8h.html
+ *
+ * Example:
+ *   value ret = hx_ecdsa_self_test(alloc_bool(false));
+ *   if (val_int(ret) == 0) {
+ *       // everthing good
+ *   }
+ *
+ * Parameters:
+ *   value[Bool] verbose output debug information or not
+ *
+ * Returns:
+ *   value[Int] the self test's return code (0 = OK).
+ *     In case of an error, a Neko error is raised too.
+ */
+value hx_ecdsa_self_test(value verbose);
+
+
+/*
+ * Imports the private key 'key' on the curve 'grp_id' and derives the matching public key.
+ *
+ * Example:
+ *   value ret = hx_ecdsa_set_private(alloc_ecdsa_context(ecdsa_context), alloc_int(POLARSSL_ECP_DP_SECP256R1), buffer_val(key), buffer_size(key), alloc_null());
+ *
+ * Parameters:
+ *   value[k_ecdsa_context]   ecdsa_context the ECDSA context to import the key into
+ *   value[Int]               grp_id        the ecp_group_id of the curve the key belongs to
+ *   value[haxe.io.BytesData] key           the big-endian secret scalar
+ *   value[Int]               length        the number of key bytes
+ *   value[k_ctr_drbg_context|null] rng    the random number generator to use for blinding (null for HAVEGE)
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_ecdsa_set_private(value ecdsa_context, value grp_id, value key, value length, value rng);
+
+
+/*
+ * Imports the public key 'point' (uncompressed format) on the curve 'grp_id'.
+ *
+ * Example:
+ *   value ret = hx_ecdsa_set_public(alloc_ecdsa_context(ecdsa_context), alloc_int(POLARSSL_ECP_DP_SECP256R1), buffer_val(point), buffer_size(point));
+ *
+ * Parameters:
+ *   value[k_ecdsa_context]   ecdsa_context the ECDSA context to import the key into
+ *   value[Int]               grp_id        the ecp_group_id of the curve the point belongs to
+ *   value[haxe.io.BytesData] point         the encoded public point
+ *   value[Int]               length        the number of point bytes
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_ecdsa_set_public(value ecdsa_context, value grp_id, value point, value length);
+
+
+/*
+ * Signs the message digest 'hash' and returns the DER encoded signature.
+ *
+ * Attn: Signatures are deterministic (RFC 6979), so no random number generator is involved.
+ *
+ * See:
+ *   https://polarssl.org/api/ecdsa_8h.html
+ *
+ * Example:
+ *   value sig = hx_ecdsa_sign(alloc_ecdsa_context(ecdsa_context), alloc_int(POLARSSL_MD_SHA256), buffer_val(hash), buffer_size(hash));
+ *
+ * Parameters:
+ *   value[k_ecdsa_context]   ecdsa_context the ECDSA context holding the private key
+ *   value[Int]               md_alg        the MD algorithm that was used to hash the message
+ *   value[haxe.io.BytesData] hash          the message digest
+ *   value[Int]               hashlen       the length of the message digest
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the signature bytes
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_ecdsa_sign(value ecdsa_context, value md_alg, value hash, value hashlen);
+
+
+/*
+ * Verifies the DER encoded signature 'sig' of the message digest 'hash'.
+ *
+ * See:
+ *   https://polarssl.org/api/ecdsa_8h.html
+ *
+ * Example:
+ *   value ret = hx_ecdsa_verify(alloc_ecdsa_context(ecdsa_context), buffer_val(hash), buffer_size(hash), buffer_val(sig), buffer_size(sig));
+ *   if (val_int(ret) == 0) {
+ *       // signature is valid
+ *   }
+ *
+ * Parameters:
+ *   value[k_ecdsa_context]   ecdsa_context the ECDSA context holding the public key
+ *   value[haxe.io.BytesData] hash          the message digest
+ *   value[Int]               hashlen       the length of the message digest
+ *   value[haxe.io.BytesData] sig           the signature to verify
+ *   value[Int]               siglen        the length of the signature
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_ecdsa_verify(value ecdsa_context, value hash, value hashlen, value sig, value siglen);
+
+
+/*
+ * Finalizes the ECDSA context by freeing associated memory.
+ *
+ * Example:
+ *   finalize_ecdsa_context(alloc_ecdsa_context(ecdsa_context));
+ *
+ * Parameters:
+ *   value[k_ecdsa_context] ecdsa_context the ECDSA context to free
+ */
+void finalize_ecdsa_context(value ecdsa_context);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_ECDSA_HPP */
@@ -5,16 +5,61 @@
 extern "C" {
 #endif
 
+#define HAVEGE_POOL_SIZE  1024
+
+/*
+ * Mask applied to next_int() values; Neko Ints only hold 31 bits (signed), so the
+ * results are limited to 30 bits to be identical (and non-negative) on all targets.
+ */
+#define HAVEGE_INT_MASK  0x3FFFFFFF
+
+
+/*
+ * Internal structure bundling the HAVEGE state with a pool of prefetched random bytes.
+ *
+ * Small requests (fill(), next_int(), next_float()) are served from the pool, which
+ * is refilled in one go once drained, so they do not pay for a havege_random() call each.
+ */
+typedef struct {
+    havege_state  hs;
+    unsigned char pool[HAVEGE_POOL_SIZE];
+    size_t        pos;
+} s_havege;
+
+
 DECLARE_KIND(k_havege_state);
 
 
 #define alloc_havege_state(v)     alloc_abstract(k_havege_state, v)
-#define malloc_havege_state()     ((havege_state*)alloc_private(sizeof(havege_state)))
-#define val_havege_state(v)       ((havege_state*)val_data(v))
+#define malloc_havege_state()     ((s_havege*)alloc_private(sizeof(s_havege)))
+#define val_havege_state(v)       ((s_havege*)val_data(v))
 #define val_check_havege_state(v) val_check_kind(v, k_havege_state)
 #define val_is_havege_state(v)    val_is_kind(v, k_havege_state)
 
 
+/*
+ * Writes 'length' random bytes into 'bytes' starting at offset 'pos'.
+ *
+ * Attn: No new Bytes are allocated; the caller's buffer is modified in place.
+ *
+ * See:
+ *   https://polarssl.org/api/havege_8h.html
+ *
+ * Example:
+ *   hx_havege_fill(alloc_havege_state(hs), buffer_val(buf), alloc_int(0), alloc_int(16));
+ *
+ * Parameters:
+ *   value[k_havege_state]    hs     the HAVEGE state to use
+ *   value[haxe.io.BytesData] bytes  the buffer to write into
+ *   value[Int]               pos    the offset to start writing at
+ *   value[Int]               length the number of random bytes to write
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_havege_fill(value hs, value bytes, value pos, value length);
+
+
 /*
  * Frees the HAVEGE state and all resources allocated for it.
  *
@@ -48,6 +93,36 @@ value hx_havege_free(value hs);
 value hx_havege_init(void);
 
 
+/*
+ * Returns a random Float in the range [0, 1) served from the state's prefetched pool.
+ *
+ * Example:
+ *   value f = hx_havege_next_float(alloc_havege_state(hs));
+ *
+ * Parameters:
+ *   value[k_havege_state] hs the HAVEGE state to use
+ *
+ * Returns:
+ *   value[Float] a random Float with 53 bits of precision
+ */
+value hx_havege_next_float(value hs);
+
+
+/*
+ * Returns a random Int served from the state's prefetched pool.
+ *
+ * Example:
+ *   value i = hx_havege_next_int(alloc_havege_state(hs));
+ *
+ * Parameters:
+ *   value[k_havege_state] hs the HAVEGE state to use
+ *
+ * Returns:
+ *   value[Int] a random Int between 0 and HAVEGE_INT_MASK (2^30 - 1)
+ */
+value hx_havege_next_int(value hs);
+
+
 /*
  * Returns an 'nbytes' long series of random bytes.
  *
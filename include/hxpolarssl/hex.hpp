@@ -0,0 +1,48 @@
+#ifndef __HX_POLARSSL_HEX_HPP
+#define __HX_POLARSSL_HEX_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Decodes the hex String (either case) back to bytes.
+ *
+ * Attn: Uses SSE2 when available.
+ *
+ * Example:
+ *   value bytes = hx_hex_decode(alloc_string("01abff"));
+ *
+ * Parameters:
+ *   value[String] str the hex String to decode
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the decoded bytes
+ *   or POLARSSL_ERR_MPI_INVALID_CHARACTER [Int] if the String has an odd length or contains
+ *   non hex digits (and a Neko error is raised).
+ */
+value hx_hex_decode(value str);
+
+
+/*
+ * Encodes the provided bytes as lowercase hex String.
+ *
+ * Attn: Uses SSE2 when available.
+ *
+ * Example:
+ *   value hex = hx_hex_encode(buffer_val(buf), buffer_size(buf));
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] bytes  the bytes to encode
+ *   value[Int]               length the number of bytes to encode
+ *
+ * Returns:
+ *   value[String] the hex String
+ */
+value hx_hex_encode(value bytes, value length);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_HEX_HPP */
@@ -0,0 +1,101 @@
+#ifndef __HX_POLARSSL_HKDF_HPP
+#define __HX_POLARSSL_HKDF_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Extracts a pseudorandom key from 'ikm' and expands it into one output per info/length pair,
+ * all concatenated into a single buffer.
+ *
+ * See:
+ *   https://tools.ietf.org/html/rfc5869
+ *
+ * Example:
+ *   value saltArr = "Array with [0] = length & [1] = salt
+ *   value ikmArr  = "Array with [0] = length & [1] = input keying material
+ *   value infos   = "Array of Arrays with [0] = length & [1] = info
+ *   value lengths = "Array of Ints
+ *   value okm     = hx_hkdf(alloc_int(POLARSSL_MD_SHA256), saltArr, ikmArr, infos, lengths);
+ *
+ * Parameters:
+ *   value[Int]                   md_alg  the MDType of the HMAC digest to use
+ *   value[Array<Dynamic>]        saltArr Array with [0] = salt length [Int] and [1] = salt [haxe.io.BytesData]
+ *   value[Array<Dynamic>]        ikmArr  Array with [0] = IKM length [Int] and [1] = IKM [haxe.io.BytesData]
+ *   value[Array<Array<Dynamic>>] infos   the [length, data] Arrays of the per-output info labels
+ *   value[Array<Int>]            lengths the number of bytes to derive per output
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the concatenated output keying material
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_hkdf(value md_alg, value saltArr, value ikmArr, value infos, value lengths);
+
+
+/*
+ * Expands the pseudorandom key into 'length' bytes of output keying material.
+ *
+ * See:
+ *   https://tools.ietf.org/html/rfc5869#section-2.3
+ *
+ * Example:
+ *   value okm = hx_hkdf_expand(alloc_int(POLARSSL_MD_SHA256), prkArr, infoArr, alloc_int(32));
+ *
+ * Parameters:
+ *   value[Int]            md_alg  the MDType of the HMAC digest to use
+ *   value[Array<Dynamic>] prkArr  Array with [0] = PRK length [Int] and [1] = PRK [haxe.io.BytesData]
+ *   value[Array<Dynamic>] infoArr Array with [0] = info length [Int] and [1] = info [haxe.io.BytesData]
+ *   value[Int]            length  the number of bytes to derive (<= 255 * digest size)
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the output keying material
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_hkdf_expand(value md_alg, value prkArr, value infoArr, value length);
+
+
+/*
+ * Extracts a pseudorandom key from the input keying material.
+ *
+ * See:
+ *   https://tools.ietf.org/html/rfc5869#section-2.2
+ *
+ * Example:
+ *   value prk = hx_hkdf_extract(alloc_int(POLARSSL_MD_SHA256), saltArr, ikmArr);
+ *
+ * Parameters:
+ *   value[Int]            md_alg  the MDType of the HMAC digest to use
+ *   value[Array<Dynamic>] saltArr Array with [0] = salt length [Int] and [1] = salt [haxe.io.BytesData]
+ *   value[Array<Dynamic>] ikmArr  Array with [0] = IKM length [Int] and [1] = IKM [haxe.io.BytesData]
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the pseudorandom key (digest size bytes)
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_hkdf_extract(value md_alg, value saltArr, value ikmArr);
+
+
+/*
+ * Runs the RFC 5869 test vectors to ensure the HKDF implementation works correctly.
+ *
+ * Example:
+ *   value ret = hx_hkdf_self_test(alloc_bool(false));
+ *   if (val_int(ret) == 0) {
+ *       // everthing good
+ *   }
+ *
+ * Parameters:
+ *   value[Bool] verbose output debug information or not
+ *
+ * Returns:
+ *   value[Int] the self test's return code (0 = OK).
+ *     In case of an error, a Neko error is raised too.
+ */
+value hx_hkdf_self_test(value verbose);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_HKDF_HPP */
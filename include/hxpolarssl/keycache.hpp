@@ -0,0 +1,154 @@
+#ifndef __HX_POLARSSL_KEYCACHE_HPP
+#define __HX_POLARSSL_KEYCACHE_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Cipher identifiers used to partition the key schedule cache.
+ */
+#define KEYCACHE_AES       0
+#define KEYCACHE_CAMELLIA  1
+
+/*
+ * Default number of expanded key schedules kept in the cache and the number of
+ * independently locked shards the capacity is split across (rounded up per shard).
+ */
+#define KEYCACHE_DEFAULT_CAPACITY  256
+#define KEYCACHE_SHARDS            16
+
+
+/*
+ * Returns an AES context keyed with 'key': the shared, read-only schedule from the cache,
+ * or a freshly expanded (and cached) one on a miss.
+ *
+ * Attn: The returned context must never be re-keyed or freed with the hx_aes_* functions;
+ *       it is released by its finalizer (finalize_keycache_entry).
+ *       Lookups hash 'key' (or 'key_id' if given) with SipHash under a per-process secret.
+ *
+ * See:
+ *   https://polarssl.org/api/aes_8h.html
+ *
+ * Example:
+ *   value aes_context = hx_keycache_aes(buffer_val(key), buffer_size(key), alloc_int(AES_ENCRYPT), alloc_null());
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] key    the secret key
+ *   value[Int]               keylen the key length in bits (128, 192 or 256)
+ *   value[Int]               mode   AES_ENCRYPT or AES_DECRYPT
+ *   value[String]            key_id an opaque ID always naming this key, or null to identify it by 'key'
+ *
+ * Returns:
+ *   value[k_aes_context] the keyed AES context
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_keycache_aes(value key, value keylen, value mode, value key_id);
+
+
+/*
+ * Times cache hits against fresh key expansions of the same AES-256 decryption key.
+ *
+ * Attn: The benchmark key stays cached like any other key; with a capacity of 0
+ *       every lookup is a miss.
+ *
+ * Example:
+ *   value ns = hx_keycache_benchmark(alloc_int(100000));
+ *
+ * Parameters:
+ *   value[Int] iterations the number of lookups and expansions to time
+ *
+ * Returns:
+ *   value[Array<Float>] the nanoseconds per cache hit and per init/setkey/free cycle
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_keycache_benchmark(value iterations);
+
+
+/*
+ * Returns a Camellia context keyed with 'key': the shared, read-only schedule from the cache,
+ * or a freshly expanded (and cached) one on a miss.
+ *
+ * Attn: The returned context must never be re-keyed or freed with the hx_camellia_* functions;
+ *       it is released by its finalizer (finalize_keycache_entry).
+ *       Lookups hash 'key' (or 'key_id' if given) with SipHash under a per-process secret.
+ *
+ * See:
+ *   https://polarssl.org/api/camellia_8h.html
+ *
+ * Example:
+ *   value camellia_context = hx_keycache_camellia(buffer_val(key), buffer_size(key), alloc_int(CAMELLIA_ENCRYPT), alloc_null());
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] key    the secret key
+ *   value[Int]               keylen the key length in bits (128, 192 or 256)
+ *   value[Int]               mode   CAMELLIA_ENCRYPT or CAMELLIA_DECRYPT
+ *   value[String]            key_id an opaque ID always naming this key, or null to identify it by 'key'
+ *
+ * Returns:
+ *   value[k_camellia_context] the keyed Camellia context
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_keycache_camellia(value key, value keylen, value mode, value key_id);
+
+
+/*
+ * Removes (and wipes) all cached key schedules. The statistics are kept.
+ *
+ * Attn: Schedules still in use are wiped once their last context is finalized.
+ *
+ * Example:
+ *   hx_keycache_clear();
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_keycache_clear(void);
+
+
+/*
+ * Sets the maximum number of cached key schedules, evicting the least recently used ones if needed.
+ *
+ * Attn: A capacity of 0 disables caching.
+ *
+ * Example:
+ *   hx_keycache_set_capacity(alloc_int(1024));
+ *
+ * Parameters:
+ *   value[Int] capacity the maximum number of entries
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_keycache_set_capacity(value capacity);
+
+
+/*
+ * Returns the cache statistics.
+ *
+ * Example:
+ *   value stats = hx_keycache_stats();
+ *
+ * Returns:
+ *   value[Array<Int>] [hits, misses, evictions, size, capacity]
+ */
+value hx_keycache_stats(void);
+
+
+/*
+ * Releases the reference a context handed out by the cache holds on its entry; the
+ * schedule is wiped and freed once it is neither cached nor used anymore.
+ *
+ * Example:
+ *   finalize_keycache_entry(aes_context);
+ *
+ * Parameters:
+ *   value[k_aes_context|k_camellia_context] context the context to finalize
+ */
+void finalize_keycache_entry(value context);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_KEYCACHE_HPP */
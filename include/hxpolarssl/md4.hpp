@@ -43,6 +43,25 @@ value hx_md4(value bytes, value length);
 value hx_md4_file(value path);
 
 
+/*
+ * Calculates the MD4 sum of the input bytes and returns it hex encoded.
+ *
+ * See:
+ *   https://polarssl.org/api/md4_8h.html
+ *
+ * Example:
+ *   value hex = hx_md4_hex(buffer_val(buf), buffer_size(buf));
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] bytes  the bytes to hash
+ *   value[Int]               length the number of bytes to hash
+ *
+ * Returns:
+ *   value[String] the lowercase hex encoded hashsum of the input bytes
+ */
+value hx_md4_hex(value bytes, value length);
+
+
 /*
  * Runs various health checks to ensure the MD4 module works correctly.
  *
@@ -43,6 +43,25 @@ value hx_md5(value bytes, value length);
 value hx_md5_file(value path);
 
 
+/*
+ * Calculates the MD5 sum of the input bytes and returns it hex encoded.
+ *
+ * See:
+ *   https://polarssl.org/api/md5_8h.html
+ *
+ * Example:
+ *   value hex = hx_md5_hex(buffer_val(buf), buffer_size(buf));
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] bytes  the bytes to hash
+ *   value[Int]               length the number of bytes to hash
+ *
+ * Returns:
+ *   value[String] the lowercase hex encoded hashsum of the input bytes
+ */
+value hx_md5_hex(value bytes, value length);
+
+
 /*
  * Runs various health checks to ensure the MD5 module works correctly.
  *
@@ -64,6 +83,24 @@ value hx_md5_file(value path);
  */
 value hx_md5_self_test(value verbose);
 
+
+/*
+ * Calculates the MD5 sum of the segments as if they were concatenated.
+ *
+ * See:
+ *   https://polarssl.org/api/md5_8h.html
+ *
+ * Example:
+ *   value sum = hx_md5v(segments);
+ *
+ * Parameters:
+ *   value[Array<Dynamic>] segments the (BytesData, pos, length) triples to hash in order
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the hashsum of the segments
+ */
+value hx_md5v(value segments);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
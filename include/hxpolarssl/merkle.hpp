@@ -0,0 +1,122 @@
+#ifndef __HX_POLARSSL_MERKLE_HPP
+#define __HX_POLARSSL_MERKLE_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bounds of the leaf size and the number of worker threads.
+ */
+#define MERKLE_MIN_LEAF_SIZE  64
+#define MERKLE_MAX_LEAF_SIZE  (1 << 30)
+#define MERKLE_MAX_THREADS    64
+
+/*
+ * Domain separation prefixes used if the tree is built as described by RFC 6962.
+ */
+#define MERKLE_LEAF_PREFIX  0x00
+#define MERKLE_NODE_PREFIX  0x01
+
+
+/*
+ * Internal structure holding the parameters of a Merkle tree builder.
+ */
+typedef struct {
+    uint32_t         leaf_size;
+    const md_info_t* md_info;
+    int              prefixed;  /* prefix leaves/nodes with 0x00/0x01 (RFC 6962) */
+    int              threads;   /* number of worker threads, 0 for one per core */
+} s_merkle;
+
+
+DECLARE_KIND(k_merkle);
+
+
+#define alloc_merkle(v)      alloc_abstract(k_merkle, v)
+#define malloc_merkle()      ((s_merkle*)alloc_private(sizeof(s_merkle)))
+#define val_merkle(v)        ((s_merkle*)val_data(v))
+#define val_check_merkle(v)  val_check_kind(v, k_merkle)
+#define val_is_merkle(v)     val_is_kind(v, k_merkle)
+
+
+/*
+ * Builds the Merkle tree over the input bytes split into leaves of the builder's leaf
+ * size (the last leaf may be shorter); an odd node is promoted to the next level as is.
+ *
+ * Example:
+ *   value levels = hx_merkle_bytes(merkle, buffer_val(buf), alloc_int(0), buffer_size(buf), alloc_bool(false));
+ *
+ * Parameters:
+ *   value[k_merkle]          merkle the builder to use
+ *   value[haxe.io.BytesData] bytes  the bytes to hash
+ *   value[Int]               pos    the position to start reading at
+ *   value[Int]               length the number of bytes to hash
+ *   value[Bool]              levels to return all levels or only the root
+ *
+ * Returns:
+ *   value[Array<haxe.io.BytesData>] the levels' concatenated digests from the leaves up to the root,
+ *                                   or only the root
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_merkle_bytes(value merkle, value bytes, value pos, value length, value levels);
+
+
+/*
+ * Builds the Merkle tree over the file specified by 'path', mapping it into memory
+ * (read into memory on Windows).
+ *
+ * Example:
+ *   value levels = hx_merkle_file(merkle, alloc_string("/some/path"), alloc_bool(true));
+ *
+ * Parameters:
+ *   value[k_merkle] merkle the builder to use
+ *   value[String]   path   the file path
+ *   value[Bool]     levels to return all levels or only the root
+ *
+ * Returns:
+ *   value[Array<haxe.io.BytesData>] the levels' concatenated digests from the leaves up to the root,
+ *                                   or only the root
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_merkle_file(value merkle, value path, value levels);
+
+
+/*
+ * Creates a Merkle tree builder.
+ *
+ * See:
+ *   https://tools.ietf.org/html/rfc6962#section-2.1
+ *
+ * Example:
+ *   value merkle = hx_merkle_init(alloc_int(1 << 20), alloc_int(POLARSSL_MD_SHA256), alloc_bool(true), alloc_int(0));
+ *
+ * Parameters:
+ *   value[Int]  leaf_size the number of bytes per leaf
+ *   value[Int]  type      the md_type_t of the digests
+ *   value[Bool] prefixed  to prefix leaves and nodes as described by RFC 6962 or not
+ *   value[Int]  threads   the number of worker threads (0 for one per core)
+ *
+ * Returns:
+ *   value[k_merkle] the builder
+ *   or in case of an error [Int] the error code (and a Neko error is raised).
+ */
+value hx_merkle_init(value leaf_size, value type, value prefixed, value threads);
+
+
+/*
+ * Finalizes the builder by wiping its parameters.
+ *
+ * Example:
+ *   finalize_merkle(merkle);
+ *
+ * Parameters:
+ *   value[k_merkle] merkle the builder to finalize
+ */
+void finalize_merkle(value merkle);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_MERKLE_HPP */
@@ -0,0 +1,439 @@
+#ifndef __HX_POLARSSL_MPI_HPP
+#define __HX_POLARSSL_MPI_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+DECLARE_KIND(k_mpi);
+
+
+#define alloc_mpi(v)      alloc_abstract(k_mpi, v)
+#define malloc_mpi()      ((mpi*)alloc_private(sizeof(mpi)))
+#define val_mpi(v)        ((mpi*)val_data(v))
+#define val_check_mpi(v)  val_check_kind(v, k_mpi)
+#define val_is_mpi(v)     val_is_kind(v, k_mpi)
+
+
+/*
+ * Sets X = A + B.
+ *
+ * Attn: X may be one of the operands (in-place operation).
+ *
+ * See:
+ *   https://polarssl.org/api/bignum_8h.html
+ *
+ * Example:
+ *   value ret = hx_mpi_add(alloc_mpi(X), alloc_mpi(A), alloc_mpi(B));
+ *
+ * Parameters:
+ *   value[k_mpi] X the destination MPI
+ *   value[k_mpi] A the first operand
+ *   value[k_mpi] B the second operand
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_add(value X, value A, value B);
+
+
+/*
+ * Sets X = A + b.
+ *
+ * Attn: X may be one of the operands (in-place operation).
+ *
+ * See:
+ *   https://polarssl.org/api/bignum_8h.html
+ *
+ * Example:
+ *   value ret = hx_mpi_add_int(alloc_mpi(X), alloc_mpi(A), alloc_int(b));
+ *
+ * Parameters:
+ *   value[k_mpi] X the destination MPI
+ *   value[k_mpi] A the first operand
+ *   value[Int]   b the integer operand
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_add_int(value X, value A, value b);
+
+
+/*
+ * Returns the number of significant bits of X.
+ *
+ * Example:
+ *   value bits = hx_mpi_bitlen(alloc_mpi(X));
+ *
+ * Parameters:
+ *   value[k_mpi] X the MPI to inspect
+ *
+ * Returns:
+ *   value[Int] the position of the most significant bit (+1)
+ */
+value hx_mpi_bitlen(value X);
+
+
+/*
+ * Compares X with Y.
+ *
+ * Example:
+ *   value cmp = hx_mpi_cmp(alloc_mpi(X), alloc_mpi(Y));
+ *
+ * Parameters:
+ *   value[k_mpi] X the left-hand MPI
+ *   value[k_mpi] Y the right-hand MPI
+ *
+ * Returns:
+ *   value[Int] 1 if X > Y, -1 if X < Y and 0 if both are equal
+ */
+value hx_mpi_cmp(value X, value Y);
+
+
+/*
+ * Copies the contents of Y into X.
+ *
+ * Example:
+ *   value ret = hx_mpi_copy(alloc_mpi(X), alloc_mpi(Y));
+ *
+ * Parameters:
+ *   value[k_mpi] X the destination MPI
+ *   value[k_mpi] Y the source MPI
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_copy(value X, value Y);
+
+
+/*
+ * Sets X = A^E mod N (sliding-window exponentiation).
+ *
+ * Attn: X may be one of the operands (in-place operation).
+ *
+ * See:
+ *   https://polarssl.org/api/bignum_8h.html
+ *
+ * Example:
+ *   value ret = hx_mpi_exp_mod(alloc_mpi(X), alloc_mpi(A), alloc_mpi(E), alloc_mpi(N));
+ *
+ * Parameters:
+ *   value[k_mpi] X the destination MPI
+ *   value[k_mpi] A the first operand
+ *   value[k_mpi] E the exponent
+ *   value[k_mpi] N the modulus
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_exp_mod(value X, value A, value E, value N);
+
+
+/*
+ * Frees the MPI and all resources allocated for it.
+ *
+ * See:
+ *   https://polarssl.org/api/bignum_8h.html
+ *
+ * Example:
+ *   hx_mpi_free(alloc_mpi(X));
+ *
+ * Parameters:
+ *   value[k_mpi] X the MPI to free
+ *
+ * Returns:
+ *   value[null] nothing is returned
+ */
+value hx_mpi_free(value X);
+
+
+/*
+ * Sets X = gcd(A, B).
+ *
+ * Attn: X may be one of the operands (in-place operation).
+ *
+ * See:
+ *   https://polarssl.org/api/bignum_8h.html
+ *
+ * Example:
+ *   value ret = hx_mpi_gcd(alloc_mpi(X), alloc_mpi(A), alloc_mpi(B));
+ *
+ * Parameters:
+ *   value[k_mpi] X the destination MPI
+ *   value[k_mpi] A the first operand
+ *   value[k_mpi] B the second operand
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_gcd(value X, value A, value B);
+
+
+/*
+ * Initializes and returns an MPI (with value 0).
+ *
+ * See:
+ *   https://polarssl.org/api/bignum_8h.html
+ *
+ * Example:
+ *   value X = hx_mpi_init();
+ *
+ * Returns:
+ *   value[k_mpi] the initialized MPI
+ */
+value hx_mpi_init(void);
+
+
+/*
+ * Sets X = A^-1 mod N.
+ *
+ * Attn: X may be one of the operands (in-place operation).
+ *
+ * See:
+ *   https://polarssl.org/api/bignum_8h.html
+ *
+ * Example:
+ *   value ret = hx_mpi_inv_mod(alloc_mpi(X), alloc_mpi(A), alloc_mpi(N));
+ *
+ * Parameters:
+ *   value[k_mpi] X the destination MPI
+ *   value[k_mpi] A the first operand
+ *   value[k_mpi] N the modulus
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_inv_mod(value X, value A, value N);
+
+
+/*
+ * Sets X to the integer value z.
+ *
+ * Example:
+ *   value ret = hx_mpi_lset(alloc_mpi(X), alloc_int(1));
+ *
+ * Parameters:
+ *   value[k_mpi] X the MPI to set
+ *   value[Int]   z the value to set
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_lset(value X, value z);
+
+
+/*
+ * Sets X = A mod B (with 0 <= X < B).
+ *
+ * Attn: X may be one of the operands (in-place operation).
+ *
+ * See:
+ *   https://polarssl.org/api/bignum_8h.html
+ *
+ * Example:
+ *   value ret = hx_mpi_mod(alloc_mpi(X), alloc_mpi(A), alloc_mpi(B));
+ *
+ * Parameters:
+ *   value[k_mpi] X the destination MPI
+ *   value[k_mpi] A the first operand
+ *   value[k_mpi] B the second operand
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_mod(value X, value A, value B);
+
+
+/*
+ * Sets X = A * B.
+ *
+ * Attn: X may be one of the operands (in-place operation).
+ *
+ * See:
+ *   https://polarssl.org/api/bignum_8h.html
+ *
+ * Example:
+ *   value ret = hx_mpi_mul(alloc_mpi(X), alloc_mpi(A), alloc_mpi(B));
+ *
+ * Parameters:
+ *   value[k_mpi] X the destination MPI
+ *   value[k_mpi] A the first operand
+ *   value[k_mpi] B the second operand
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_mul(value X, value A, value B);
+
+
+/*
+ * Sets X = A * b.
+ *
+ * Attn: X may be one of the operands (in-place operation).
+ *
+ * See:
+ *   https://polarssl.org/api/bignum_8h.html
+ *
+ * Example:
+ *   value ret = hx_mpi_mul_int(alloc_mpi(X), alloc_mpi(A), alloc_int(b));
+ *
+ * Parameters:
+ *   value[k_mpi] X the destination MPI
+ *   value[k_mpi] A the first operand
+ *   value[Int]   b the integer operand
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_mul_int(value X, value A, value b);
+
+
+/*
+ * Imports X from the unsigned big-endian bytes.
+ *
+ * Example:
+ *   value ret = hx_mpi_read_binary(alloc_mpi(X), buffer_val(buf), buffer_size(buf));
+ *
+ * Parameters:
+ *   value[k_mpi]             X      the MPI to set
+ *   value[haxe.io.BytesData] bytes  the big-endian bytes
+ *   value[Int]               length the number of bytes to read
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_read_binary(value X, value bytes, value length);
+
+
+/*
+ * Imports X from its ASCII representation in the given radix.
+ *
+ * Example:
+ *   value ret = hx_mpi_read_string(alloc_mpi(X), alloc_int(16), alloc_string("-01AF"));
+ *
+ * Parameters:
+ *   value[k_mpi]  X     the MPI to set
+ *   value[Int]    radix the input radix (2 - 16)
+ *   value[String] str   the (optionally negative) number
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_read_string(value X, value radix, value str);
+
+
+/*
+ * Runs various health checks to ensure the bignum module works correctly.
+ *
+ * See:
+ *   https://polarssl.org/api/bignum_8h.html
+ *
+ * Example:
+ *   value ret = hx_mpi_self_test(alloc_bool(false));
+ *   if (val_int(ret) == 0) {
+ *       // everthing good
+ *   }
+ *
+ * Parameters:
+ *   value[Bool] verbose output debug information or not
+ *
+ * Returns:
+ *   value[Int] the self test's return code (0 = OK).
+ *     In case of an error, a Neko error is raised too.
+ */
+value hx_mpi_self_test(value verbose);
+
+
+/*
+ * Sets X = A - B.
+ *
+ * Attn: X may be one of the operands (in-place operation).
+ *
+ * See:
+ *   https://polarssl.org/api/bignum_8h.html
+ *
+ * Example:
+ *   value ret = hx_mpi_sub(alloc_mpi(X), alloc_mpi(A), alloc_mpi(B));
+ *
+ * Parameters:
+ *   value[k_mpi] X the destination MPI
+ *   value[k_mpi] A the first operand
+ *   value[k_mpi] B the second operand
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_sub(value X, value A, value B);
+
+
+/*
+ * Sets X = A - b.
+ *
+ * Attn: X may be one of the operands (in-place operation).
+ *
+ * See:
+ *   https://polarssl.org/api/bignum_8h.html
+ *
+ * Example:
+ *   value ret = hx_mpi_sub_int(alloc_mpi(X), alloc_mpi(A), alloc_int(b));
+ *
+ * Parameters:
+ *   value[k_mpi] X the destination MPI
+ *   value[k_mpi] A the first operand
+ *   value[Int]   b the integer operand
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_mpi_sub_int(value X, value A, value b);
+
+
+/*
+ * Exports the absolute value of X as unsigned big-endian bytes.
+ *
+ * Example:
+ *   value bytes = hx_mpi_write_binary(alloc_mpi(X));
+ *
+ * Parameters:
+ *   value[k_mpi] X the MPI to export
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the big-endian bytes
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_mpi_write_binary(value X);
+
+
+/*
+ * Exports X as ASCII representation in the given radix.
+ *
+ * Example:
+ *   value str = hx_mpi_write_string(alloc_mpi(X), alloc_int(10));
+ *
+ * Parameters:
+ *   value[k_mpi] X     the MPI to export
+ *   value[Int]   radix the output radix (2 - 16)
+ *
+ * Returns:
+ *   value[String] the (optionally negative) number
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_mpi_write_string(value X, value radix);
+
+
+/*
+ * Finalizes the MPI by freeing associated memory.
+ *
+ * Example:
+ *   finalize_mpi(alloc_mpi(X));
+ *
+ * Parameters:
+ *   value[k_mpi] X the MPI to free
+ */
+void finalize_mpi(value X);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_MPI_HPP */
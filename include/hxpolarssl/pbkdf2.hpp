@@ -0,0 +1,62 @@
+#ifndef __HX_POLARSSL_PBKDF2_HPP
+#define __HX_POLARSSL_PBKDF2_HPP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Derives a 'key_length' bytes long key from the password and salt using PBKDF2 with HMAC.
+ *
+ * Attn: The derivation runs outside of the GC's lock, so other Haxe threads keep running.
+ *       Keys longer than the digest size are made of independent blocks, which are
+ *       computed in parallel on up to one thread per CPU core.
+ *
+ * See:
+ *   https://polarssl.org/api/pkcs5_8h.html
+ *
+ * Example:
+ *   value pwdArr  = "Array with [0] = length & [1] = password
+ *   value saltArr = "Array with [0] = length & [1] = salt
+ *   value key     = hx_pbkdf2_hmac(alloc_int(POLARSSL_MD_SHA256), pwdArr, saltArr, alloc_int(100000), alloc_int(32));
+ *
+ * Parameters:
+ *   value[Int]            md_alg     the MDType of the HMAC digest to use
+ *   value[Array<Dynamic>] pwdArr     Array with [0] = password length [Int] and [1] = password [haxe.io.BytesData]
+ *   value[Array<Dynamic>] saltArr    Array with [0] = salt length [Int] and [1] = salt [haxe.io.BytesData]
+ *   value[Int]            iterations the number of iterations
+ *   value[Int]            key_length the number of key bytes to derive
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the derived key
+ *   or the error code [Int] (and a Neko error is raised).
+ */
+value hx_pbkdf2_hmac(value md_alg, value pwdArr, value saltArr, value iterations, value key_length);
+
+
+/*
+ * Runs various health checks to ensure the PKCS#5 module works correctly.
+ *
+ * See:
+ *   https://polarssl.org/api/pkcs5_8h.html
+ *
+ * Example:
+ *   value ret = hx_pbkdf2_self_test(alloc_bool(false));
+ *   if (val_int(ret) == 0) {
+ *       // everthing good
+ *   }
+ *
+ * Parameters:
+ *   value[Bool] verbose output debug information or not
+ *
+ * Returns:
+ *   value[Int] the self test's return code (0 = OK).
+ *     In case of an error, a Neko error is raised too.
+ */
+value hx_pbkdf2_self_test(value verbose);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __HX_POLARSSL_PBKDF2_HPP */
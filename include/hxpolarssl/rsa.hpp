@@ -109,18 +109,15 @@ value hx_rsa_free(value rsa_context);
 /*
  * Generates an RSA keypair of length 'nbits' with public n 'exponent'.
  *
- * Attn: The random number generator in use is PolarSSL's internal havege function.
- *       It is by default NOT compiled into the library, so make sure to uncomment the #define
- *       for that.
- *
- * TODO:
- *   - Allow passing a RNG function from Haxe?
+ * Attn: If no CTR_DRBG context is passed, the random number generator in use is PolarSSL's
+ *       internal havege function. It is by default NOT compiled into the library, so make sure
+ *       to uncomment the #define for that.
  *
  * See:
  *   https://polarssl.org/api/rsa_8h.html
  *
  * Example:
- *   value ret = hx_rsa_gen_key(alloc_rsa_context(rsa_context), alloc_int(2048), alloc_int(65537));
+ *   value ret = hx_rsa_gen_key(alloc_rsa_context(rsa_context), alloc_int(2048), alloc_int(65537), alloc_null());
  *   if (val_int(ret) == 0) {
  *       // everything good
  *   }
@@ -129,11 +126,12 @@ value hx_rsa_free(value rsa_context);
  *   value[k_rsa_context] rsa_context the RSA context for which a keypair should be generated
  *   value[Int]           nbits       the length of the keys to generate (in bit)
  *   value[Int]           exponent    the public exponent
+ *   value[k_ctr_drbg_context|null] rng the random number generator to use (null for HAVEGE)
  *
  * Returns:
  *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
  */
-value hx_rsa_gen_key(value rsa_context, value nbits, value exponent);
+value hx_rsa_gen_key(value rsa_context, value nbits, value exponent, value rng);
 
 
 /*
@@ -243,19 +241,20 @@ value hx_rsa_init(value padding, value hash_id);
  *
  * Example:
  *   val context = alloc_rsa_context(rsa_context);
- *   val enc = hx_rsa_pkcs1_encrypt(context, alloc_int(RSA_PUBLIC), buffer_val(input), buffer_size(length));
- *   val dec = hx_rsa_pkcs1_decrypt(context, alloc_int(RSA_PRIVATE), enc);
+ *   val enc = hx_rsa_pkcs1_encrypt(context, alloc_int(RSA_PUBLIC), buffer_val(input), buffer_size(length), alloc_null());
+ *   val dec = hx_rsa_pkcs1_decrypt(context, alloc_int(RSA_PRIVATE), enc, alloc_null());
  *
  * Parameters:
  *   value[k_rsa_context]     rsa_context the RSA context to decrypt in
  *   value[Int]               mode        the mode in which should be decrypted (e.g. RSA_PRIVATE (1))
  *   value[haxe.io.BytesData] input       the input bytes to decrypt
+ *   value[k_ctr_drbg_context|null] rng   the random number generator to use (null for HAVEGE)
  *
  * Returns:
  *   value[haxe.io.BytesData] the decrypted bytes
  *   or the error code [Int] together with a raised Neko error.
  */
-value hx_rsa_pkcs1_decrypt(value rsa_context, value mode, value input);
+value hx_rsa_pkcs1_decrypt(value rsa_context, value mode, value input, value rng);
 
 
 /*
@@ -265,19 +264,20 @@ value hx_rsa_pkcs1_decrypt(value rsa_context, value mode, value input);
  *   https://polarssl.org/api/rsa_8h.html
  *
  * Example:
- *   val enc = hx_rsa_pkcs1_encrypt(alloc_rsa_context(rsa_context), alloc_int(RSA_PUBLIC), buffer_val(input), buffer_size(length));
+ *   val enc = hx_rsa_pkcs1_encrypt(alloc_rsa_context(rsa_context), alloc_int(RSA_PUBLIC), buffer_val(input), buffer_size(length), alloc_null());
  *
  * Parameters:
  *   value[k_rsa_context]     rsa_context the RSA context to encrypt in
  *   value[Int]               mode        the mode in which should be encrypted (e.g. RSA_PRIVATE (1))
  *   value[haxe.io.BytesData] input       the input bytes to encrypt
  *   value[Int]               length      the number of bytes to encrypt
+ *   value[k_ctr_drbg_context|null] rng   the random number generator to use (null for HAVEGE)
  *
  * Returns:
  *   value[haxe.io.BytesData] the encrypted bytes
  *   or the error code [Int] together with a raised Neko error.
  */
-value hx_rsa_pkcs1_encrypt(value rsa_context, value mode, value input, value length);
+value hx_rsa_pkcs1_encrypt(value rsa_context, value mode, value input, value length, value rng);
 
 
 /*
@@ -287,20 +287,21 @@ value hx_rsa_pkcs1_encrypt(value rsa_context, value mode, value input, value len
  *   https://polarssl.org/api/rsa_8h.html
  *
  * Example:
- *   val sig = hx_rsa_pkcs1_sign(alloc_rsa_context(rsa_context), alloc_int(RSA_PUBLIC) alloc_int(POLARSSL_MD_NONE), buffer_size(hash), buffer_val(hash));
+ *   value hashArr = "Array with [0] = hashLen & [1] = hash
+ *   val sig = hx_rsa_pkcs1_sign(alloc_rsa_context(rsa_context), alloc_int(RSA_PUBLIC) alloc_int(POLARSSL_MD_NONE), hashArr, alloc_null());
  *
  * Parameters:
  *   value[k_rsa_context]     rsa_context the RSA context to encrypt in
  *   value[Int]               mode        the mode in which should be signed (e.g. RSA_PRIVATE (1))
  *   value[Int]               md_alg      the hashing algorithm (e.g. MD_SHA512)
- *   value[Int]               hashlen     the number of hash bytes (only if md_alg = NONE)
- *   value[haxe.io.BytesData] hash        the hash in bytes
+ *   value[Array<Dynamic>]    hashArr     Array with [0] = hash length [Int] and [1] = hash bytes [haxe.io.BytesData]
+ *   value[k_ctr_drbg_context|null] rng   the random number generator to use (null for HAVEGE)
  *
  * Returns:
  *   value[haxe.io.BytesData] the signature bytes
  *   or the error code [Int] together with a raised Neko error.
  */
-value hx_rsa_pkcs1_sign(value rsa_context, value mode, value md_alg, value hashlen, value hash);
+value hx_rsa_pkcs1_sign(value rsa_context, value mode, value md_alg, value hashArr, value rng);
 
 
 /*
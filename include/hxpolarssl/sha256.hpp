@@ -45,6 +45,28 @@ value hx_sha256(value bytes, value length, value is224);
 value hx_sha256_file(value path, value is224);
 
 
+/*
+ * Calculates the SHA-256 sum of the input bytes and returns it hex encoded.
+ *
+ * Attn: The 224 bit variant's sum is truncated to 28 bytes.
+ *
+ * See:
+ *   https://polarssl.org/api/sha256_8h.html
+ *
+ * Example:
+ *   value hex = hx_sha256_hex(buffer_val(buf), buffer_size(buf), alloc_int(0));
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] bytes  the bytes to hash
+ *   value[Int]               length the number of bytes to hash
+ *   value[Bool]              is224  to use SHA-224 or not (SHA-256 is false)
+ *
+ * Returns:
+ *   value[String] the lowercase hex encoded hashsum of the input bytes
+ */
+value hx_sha256_hex(value bytes, value length, value is224);
+
+
 /*
  * Runs various health checks to ensure the SHA-256 module works correctly.
  *
@@ -66,6 +88,27 @@ value hx_sha256_file(value path, value is224);
  */
 value hx_sha256_self_test(value verbose);
 
+
+/*
+ * Calculates the SHA-256 sum of the segments as if they were concatenated.
+ *
+ * Attn: The 224 bit variant's sum is truncated to 28 bytes.
+ *
+ * See:
+ *   https://polarssl.org/api/sha256_8h.html
+ *
+ * Example:
+ *   value sum = hx_sha256v(segments, alloc_int(0));
+ *
+ * Parameters:
+ *   value[Array<Dynamic>] segments the (BytesData, pos, length) triples to hash in order
+ *   value[Bool]           is224    to use SHA-224 or not (SHA-256 is false)
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the hashsum of the segments
+ */
+value hx_sha256v(value segments, value is224);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
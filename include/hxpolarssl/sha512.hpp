@@ -45,6 +45,28 @@ value hx_sha512(value bytes, value length, value is384);
 value hx_sha512_file(value path, value is384);
 
 
+/*
+ * Calculates the SHA-512 sum of the input bytes and returns it hex encoded.
+ *
+ * Attn: The 384 bit variant's sum is truncated to 48 bytes.
+ *
+ * See:
+ *   https://polarssl.org/api/sha512_8h.html
+ *
+ * Example:
+ *   value hex = hx_sha512_hex(buffer_val(buf), buffer_size(buf), alloc_int(0));
+ *
+ * Parameters:
+ *   value[haxe.io.BytesData] bytes  the bytes to hash
+ *   value[Int]               length the number of bytes to hash
+ *   value[Bool]              is384  to use SHA-384 or not (SHA-512 is false)
+ *
+ * Returns:
+ *   value[String] the lowercase hex encoded hashsum of the input bytes
+ */
+value hx_sha512_hex(value bytes, value length, value is384);
+
+
 /*
  * Runs various health checks to ensure the SHA-512 module works correctly.
  *
@@ -66,6 +88,27 @@ value hx_sha512_file(value path, value is384);
  */
 value hx_sha512_self_test(value verbose);
 
+
+/*
+ * Calculates the SHA-512 sum of the segments as if they were concatenated.
+ *
+ * Attn: The 384 bit variant's sum is truncated to 48 bytes.
+ *
+ * See:
+ *   https://polarssl.org/api/sha512_8h.html
+ *
+ * Example:
+ *   value sum = hx_sha512v(segments, alloc_int(0));
+ *
+ * Parameters:
+ *   value[Array<Dynamic>] segments the (BytesData, pos, length) triples to hash in order
+ *   value[Bool]           is384    to use SHA-384 or not (SHA-512 is false)
+ *
+ * Returns:
+ *   value[haxe.io.BytesData] the hashsum of the segments
+ */
+value hx_sha512v(value segments, value is384);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -27,6 +27,53 @@ typedef struct {
 s_bytes* bytes_fromHaxe(value bytes, value length);
 
 
+/*
+ * Returns a writable pointer to the memory backing Haxe's BytesData,
+ * allowing native code to write results directly into caller-provided buffers.
+ *
+ * Example:
+ *   unsigned char* data = data_fromHaxe(hx_bytes);
+ *   memcpy(data + val_int(pos), src, len);
+ */
+unsigned char* data_fromHaxe(value bytes);
+
+
+/*
+ * Decodes 'length' hex digits (either case) into length / 2 bytes.
+ *
+ * Returns 0 on success or -1 if the length is odd or a character is not a hex digit
+ * (the content of 'dst' is undefined then).
+ *
+ * Example:
+ *   unsigned char key[32];
+ *   if (hex_decode(val_string(str), 64, key) != 0) { ... }
+ */
+int hex_decode(const char* src, size_t length, unsigned char* dst);
+
+
+/*
+ * Encodes 'length' bytes into 2 * 'length' lowercase hex digits (not NUL terminated).
+ *
+ * Example:
+ *   char hex[2 * 32];
+ *   hex_encode(sum, 32, hex);
+ */
+void hex_encode(const unsigned char* src, size_t length, char* dst);
+
+
+/*
+ * Converts a flat Haxe array of (BytesData, pos, length) triples, as built by
+ * polarssl.Segments, into C byte ranges that can be processed as one stream.
+ *
+ * Attn: The ranges are expected to have been validated on the Haxe side.
+ *
+ * Example:
+ *   size_t count, total;
+ *   s_bytes* parts = segments_fromHaxe(segments, &count, &total);
+ */
+s_bytes* segments_fromHaxe(value segments, size_t* count, size_t* total);
+
+
 /*
  * Raises a Neko exception for the given PolarSSL error code.
  *
@@ -47,6 +94,15 @@ void throw_err(int errnum);
  */
 value value_fromBytes(const unsigned char* bytes, size_t length);
 
+
+/*
+ * Converts C bytes to a Haxe String holding their lowercase hex encoding.
+ *
+ * Example:
+ *   value hex = value_hexFromBytes(sum, sizeof(sum));
+ */
+value value_hexFromBytes(const unsigned char* bytes, size_t length);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -38,6 +38,32 @@ DECLARE_KIND(k_xtea_context);
 value hx_xtea_crypt_cbc(value xtea_context, value mode, value length, value iv, value input);
 
 
+/*
+ * XTEA CBC cipher function for a batch of independent frames, each with its own IV.
+ *
+ * The frames are read back-to-back from 'input' and written back-to-back to 'output'
+ * (which may be the same range as 'input'); the IVs are read (but not updated) from the
+ * 8 bytes slots in 'ivs'. All frames are processed within a single call.
+ *
+ * See:
+ *   https://polarssl.org/api/xtea_8h.html
+ *
+ * Example:
+ *   hx_xtea_crypt_cbc_batch(xtea, alloc_int(XTEA_DECRYPT), lengths, [ ivs, alloc_int(0) ], [ alloc_int(total), in, alloc_int(0), out, alloc_int(0) ]);
+ *
+ * Parameters:
+ *   value[k_xtea_context] xtea_context the XTEA context to use
+ *   value[Int]            mode         XTEA_ENCRYPT or XTEA_DECRYPT
+ *   value[Array<Int>]     lengths      the length of each frame (each must be % 8 == 0)
+ *   value[Array]          ivArr        [ivs:BytesData, ivPos:Int] holding 8 * lengths.length bytes
+ *   value[Array]          ioArr        [length:Int, input:BytesData, inPos:Int, output:BytesData, outPos:Int]
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_xtea_crypt_cbc_batch(value xtea_context, value mode, value lengths, value ivArr, value ioArr);
+
+
 /**
  * XTEA ECB cipher function.
  *
@@ -59,6 +85,26 @@ value hx_xtea_crypt_cbc(value xtea_context, value mode, value length, value iv,
 value hx_xtea_crypt_ecb(value xtea_context, value mode, value input);
 
 
+/*
+ * XTEA ECB cipher function for any number of consecutive blocks, writing into the caller's buffer.
+ *
+ * See:
+ *   https://polarssl.org/api/xtea_8h.html
+ *
+ * Example:
+ *   hx_xtea_crypt_ecb_into(xtea, alloc_int(XTEA_ENCRYPT), [ alloc_int(len), buf, alloc_int(0), buf, alloc_int(0) ]);
+ *
+ * Parameters:
+ *   value[k_xtea_context] xtea_context the XTEA context to use
+ *   value[Int]            mode         XTEA_ENCRYPT or XTEA_DECRYPT
+ *   value[Array]          ioArr        [length:Int (% 8 == 0), input:BytesData, inPos:Int, output:BytesData, outPos:Int]
+ *
+ * Returns:
+ *   value[Int] the return code which is 0 == OK; other codes also raise a Neko error.
+ */
+value hx_xtea_crypt_ecb_into(value xtea_context, value mode, value ioArr);
+
+
 /*
  * Frees the XTEA context and all resources allocated for it.
  *
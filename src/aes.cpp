@@ -1,6 +1,8 @@
 #define  NEKO_COMPATIBLE
 #include <hx/CFFI.h>
 #include <stdlib.h>
+#include <string.h>
+#include <vector>
 #include <polarssl/aes.h>
 
 #include "hxpolarssl/aes.hpp"
@@ -34,6 +36,73 @@ value hx_aes_crypt_cbc(value context, value mode, value length, value iv, value
 DEFINE_PRIM(hx_aes_crypt_cbc, 5);
 
 
+value hx_aes_crypt_cbcv(value context, value mode, value iv, value segments)
+{
+    val_check_aes_context(context);
+    val_check(mode, int);
+    val_check(segments, array);
+
+    size_t count;
+    size_t total;
+    s_bytes* parts = segments_fromHaxe(segments, &count, &total);
+    if (total % AES_BLOCKSIZE != 0) {
+        throw_err(POLARSSL_ERR_AES_INVALID_INPUT_LENGTH);
+        return alloc_int(POLARSSL_ERR_AES_INVALID_INPUT_LENGTH);
+    }
+
+    aes_context* ctx = val_aes_context(context);
+    unsigned char* _iv = data_fromHaxe(iv);
+    std::vector<unsigned char> output(total + 1);
+    unsigned char block[AES_BLOCKSIZE];
+    size_t filled  = 0; // bytes of a block straddling segment boundaries
+    size_t written = 0;
+
+    int ret = 0;
+    for (size_t i = 0; i < count && ret == 0; ++i) {
+        const unsigned char* data = parts[i].data;
+        size_t length             = parts[i].length;
+
+        if (filled > 0) {
+            const size_t n = (length < AES_BLOCKSIZE - filled) ? length : AES_BLOCKSIZE - filled;
+            memcpy(block + filled, data, n);
+            filled += n;
+            data   += n;
+            length -= n;
+            if (filled == AES_BLOCKSIZE) {
+                ret      = aes_crypt_cbc(ctx, val_int(mode), AES_BLOCKSIZE, _iv, block, &output[written]);
+                written += AES_BLOCKSIZE;
+                filled   = 0;
+            }
+        }
+
+        // whole blocks are crypted straight from the segment
+        const size_t whole = length - (length % AES_BLOCKSIZE);
+        if (whole > 0 && ret == 0) {
+            ret      = aes_crypt_cbc(ctx, val_int(mode), whole, _iv, data, &output[written]);
+            written += whole;
+            data    += whole;
+            length  -= whole;
+        }
+
+        memcpy(block + filled, data, length);
+        filled += length;
+    }
+    memset(block, 0, sizeof(block));
+
+    value val;
+    if (ret == 0) {
+        val = value_fromBytes(&output[0], total);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+    memset(&output[0], 0, output.size());
+
+    return val;
+}
+DEFINE_PRIM(hx_aes_crypt_cbcv, 4);
+
+
 value hx_aes_crypt_ecb(value context, value mode, value input)
 {
     val_check_aes_context(context);
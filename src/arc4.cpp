@@ -13,7 +13,7 @@ DEFINE_KIND(k_arc4_context);
 
 value hx_arc4_crypt(value context, value length, value input)
 {
-    val_arc4_context(context);
+    val_check_arc4_context(context);
 
     const size_t size = val_int(length);
     s_bytes* bytes    = bytes_fromHaxe(input, length);
@@ -33,6 +33,29 @@ value hx_arc4_crypt(value context, value length, value input)
 DEFINE_PRIM(hx_arc4_crypt, 3);
 
 
+value hx_arc4_crypt_into(value context, value ioArr)
+{
+    val_check_arc4_context(context);
+    val_check(ioArr, array);
+    val_check(val_array_i(ioArr, 0), int);
+    val_check(val_array_i(ioArr, 2), int);
+    val_check(val_array_i(ioArr, 4), int);
+
+    const size_t size          = val_int(val_array_i(ioArr, 0));
+    const unsigned char* input = data_fromHaxe(val_array_i(ioArr, 1)) + val_int(val_array_i(ioArr, 2));
+    unsigned char* output      = data_fromHaxe(val_array_i(ioArr, 3)) + val_int(val_array_i(ioArr, 4));
+
+    // arc4_crypt() reads each byte before writing it, so input == output is fine
+    int ret = arc4_crypt(val_arc4_context(context), size, input, output);
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_arc4_crypt_into, 2);
+
+
 value hx_arc4_free(value context)
 {
     val_check_arc4_context(context);
@@ -83,6 +106,31 @@ value hx_arc4_setup(value context, value key, value keylen)
 DEFINE_PRIM(hx_arc4_setup, 3);
 
 
+value hx_arc4_skip(value context, value count)
+{
+    val_check_arc4_context(context);
+    val_check(count, int);
+
+    // same state update as arc4_crypt(), minus the keystream output
+    arc4_context* _context = val_arc4_context(context);
+    unsigned char* m       = _context->m;
+    int x                  = _context->x;
+    int y                  = _context->y;
+    for (int i = val_int(count); i > 0; --i) {
+        x = (x + 1) & 0xFF;
+        const unsigned char a = m[x];
+        y = (y + a) & 0xFF;
+        m[x] = m[y];
+        m[y] = a;
+    }
+    _context->x = x;
+    _context->y = y;
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_arc4_skip, 2);
+
+
 void finalize_arc4_context(value context)
 {
     val_check_arc4_context(context);
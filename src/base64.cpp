@@ -1,23 +1,593 @@
 #define  NEKO_COMPATIBLE
 #include <hx/CFFI.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define BASE64_HAVE_X86_SIMD
+    #include <immintrin.h>
+#endif
 #include <polarssl/base64.h>
 
 #include "hxpolarssl/utils.hpp"
 #include "hxpolarssl/base64.hpp"
 
+static const unsigned char base64_enc_map[64] = {
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
+};
+
+static const unsigned char base64_url_enc_map[64] = {
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '-', '_'
+};
+
+/*
+ * Maps characters to their 6 bit values; 127 marks characters outside of the alphabet.
+ */
+static const unsigned char base64_dec_map[128] = {
+    127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+    127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+    127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,  62, 127, 127, 127,  63,
+     52,  53,  54,  55,  56,  57,  58,  59,  60,  61, 127, 127, 127, 127, 127, 127,
+    127,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,
+     15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25, 127, 127, 127, 127, 127,
+    127,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,
+     41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51, 127, 127, 127, 127, 127
+};
+
+static const unsigned char base64_url_dec_map[128] = {
+    127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+    127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+    127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,  62, 127, 127,
+     52,  53,  54,  55,  56,  57,  58,  59,  60,  61, 127, 127, 127, 127, 127, 127,
+    127,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,
+     15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25, 127, 127, 127, 127,  63,
+    127,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,
+     41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51, 127, 127, 127, 127, 127
+};
+
+
+#ifdef BASE64_HAVE_X86_SIMD
+
+/*
+ * Widest codec kernel usable on this CPU (and OS, for the AVX2 state).
+ */
+#define BASE64_SIMD_NONE   0
+#define BASE64_SIMD_SSSE3  1
+#define BASE64_SIMD_AVX2   2
+
+static int base64_detect_simd(void)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return BASE64_SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return BASE64_SIMD_SSSE3;
+    }
+
+    return BASE64_SIMD_NONE;
+}
+
+
+static int base64_simd(void)
+{
+    static const int simd = base64_detect_simd();
+    return simd;
+}
+
+
+/*
+ * Encodes 12 bytes of 'src' (16 are read) into 16 characters.
+ *
+ * The 6 bit indices are split out with two multiplies, then mapped to ASCII by adding
+ * a per-range offset looked up with pshufb (the last two ranges select the alphabet).
+ *
+ * See:
+ *   http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html
+ */
+__attribute__((target("ssse3")))
+static void base64_encode12_ssse3(const unsigned char* src, unsigned char* dst, const bool urlsafe)
+{
+    const char c62 = urlsafe ? '-' - 62 : '+' - 62;
+    const char c63 = urlsafe ? '_' - 63 : '/' - 63;
+    const __m128i shift_lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, c62,
+                                            c63, 'A', 0, 0);
+
+    __m128i in = _mm_loadu_si128((const __m128i*)src);
+    in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+    const __m128i t0      = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    const __m128i t1      = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t0, t1);
+
+    __m128i offsets = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    offsets = _mm_or_si128(offsets, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+    offsets = _mm_shuffle_epi8(shift_lut, offsets);
+
+    _mm_storeu_si128((__m128i*)dst, _mm_add_epi8(indices, offsets));
+}
+
+
+/*
+ * Encodes 24 bytes of 'src' (28 are read) into 32 characters; the AVX2 version of the above.
+ */
+__attribute__((target("avx2")))
+static void base64_encode24_avx2(const unsigned char* src, unsigned char* dst, const bool urlsafe)
+{
+    const char c62 = urlsafe ? '-' - 62 : '+' - 62;
+    const char c63 = urlsafe ? '_' - 63 : '/' - 63;
+    const __m256i shift_lut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                               '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, c62,
+                                               c63, 'A', 0, 0,
+                                               'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                               '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, c62,
+                                               c63, 'A', 0, 0);
+
+    __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)src)),
+                                         _mm_loadu_si128((const __m128i*)(src + 12)), 1);
+    in = _mm256_shuffle_epi8(in, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                                  1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+    const __m256i t0      = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+    const __m256i t1      = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+    const __m256i indices = _mm256_or_si256(t0, t1);
+
+    __m256i offsets = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    offsets = _mm256_or_si256(offsets, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+    offsets = _mm256_shuffle_epi8(shift_lut, offsets);
+
+    _mm256_storeu_si256((__m256i*)dst, _mm256_add_epi8(indices, offsets));
+}
+
+
+/*
+ * Decodes 16 characters of 'src' into 12 bytes (16 are written).
+ *
+ * Returns false, without consuming anything, if any of the characters is outside of the
+ * alphabet (padding and line breaks included); the scalar decoder handles those.
+ * URL-safe input is mapped onto the standard alphabet first.
+ *
+ * See:
+ *   http://0x80.pl/notesen/2016-01-17-sse-base64-decoding.html
+ */
+__attribute__((target("ssse3")))
+static bool base64_decode16_ssse3(const unsigned char* src, unsigned char* dst, const bool urlsafe)
+{
+    const __m128i lut_lo   = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                           0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi   = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                           0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    __m128i in = _mm_loadu_si128((const __m128i*)src);
+    if (urlsafe) {
+        const __m128i plus  = _mm_cmpeq_epi8(in, _mm_set1_epi8('+'));
+        const __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+        if (_mm_movemask_epi8(_mm_or_si128(plus, slash)) != 0) {
+            return false;
+        }
+        const __m128i minus = _mm_cmpeq_epi8(in, _mm_set1_epi8('-'));
+        const __m128i under = _mm_cmpeq_epi8(in, _mm_set1_epi8('_'));
+        in = _mm_or_si128(_mm_andnot_si128(_mm_or_si128(minus, under), in),
+                          _mm_or_si128(_mm_and_si128(minus, _mm_set1_epi8('+')), _mm_and_si128(under, _mm_set1_epi8('/'))));
+    }
+
+    const __m128i hi_nib   = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0F));
+    const __m128i lo_nib   = _mm_and_si128(in, _mm_set1_epi8(0x0F));
+    const __m128i invalid  = _mm_and_si128(_mm_shuffle_epi8(lut_lo, lo_nib), _mm_shuffle_epi8(lut_hi, hi_nib));
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(invalid, _mm_setzero_si128())) != 0) {
+        return false;
+    }
+
+    const __m128i roll   = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(in, _mm_set1_epi8(0x2F)), hi_nib));
+    const __m128i values = _mm_add_epi8(in, roll);
+
+    // merge the 6 bit values into 24 bit groups, then squeeze out the empty bytes
+    const __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+    const __m128i out    = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    _mm_storeu_si128((__m128i*)dst, out);
+
+    return true;
+}
+
+
+/*
+ * Decodes 32 characters of 'src' into 24 bytes (32 are written); the AVX2 version of the above.
+ */
+__attribute__((target("avx2")))
+static bool base64_decode32_avx2(const unsigned char* src, unsigned char* dst, const bool urlsafe)
+{
+    const __m256i lut_lo   = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                              0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                              0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                              0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lut_hi   = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                              0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                              0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                              0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    __m256i in = _mm256_loadu_si256((const __m256i*)src);
+    if (urlsafe) {
+        const __m256i plus  = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('+'));
+        const __m256i slash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+        if (_mm256_movemask_epi8(_mm256_or_si256(plus, slash)) != 0) {
+            return false;
+        }
+        const __m256i minus = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('-'));
+        const __m256i under = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('_'));
+        in = _mm256_or_si256(_mm256_andnot_si256(_mm256_or_si256(minus, under), in),
+                             _mm256_or_si256(_mm256_and_si256(minus, _mm256_set1_epi8('+')), _mm256_and_si256(under, _mm256_set1_epi8('/'))));
+    }
+
+    const __m256i hi_nib   = _mm256_and_si256(_mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x0F));
+    const __m256i lo_nib   = _mm256_and_si256(in, _mm256_set1_epi8(0x0F));
+    const __m256i invalid  = _mm256_and_si256(_mm256_shuffle_epi8(lut_lo, lo_nib), _mm256_shuffle_epi8(lut_hi, hi_nib));
+    if (_mm256_movemask_epi8(_mm256_cmpgt_epi8(invalid, _mm256_setzero_si256())) != 0) {
+        return false;
+    }
+
+    const __m256i roll   = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(_mm256_cmpeq_epi8(in, _mm256_set1_epi8(0x2F)), hi_nib));
+    const __m256i values = _mm256_add_epi8(in, roll);
+
+    const __m256i merged = _mm256_madd_epi16(_mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+    __m256i out = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                               2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    out = _mm256_permutevar8x32_epi32(out, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    _mm256_storeu_si256((__m256i*)dst, out);
+
+    return true;
+}
+
+#endif /* BASE64_HAVE_X86_SIMD */
+
+
+/*
+ * Returns the exact (padded, unwrapped) encoded length of 'length' bytes.
+ */
+static inline size_t base64_encoded_length(const size_t length)
+{
+    return ((length + 2) / 3) * 4;
+}
+
+
+/*
+ * Returns the buffer size needed to encode 'length' more bytes of the stream (including up
+ * to two carried over bytes and the line breaks).
+ */
+static inline size_t base64_encode_bound(const s_base64_stream* stream, const size_t length)
+{
+    const size_t chars = base64_encoded_length(length + 2);
+    if (stream->line_length == 0) {
+        return chars;
+    }
+
+    return chars + 2 * (chars / stream->line_length + 1);
+}
+
+
+/*
+ * Returns the buffer size needed to decode 'length' more characters (including up to three
+ * carried over from a previous chunk and the slack the vector kernels write past the data).
+ */
+static inline size_t base64_decode_bound(const size_t length)
+{
+    return ((length + 3) / 4) * 3 + 32;
+}
+
+
+/*
+ * Encodes 'length' bytes in the alphabet selected by 'flags' and returns the number of
+ * characters written (base64_encoded_length(length), less the padding with BASE64_NOPAD).
+ */
+static size_t base64_encode_fast(const unsigned char* src, const size_t length, unsigned char* dst, const int flags)
+{
+    const unsigned char* map = (flags & BASE64_URLSAFE) ? base64_url_enc_map : base64_enc_map;
+    size_t i = 0;
+    size_t p = 0;
+
+#ifdef BASE64_HAVE_X86_SIMD
+    const int simd     = (length >= 16) ? base64_simd() : BASE64_SIMD_NONE;
+    const bool urlsafe = (flags & BASE64_URLSAFE) != 0;
+    if (simd == BASE64_SIMD_AVX2) {
+        for (; length - i >= 28; i += 24, p += 32) {
+            base64_encode24_avx2(src + i, dst + p, urlsafe);
+        }
+    }
+    if (simd != BASE64_SIMD_NONE) {
+        for (; length - i >= 16; i += 12, p += 16) {
+            base64_encode12_ssse3(src + i, dst + p, urlsafe);
+        }
+    }
+#endif
+
+    for (; length - i >= 3; i += 3) {
+        const uint32_t x = ((uint32_t)src[i] << 16) | ((uint32_t)src[i + 1] << 8) | src[i + 2];
+        dst[p++] = map[(x >> 18) & 0x3F];
+        dst[p++] = map[(x >> 12) & 0x3F];
+        dst[p++] = map[(x >>  6) & 0x3F];
+        dst[p++] = map[x & 0x3F];
+    }
+
+    if (i < length) {
+        const uint32_t x = ((uint32_t)src[i] << 16) | ((i + 1 < length) ? ((uint32_t)src[i + 1] << 8) : 0);
+        dst[p++] = map[(x >> 18) & 0x3F];
+        dst[p++] = map[(x >> 12) & 0x3F];
+        if (i + 1 < length) {
+            dst[p++] = map[(x >> 6) & 0x3F];
+        } else if (!(flags & BASE64_NOPAD)) {
+            dst[p++] = '=';
+        }
+        if (!(flags & BASE64_NOPAD)) {
+            dst[p++] = '=';
+        }
+    }
+
+    return p;
+}
+
+
+/*
+ * Encodes 'length' bytes (a multiple of 3, unless it is the final group) continuing the
+ * current line, and returns the number of characters written.
+ *
+ * Lines are only broken between quanta (the line length is a multiple of 4), and a line
+ * break is only written once more output follows, so there is no trailing one.
+ */
+static size_t base64_encode_wrapped(s_base64_stream* stream, const unsigned char* src, size_t length, unsigned char* dst)
+{
+    if (stream->line_length == 0) {
+        return base64_encode_fast(src, length, dst, stream->flags);
+    }
+
+    size_t p = 0;
+    while (length > 0) {
+        if (stream->column == stream->line_length) {
+            if (!(stream->flags & BASE64_LF)) {
+                dst[p++] = '\r';
+            }
+            dst[p++] = '\n';
+            stream->column = 0;
+        }
+
+        size_t use = ((stream->line_length - stream->column) / 4) * 3;
+        if (use > length) {
+            use = length;
+        }
+        const size_t chars = base64_encode_fast(src, use, dst + p, stream->flags);
+        stream->column += chars;
+        p              += chars;
+        src            += use;
+        length         -= use;
+    }
+
+    return p;
+}
+
+
+static void base64_stream_reset(s_base64_stream* stream, const int mode, const int flags, const int line_length)
+{
+    memset(stream, 0, sizeof(s_base64_stream));
+    stream->mode        = mode;
+    stream->flags       = flags;
+    stream->line_length = (line_length > 0) ? (size_t)(line_length - line_length % 4) : 0;
+}
+
+
+/*
+ * Encodes the next chunk into 'dst' (of base64_encode_bound(length) bytes) and returns the
+ * number of characters written; bytes of an incomplete group are kept in the stream.
+ */
+static size_t base64_encode_update(s_base64_stream* stream, const unsigned char* src, size_t length, unsigned char* dst)
+{
+    size_t p = 0;
+    if (stream->pending_len > 0) {
+        while (stream->pending_len < 3 && length > 0) {
+            stream->pending[stream->pending_len++] = *src++;
+            --length;
+        }
+        if (stream->pending_len < 3) {
+            return 0;
+        }
+        p = base64_encode_wrapped(stream, stream->pending, 3, dst);
+        stream->pending_len = 0;
+    }
+
+    const size_t full = length - (length % 3);
+    p += base64_encode_wrapped(stream, src, full, dst + p);
+    memcpy(stream->pending, src + full, length - full);
+    stream->pending_len = length - full;
+
+    return p;
+}
+
+
+/*
+ * Encodes the kept bytes into 'dst' (of at least 6 bytes) and returns the number of
+ * characters written.
+ */
+static size_t base64_encode_finish(s_base64_stream* stream, unsigned char* dst)
+{
+    const size_t length = base64_encode_wrapped(stream, stream->pending, stream->pending_len, dst);
+    base64_stream_reset(stream, stream->mode, stream->flags, (int)stream->line_length);
+
+    return length;
+}
+
+
+/*
+ * Decodes the next chunk into 'dst' (of 'size' bytes) and stores the number of decoded
+ * bytes in 'olen'; characters of an incomplete quantum are kept in the stream.
+ *
+ * Line breaks are skipped, padding may only complete the last quantum; runs of plain
+ * alphabet characters are handed to the vector kernels as long as the bytes they write
+ * past their output still fit into 'dst', so nothing beyond 'size' is ever touched.
+ * A 'size' of base64_decode_bound(length) is always sufficient.
+ */
+static int base64_decode_update(s_base64_stream* stream, const unsigned char* src, const size_t length, unsigned char* dst, const size_t size, size_t* olen)
+{
+    const unsigned char* map = (stream->flags & BASE64_URLSAFE) ? base64_url_dec_map : base64_dec_map;
+    size_t i      = 0;
+    size_t p      = 0;
+    uint32_t x    = stream->bits;
+    int n         = stream->chars;    // characters of the current quantum
+    int pad       = stream->pad;      // '=' of the current quantum
+    bool finished = stream->finished; // padding seen, only line breaks may follow
+
+    if (stream->failed) {
+        return POLARSSL_ERR_BASE64_INVALID_CHARACTER;
+    }
+
+#ifdef BASE64_HAVE_X86_SIMD
+    const int simd     = (length >= 16) ? base64_simd() : BASE64_SIMD_NONE;
+    const bool urlsafe = (stream->flags & BASE64_URLSAFE) != 0;
+#endif
+
+    while (i < length) {
+#ifdef BASE64_HAVE_X86_SIMD
+        if (simd != BASE64_SIMD_NONE && n == 0 && !finished) {
+            if (simd == BASE64_SIMD_AVX2) {
+                for (; length - i >= 32 && size - p >= 32 && base64_decode32_avx2(src + i, dst + p, urlsafe); i += 32, p += 24);
+            }
+            for (; length - i >= 16 && size - p >= 16 && base64_decode16_ssse3(src + i, dst + p, urlsafe); i += 16, p += 12);
+            if (i == length) {
+                break;
+            }
+        }
+#endif
+
+        const unsigned char c = src[i++];
+        if (c == '\r' || c == '\n') {
+            continue;
+        }
+        if (c == '=') {
+            if (finished || n < 2) {
+                stream->failed = 1;
+                return POLARSSL_ERR_BASE64_INVALID_CHARACTER;
+            }
+            ++pad;
+        } else {
+            if (finished || pad > 0 || c > 127 || map[c] == 127) {
+                stream->failed = 1;
+                return POLARSSL_ERR_BASE64_INVALID_CHARACTER;
+            }
+            x = (x << 6) | map[c];
+            ++n;
+        }
+
+        if (n + pad == 4) {
+            if (size - p < (size_t)(n - 1)) {
+                stream->failed = 1;
+                return POLARSSL_ERR_BASE64_BUFFER_TOO_SMALL;
+            }
+            x <<= 6 * pad;
+            dst[p++] = (unsigned char)(x >> 16);
+            if (n > 2) {
+                dst[p++] = (unsigned char)(x >> 8);
+            }
+            if (n > 3) {
+                dst[p++] = (unsigned char)x;
+            }
+            finished = (pad > 0);
+            n   = 0;
+            pad = 0;
+            x   = 0;
+        }
+    }
+
+    stream->bits     = x;
+    stream->chars    = n;
+    stream->pad      = pad;
+    stream->finished = finished;
+    *olen = p;
+
+    return 0;
+}
+
+
+/*
+ * Checks that the decoded input ended on a complete quantum and resets the stream.
+ *
+ * With BASE64_NOPAD, an unpadded final quantum of 2 or 3 characters is accepted and its
+ * 1 or 2 bytes are written to 'dst' (the number is stored in 'olen').
+ */
+static int base64_decode_finish(s_base64_stream* stream, unsigned char dst[2], size_t* olen)
+{
+    int ret = 0;
+    *olen   = 0;
+    if (stream->failed || stream->pad != 0) {
+        ret = POLARSSL_ERR_BASE64_INVALID_CHARACTER;
+    } else if (stream->chars != 0) {
+        if ((stream->flags & BASE64_NOPAD) && stream->chars >= 2) {
+            const uint32_t x = stream->bits << (6 * (4 - stream->chars));
+            dst[(*olen)++] = (unsigned char)(x >> 16);
+            if (stream->chars > 2) {
+                dst[(*olen)++] = (unsigned char)(x >> 8);
+            }
+        } else {
+            ret = POLARSSL_ERR_BASE64_INVALID_CHARACTER;
+        }
+    }
+    base64_stream_reset(stream, stream->mode, stream->flags, (int)stream->line_length);
+
+    return ret;
+}
+
+
+/*
+ * Decodes the complete input into 'dst' (of 'size' bytes) and stores the number of
+ * decoded bytes in 'olen'.
+ */
+static int base64_decode_all(const unsigned char* src, const size_t length, const int flags, unsigned char* dst, const size_t size, size_t* olen)
+{
+    s_base64_stream stream;
+    unsigned char tail[2];
+    size_t tail_len = 0;
+
+    base64_stream_reset(&stream, BASE64_DECODE, flags, 0);
+    int ret = base64_decode_update(&stream, src, length, dst, size, olen);
+    if (ret == 0) {
+        ret = base64_decode_finish(&stream, tail, &tail_len);
+    }
+    if (ret == 0) {
+        if (size - *olen < tail_len) {
+            ret = POLARSSL_ERR_BASE64_BUFFER_TOO_SMALL;
+        } else {
+            memcpy(dst + *olen, tail, tail_len);
+            *olen += tail_len;
+        }
+    }
+
+    return ret;
+}
+
+
 extern "C" {
 
-value hx_base64_decode(value bytes, value length)
+DEFINE_KIND(k_base64_stream);
+
+
+value hx_base64_decode(value bytes, value length, value flags)
 {
+    val_check(flags, int);
+
     s_bytes* cbytes = bytes_fromHaxe(bytes, length);
 
     value val;
     size_t dlen = 0;
-    int ret = base64_decode(NULL, &dlen, cbytes->data, cbytes->length); // get required buffer length
-    unsigned char decoded[dlen];
-    ret = base64_decode(decoded, &dlen, cbytes->data, cbytes->length);
+    std::vector<unsigned char> decoded(base64_decode_bound(cbytes->length));
+    int ret = base64_decode_all(cbytes->data, cbytes->length, val_int(flags), &decoded[0], decoded.size(), &dlen);
     if (ret == 0) {
-        val = value_fromBytes(decoded, dlen);
+        val = value_fromBytes(&decoded[0], dlen);
     } else {
         throw_err(ret);
         val = alloc_int(ret);
@@ -25,20 +595,45 @@ value hx_base64_decode(value bytes, value length)
 
     return val;
 }
-DEFINE_PRIM(hx_base64_decode, 2);
+DEFINE_PRIM(hx_base64_decode, 3);
 
 
-value hx_base64_encode(value bytes, value length)
+value hx_base64_decode_into(value str, value flags, value bytes, value pos, value size)
 {
-    s_bytes* cbytes = bytes_fromHaxe(bytes, length);
+    val_check(str, string);
+    val_check(flags, int);
+    val_check(pos, int);
+    val_check(size, int);
+
+    const unsigned char* src = (const unsigned char*)val_string(str);
+    unsigned char* output    = data_fromHaxe(bytes) + val_int(pos);
+
+    size_t dlen = 0;
+    int ret = base64_decode_all(src, val_strlen(str), val_int(flags), output, val_int(size), &dlen);
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    return alloc_int((int)dlen);
+}
+DEFINE_PRIM(hx_base64_decode_into, 5);
+
+
+value hx_base64_decode_string(value str, value flags)
+{
+    val_check(str, string);
+    val_check(flags, int);
+
+    const unsigned char* src = (const unsigned char*)val_string(str);
+    const size_t length      = val_strlen(str);
 
     value val;
     size_t dlen = 0;
-    int ret = base64_encode(NULL, &dlen, cbytes->data, cbytes->length); // get required buffer length
-    unsigned char encoded[dlen];
-    ret = base64_encode(encoded, &dlen, cbytes->data, cbytes->length);
+    std::vector<unsigned char> decoded(base64_decode_bound(length));
+    int ret = base64_decode_all(src, length, val_int(flags), &decoded[0], decoded.size(), &dlen);
     if (ret == 0) {
-        val = value_fromBytes(encoded, dlen);
+        val = value_fromBytes(&decoded[0], dlen);
     } else {
         throw_err(ret);
         val = alloc_int(ret);
@@ -46,7 +641,41 @@ value hx_base64_encode(value bytes, value length)
 
     return val;
 }
-DEFINE_PRIM(hx_base64_encode, 2);
+DEFINE_PRIM(hx_base64_decode_string, 2);
+
+
+value hx_base64_encode(value bytes, value length, value flags, value line_length)
+{
+    val_check(flags, int);
+    val_check(line_length, int);
+
+    s_bytes* cbytes = bytes_fromHaxe(bytes, length);
+
+    s_base64_stream stream;
+    base64_stream_reset(&stream, BASE64_ENCODE, val_int(flags), val_int(line_length));
+    std::vector<unsigned char> encoded(base64_encode_bound(&stream, cbytes->length) + 1);
+    const size_t dlen = base64_encode_wrapped(&stream, cbytes->data, cbytes->length, &encoded[0]);
+
+    return value_fromBytes(&encoded[0], dlen);
+}
+DEFINE_PRIM(hx_base64_encode, 4);
+
+
+value hx_base64_encode_string(value bytes, value length, value flags, value line_length)
+{
+    val_check(flags, int);
+    val_check(line_length, int);
+
+    s_bytes* cbytes = bytes_fromHaxe(bytes, length);
+
+    s_base64_stream stream;
+    base64_stream_reset(&stream, BASE64_ENCODE, val_int(flags), val_int(line_length));
+    std::vector<unsigned char> encoded(base64_encode_bound(&stream, cbytes->length) + 1);
+    const size_t dlen = base64_encode_wrapped(&stream, cbytes->data, cbytes->length, &encoded[0]);
+
+    return alloc_string_len((const char*)&encoded[0], (int)dlen);
+}
+DEFINE_PRIM(hx_base64_encode_string, 4);
 
 
 value hx_base64_self_test(value verbose)
@@ -54,6 +683,87 @@ value hx_base64_self_test(value verbose)
     val_check(verbose, bool);
 
     int ret = base64_self_test(val_bool(verbose));
+
+    // cross-check the vectorized codec against PolarSSL's over lengths hitting every kernel and tail
+    if (ret == 0) {
+        if (val_bool(verbose)) {
+            printf("  Base64 vector codec test: ");
+        }
+
+        unsigned char src[200];
+        for (size_t i = 0; i < sizeof(src); ++i) {
+            src[i] = (unsigned char)(i * 131 + 7);
+        }
+        std::vector<unsigned char> ref(base64_encoded_length(sizeof(src)) + 1);
+        std::vector<unsigned char> enc(ref.size());
+        std::vector<unsigned char> dec(base64_decode_bound(ref.size()));
+        for (size_t len = 0; len <= sizeof(src) && ret == 0; ++len) {
+            s_base64_stream stream;
+            const size_t split = len / 3;
+            size_t rlen = ref.size();
+            size_t elen = 0;
+            size_t dlen = 0;
+            size_t part = 0;
+            size_t tail = 0;
+
+            ret = base64_encode(&ref[0], &rlen, src, len);
+            if (ret == 0) {
+                // streamed in two chunks to also cover carried over groups and quanta
+                base64_stream_reset(&stream, BASE64_ENCODE, 0, 0);
+                elen  = base64_encode_update(&stream, src, split, &enc[0]);
+                elen += base64_encode_update(&stream, src + split, len - split, &enc[elen]);
+                elen += base64_encode_finish(&stream, &enc[elen]);
+                if (rlen != base64_encoded_length(len) || elen != rlen || memcmp(&ref[0], &enc[0], rlen) != 0) {
+                    ret = 1;
+                }
+            }
+            if (ret == 0) {
+                base64_stream_reset(&stream, BASE64_DECODE, 0, 0);
+                ret = base64_decode_update(&stream, &enc[0], rlen / 3, &dec[0], dec.size(), &dlen);
+                if (ret == 0) {
+                    ret = base64_decode_update(&stream, &enc[rlen / 3], rlen - rlen / 3, &dec[dlen], dec.size() - dlen, &part);
+                }
+                if (ret == 0) {
+                    ret = base64_decode_finish(&stream, &dec[dlen + part], &tail);
+                }
+                if (ret == 0 && (dlen + part + tail != len || memcmp(&dec[0], src, len) != 0)) {
+                    ret = 1;
+                }
+            }
+        }
+
+        // URL-safe alphabet, no padding and line wrapping in a single pass
+        if (ret == 0) {
+            static const unsigned char variant_src[4] = { 0xFB, 0xFF, 0xFE, 0x61 };
+            static const char variant_enc[]           = "-__-\nYQ";
+            s_base64_stream stream;
+            size_t elen = 0;
+            size_t dlen = 0;
+            size_t tail = 0;
+
+            base64_stream_reset(&stream, BASE64_ENCODE, BASE64_URLSAFE | BASE64_NOPAD | BASE64_LF, 4);
+            elen  = base64_encode_update(&stream, variant_src, sizeof(variant_src), &enc[0]);
+            elen += base64_encode_finish(&stream, &enc[elen]);
+            if (elen != sizeof(variant_enc) - 1 || memcmp(&enc[0], variant_enc, elen) != 0) {
+                ret = 1;
+            }
+            if (ret == 0) {
+                base64_stream_reset(&stream, BASE64_DECODE, BASE64_URLSAFE | BASE64_NOPAD, 0);
+                ret = base64_decode_update(&stream, &enc[0], elen, &dec[0], dec.size(), &dlen);
+                if (ret == 0) {
+                    ret = base64_decode_finish(&stream, &dec[dlen], &tail);
+                }
+                if (ret == 0 && (dlen + tail != sizeof(variant_src) || memcmp(&dec[0], variant_src, sizeof(variant_src)) != 0)) {
+                    ret = 1;
+                }
+            }
+        }
+
+        if (val_bool(verbose)) {
+            printf((ret == 0) ? "passed\n\n" : "failed\n");
+        }
+    }
+
     if (ret != 0) {
         throw_err(ret);
     }
@@ -62,4 +772,85 @@ value hx_base64_self_test(value verbose)
 }
 DEFINE_PRIM(hx_base64_self_test, 1);
 
+
+value hx_base64_stream_finish(value stream)
+{
+    val_check_base64_stream(stream);
+
+    s_base64_stream* _stream = val_base64_stream(stream);
+    unsigned char out[8];
+    size_t olen = 0;
+    if (_stream->mode == BASE64_ENCODE) {
+        olen = base64_encode_finish(_stream, out);
+    } else {
+        int ret = base64_decode_finish(_stream, out, &olen);
+        if (ret != 0) {
+            throw_err(ret);
+            return alloc_int(ret);
+        }
+    }
+
+    return value_fromBytes(out, olen);
+}
+DEFINE_PRIM(hx_base64_stream_finish, 1);
+
+
+value hx_base64_stream_init(value mode, value flags, value line_length)
+{
+    val_check(mode, int);
+    val_check(flags, int);
+    val_check(line_length, int);
+
+    s_base64_stream* stream = malloc_base64_stream();
+    base64_stream_reset(stream, (val_int(mode) == BASE64_ENCODE) ? BASE64_ENCODE : BASE64_DECODE, val_int(flags), val_int(line_length));
+
+    value val = alloc_base64_stream(stream);
+    val_gc(val, finalize_base64_stream);
+
+    return val;
+}
+DEFINE_PRIM(hx_base64_stream_init, 3);
+
+
+value hx_base64_stream_update(value stream, value bytes, value pos, value length)
+{
+    val_check_base64_stream(stream);
+    val_check(pos, int);
+    val_check(length, int);
+
+    s_base64_stream* _stream   = val_base64_stream(stream);
+    const unsigned char* input = data_fromHaxe(bytes) + val_int(pos);
+    const size_t len           = val_int(length);
+    size_t olen                = 0;
+
+    if (_stream->mode == BASE64_ENCODE) {
+        std::vector<unsigned char> encoded(base64_encode_bound(_stream, len) + 1);
+        olen = base64_encode_update(_stream, input, len, &encoded[0]);
+
+        return value_fromBytes(&encoded[0], olen);
+    }
+
+    std::vector<unsigned char> decoded(base64_decode_bound(len));
+    int ret = base64_decode_update(_stream, input, len, &decoded[0], decoded.size(), &olen);
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    return value_fromBytes(&decoded[0], olen);
+}
+DEFINE_PRIM(hx_base64_stream_update, 4);
+
+
+void finalize_base64_stream(value stream)
+{
+    val_check_base64_stream(stream);
+
+    if (stream != NULL) {
+        s_base64_stream* _stream = val_base64_stream(stream);
+        memset(_stream, 0, sizeof(s_base64_stream));
+        _stream = NULL;
+    }
+}
+
 } // extern "C"
@@ -1,6 +1,8 @@
 #define  NEKO_COMPATIBLE
 #include <hx/CFFI.h>
 #include <stdlib.h>
+#include <string.h>
+#include <vector>
 #include <polarssl/blowfish.h>
 
 #include "hxpolarssl/blowfish.hpp"
@@ -9,6 +11,7 @@
 extern "C" {
 
 DEFINE_KIND(k_blowfish_context);
+DEFINE_KIND(k_blowfish_stream);
 
 
 value hx_blowfish_crypt_cbc(value context, value mode, value length, value iv, value input)
@@ -18,22 +21,72 @@ value hx_blowfish_crypt_cbc(value context, value mode, value length, value iv, v
 
     s_bytes* _iv = bytes_fromHaxe(iv, alloc_int(BLOWFISH_BLOCKSIZE));
     s_bytes* _in = bytes_fromHaxe(input, length);
-    unsigned char output[_in->length];
+    std::vector<unsigned char> output(_in->length + 1);
 
     value val;
-    int ret = blowfish_crypt_cbc(val_blowfish_context(context), val_int(mode), _in->length, (unsigned char*)_iv->data, _in->data, output);
+    int ret = blowfish_crypt_cbc(val_blowfish_context(context), val_int(mode), _in->length, (unsigned char*)_iv->data, _in->data, &output[0]);
     if (ret == 0) {
-        val = value_fromBytes(output, _in->length);
+        val = value_fromBytes(&output[0], _in->length);
     } else {
         throw_err(ret);
         val = alloc_int(ret);
     }
+    memset(&output[0], 0, output.size());
 
     return val;
 }
 DEFINE_PRIM(hx_blowfish_crypt_cbc, 5);
 
 
+value hx_blowfish_crypt_cfb64(value context, value stream, value mode, value length, value input)
+{
+    val_check_blowfish_context(context);
+    val_check_blowfish_stream(stream);
+    val_check(mode, int);
+
+    s_blowfish_stream* _stream = val_blowfish_stream(stream);
+    s_bytes* _in               = bytes_fromHaxe(input, length);
+    std::vector<unsigned char> output(_in->length + 1);
+
+    value val;
+    int ret = blowfish_crypt_cfb64(val_blowfish_context(context), val_int(mode), _in->length, &(_stream->offset), _stream->iv, _in->data, &output[0]);
+    if (ret == 0) {
+        val = value_fromBytes(&output[0], _in->length);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+    memset(&output[0], 0, output.size());
+
+    return val;
+}
+DEFINE_PRIM(hx_blowfish_crypt_cfb64, 5);
+
+
+value hx_blowfish_crypt_ctr(value context, value stream, value length, value input)
+{
+    val_check_blowfish_context(context);
+    val_check_blowfish_stream(stream);
+
+    s_blowfish_stream* _stream = val_blowfish_stream(stream);
+    s_bytes* _in               = bytes_fromHaxe(input, length);
+    std::vector<unsigned char> output(_in->length + 1);
+
+    value val;
+    int ret = blowfish_crypt_ctr(val_blowfish_context(context), _in->length, &(_stream->offset), _stream->iv, _stream->stream_block, _in->data, &output[0]);
+    if (ret == 0) {
+        val = value_fromBytes(&output[0], _in->length);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+    memset(&output[0], 0, output.size());
+
+    return val;
+}
+DEFINE_PRIM(hx_blowfish_crypt_ctr, 4);
+
+
 value hx_blowfish_crypt_ecb(value context, value mode, value input)
 {
     val_check_blowfish_context(context);
@@ -96,6 +149,23 @@ value hx_blowfish_setkey(value context, value key, value keysize)
 DEFINE_PRIM(hx_blowfish_setkey, 3);
 
 
+value hx_blowfish_stream_init(value iv)
+{
+    s_bytes* _iv = bytes_fromHaxe(iv, alloc_int(BLOWFISH_BLOCKSIZE));
+
+    s_blowfish_stream* stream = malloc_blowfish_stream();
+    stream->offset = 0;
+    memcpy(stream->iv, _iv->data, BLOWFISH_BLOCKSIZE);
+    memset(stream->stream_block, 0, BLOWFISH_BLOCKSIZE);
+
+    value val = alloc_blowfish_stream(stream);
+    val_gc(val, finalize_blowfish_stream);
+
+    return val;
+}
+DEFINE_PRIM(hx_blowfish_stream_init, 1);
+
+
 void finalize_blowfish_context(value context)
 {
     val_check_blowfish_context(context);
@@ -107,4 +177,14 @@ void finalize_blowfish_context(value context)
     }
 }
 
+
+void finalize_blowfish_stream(value stream)
+{
+    val_check_blowfish_stream(stream);
+
+    if (stream != NULL) {
+        memset(val_blowfish_stream(stream), 0, sizeof(s_blowfish_stream));
+    }
+}
+
 } // extern "C"
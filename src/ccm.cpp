@@ -0,0 +1,215 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <string.h>
+#include <polarssl/aes.h>
+
+#include "hxpolarssl/aes.hpp"
+#include "hxpolarssl/ccm.hpp"
+#include "hxpolarssl/utils.hpp"
+
+/*
+ * Encrypts/decrypts and authenticates 'length' bytes in a single pass: every block is fed
+ * into the CBC-MAC and XORed with its CTR keystream block before moving on to the next one.
+ *
+ * The computed (untruncated) tag is written to 'mac'. Input and output may overlap exactly.
+ *
+ * See:
+ *   http://csrc.nist.gov/publications/nistpubs/800-38C/SP800-38C_updated-July20_2007.pdf
+ */
+static int ccm_auth_crypt(aes_context* ctx, const int mode, const size_t length,
+    const unsigned char* iv, const size_t iv_len, const unsigned char* add, const size_t add_len,
+    const unsigned char* input, unsigned char* output, const size_t tag_len, unsigned char mac[AES_BLOCKSIZE])
+{
+    const size_t q = 16 - 1 - iv_len;
+    unsigned char b[AES_BLOCKSIZE];
+    unsigned char ctr[AES_BLOCKSIZE];
+    unsigned char ks[AES_BLOCKSIZE];
+    unsigned char blk[AES_BLOCKSIZE];
+
+    // first block B0: flags, nonce and message length
+    b[0] = (unsigned char)(((add_len > 0) ? 0x40 : 0x00) | (((tag_len - 2) / 2) << 3) | (q - 1));
+    memcpy(b + 1, iv, iv_len);
+    size_t len_left = length;
+    for (size_t i = 0; i < q; ++i, len_left >>= 8) {
+        b[15 - i] = (unsigned char)(len_left & 0xFF);
+    }
+    if (len_left > 0) {
+        return POLARSSL_ERR_CCM_BAD_INPUT;
+    }
+    aes_crypt_ecb(ctx, AES_ENCRYPT, b, mac);
+
+    // additional data, prefixed with its 2 bytes length
+    if (add_len > 0) {
+        size_t use = (add_len < 14) ? add_len : 14;
+        memset(b, 0, AES_BLOCKSIZE);
+        b[0] = (unsigned char)((add_len >> 8) & 0xFF);
+        b[1] = (unsigned char)(add_len & 0xFF);
+        memcpy(b + 2, add, use);
+        for (size_t i = 0; i < AES_BLOCKSIZE; ++i) {
+            mac[i] ^= b[i];
+        }
+        aes_crypt_ecb(ctx, AES_ENCRYPT, mac, mac);
+
+        for (size_t offset = use; offset < add_len; offset += use) {
+            use = (add_len - offset < AES_BLOCKSIZE) ? add_len - offset : AES_BLOCKSIZE;
+            for (size_t i = 0; i < use; ++i) {
+                mac[i] ^= add[offset + i];
+            }
+            aes_crypt_ecb(ctx, AES_ENCRYPT, mac, mac);
+        }
+    }
+
+    // counter block A0 (its keystream masks the tag), payload starts at A1
+    ctr[0] = (unsigned char)(q - 1);
+    memcpy(ctr + 1, iv, iv_len);
+    memset(ctr + 1 + iv_len, 0, q);
+
+    for (size_t offset = 0; offset < length; offset += AES_BLOCKSIZE) {
+        const size_t use = (length - offset < AES_BLOCKSIZE) ? length - offset : AES_BLOCKSIZE;
+
+        for (size_t i = 0; i < q; ++i) {
+            if (++ctr[15 - i] != 0) {
+                break;
+            }
+        }
+        aes_crypt_ecb(ctx, AES_ENCRYPT, ctr, ks);
+
+        memcpy(blk, input + offset, use);
+        if (mode == AES_ENCRYPT) {
+            for (size_t i = 0; i < use; ++i) {
+                mac[i] ^= blk[i];
+                output[offset + i] = blk[i] ^ ks[i];
+            }
+        } else {
+            for (size_t i = 0; i < use; ++i) {
+                output[offset + i] = blk[i] ^ ks[i];
+                mac[i] ^= output[offset + i];
+            }
+        }
+        aes_crypt_ecb(ctx, AES_ENCRYPT, mac, mac);
+    }
+
+    memset(ctr + 1 + iv_len, 0, q);
+    aes_crypt_ecb(ctx, AES_ENCRYPT, ctr, ks);
+    for (size_t i = 0; i < AES_BLOCKSIZE; ++i) {
+        mac[i] ^= ks[i];
+    }
+
+    memset(ks, 0, sizeof(ks));
+    memset(blk, 0, sizeof(blk));
+
+    return 0;
+}
+
+
+/*
+ * Validates the nonce and tag lengths against the ones allowed by CCM.
+ */
+static int ccm_check_lengths(const size_t iv_len, const size_t tag_len, const size_t add_len)
+{
+    if (iv_len < 7 || iv_len > 13) {
+        return POLARSSL_ERR_CCM_BAD_INPUT;
+    }
+    if (tag_len < 4 || tag_len > 16 || (tag_len % 2) != 0) {
+        return POLARSSL_ERR_CCM_BAD_INPUT;
+    }
+    if (add_len > 0xFF00) {
+        return POLARSSL_ERR_CCM_BAD_INPUT;
+    }
+
+    return 0;
+}
+
+
+extern "C" {
+
+value hx_ccm_auth_decrypt(value context, value ivArr, value addArr, value ioArr, value tagArr)
+{
+    val_check_aes_context(context);
+    val_check(ivArr, array);
+    val_check(val_array_i(ivArr, 0), int);
+    val_check(addArr, array);
+    val_check(val_array_i(addArr, 0), int);
+    val_check(ioArr, array);
+    val_check(val_array_i(ioArr, 0), int);
+    val_check(val_array_i(ioArr, 2), int);
+    val_check(val_array_i(ioArr, 4), int);
+    val_check(tagArr, array);
+    val_check(val_array_i(tagArr, 0), int);
+    val_check(val_array_i(tagArr, 2), int);
+
+    s_bytes* iv                = bytes_fromHaxe(val_array_i(ivArr, 1), val_array_i(ivArr, 0));
+    s_bytes* add               = bytes_fromHaxe(val_array_i(addArr, 1), val_array_i(addArr, 0));
+    const size_t length        = val_int(val_array_i(ioArr, 0));
+    const unsigned char* input = data_fromHaxe(val_array_i(ioArr, 1)) + val_int(val_array_i(ioArr, 2));
+    unsigned char* output      = data_fromHaxe(val_array_i(ioArr, 3)) + val_int(val_array_i(ioArr, 4));
+    const size_t tag_len       = val_int(val_array_i(tagArr, 0));
+    const unsigned char* tag   = data_fromHaxe(val_array_i(tagArr, 1)) + val_int(val_array_i(tagArr, 2));
+    unsigned char mac[AES_BLOCKSIZE];
+
+    int ret = ccm_check_lengths(iv->length, tag_len, add->length);
+    if (ret == 0) {
+        ret = ccm_auth_crypt(val_aes_context(context), AES_DECRYPT, length, iv->data, iv->length, add->data, add->length, input, output, tag_len, mac);
+    }
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    // constant-time tag comparison
+    unsigned char diff = 0;
+    for (size_t i = 0; i < tag_len; ++i) {
+        diff |= mac[i] ^ tag[i];
+    }
+    memset(mac, 0, sizeof(mac));
+
+    if (diff != 0) {
+        // do not hand out unauthenticated plaintext
+        memset(output, 0, length);
+    }
+
+    return alloc_bool(diff == 0);
+}
+DEFINE_PRIM(hx_ccm_auth_decrypt, 5);
+
+
+value hx_ccm_encrypt_and_tag(value context, value ivArr, value addArr, value ioArr, value tagArr)
+{
+    val_check_aes_context(context);
+    val_check(ivArr, array);
+    val_check(val_array_i(ivArr, 0), int);
+    val_check(addArr, array);
+    val_check(val_array_i(addArr, 0), int);
+    val_check(ioArr, array);
+    val_check(val_array_i(ioArr, 0), int);
+    val_check(val_array_i(ioArr, 2), int);
+    val_check(val_array_i(ioArr, 4), int);
+    val_check(tagArr, array);
+    val_check(val_array_i(tagArr, 0), int);
+    val_check(val_array_i(tagArr, 2), int);
+
+    s_bytes* iv                = bytes_fromHaxe(val_array_i(ivArr, 1), val_array_i(ivArr, 0));
+    s_bytes* add               = bytes_fromHaxe(val_array_i(addArr, 1), val_array_i(addArr, 0));
+    const size_t length        = val_int(val_array_i(ioArr, 0));
+    const unsigned char* input = data_fromHaxe(val_array_i(ioArr, 1)) + val_int(val_array_i(ioArr, 2));
+    unsigned char* output      = data_fromHaxe(val_array_i(ioArr, 3)) + val_int(val_array_i(ioArr, 4));
+    const size_t tag_len       = val_int(val_array_i(tagArr, 0));
+    unsigned char* tag         = data_fromHaxe(val_array_i(tagArr, 1)) + val_int(val_array_i(tagArr, 2));
+    unsigned char mac[AES_BLOCKSIZE];
+
+    int ret = ccm_check_lengths(iv->length, tag_len, add->length);
+    if (ret == 0) {
+        ret = ccm_auth_crypt(val_aes_context(context), AES_ENCRYPT, length, iv->data, iv->length, add->data, add->length, input, output, tag_len, mac);
+    }
+    if (ret == 0) {
+        memcpy(tag, mac, tag_len);
+    } else {
+        throw_err(ret);
+    }
+    memset(mac, 0, sizeof(mac));
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_ccm_encrypt_and_tag, 5);
+
+} // extern "C"
@@ -0,0 +1,1026 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define CHACHAPOLY_HAVE_X86_SIMD
+    #include <immintrin.h>
+#endif
+
+#include "hxpolarssl/chachapoly.hpp"
+#include "hxpolarssl/utils.hpp"
+
+/*
+ * Message stages of a context.
+ */
+#define CHACHAPOLY_STAGE_NOKEY  0 /* no key set yet */
+#define CHACHAPOLY_STAGE_READY  1 /* keyed, waiting for a nonce */
+#define CHACHAPOLY_STAGE_AAD    2 /* accepting additional data */
+#define CHACHAPOLY_STAGE_TEXT   3 /* accepting plain-/ciphertext */
+
+
+static inline uint32_t chacha_load32(const unsigned char* p)
+{
+    return ((uint32_t)p[0]) | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+
+static inline void chacha_store32(unsigned char* p, const uint32_t v)
+{
+    p[0] = (unsigned char)(v);
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+
+#define CHACHA_ROTL32(v, n)  (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define CHACHA_QR(a, b, c, d)                        \
+    a += b; d ^= a; d = CHACHA_ROTL32(d, 16);        \
+    c += d; b ^= c; b = CHACHA_ROTL32(b, 12);        \
+    a += b; d ^= a; d = CHACHA_ROTL32(d, 8);         \
+    c += d; b ^= c; b = CHACHA_ROTL32(b, 7);
+
+/*
+ * Computes the ChaCha20 keystream block 'counter' for the key and nonce stored in 'state'.
+ *
+ * See:
+ *   https://tools.ietf.org/html/rfc8439#section-2.3
+ */
+static void chacha20_block(const uint32_t state[16], const uint32_t counter, unsigned char out[CHACHA20_BLOCKSIZE])
+{
+    uint32_t x[16];
+    memcpy(x, state, sizeof(x));
+    x[12] = counter;
+
+    for (int i = 0; i < 10; ++i) {
+        CHACHA_QR(x[0], x[4], x[8],  x[12]);
+        CHACHA_QR(x[1], x[5], x[9],  x[13]);
+        CHACHA_QR(x[2], x[6], x[10], x[14]);
+        CHACHA_QR(x[3], x[7], x[11], x[15]);
+        CHACHA_QR(x[0], x[5], x[10], x[15]);
+        CHACHA_QR(x[1], x[6], x[11], x[12]);
+        CHACHA_QR(x[2], x[7], x[8],  x[13]);
+        CHACHA_QR(x[3], x[4], x[9],  x[14]);
+    }
+
+    for (int i = 0; i < 16; ++i) {
+        chacha_store32(out + 4 * i, x[i] + ((i == 12) ? counter : state[i]));
+    }
+    memset(x, 0, sizeof(x));
+}
+
+
+#ifdef CHACHAPOLY_HAVE_X86_SIMD
+
+#define CHACHA_SSE2_ROTL(v, n)  _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+
+#define CHACHA_SSE2_QR(a, b, c, d)                                                                            \
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a);                                                         \
+    d = _mm_shufflehi_epi16(_mm_shufflelo_epi16(d, 0xB1), 0xB1);                                              \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = CHACHA_SSE2_ROTL(b, 12);                            \
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = CHACHA_SSE2_ROTL(d, 8);                             \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = CHACHA_SSE2_ROTL(b, 7);
+
+/*
+ * XORs four consecutive keystream blocks (starting at 'counter') into 'input'.
+ *
+ * Every register holds the same state word of the four blocks; the words are transposed
+ * back into block order when the keystream is applied.
+ */
+__attribute__((target("sse2")))
+static void chacha20_xor4_sse2(const uint32_t state[16], const uint32_t counter, const unsigned char* input, unsigned char* output)
+{
+    __m128i orig[16];
+    __m128i x[16];
+    for (int i = 0; i < 16; ++i) {
+        orig[i] = _mm_set1_epi32((int)state[i]);
+    }
+    orig[12] = _mm_add_epi32(_mm_set1_epi32((int)counter), _mm_set_epi32(3, 2, 1, 0));
+    memcpy(x, orig, sizeof(x));
+
+    for (int i = 0; i < 10; ++i) {
+        CHACHA_SSE2_QR(x[0], x[4], x[8],  x[12]);
+        CHACHA_SSE2_QR(x[1], x[5], x[9],  x[13]);
+        CHACHA_SSE2_QR(x[2], x[6], x[10], x[14]);
+        CHACHA_SSE2_QR(x[3], x[7], x[11], x[15]);
+        CHACHA_SSE2_QR(x[0], x[5], x[10], x[15]);
+        CHACHA_SSE2_QR(x[1], x[6], x[11], x[12]);
+        CHACHA_SSE2_QR(x[2], x[7], x[8],  x[13]);
+        CHACHA_SSE2_QR(x[3], x[4], x[9],  x[14]);
+    }
+
+    for (int i = 0; i < 16; i += 4) {
+        const __m128i a  = _mm_add_epi32(x[i],     orig[i]);
+        const __m128i b  = _mm_add_epi32(x[i + 1], orig[i + 1]);
+        const __m128i c  = _mm_add_epi32(x[i + 2], orig[i + 2]);
+        const __m128i d  = _mm_add_epi32(x[i + 3], orig[i + 3]);
+        const __m128i t0 = _mm_unpacklo_epi32(a, b);
+        const __m128i t1 = _mm_unpacklo_epi32(c, d);
+        const __m128i t2 = _mm_unpackhi_epi32(a, b);
+        const __m128i t3 = _mm_unpackhi_epi32(c, d);
+        const __m128i r[4] = {
+            _mm_unpacklo_epi64(t0, t1),
+            _mm_unpackhi_epi64(t0, t1),
+            _mm_unpacklo_epi64(t2, t3),
+            _mm_unpackhi_epi64(t2, t3)
+        };
+        for (int blk = 0; blk < 4; ++blk) {
+            const size_t offset = blk * CHACHA20_BLOCKSIZE + i * 4;
+            const __m128i in    = _mm_loadu_si128((const __m128i*)(input + offset));
+            _mm_storeu_si128((__m128i*)(output + offset), _mm_xor_si128(in, r[blk]));
+        }
+    }
+}
+
+
+#define CHACHA_AVX2_ROTL(v, n)  _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+
+#define CHACHA_AVX2_QR(a, b, c, d)                                                                            \
+    a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = _mm256_shuffle_epi8(d, rot16);                \
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = CHACHA_AVX2_ROTL(b, 12);                      \
+    a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = _mm256_shuffle_epi8(d, rot8);                 \
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = CHACHA_AVX2_ROTL(b, 7);
+
+/*
+ * XORs eight consecutive keystream blocks (starting at 'counter') into 'input'.
+ *
+ * Same layout as the SSE2 kernel; the low 128 bit lanes hold blocks 0-3, the high ones blocks 4-7.
+ */
+__attribute__((target("avx2")))
+static void chacha20_xor8_avx2(const uint32_t state[16], const uint32_t counter, const unsigned char* input, unsigned char* output)
+{
+    const __m256i rot16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                           2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    const __m256i rot8  = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                           3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+    __m256i orig[16];
+    __m256i x[16];
+    for (int i = 0; i < 16; ++i) {
+        orig[i] = _mm256_set1_epi32((int)state[i]);
+    }
+    orig[12] = _mm256_add_epi32(_mm256_set1_epi32((int)counter), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    memcpy(x, orig, sizeof(x));
+
+    for (int i = 0; i < 10; ++i) {
+        CHACHA_AVX2_QR(x[0], x[4], x[8],  x[12]);
+        CHACHA_AVX2_QR(x[1], x[5], x[9],  x[13]);
+        CHACHA_AVX2_QR(x[2], x[6], x[10], x[14]);
+        CHACHA_AVX2_QR(x[3], x[7], x[11], x[15]);
+        CHACHA_AVX2_QR(x[0], x[5], x[10], x[15]);
+        CHACHA_AVX2_QR(x[1], x[6], x[11], x[12]);
+        CHACHA_AVX2_QR(x[2], x[7], x[8],  x[13]);
+        CHACHA_AVX2_QR(x[3], x[4], x[9],  x[14]);
+    }
+
+    for (int i = 0; i < 16; i += 4) {
+        const __m256i a  = _mm256_add_epi32(x[i],     orig[i]);
+        const __m256i b  = _mm256_add_epi32(x[i + 1], orig[i + 1]);
+        const __m256i c  = _mm256_add_epi32(x[i + 2], orig[i + 2]);
+        const __m256i d  = _mm256_add_epi32(x[i + 3], orig[i + 3]);
+        const __m256i t0 = _mm256_unpacklo_epi32(a, b);
+        const __m256i t1 = _mm256_unpacklo_epi32(c, d);
+        const __m256i t2 = _mm256_unpackhi_epi32(a, b);
+        const __m256i t3 = _mm256_unpackhi_epi32(c, d);
+        const __m256i r[4] = {
+            _mm256_unpacklo_epi64(t0, t1),
+            _mm256_unpackhi_epi64(t0, t1),
+            _mm256_unpacklo_epi64(t2, t3),
+            _mm256_unpackhi_epi64(t2, t3)
+        };
+        for (int blk = 0; blk < 4; ++blk) {
+            const size_t lo  = blk * CHACHA20_BLOCKSIZE + i * 4;
+            const size_t hi  = lo + 4 * CHACHA20_BLOCKSIZE;
+            const __m128i in_lo = _mm_loadu_si128((const __m128i*)(input + lo));
+            const __m128i in_hi = _mm_loadu_si128((const __m128i*)(input + hi));
+            _mm_storeu_si128((__m128i*)(output + lo), _mm_xor_si128(in_lo, _mm256_castsi256_si128(r[blk])));
+            _mm_storeu_si128((__m128i*)(output + hi), _mm_xor_si128(in_hi, _mm256_extracti128_si256(r[blk], 1)));
+        }
+    }
+}
+
+
+/*
+ * Widest keystream kernel usable on this CPU (and OS, for the AVX2 state).
+ */
+#define CHACHA20_SIMD_NONE  0
+#define CHACHA20_SIMD_SSE2  1
+#define CHACHA20_SIMD_AVX2  2
+
+static int chacha20_detect_simd(void)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return CHACHA20_SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return CHACHA20_SIMD_SSE2;
+    }
+
+    return CHACHA20_SIMD_NONE;
+}
+
+
+static int chacha20_simd(void)
+{
+    static const int simd = chacha20_detect_simd();
+    return simd;
+}
+
+#endif /* CHACHAPOLY_HAVE_X86_SIMD */
+
+
+/*
+ * XORs 'blocks' full keystream blocks, starting at block 'counter', into 'input'.
+ *
+ * Runs the widest kernel supported by the CPU (AVX2: 8 blocks, SSE2: 4 blocks per call)
+ * and the scalar block function for the rest. Input and output may overlap exactly.
+ */
+static void chacha20_xor_blocks(const uint32_t state[16], const uint32_t counter,
+    const unsigned char* input, unsigned char* output, const size_t blocks)
+{
+    size_t done = 0;
+
+#ifdef CHACHAPOLY_HAVE_X86_SIMD
+    const int simd = (blocks >= 4) ? chacha20_simd() : CHACHA20_SIMD_NONE;
+    if (simd == CHACHA20_SIMD_AVX2) {
+        for (; done + 8 <= blocks; done += 8) {
+            const size_t offset = done * CHACHA20_BLOCKSIZE;
+            chacha20_xor8_avx2(state, counter + (uint32_t)done, input + offset, output + offset);
+        }
+    }
+    if (simd != CHACHA20_SIMD_NONE) {
+        for (; done + 4 <= blocks; done += 4) {
+            const size_t offset = done * CHACHA20_BLOCKSIZE;
+            chacha20_xor4_sse2(state, counter + (uint32_t)done, input + offset, output + offset);
+        }
+    }
+#endif
+
+    unsigned char ks[CHACHA20_BLOCKSIZE];
+    for (; done < blocks; ++done) {
+        const size_t offset = done * CHACHA20_BLOCKSIZE;
+        chacha20_block(state, counter + (uint32_t)done, ks);
+        for (size_t i = 0; i < CHACHA20_BLOCKSIZE; ++i) {
+            output[offset + i] = input[offset + i] ^ ks[i];
+        }
+    }
+    memset(ks, 0, sizeof(ks));
+}
+
+
+/*
+ * Poly1305 one-time authenticator using 26 bit limbs.
+ *
+ * See:
+ *   https://tools.ietf.org/html/rfc8439#section-2.5
+ */
+static void poly1305_init(s_poly1305* st, const unsigned char key[32])
+{
+    // r is clamped while being split into limbs
+    st->r[0] = (chacha_load32(key +  0)     ) & 0x3ffffff;
+    st->r[1] = (chacha_load32(key +  3) >> 2) & 0x3ffff03;
+    st->r[2] = (chacha_load32(key +  6) >> 4) & 0x3ffc0ff;
+    st->r[3] = (chacha_load32(key +  9) >> 6) & 0x3f03fff;
+    st->r[4] = (chacha_load32(key + 12) >> 8) & 0x00fffff;
+
+    memset(st->h, 0, sizeof(st->h));
+    for (int i = 0; i < 4; ++i) {
+        st->pad[i] = chacha_load32(key + 16 + 4 * i);
+    }
+    st->leftover = 0;
+    st->final    = 0;
+}
+
+
+static void poly1305_blocks(s_poly1305* st, const unsigned char* m, size_t bytes)
+{
+    const uint32_t hibit = st->final ? 0 : (1UL << 24);
+    const uint32_t r0 = st->r[0], r1 = st->r[1], r2 = st->r[2], r3 = st->r[3], r4 = st->r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], h3 = st->h[3], h4 = st->h[4];
+
+    while (bytes >= 16) {
+        h0 += (chacha_load32(m +  0)     ) & 0x3ffffff;
+        h1 += (chacha_load32(m +  3) >> 2) & 0x3ffffff;
+        h2 += (chacha_load32(m +  6) >> 4) & 0x3ffffff;
+        h3 += (chacha_load32(m +  9) >> 6) & 0x3ffffff;
+        h4 += (chacha_load32(m + 12) >> 8) | hibit;
+
+        // h *= r (mod 2^130 - 5)
+        uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+        uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+        uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+        uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+        uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+
+        // partial carry propagation
+        uint32_t c;
+        c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & 0x3ffffff;
+        d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & 0x3ffffff;
+        d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & 0x3ffffff;
+        d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & 0x3ffffff;
+        d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & 0x3ffffff;
+        h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+        h1 += c;
+
+        m     += 16;
+        bytes -= 16;
+    }
+
+    st->h[0] = h0; st->h[1] = h1; st->h[2] = h2; st->h[3] = h3; st->h[4] = h4;
+}
+
+
+static void poly1305_update(s_poly1305* st, const unsigned char* m, size_t bytes)
+{
+    if (st->leftover > 0) {
+        size_t want = 16 - st->leftover;
+        if (want > bytes) {
+            want = bytes;
+        }
+        memcpy(st->buffer + st->leftover, m, want);
+        st->leftover += want;
+        m            += want;
+        bytes        -= want;
+        if (st->leftover < 16) {
+            return;
+        }
+        poly1305_blocks(st, st->buffer, 16);
+        st->leftover = 0;
+    }
+
+    if (bytes >= 16) {
+        const size_t want = bytes & ~(size_t)15;
+        poly1305_blocks(st, m, want);
+        m     += want;
+        bytes -= want;
+    }
+
+    if (bytes > 0) {
+        memcpy(st->buffer, m, bytes);
+        st->leftover = bytes;
+    }
+}
+
+
+static void poly1305_finish(s_poly1305* st, unsigned char mac[16])
+{
+    if (st->leftover > 0) {
+        st->buffer[st->leftover] = 1;
+        memset(st->buffer + st->leftover + 1, 0, 16 - st->leftover - 1);
+        st->final = 1;
+        poly1305_blocks(st, st->buffer, 16);
+    }
+
+    uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], h3 = st->h[3], h4 = st->h[4];
+    uint32_t c;
+
+    // full carry propagation
+    c = h1 >> 26; h1 &= 0x3ffffff;
+    h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+    h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+    h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+
+    // g = h + -p
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    uint32_t g4 = h4 + c - (1UL << 26);
+
+    // constant-time select of h (h < p) or g (h >= p)
+    uint32_t mask = (g4 >> 31) - 1;
+    g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+    h3 = (h3 & mask) | g3;
+    h4 = (h4 & mask) | g4;
+
+    // h %= 2^128, then add the pad
+    h0 = ((h0      ) | (h1 << 26));
+    h1 = ((h1 >>  6) | (h2 << 20));
+    h2 = ((h2 >> 12) | (h3 << 14));
+    h3 = ((h3 >> 18) | (h4 <<  8));
+
+    uint64_t f;
+    f = (uint64_t)h0 + st->pad[0];             h0 = (uint32_t)f;
+    f = (uint64_t)h1 + st->pad[1] + (f >> 32); h1 = (uint32_t)f;
+    f = (uint64_t)h2 + st->pad[2] + (f >> 32); h2 = (uint32_t)f;
+    f = (uint64_t)h3 + st->pad[3] + (f >> 32); h3 = (uint32_t)f;
+
+    chacha_store32(mac +  0, h0);
+    chacha_store32(mac +  4, h1);
+    chacha_store32(mac +  8, h2);
+    chacha_store32(mac + 12, h3);
+
+    memset(st, 0, sizeof(s_poly1305));
+}
+
+
+/*
+ * Feeds zeros into the authenticator up to the next 16 bytes boundary.
+ */
+static void chachapoly_pad16(s_chachapoly* ctx, const uint64_t length)
+{
+    static const unsigned char zeros[16] = { 0 };
+    if ((length % 16) != 0) {
+        poly1305_update(&(ctx->poly), zeros, 16 - (size_t)(length % 16));
+    }
+}
+
+
+static void chachapoly_setkey(s_chachapoly* ctx, const unsigned char key[CHACHAPOLY_KEY_LENGTH])
+{
+    memset(ctx, 0, sizeof(s_chachapoly));
+    ctx->state[0] = 0x61707865; // "expand 32-byte k"
+    ctx->state[1] = 0x3320646e;
+    ctx->state[2] = 0x79622d32;
+    ctx->state[3] = 0x6b206574;
+    for (int i = 0; i < 8; ++i) {
+        ctx->state[4 + i] = chacha_load32(key + 4 * i);
+    }
+    ctx->stage = CHACHAPOLY_STAGE_READY;
+}
+
+
+/*
+ * Starts a message: the Poly1305 key is the first half of keystream block 0,
+ * the payload is encrypted starting at block 1.
+ */
+static void chachapoly_starts(s_chachapoly* ctx, const unsigned char nonce[CHACHAPOLY_IV_LENGTH], const int mode)
+{
+    unsigned char otk[CHACHA20_BLOCKSIZE];
+
+    ctx->state[13] = chacha_load32(nonce);
+    ctx->state[14] = chacha_load32(nonce + 4);
+    ctx->state[15] = chacha_load32(nonce + 8);
+    chacha20_block(ctx->state, 0, otk);
+    poly1305_init(&(ctx->poly), otk);
+    memset(otk, 0, sizeof(otk));
+
+    ctx->state[12]       = 1;
+    ctx->keystream_used  = CHACHA20_BLOCKSIZE;
+    ctx->aad_len         = 0;
+    ctx->text_len        = 0;
+    ctx->mode            = mode;
+    ctx->stage           = CHACHAPOLY_STAGE_AAD;
+}
+
+
+static void chachapoly_update_aad(s_chachapoly* ctx, const unsigned char* aad, const size_t length)
+{
+    poly1305_update(&(ctx->poly), aad, length);
+    ctx->aad_len += length;
+}
+
+
+/*
+ * Encrypts/decrypts the next 'length' bytes; input and output may overlap exactly.
+ *
+ * Fails if the message would exceed CHACHAPOLY_MAX_TEXT_LENGTH, as the 32 bit block
+ * counter would wrap around and the keystream repeat.
+ */
+static int chachapoly_update(s_chachapoly* ctx, const unsigned char* input, unsigned char* output, const size_t length)
+{
+    if (length > CHACHAPOLY_MAX_TEXT_LENGTH - ctx->text_len) {
+        return POLARSSL_ERR_CHACHAPOLY_BAD_INPUT;
+    }
+    if (ctx->stage == CHACHAPOLY_STAGE_AAD) {
+        chachapoly_pad16(ctx, ctx->aad_len);
+        ctx->stage = CHACHAPOLY_STAGE_TEXT;
+    }
+    if (ctx->mode == CHACHAPOLY_DECRYPT) {
+        poly1305_update(&(ctx->poly), input, length);
+    }
+
+    size_t offset = 0;
+    // rest of the keystream block of the previous call
+    while (offset < length && ctx->keystream_used < CHACHA20_BLOCKSIZE) {
+        output[offset] = input[offset] ^ ctx->keystream[ctx->keystream_used++];
+        ++offset;
+    }
+
+    const size_t blocks = (length - offset) / CHACHA20_BLOCKSIZE;
+    if (blocks > 0) {
+        chacha20_xor_blocks(ctx->state, ctx->state[12], input + offset, output + offset, blocks);
+        ctx->state[12] += (uint32_t)blocks;
+        offset         += blocks * CHACHA20_BLOCKSIZE;
+    }
+
+    if (offset < length) {
+        chacha20_block(ctx->state, ctx->state[12]++, ctx->keystream);
+        ctx->keystream_used = 0;
+        while (offset < length) {
+            output[offset] = input[offset] ^ ctx->keystream[ctx->keystream_used++];
+            ++offset;
+        }
+    }
+
+    if (ctx->mode == CHACHAPOLY_ENCRYPT) {
+        poly1305_update(&(ctx->poly), output, length);
+    }
+    ctx->text_len += length;
+
+    return 0;
+}
+
+
+static void chachapoly_finish(s_chachapoly* ctx, unsigned char tag[CHACHAPOLY_TAG_LENGTH])
+{
+    unsigned char lengths[16];
+
+    if (ctx->stage == CHACHAPOLY_STAGE_AAD) {
+        chachapoly_pad16(ctx, ctx->aad_len);
+    }
+    chachapoly_pad16(ctx, ctx->text_len);
+    for (int i = 0; i < 8; ++i) {
+        lengths[i]     = (unsigned char)(ctx->aad_len >> (8 * i));
+        lengths[8 + i] = (unsigned char)(ctx->text_len >> (8 * i));
+    }
+    poly1305_update(&(ctx->poly), lengths, sizeof(lengths));
+    poly1305_finish(&(ctx->poly), tag);
+
+    memset(ctx->keystream, 0, sizeof(ctx->keystream));
+    ctx->stage = CHACHAPOLY_STAGE_READY;
+}
+
+
+/*
+ * Encrypts/decrypts a complete message on a private copy of the keyed state,
+ * so a streamed message of the context is left untouched.
+ */
+static void chachapoly_crypt_and_tag(const s_chachapoly* ctx, const int mode, const unsigned char* nonce,
+    const unsigned char* aad, const size_t aad_len, const unsigned char* input, unsigned char* output, const size_t length,
+    unsigned char tag[CHACHAPOLY_TAG_LENGTH])
+{
+    s_chachapoly msg;
+    memcpy(&msg, ctx, sizeof(s_chachapoly));
+
+    chachapoly_starts(&msg, nonce, mode);
+    chachapoly_update_aad(&msg, aad, aad_len);
+    chachapoly_update(&msg, input, output, length); // Haxe lengths are far below the counter limit
+    chachapoly_finish(&msg, tag);
+
+    memset(&msg, 0, sizeof(s_chachapoly));
+}
+
+
+/*
+ * Compares two tags in constant time.
+ */
+static bool chachapoly_tag_equal(const unsigned char mac[CHACHAPOLY_TAG_LENGTH], const unsigned char tag[CHACHAPOLY_TAG_LENGTH])
+{
+    unsigned char diff = 0;
+    for (size_t i = 0; i < CHACHAPOLY_TAG_LENGTH; ++i) {
+        diff |= mac[i] ^ tag[i];
+    }
+
+    return diff == 0;
+}
+
+
+/*
+ * Checks the arguments shared by the one-shot functions.
+ */
+static int chachapoly_check_oneshot(const s_chachapoly* ctx, const size_t iv_len, const size_t tag_len)
+{
+    if (ctx->stage == CHACHAPOLY_STAGE_NOKEY) {
+        return POLARSSL_ERR_CHACHAPOLY_BAD_STATE;
+    }
+    if (iv_len != CHACHAPOLY_IV_LENGTH || tag_len != CHACHAPOLY_TAG_LENGTH) {
+        return POLARSSL_ERR_CHACHAPOLY_BAD_INPUT;
+    }
+
+    return 0;
+}
+
+
+extern "C" {
+
+DEFINE_KIND(k_chachapoly_context);
+
+
+value hx_chachapoly_auth_decrypt(value context, value ivArr, value addArr, value ioArr, value tagArr)
+{
+    val_check_chachapoly_context(context);
+    val_check(ivArr, array);
+    val_check(val_array_i(ivArr, 0), int);
+    val_check(addArr, array);
+    val_check(val_array_i(addArr, 0), int);
+    val_check(ioArr, array);
+    val_check(val_array_i(ioArr, 0), int);
+    val_check(val_array_i(ioArr, 2), int);
+    val_check(val_array_i(ioArr, 4), int);
+    val_check(tagArr, array);
+    val_check(val_array_i(tagArr, 0), int);
+    val_check(val_array_i(tagArr, 2), int);
+
+    s_bytes* iv                = bytes_fromHaxe(val_array_i(ivArr, 1), val_array_i(ivArr, 0));
+    s_bytes* add               = bytes_fromHaxe(val_array_i(addArr, 1), val_array_i(addArr, 0));
+    const size_t length        = val_int(val_array_i(ioArr, 0));
+    const unsigned char* input = data_fromHaxe(val_array_i(ioArr, 1)) + val_int(val_array_i(ioArr, 2));
+    unsigned char* output      = data_fromHaxe(val_array_i(ioArr, 3)) + val_int(val_array_i(ioArr, 4));
+    const size_t tag_len       = val_int(val_array_i(tagArr, 0));
+    const unsigned char* tag   = data_fromHaxe(val_array_i(tagArr, 1)) + val_int(val_array_i(tagArr, 2));
+    unsigned char mac[CHACHAPOLY_TAG_LENGTH];
+
+    int ret = chachapoly_check_oneshot(val_chachapoly_context(context), iv->length, tag_len);
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+    chachapoly_crypt_and_tag(val_chachapoly_context(context), CHACHAPOLY_DECRYPT, iv->data, add->data, add->length, input, output, length, mac);
+
+    const bool authentic = chachapoly_tag_equal(mac, tag);
+    memset(mac, 0, sizeof(mac));
+
+    if (!authentic) {
+        // do not hand out unauthenticated plaintext
+        memset(output, 0, length);
+    }
+
+    return alloc_bool(authentic);
+}
+DEFINE_PRIM(hx_chachapoly_auth_decrypt, 5);
+
+
+value hx_chachapoly_encrypt_and_tag(value context, value ivArr, value addArr, value ioArr, value tagArr)
+{
+    val_check_chachapoly_context(context);
+    val_check(ivArr, array);
+    val_check(val_array_i(ivArr, 0), int);
+    val_check(addArr, array);
+    val_check(val_array_i(addArr, 0), int);
+    val_check(ioArr, array);
+    val_check(val_array_i(ioArr, 0), int);
+    val_check(val_array_i(ioArr, 2), int);
+    val_check(val_array_i(ioArr, 4), int);
+    val_check(tagArr, array);
+    val_check(val_array_i(tagArr, 0), int);
+    val_check(val_array_i(tagArr, 2), int);
+
+    s_bytes* iv                = bytes_fromHaxe(val_array_i(ivArr, 1), val_array_i(ivArr, 0));
+    s_bytes* add               = bytes_fromHaxe(val_array_i(addArr, 1), val_array_i(addArr, 0));
+    const size_t length        = val_int(val_array_i(ioArr, 0));
+    const unsigned char* input = data_fromHaxe(val_array_i(ioArr, 1)) + val_int(val_array_i(ioArr, 2));
+    unsigned char* output      = data_fromHaxe(val_array_i(ioArr, 3)) + val_int(val_array_i(ioArr, 4));
+    const size_t tag_len       = val_int(val_array_i(tagArr, 0));
+    unsigned char* tag         = data_fromHaxe(val_array_i(tagArr, 1)) + val_int(val_array_i(tagArr, 2));
+
+    int ret = chachapoly_check_oneshot(val_chachapoly_context(context), iv->length, tag_len);
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+    chachapoly_crypt_and_tag(val_chachapoly_context(context), CHACHAPOLY_ENCRYPT, iv->data, add->data, add->length, input, output, length, tag);
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_chachapoly_encrypt_and_tag, 5);
+
+
+value hx_chachapoly_finish(value context)
+{
+    val_check_chachapoly_context(context);
+
+    s_chachapoly* _context = val_chachapoly_context(context);
+    if (_context->stage != CHACHAPOLY_STAGE_AAD && _context->stage != CHACHAPOLY_STAGE_TEXT) {
+        throw_err(POLARSSL_ERR_CHACHAPOLY_BAD_STATE);
+        return alloc_int(POLARSSL_ERR_CHACHAPOLY_BAD_STATE);
+    }
+
+    unsigned char tag[CHACHAPOLY_TAG_LENGTH];
+    chachapoly_finish(_context, tag);
+    value val = value_fromBytes(tag, CHACHAPOLY_TAG_LENGTH);
+    memset(tag, 0, sizeof(tag));
+
+    return val;
+}
+DEFINE_PRIM(hx_chachapoly_finish, 1);
+
+
+value hx_chachapoly_finish_verify(value context, value tag, value length)
+{
+    val_check_chachapoly_context(context);
+    val_check(length, int);
+
+    s_chachapoly* _context = val_chachapoly_context(context);
+    if (_context->stage != CHACHAPOLY_STAGE_AAD && _context->stage != CHACHAPOLY_STAGE_TEXT) {
+        throw_err(POLARSSL_ERR_CHACHAPOLY_BAD_STATE);
+        return alloc_int(POLARSSL_ERR_CHACHAPOLY_BAD_STATE);
+    }
+    if (val_int(length) != CHACHAPOLY_TAG_LENGTH) {
+        throw_err(POLARSSL_ERR_CHACHAPOLY_BAD_INPUT);
+        return alloc_int(POLARSSL_ERR_CHACHAPOLY_BAD_INPUT);
+    }
+
+    unsigned char mac[CHACHAPOLY_TAG_LENGTH];
+    chachapoly_finish(_context, mac);
+    const bool authentic = chachapoly_tag_equal(mac, data_fromHaxe(tag));
+    memset(mac, 0, sizeof(mac));
+
+    return alloc_bool(authentic);
+}
+DEFINE_PRIM(hx_chachapoly_finish_verify, 3);
+
+
+value hx_chachapoly_free(value context)
+{
+    val_check_chachapoly_context(context);
+
+    memset(val_chachapoly_context(context), 0, sizeof(s_chachapoly));
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_chachapoly_free, 1);
+
+
+value hx_chachapoly_init(void)
+{
+    s_chachapoly* context = malloc_chachapoly_context();
+    memset(context, 0, sizeof(s_chachapoly));
+
+    value val = alloc_chachapoly_context(context);
+    val_gc(val, finalize_chachapoly_context);
+
+    return val;
+}
+DEFINE_PRIM(hx_chachapoly_init, 0);
+
+
+value hx_chachapoly_self_test(value verbose)
+{
+    val_check(verbose, bool);
+
+    // RFC 8439, section 2.8.2
+    static const unsigned char key[CHACHAPOLY_KEY_LENGTH] = {
+        0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
+        0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f
+    };
+    static const unsigned char nonce[CHACHAPOLY_IV_LENGTH] = {
+        0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47
+    };
+    static const unsigned char aad[12] = {
+        0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7
+    };
+    static const char* plaintext = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.";
+    static const unsigned char ciphertext[114] = {
+        0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+        0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe, 0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+        0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+        0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+        0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c, 0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+        0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+        0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+        0x61, 0x16
+    };
+    static const unsigned char tag[CHACHAPOLY_TAG_LENGTH] = {
+        0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+    };
+
+    // RFC 8439, appendix A.2, test vector #2 (keystream from block 1, 5 whole blocks and a tail)
+    static const unsigned char ks_key[CHACHAPOLY_KEY_LENGTH] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01
+    };
+    static const unsigned char ks_nonce[CHACHAPOLY_IV_LENGTH] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02
+    };
+    static const char* ks_plaintext = "Any submission to the IETF intended by the Contributor for publication as all or part of an "
+        "IETF Internet-Draft or RFC and any statement made within the context of an IETF activity is considered an "
+        "\"IETF Contribution\". Such statements include oral statements in IETF sessions, as well as written and "
+        "electronic communications made at any time or place, which are addressed to";
+    static const unsigned char ks_ciphertext[375] = {
+        0xa3, 0xfb, 0xf0, 0x7d, 0xf3, 0xfa, 0x2f, 0xde, 0x4f, 0x37, 0x6c, 0xa2, 0x3e, 0x82, 0x73, 0x70,
+        0x41, 0x60, 0x5d, 0x9f, 0x4f, 0x4f, 0x57, 0xbd, 0x8c, 0xff, 0x2c, 0x1d, 0x4b, 0x79, 0x55, 0xec,
+        0x2a, 0x97, 0x94, 0x8b, 0xd3, 0x72, 0x29, 0x15, 0xc8, 0xf3, 0xd3, 0x37, 0xf7, 0xd3, 0x70, 0x05,
+        0x0e, 0x9e, 0x96, 0xd6, 0x47, 0xb7, 0xc3, 0x9f, 0x56, 0xe0, 0x31, 0xca, 0x5e, 0xb6, 0x25, 0x0d,
+        0x40, 0x42, 0xe0, 0x27, 0x85, 0xec, 0xec, 0xfa, 0x4b, 0x4b, 0xb5, 0xe8, 0xea, 0xd0, 0x44, 0x0e,
+        0x20, 0xb6, 0xe8, 0xdb, 0x09, 0xd8, 0x81, 0xa7, 0xc6, 0x13, 0x2f, 0x42, 0x0e, 0x52, 0x79, 0x50,
+        0x42, 0xbd, 0xfa, 0x77, 0x73, 0xd8, 0xa9, 0x05, 0x14, 0x47, 0xb3, 0x29, 0x1c, 0xe1, 0x41, 0x1c,
+        0x68, 0x04, 0x65, 0x55, 0x2a, 0xa6, 0xc4, 0x05, 0xb7, 0x76, 0x4d, 0x5e, 0x87, 0xbe, 0xa8, 0x5a,
+        0xd0, 0x0f, 0x84, 0x49, 0xed, 0x8f, 0x72, 0xd0, 0xd6, 0x62, 0xab, 0x05, 0x26, 0x91, 0xca, 0x66,
+        0x42, 0x4b, 0xc8, 0x6d, 0x2d, 0xf8, 0x0e, 0xa4, 0x1f, 0x43, 0xab, 0xf9, 0x37, 0xd3, 0x25, 0x9d,
+        0xc4, 0xb2, 0xd0, 0xdf, 0xb4, 0x8a, 0x6c, 0x91, 0x39, 0xdd, 0xd7, 0xf7, 0x69, 0x66, 0xe9, 0x28,
+        0xe6, 0x35, 0x55, 0x3b, 0xa7, 0x6c, 0x5c, 0x87, 0x9d, 0x7b, 0x35, 0xd4, 0x9e, 0xb2, 0xe6, 0x2b,
+        0x08, 0x71, 0xcd, 0xac, 0x63, 0x89, 0x39, 0xe2, 0x5e, 0x8a, 0x1e, 0x0e, 0xf9, 0xd5, 0x28, 0x0f,
+        0xa8, 0xca, 0x32, 0x8b, 0x35, 0x1c, 0x3c, 0x76, 0x59, 0x89, 0xcb, 0xcf, 0x3d, 0xaa, 0x8b, 0x6c,
+        0xcc, 0x3a, 0xaf, 0x9f, 0x39, 0x79, 0xc9, 0x2b, 0x37, 0x20, 0xfc, 0x88, 0xdc, 0x95, 0xed, 0x84,
+        0xa1, 0xbe, 0x05, 0x9c, 0x64, 0x99, 0xb9, 0xfd, 0xa2, 0x36, 0xe7, 0xe8, 0x18, 0xb0, 0x4b, 0x0b,
+        0xc3, 0x9c, 0x1e, 0x87, 0x6b, 0x19, 0x3b, 0xfe, 0x55, 0x69, 0x75, 0x3f, 0x88, 0x12, 0x8c, 0xc0,
+        0x8a, 0xaa, 0x9b, 0x63, 0xd1, 0xa1, 0x6f, 0x80, 0xef, 0x25, 0x54, 0xd7, 0x18, 0x9c, 0x41, 0x1f,
+        0x58, 0x69, 0xca, 0x52, 0xc5, 0xb8, 0x3f, 0xa3, 0x6f, 0xf2, 0x16, 0xb9, 0xc1, 0xd3, 0x00, 0x62,
+        0xbe, 0xbc, 0xfd, 0x2d, 0xc5, 0xbc, 0xe0, 0x91, 0x19, 0x34, 0xfd, 0xa7, 0x9a, 0x86, 0xf6, 0xe6,
+        0x98, 0xce, 0xd7, 0x59, 0xc3, 0xff, 0x9b, 0x64, 0x77, 0x33, 0x8f, 0x3d, 0xa4, 0xf9, 0xcd, 0x85,
+        0x14, 0xea, 0x99, 0x82, 0xcc, 0xaf, 0xb3, 0x41, 0xb2, 0x38, 0x4d, 0xd9, 0x02, 0xf3, 0xd1, 0xab,
+        0x7a, 0xc6, 0x1d, 0xd2, 0x9c, 0x6f, 0x21, 0xba, 0x5b, 0x86, 0x2f, 0x37, 0x30, 0xe3, 0x7c, 0xfd,
+        0xc4, 0xfd, 0x80, 0x6c, 0x22, 0xf2, 0x21
+    };
+
+    // 1000 zero bytes (15 whole blocks and a tail, so every kernel runs) under the A.2 key and nonce
+    // and the AAD above; tag cross-checked against OpenSSL's EVP_chacha20_poly1305()
+    static const unsigned char long_tag[CHACHAPOLY_TAG_LENGTH] = {
+        0x24, 0xfa, 0xb4, 0x30, 0x5e, 0x63, 0x6d, 0x32, 0xd6, 0x9e, 0xbc, 0x34, 0xd5, 0x27, 0x7c, 0xf5
+    };
+    static const char* names[6] = { "enc", "dec", "stream", "keystream", "long", "simd" };
+
+    s_chachapoly ctx;
+    unsigned char out[1100];
+    unsigned char ref[1100];
+    unsigned char block[CHACHA20_BLOCKSIZE];
+    unsigned char mac[CHACHAPOLY_TAG_LENGTH];
+    chachapoly_setkey(&ctx, key);
+
+    int ret = 0;
+    for (int i = 0; i < 6 && ret == 0; ++i) {
+        if (val_bool(verbose)) {
+            printf("  CHACHA20-POLY1305 test #%d (%s): ", i + 1, names[i]);
+        }
+
+        if (i == 0) {
+            chachapoly_crypt_and_tag(&ctx, CHACHAPOLY_ENCRYPT, nonce, aad, sizeof(aad), (const unsigned char*)plaintext, out, sizeof(ciphertext), mac);
+            if (memcmp(out, ciphertext, sizeof(ciphertext)) != 0 || memcmp(mac, tag, sizeof(tag)) != 0) {
+                ret = 1;
+            }
+        } else if (i == 1) {
+            chachapoly_crypt_and_tag(&ctx, CHACHAPOLY_DECRYPT, nonce, aad, sizeof(aad), ciphertext, out, sizeof(ciphertext), mac);
+            if (memcmp(out, plaintext, sizeof(ciphertext)) != 0 || memcmp(mac, tag, sizeof(tag)) != 0) {
+                ret = 1;
+            }
+        } else if (i == 2) {
+            // odd chunk sizes to exercise the buffered keystream and authenticator
+            chachapoly_starts(&ctx, nonce, CHACHAPOLY_ENCRYPT);
+            chachapoly_update_aad(&ctx, aad, 5);
+            chachapoly_update_aad(&ctx, aad + 5, sizeof(aad) - 5);
+            chachapoly_update(&ctx, (const unsigned char*)plaintext, out, 1);
+            chachapoly_update(&ctx, (const unsigned char*)plaintext + 1, out + 1, 70);
+            chachapoly_update(&ctx, (const unsigned char*)plaintext + 71, out + 71, sizeof(ciphertext) - 71);
+            chachapoly_finish(&ctx, mac);
+            if (memcmp(out, ciphertext, sizeof(ciphertext)) != 0 || memcmp(mac, tag, sizeof(tag)) != 0) {
+                ret = 1;
+            }
+        } else if (i == 3) {
+            chachapoly_setkey(&ctx, ks_key);
+            chachapoly_starts(&ctx, ks_nonce, CHACHAPOLY_ENCRYPT);
+            chachapoly_update(&ctx, (const unsigned char*)ks_plaintext, out, sizeof(ks_ciphertext));
+            chachapoly_finish(&ctx, mac);
+            if (memcmp(out, ks_ciphertext, sizeof(ks_ciphertext)) != 0) {
+                ret = 1;
+            }
+        } else if (i == 4) {
+            memset(ref, 0, 1000);
+            chachapoly_crypt_and_tag(&ctx, CHACHAPOLY_ENCRYPT, ks_nonce, aad, sizeof(aad), ref, out, 1000, mac);
+            if (memcmp(mac, long_tag, sizeof(long_tag)) != 0) {
+                ret = 1;
+            }
+            chachapoly_crypt_and_tag(&ctx, CHACHAPOLY_DECRYPT, ks_nonce, aad, sizeof(aad), out, out, 1000, mac);
+            if (memcmp(out, ref, 1000) != 0 || memcmp(mac, long_tag, sizeof(long_tag)) != 0) {
+                ret = 1;
+            }
+        } else {
+            // cross-check the vectorized kernels against the scalar block function
+            // over lengths around their widths and with differently sized chunks
+            static const size_t lengths[] = { 255, 256, 257, 511, 512, 513, 767, 1000, 1100 };
+            static const size_t chunks[]  = { 1, 17, 64, 100, 257, 1100 };
+            for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]) && ret == 0; ++l) {
+                const size_t length = lengths[l];
+                chachapoly_starts(&ctx, ks_nonce, CHACHAPOLY_ENCRYPT);
+                for (size_t offset = 0; offset < length; offset += CHACHA20_BLOCKSIZE) {
+                    chacha20_block(ctx.state, 1 + (uint32_t)(offset / CHACHA20_BLOCKSIZE), block);
+                    memcpy(ref + offset, block, (length - offset < CHACHA20_BLOCKSIZE) ? length - offset : CHACHA20_BLOCKSIZE);
+                }
+                for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]) && ret == 0; ++c) {
+                    memset(out, 0, length);
+                    chachapoly_starts(&ctx, ks_nonce, CHACHAPOLY_ENCRYPT);
+                    for (size_t done = 0; done < length; done += chunks[c]) {
+                        const size_t n = (length - done < chunks[c]) ? length - done : chunks[c];
+                        chachapoly_update(&ctx, out + done, out + done, n);
+                    }
+                    chachapoly_finish(&ctx, mac);
+                    if (memcmp(out, ref, length) != 0) {
+                        ret = 1;
+                    }
+                }
+            }
+        }
+
+        if (val_bool(verbose)) {
+            printf((ret == 0) ? "passed\n" : "failed\n");
+        }
+    }
+    memset(&ctx, 0, sizeof(ctx));
+    memset(block, 0, sizeof(block));
+
+    if (val_bool(verbose) && ret == 0) {
+        printf("\n");
+    }
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_chachapoly_self_test, 1);
+
+
+value hx_chachapoly_setkey(value context, value key)
+{
+    val_check_chachapoly_context(context);
+
+    s_bytes* _key = bytes_fromHaxe(key, alloc_int(CHACHAPOLY_KEY_LENGTH));
+    chachapoly_setkey(val_chachapoly_context(context), _key->data);
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_chachapoly_setkey, 2);
+
+
+value hx_chachapoly_starts(value context, value nonce, value mode)
+{
+    val_check_chachapoly_context(context);
+    val_check(mode, int);
+
+    s_chachapoly* _context = val_chachapoly_context(context);
+    int ret = 0;
+    if (_context->stage == CHACHAPOLY_STAGE_NOKEY) {
+        ret = POLARSSL_ERR_CHACHAPOLY_BAD_STATE;
+    } else if (val_int(mode) != CHACHAPOLY_ENCRYPT && val_int(mode) != CHACHAPOLY_DECRYPT) {
+        ret = POLARSSL_ERR_CHACHAPOLY_BAD_INPUT;
+    }
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    s_bytes* _nonce = bytes_fromHaxe(nonce, alloc_int(CHACHAPOLY_IV_LENGTH));
+    chachapoly_starts(_context, _nonce->data, val_int(mode));
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_chachapoly_starts, 3);
+
+
+value hx_chachapoly_update(value context, value ioArr)
+{
+    val_check_chachapoly_context(context);
+    val_check(ioArr, array);
+    val_check(val_array_i(ioArr, 0), int);
+    val_check(val_array_i(ioArr, 2), int);
+    val_check(val_array_i(ioArr, 4), int);
+
+    s_chachapoly* _context = val_chachapoly_context(context);
+    if (_context->stage != CHACHAPOLY_STAGE_AAD && _context->stage != CHACHAPOLY_STAGE_TEXT) {
+        throw_err(POLARSSL_ERR_CHACHAPOLY_BAD_STATE);
+        return alloc_int(POLARSSL_ERR_CHACHAPOLY_BAD_STATE);
+    }
+
+    const size_t length        = val_int(val_array_i(ioArr, 0));
+    const unsigned char* input = data_fromHaxe(val_array_i(ioArr, 1)) + val_int(val_array_i(ioArr, 2));
+    unsigned char* output      = data_fromHaxe(val_array_i(ioArr, 3)) + val_int(val_array_i(ioArr, 4));
+    int ret = chachapoly_update(_context, input, output, length);
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_chachapoly_update, 2);
+
+
+value hx_chachapoly_update_aad(value context, value aad, value length)
+{
+    val_check_chachapoly_context(context);
+
+    s_chachapoly* _context = val_chachapoly_context(context);
+    if (_context->stage != CHACHAPOLY_STAGE_AAD) {
+        throw_err(POLARSSL_ERR_CHACHAPOLY_BAD_STATE);
+        return alloc_int(POLARSSL_ERR_CHACHAPOLY_BAD_STATE);
+    }
+
+    s_bytes* _aad = bytes_fromHaxe(aad, length);
+    chachapoly_update_aad(_context, _aad->data, _aad->length);
+
+    return alloc_int(0);
+}
+DEFINE_PRIM(hx_chachapoly_update_aad, 3);
+
+
+void finalize_chachapoly_context(value context)
+{
+    val_check_chachapoly_context(context);
+
+    if (context != NULL) {
+        s_chachapoly* _context = val_chachapoly_context(context);
+        memset(_context, 0, sizeof(s_chachapoly));
+        _context = NULL;
+    }
+}
+
+} // extern "C"
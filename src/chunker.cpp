@@ -0,0 +1,281 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <polarssl/md.h>
+#include <polarssl/sha1.h>
+#include <polarssl/sha256.h>
+
+#include "hxpolarssl/utils.hpp"
+#include "hxpolarssl/chunker.hpp"
+
+/*
+ * Number of bytes read from files at once (on top of the maximum chunk size kept buffered).
+ */
+#define CHUNKER_READ_SIZE  (1 << 20)
+
+
+/*
+ * Table of 256 random 64 bit values driving the gear rolling hash, derived from a fixed
+ * SplitMix64 seed so boundaries are stable across builds and platforms.
+ */
+struct s_chunker_gear
+{
+    uint64_t table[256];
+
+    s_chunker_gear()
+    {
+        uint64_t seed = 0x6878706F6C617273ULL;
+        for (int i = 0; i < 256; ++i) {
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            table[i] = z ^ (z >> 31);
+        }
+    }
+};
+
+static const uint64_t* chunker_gear(void)
+{
+    static const s_chunker_gear gear;
+
+    return gear.table;
+}
+
+
+/*
+ * Returns a mask of the 'bits' most significant bits; as the gear hash shifts left, those
+ * depend on the most recent bytes rather than only on the last few.
+ */
+static inline uint64_t chunker_mask(const int bits)
+{
+    return ~(uint64_t)0 << (64 - bits);
+}
+
+
+static size_t chunker_digest_size(const md_type_t type)
+{
+    switch (type) {
+        case POLARSSL_MD_SHA1:
+            return 20;
+        case POLARSSL_MD_SHA256:
+            return 32;
+        default:
+            return 0;
+    }
+}
+
+
+/*
+ * Returns the length of the chunk starting at 'src' (FastCDC with normalized chunking).
+ */
+static size_t chunker_cut(const s_chunker* chunker, const unsigned char* src, size_t length)
+{
+    if (length <= chunker->min_size) {
+        return length;
+    }
+    if (length > chunker->max_size) {
+        length = chunker->max_size;
+    }
+
+    const uint64_t* gear = chunker_gear();
+    const size_t normal  = (length < chunker->avg_size) ? length : chunker->avg_size;
+    uint64_t hash        = 0;
+    size_t i             = chunker->min_size;
+
+    for (; i < normal; ++i) {
+        hash = (hash << 1) + gear[src[i]];
+        if ((hash & chunker->mask_s) == 0) {
+            return i + 1;
+        }
+    }
+    for (; i < length; ++i) {
+        hash = (hash << 1) + gear[src[i]];
+        if ((hash & chunker->mask_l) == 0) {
+            return i + 1;
+        }
+    }
+
+    return length;
+}
+
+
+/*
+ * Appends the record (offset, length and digest) of a chunk to 'out'.
+ */
+static void chunker_emit(const s_chunker* chunker, const unsigned char* chunk, const size_t length,
+                         const uint64_t offset, std::vector<unsigned char>* out)
+{
+    const size_t start = out->size();
+    out->resize(start + CHUNKER_RECORD_HEADER + chunker_digest_size(chunker->type));
+
+    unsigned char* record = &(*out)[start];
+    for (int i = 0; i < 8; ++i) {
+        record[i] = (unsigned char)(offset >> (8 * i));
+    }
+    for (int i = 0; i < 4; ++i) {
+        record[8 + i] = (unsigned char)(length >> (8 * i));
+    }
+
+    if (chunker->type == POLARSSL_MD_SHA1) {
+        sha1(chunk, length, record + CHUNKER_RECORD_HEADER);
+    } else if (chunker->type == POLARSSL_MD_SHA256) {
+        sha256(chunk, length, record + CHUNKER_RECORD_HEADER, 0);
+    }
+}
+
+
+static void chunker_bytes(const s_chunker* chunker, const unsigned char* src, const size_t length,
+                          std::vector<unsigned char>* out)
+{
+    size_t offset = 0;
+    while (offset < length) {
+        const size_t n = chunker_cut(chunker, src + offset, length - offset);
+        chunker_emit(chunker, src + offset, n, offset, out);
+        offset += n;
+    }
+}
+
+
+/*
+ * Chunks the file, keeping at least a maximum sized chunk buffered until the end of file.
+ */
+static int chunker_file(const s_chunker* chunker, const char* path, std::vector<unsigned char>* out)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return POLARSSL_ERR_MD_FILE_IO_ERROR;
+    }
+
+    std::vector<unsigned char> buf((size_t)chunker->max_size + CHUNKER_READ_SIZE);
+    size_t begin    = 0;
+    size_t end      = 0;
+    uint64_t offset = 0;
+    bool eof        = false;
+
+    for (;;) {
+        if (!eof && end - begin < chunker->max_size) {
+            memmove(&buf[0], &buf[begin], end - begin);
+            end  -= begin;
+            begin = 0;
+            while (!eof && end < buf.size()) {
+                const size_t n = fread(&buf[end], 1, buf.size() - end, file);
+                end += n;
+                eof  = (n == 0);
+            }
+            if (ferror(file)) {
+                fclose(file);
+                return POLARSSL_ERR_MD_FILE_IO_ERROR;
+            }
+        }
+        if (begin == end) {
+            break;
+        }
+
+        const size_t n = chunker_cut(chunker, &buf[begin], end - begin);
+        chunker_emit(chunker, &buf[begin], n, offset, out);
+        begin  += n;
+        offset += n;
+    }
+    fclose(file);
+
+    return 0;
+}
+
+
+extern "C" {
+
+DEFINE_KIND(k_chunker);
+
+
+value hx_chunker_bytes(value chunker, value bytes, value pos, value length)
+{
+    val_check_chunker(chunker);
+    val_check(pos, int);
+    val_check(length, int);
+
+    std::vector<unsigned char> out;
+    chunker_bytes(val_chunker(chunker), data_fromHaxe(bytes) + val_int(pos), val_int(length), &out);
+
+    return value_fromBytes(out.empty() ? NULL : &out[0], out.size());
+}
+DEFINE_PRIM(hx_chunker_bytes, 4);
+
+
+value hx_chunker_file(value chunker, value path)
+{
+    val_check_chunker(chunker);
+    val_check(path, string);
+
+    // chunk with copies; the GC may run (and move the context) while the file is read
+    const s_chunker params = *val_chunker(chunker);
+    const std::string cpath(val_string(path));
+    std::vector<unsigned char> out;
+
+    gc_enter_blocking();
+    int ret = chunker_file(&params, cpath.c_str(), &out);
+    gc_exit_blocking();
+
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    return value_fromBytes(out.empty() ? NULL : &out[0], out.size());
+}
+DEFINE_PRIM(hx_chunker_file, 2);
+
+
+value hx_chunker_init(value min_size, value avg_size, value max_size, value type)
+{
+    val_check(min_size, int);
+    val_check(avg_size, int);
+    val_check(max_size, int);
+    val_check(type, int);
+
+    const int min = val_int(min_size);
+    const int avg = val_int(avg_size);
+    const int max = val_int(max_size);
+    const int md  = val_int(type);
+    if (min < CHUNKER_MIN_SIZE || avg < min || max < avg || max > CHUNKER_MAX_SIZE
+            || (md != POLARSSL_MD_NONE && md != POLARSSL_MD_SHA1 && md != POLARSSL_MD_SHA256)) {
+        throw_err(POLARSSL_ERR_MD_BAD_INPUT_DATA);
+        return alloc_int(POLARSSL_ERR_MD_BAD_INPUT_DATA);
+    }
+
+    int bits = 0;
+    while ((2 << bits) <= avg) {
+        ++bits;
+    }
+
+    s_chunker* chunker = malloc_chunker();
+    chunker->min_size  = min;
+    chunker->avg_size  = avg;
+    chunker->max_size  = max;
+    chunker->mask_s    = chunker_mask(bits + 2);
+    chunker->mask_l    = chunker_mask(bits - 2);
+    chunker->type      = (md_type_t)md;
+
+    value val = alloc_chunker(chunker);
+    val_gc(val, finalize_chunker);
+
+    return val;
+}
+DEFINE_PRIM(hx_chunker_init, 4);
+
+
+void finalize_chunker(value chunker)
+{
+    val_check_chunker(chunker);
+
+    if (chunker != NULL) {
+        s_chunker* _chunker = val_chunker(chunker);
+        memset(_chunker, 0, sizeof(s_chunker));
+        _chunker = NULL;
+    }
+}
+
+} // extern "C"
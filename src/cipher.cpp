@@ -0,0 +1,368 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <stdlib.h>
+#include <string.h>
+#include <polarssl/cipher.h>
+
+#include "hxpolarssl/cipher.hpp"
+#include "hxpolarssl/utils.hpp"
+
+/*
+ * Checks if the mode requires input to be collected into full blocks before cipher_update().
+ */
+static int cipher_needs_buffer(const cipher_context_t* ctx)
+{
+    const cipher_mode_t mode = cipher_get_cipher_mode(ctx);
+
+    return mode == POLARSSL_MODE_ECB || mode == POLARSSL_MODE_GCM;
+}
+
+
+/*
+ * Feeds the input through cipher_update(), collecting partial blocks in the
+ * context's buffer for the modes that need it.
+ *
+ * 'output' must have room for 'ilen' + block size bytes.
+ */
+static int cipher_update_buffered(s_cipher* context, const unsigned char* input, size_t ilen,
+    unsigned char* output, size_t* olen)
+{
+    cipher_context_t* ctx = &(context->cipher);
+    *olen = 0;
+
+    if (!cipher_needs_buffer(ctx)) {
+        return cipher_update(ctx, input, ilen, output, olen);
+    }
+
+    const size_t bsize = cipher_get_block_size(ctx);
+    const int is_ecb   = cipher_get_cipher_mode(ctx) == POLARSSL_MODE_ECB;
+    size_t part;
+    int ret;
+
+    // complete a previously buffered block first
+    if (context->buffer_len > 0) {
+        const size_t use = (ilen < bsize - context->buffer_len) ? ilen : bsize - context->buffer_len;
+        memcpy(context->buffer + context->buffer_len, input, use);
+        context->buffer_len += use;
+        input += use;
+        ilen  -= use;
+
+        if (context->buffer_len < bsize) {
+            return 0;
+        }
+        if ((ret = cipher_update(ctx, context->buffer, bsize, output, &part)) != 0) {
+            return ret;
+        }
+        *olen += part;
+        context->buffer_len = 0;
+    }
+
+    // full blocks straight from the input (one per call in ECB mode)
+    const size_t full = ilen - (ilen % bsize);
+    if (is_ecb) {
+        for (size_t offset = 0; offset < full; offset += bsize) {
+            if ((ret = cipher_update(ctx, input + offset, bsize, output + *olen, &part)) != 0) {
+                return ret;
+            }
+            *olen += part;
+        }
+    } else if (full > 0) {
+        if ((ret = cipher_update(ctx, input, full, output + *olen, &part)) != 0) {
+            return ret;
+        }
+        *olen += part;
+    }
+
+    // keep the remainder for the next call
+    memcpy(context->buffer, input + full, ilen - full);
+    context->buffer_len = ilen - full;
+
+    return 0;
+}
+
+
+extern "C" {
+
+DEFINE_KIND(k_cipher_context);
+
+
+value hx_cipher_check_tag(value context, value tag, value length)
+{
+    val_check_cipher_context(context);
+
+    s_bytes* bytes = bytes_fromHaxe(tag, length);
+
+    int ret = cipher_check_tag(&(val_cipher_context(context)->cipher), bytes->data, bytes->length);
+    if (ret == POLARSSL_ERR_CIPHER_AUTH_FAILED) {
+        return alloc_bool(false);
+    }
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    return alloc_bool(true);
+}
+DEFINE_PRIM(hx_cipher_check_tag, 3);
+
+
+value hx_cipher_finish(value context)
+{
+    val_check_cipher_context(context);
+
+    s_cipher* _context    = val_cipher_context(context);
+    cipher_context_t* ctx = &(_context->cipher);
+    unsigned char output[2 * POLARSSL_MAX_BLOCK_LENGTH];
+    size_t olen = 0;
+    size_t part = 0;
+
+    int ret = 0;
+    if (_context->buffer_len > 0) {
+        if (cipher_get_cipher_mode(ctx) == POLARSSL_MODE_ECB) {
+            ret = POLARSSL_ERR_CIPHER_FULL_BLOCK_EXPECTED;
+        } else { // GCM accepts a partial last block
+            ret  = cipher_update(ctx, _context->buffer, _context->buffer_len, output, &olen);
+        }
+        _context->buffer_len = 0;
+    }
+    if (ret == 0) {
+        ret   = cipher_finish(ctx, output + olen, &part);
+        olen += part;
+    }
+
+    value val;
+    if (ret == 0) {
+        val = value_fromBytes(output, olen);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_cipher_finish, 1);
+
+
+value hx_cipher_free(value context)
+{
+    val_check_cipher_context(context);
+
+    s_cipher* _context = val_cipher_context(context);
+    cipher_free(&(_context->cipher));
+    memset(_context->buffer, 0, sizeof(_context->buffer));
+    _context->buffer_len = 0;
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_cipher_free, 1);
+
+
+value hx_cipher_get_block_size(value context)
+{
+    val_check_cipher_context(context);
+
+    return alloc_int(cipher_get_block_size(&(val_cipher_context(context)->cipher)));
+}
+DEFINE_PRIM(hx_cipher_get_block_size, 1);
+
+
+value hx_cipher_get_iv_size(value context)
+{
+    val_check_cipher_context(context);
+
+    return alloc_int(cipher_get_iv_size(&(val_cipher_context(context)->cipher)));
+}
+DEFINE_PRIM(hx_cipher_get_iv_size, 1);
+
+
+value hx_cipher_get_key_size(value context)
+{
+    val_check_cipher_context(context);
+
+    return alloc_int(cipher_get_key_size(&(val_cipher_context(context)->cipher)));
+}
+DEFINE_PRIM(hx_cipher_get_key_size, 1);
+
+
+value hx_cipher_init(value name)
+{
+    val_check(name, string);
+
+    const cipher_info_t* info = cipher_info_from_string(val_string(name));
+    if (info == NULL) {
+        throw_err(POLARSSL_ERR_CIPHER_FEATURE_UNAVAILABLE);
+        return alloc_int(POLARSSL_ERR_CIPHER_FEATURE_UNAVAILABLE);
+    }
+
+    s_cipher* context = malloc_cipher_context();
+    cipher_init(&(context->cipher));
+    context->buffer_len = 0;
+
+    int ret = cipher_init_ctx(&(context->cipher), info);
+    if (ret != 0) {
+        cipher_free(&(context->cipher));
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    value val = alloc_cipher_context(context);
+    val_gc(val, finalize_cipher_context);
+
+    return val;
+}
+DEFINE_PRIM(hx_cipher_init, 1);
+
+
+value hx_cipher_reset(value context)
+{
+    val_check_cipher_context(context);
+
+    s_cipher* _context   = val_cipher_context(context);
+    _context->buffer_len = 0;
+
+    int ret = cipher_reset(&(_context->cipher));
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_cipher_reset, 1);
+
+
+value hx_cipher_set_iv(value context, value iv, value length)
+{
+    val_check_cipher_context(context);
+
+    s_bytes* bytes = bytes_fromHaxe(iv, length);
+
+    int ret = cipher_set_iv(&(val_cipher_context(context)->cipher), bytes->data, bytes->length);
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_cipher_set_iv, 3);
+
+
+value hx_cipher_set_padding(value context, value padding)
+{
+    val_check_cipher_context(context);
+    val_check(padding, int);
+
+    int ret = cipher_set_padding_mode(&(val_cipher_context(context)->cipher), (cipher_padding_t)val_int(padding));
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_cipher_set_padding, 2);
+
+
+value hx_cipher_setkey(value context, value key, value length, value operation)
+{
+    val_check_cipher_context(context);
+    val_check(operation, int);
+
+    s_bytes* bytes = bytes_fromHaxe(key, length);
+
+    int ret = cipher_setkey(&(val_cipher_context(context)->cipher), bytes->data, (int)(bytes->length * 8), (operation_t)val_int(operation));
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_cipher_setkey, 4);
+
+
+value hx_cipher_update(value context, value input, value pos, value length)
+{
+    val_check_cipher_context(context);
+    val_check(pos, int);
+    val_check(length, int);
+
+    const unsigned char* data = data_fromHaxe(input) + val_int(pos);
+    const size_t ilen         = val_int(length);
+    unsigned char* output     = (unsigned char*)malloc(ilen + POLARSSL_MAX_BLOCK_LENGTH);
+    size_t olen               = 0;
+    if (output == NULL) {
+        throw_err(POLARSSL_ERR_CIPHER_ALLOC_FAILED);
+        return alloc_int(POLARSSL_ERR_CIPHER_ALLOC_FAILED);
+    }
+
+    value val;
+    int ret = cipher_update_buffered(val_cipher_context(context), data, ilen, output, &olen);
+    if (ret == 0) {
+        val = value_fromBytes(output, olen);
+    } else {
+        val = alloc_int(ret);
+    }
+    free(output);
+
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_cipher_update, 4);
+
+
+value hx_cipher_update_ad(value context, value ad, value length)
+{
+    val_check_cipher_context(context);
+
+    s_bytes* bytes = bytes_fromHaxe(ad, length);
+
+    int ret = cipher_update_ad(&(val_cipher_context(context)->cipher), bytes->data, bytes->length);
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_cipher_update_ad, 3);
+
+
+value hx_cipher_write_tag(value context, value length)
+{
+    val_check_cipher_context(context);
+    val_check(length, int);
+
+    if (val_int(length) < 0 || val_int(length) > CIPHER_MAX_TAG_LENGTH) {
+        throw_err(POLARSSL_ERR_CIPHER_BAD_INPUT_DATA);
+        return alloc_int(POLARSSL_ERR_CIPHER_BAD_INPUT_DATA);
+    }
+
+    const size_t size = val_int(length);
+    unsigned char tag[CIPHER_MAX_TAG_LENGTH];
+
+    value val;
+    int ret = cipher_write_tag(&(val_cipher_context(context)->cipher), tag, size);
+    if (ret == 0) {
+        val = value_fromBytes(tag, size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_cipher_write_tag, 2);
+
+
+void finalize_cipher_context(value context)
+{
+    val_check_cipher_context(context);
+
+    if (context != NULL) {
+        s_cipher* _context = val_cipher_context(context);
+        cipher_free(&(_context->cipher));
+        _context = NULL;
+    }
+}
+
+} // extern "C"
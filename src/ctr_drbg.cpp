@@ -0,0 +1,201 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <stdlib.h>
+#include <polarssl/ctr_drbg.h>
+#include <polarssl/entropy.h>
+#include <polarssl/havege.h>
+
+#include "hxpolarssl/ctr_drbg.hpp"
+#include "hxpolarssl/utils.hpp"
+
+extern "C" {
+
+DEFINE_KIND(k_ctr_drbg_context);
+
+
+/*
+ * Writes 'size' random bytes into 'out', splitting the request into chunks
+ * PolarSSL accepts.
+ */
+static int ctr_drbg_random_chunked(ctr_drbg_context* ctx, unsigned char* out, const size_t size)
+{
+    int ret       = 0;
+    size_t offset = 0;
+    while (ret == 0 && offset < size) {
+        const size_t chunk = (size - offset < CTR_DRBG_MAX_REQUEST) ? size - offset : CTR_DRBG_MAX_REQUEST;
+        ret     = ctr_drbg_random(ctx, out + offset, chunk);
+        offset += chunk;
+    }
+
+    return ret;
+}
+
+
+value hx_ctr_drbg_fill(value context, value bytes, value pos, value length)
+{
+    val_check_ctr_drbg_context(context);
+    val_check(pos, int);
+    val_check(length, int);
+
+    int ret = ctr_drbg_random_chunked(&(val_ctr_drbg_context(context)->ctr_drbg), data_fromHaxe(bytes) + val_int(pos), val_int(length));
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_ctr_drbg_fill, 4);
+
+
+value hx_ctr_drbg_free(value context)
+{
+    val_check_ctr_drbg_context(context);
+
+    s_ctr_drbg* _context = val_ctr_drbg_context(context);
+    ctr_drbg_free(&(_context->ctr_drbg));
+    entropy_free(&(_context->entropy));
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_ctr_drbg_free, 1);
+
+
+value hx_ctr_drbg_init(value custom, value length)
+{
+    s_bytes* bytes       = bytes_fromHaxe(custom, length);
+    s_ctr_drbg* context  = malloc_ctr_drbg_context();
+    entropy_init(&(context->entropy));
+
+    int ret = ctr_drbg_init(&(context->ctr_drbg), entropy_func, &(context->entropy), bytes->data, bytes->length);
+    if (ret != 0) {
+        entropy_free(&(context->entropy));
+        free(context);
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    value val = alloc_ctr_drbg_context(context);
+    val_gc(val, finalize_ctr_drbg_context);
+
+    return val;
+}
+DEFINE_PRIM(hx_ctr_drbg_init, 2);
+
+
+value hx_ctr_drbg_random(value context, value nbytes)
+{
+    val_check_ctr_drbg_context(context);
+    val_check(nbytes, int);
+
+    s_ctr_drbg* _context = val_ctr_drbg_context(context);
+    const size_t size    = val_int(nbytes);
+    unsigned char buffer[size];
+
+    int ret = ctr_drbg_random_chunked(&(_context->ctr_drbg), buffer, size);
+
+    value val;
+    if (ret == 0) {
+        val = value_fromBytes(buffer, size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_ctr_drbg_random, 2);
+
+
+value hx_ctr_drbg_reseed(value context, value additional, value length)
+{
+    val_check_ctr_drbg_context(context);
+
+    s_bytes* bytes = bytes_fromHaxe(additional, length);
+
+    int ret = ctr_drbg_reseed(&(val_ctr_drbg_context(context)->ctr_drbg), bytes->data, bytes->length);
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_ctr_drbg_reseed, 3);
+
+
+value hx_ctr_drbg_self_test(value verbose)
+{
+    val_check(verbose, bool);
+
+    int ret = ctr_drbg_self_test(val_bool(verbose));
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_ctr_drbg_self_test, 1);
+
+
+value hx_ctr_drbg_set_prediction_resistance(value context, value resistance)
+{
+    val_check_ctr_drbg_context(context);
+    val_check(resistance, bool);
+
+    ctr_drbg_set_prediction_resistance(&(val_ctr_drbg_context(context)->ctr_drbg), val_bool(resistance) ? CTR_DRBG_PR_ON : CTR_DRBG_PR_OFF);
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_ctr_drbg_set_prediction_resistance, 2);
+
+
+value hx_ctr_drbg_set_reseed_interval(value context, value interval)
+{
+    val_check_ctr_drbg_context(context);
+    val_check(interval, int);
+
+    ctr_drbg_set_reseed_interval(&(val_ctr_drbg_context(context)->ctr_drbg), val_int(interval));
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_ctr_drbg_set_reseed_interval, 2);
+
+
+void finalize_ctr_drbg_context(value context)
+{
+    val_check_ctr_drbg_context(context);
+
+    if (context != NULL) {
+        s_ctr_drbg* _context = val_ctr_drbg_context(context);
+        ctr_drbg_free(&(_context->ctr_drbg));
+        entropy_free(&(_context->entropy));
+        free(_context);
+        _context = NULL;
+    }
+}
+
+
+void rng_fromHaxe(value rng, s_rng* out)
+{
+    if (val_is_null(rng)) {
+        havege_init(&(out->havege));
+        out->f_rng      = havege_random;
+        out->p_rng      = &(out->havege);
+        out->has_havege = 1;
+    } else {
+        val_check_ctr_drbg_context(rng);
+        out->f_rng      = ctr_drbg_random;
+        out->p_rng      = &(val_ctr_drbg_context(rng)->ctr_drbg);
+        out->has_havege = 0;
+    }
+}
+
+
+void rng_free(s_rng* rng)
+{
+    if (rng->has_havege) {
+        havege_free(&(rng->havege));
+        rng->has_havege = 0;
+    }
+}
+
+} // extern "C"
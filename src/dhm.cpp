@@ -0,0 +1,296 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <stdlib.h>
+#include <polarssl/bignum.h>
+#include <polarssl/dhm.h>
+#include <polarssl/ctr_drbg.h>
+#include <polarssl/entropy.h>
+#include <polarssl/havege.h>
+
+#include "hxpolarssl/ctr_drbg.hpp"
+#include "hxpolarssl/dhm.hpp"
+#include "hxpolarssl/utils.hpp"
+
+extern "C" {
+
+DEFINE_KIND(k_dhm_context);
+
+
+/*
+ * Drops the values PolarSSL derives from (and caches for) the prime modulus P.
+ */
+static void dhm_reset_cache(dhm_context* context)
+{
+    mpi_free(&(context->RP));
+    mpi_free(&(context->Vi));
+    mpi_free(&(context->Vf));
+    context->len = mpi_size(&(context->P));
+}
+
+
+/*
+ * Sets the group parameters unless they are already in use by the context.
+ */
+static int dhm_set_group(dhm_context* context, const mpi* P, const mpi* G)
+{
+    if (mpi_cmp_mpi(&(context->P), P) == 0 && mpi_cmp_mpi(&(context->G), G) == 0) {
+        return 0;
+    }
+
+    int ret = mpi_copy(&(context->P), P);
+    if (ret == 0) {
+        ret = mpi_copy(&(context->G), G);
+    }
+    dhm_reset_cache(context);
+
+    return ret;
+}
+
+
+value hx_dhm_calc_secret(value context, value rng)
+{
+    val_check_dhm_context(context);
+
+    dhm_context* _context = val_dhm_context(context);
+    size_t size           = _context->len;
+    unsigned char buffer[size];
+    s_rng _rng;
+    rng_fromHaxe(rng, &_rng);
+
+    value val;
+    int ret = dhm_calc_secret(_context, buffer, &size, _rng.f_rng, _rng.p_rng);
+    rng_free(&_rng);
+    if (ret == 0) {
+        val = value_fromBytes(buffer, size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_dhm_calc_secret, 2);
+
+
+value hx_dhm_free(value context)
+{
+    val_check_dhm_context(context);
+
+    dhm_free(val_dhm_context(context));
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_dhm_free, 1);
+
+
+value hx_dhm_init(void)
+{
+    dhm_context* context = malloc_dhm_context();
+    dhm_init(context);
+
+    value val = alloc_dhm_context(context);
+    val_gc(val, finalize_dhm_context);
+
+    return val;
+}
+DEFINE_PRIM(hx_dhm_init, 0);
+
+
+value hx_dhm_make_params(value context, value x_size, value rng)
+{
+    val_check_dhm_context(context);
+    val_check(x_size, int);
+
+    dhm_context* _context = val_dhm_context(context);
+    const int xsize       = (val_int(x_size) > 0) ? val_int(x_size) : (int)mpi_size(&(_context->P));
+    unsigned char buffer[3 * (2 + _context->len)];
+    size_t size;
+    s_rng _rng;
+    rng_fromHaxe(rng, &_rng);
+
+    value val;
+    int ret = dhm_make_params(_context, xsize, buffer, &size, _rng.f_rng, _rng.p_rng);
+    rng_free(&_rng);
+    if (ret == 0) {
+        val = value_fromBytes(buffer, size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_dhm_make_params, 3);
+
+
+value hx_dhm_make_public(value context, value x_size, value rng)
+{
+    val_check_dhm_context(context);
+    val_check(x_size, int);
+
+    dhm_context* _context = val_dhm_context(context);
+    const int xsize       = (val_int(x_size) > 0) ? val_int(x_size) : (int)mpi_size(&(_context->P));
+    const size_t size     = _context->len;
+    unsigned char buffer[size];
+    s_rng _rng;
+    rng_fromHaxe(rng, &_rng);
+
+    value val;
+    int ret = dhm_make_public(_context, xsize, buffer, size, _rng.f_rng, _rng.p_rng);
+    rng_free(&_rng);
+    if (ret == 0) {
+        val = value_fromBytes(buffer, size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_dhm_make_public, 3);
+
+
+value hx_dhm_read_params(value context, value params, value length)
+{
+    val_check_dhm_context(context);
+
+    dhm_context* _context = val_dhm_context(context);
+    s_bytes* bytes        = bytes_fromHaxe(params, length);
+    unsigned char* p      = (unsigned char*)bytes->data;
+    mpi P;
+    mpi_init(&P);
+
+    int ret = mpi_copy(&P, &(_context->P));
+    if (ret == 0) {
+        ret = dhm_read_params(_context, &p, bytes->data + bytes->length);
+    }
+    if (ret == 0 && mpi_cmp_mpi(&P, &(_context->P)) != 0) {
+        dhm_reset_cache(_context);
+    }
+    mpi_free(&P);
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_dhm_read_params, 3);
+
+
+value hx_dhm_read_public(value context, value input, value length)
+{
+    val_check_dhm_context(context);
+
+    s_bytes* bytes = bytes_fromHaxe(input, length);
+
+    int ret = dhm_read_public(val_dhm_context(context), bytes->data, bytes->length);
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_dhm_read_public, 3);
+
+
+value hx_dhm_self_test(value verbose)
+{
+    val_check(verbose, bool);
+
+    int ret = dhm_self_test(val_bool(verbose));
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_dhm_self_test, 1);
+
+
+value hx_dhm_set_group(value context, value P, value Plen, value G, value Glen)
+{
+    val_check_dhm_context(context);
+
+    s_bytes* P_bytes = bytes_fromHaxe(P, Plen);
+    s_bytes* G_bytes = bytes_fromHaxe(G, Glen);
+    mpi _P, _G;
+    mpi_init(&_P);
+    mpi_init(&_G);
+
+    int ret = mpi_read_binary(&_P, P_bytes->data, P_bytes->length);
+    if (ret == 0) {
+        ret = mpi_read_binary(&_G, G_bytes->data, G_bytes->length);
+    }
+    if (ret == 0) {
+        ret = dhm_set_group(val_dhm_context(context), &_P, &_G);
+    }
+    mpi_free(&_P);
+    mpi_free(&_G);
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_dhm_set_group, 5);
+
+
+value hx_dhm_use_known_group(value context, value group_id)
+{
+    val_check_dhm_context(context);
+    val_check(group_id, int);
+
+    const char* P_str;
+    const char* G_str;
+    switch (val_int(group_id)) {
+        case DHM_GROUP_RFC3526_MODP_2048:
+            P_str = POLARSSL_DHM_RFC3526_MODP_2048_P;
+            G_str = POLARSSL_DHM_RFC3526_MODP_2048_G;
+            break;
+        case DHM_GROUP_RFC3526_MODP_3072:
+            P_str = POLARSSL_DHM_RFC3526_MODP_3072_P;
+            G_str = POLARSSL_DHM_RFC3526_MODP_3072_G;
+            break;
+        case DHM_GROUP_RFC5114_MODP_2048:
+            P_str = POLARSSL_DHM_RFC5114_MODP_2048_P;
+            G_str = POLARSSL_DHM_RFC5114_MODP_2048_G;
+            break;
+        default:
+            throw_err(POLARSSL_ERR_DHM_BAD_INPUT_DATA);
+            return alloc_int(POLARSSL_ERR_DHM_BAD_INPUT_DATA);
+    }
+
+    mpi P, G;
+    mpi_init(&P);
+    mpi_init(&G);
+
+    int ret = mpi_read_string(&P, 16, P_str);
+    if (ret == 0) {
+        ret = mpi_read_string(&G, 16, G_str);
+    }
+    if (ret == 0) {
+        ret = dhm_set_group(val_dhm_context(context), &P, &G);
+    }
+    mpi_free(&P);
+    mpi_free(&G);
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_dhm_use_known_group, 2);
+
+
+void finalize_dhm_context(value context)
+{
+    val_check_dhm_context(context);
+
+    if (context != NULL) {
+        dhm_context* _context = val_dhm_context(context);
+        dhm_free(_context);
+        _context = NULL;
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,477 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <polarssl/md.h>
+#include <polarssl/md5.h>
+#include <polarssl/ripemd160.h>
+#include <polarssl/sha1.h>
+#include <polarssl/sha256.h>
+#include <polarssl/sha512.h>
+
+#include "hxpolarssl/utils.hpp"
+#include "hxpolarssl/digest.hpp"
+
+/*
+ * Size of the chunks files are read in.
+ */
+#define DIGEST_FILE_CHUNK  65536
+
+
+static bool digest_supported(const int type)
+{
+    switch (type) {
+        case POLARSSL_MD_MD5:
+        case POLARSSL_MD_SHA1:
+        case POLARSSL_MD_SHA224:
+        case POLARSSL_MD_SHA256:
+        case POLARSSL_MD_SHA384:
+        case POLARSSL_MD_SHA512:
+        case POLARSSL_MD_RIPEMD160:
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+static void digest_starts(s_digest* digest, const md_type_t type)
+{
+    memset(digest, 0, sizeof(s_digest));
+    digest->type = type;
+    switch (type) {
+        case POLARSSL_MD_MD5:
+            md5_starts(&digest->ctx.md5);
+            break;
+        case POLARSSL_MD_SHA1:
+            sha1_starts(&digest->ctx.sha1);
+            break;
+        case POLARSSL_MD_SHA224:
+        case POLARSSL_MD_SHA256:
+            sha256_starts(&digest->ctx.sha256, type == POLARSSL_MD_SHA224);
+            break;
+        case POLARSSL_MD_SHA384:
+        case POLARSSL_MD_SHA512:
+            sha512_starts(&digest->ctx.sha512, type == POLARSSL_MD_SHA384);
+            break;
+        default:
+            ripemd160_starts(&digest->ctx.ripemd160);
+            break;
+    }
+}
+
+
+static void digest_update(s_digest* digest, const unsigned char* input, const size_t length)
+{
+    switch (digest->type) {
+        case POLARSSL_MD_MD5:
+            md5_update(&digest->ctx.md5, input, length);
+            break;
+        case POLARSSL_MD_SHA1:
+            sha1_update(&digest->ctx.sha1, input, length);
+            break;
+        case POLARSSL_MD_SHA224:
+        case POLARSSL_MD_SHA256:
+            sha256_update(&digest->ctx.sha256, input, length);
+            break;
+        case POLARSSL_MD_SHA384:
+        case POLARSSL_MD_SHA512:
+            sha512_update(&digest->ctx.sha512, input, length);
+            break;
+        default:
+            ripemd160_update(&digest->ctx.ripemd160, input, length);
+            break;
+    }
+}
+
+
+/*
+ * Writes the sum into 'sum' (of at least 64 bytes) and returns its length.
+ */
+static size_t digest_finish(s_digest* digest, unsigned char* sum)
+{
+    switch (digest->type) {
+        case POLARSSL_MD_MD5:
+            md5_finish(&digest->ctx.md5, sum);
+            return 16;
+        case POLARSSL_MD_SHA1:
+            sha1_finish(&digest->ctx.sha1, sum);
+            return 20;
+        case POLARSSL_MD_SHA224:
+        case POLARSSL_MD_SHA256:
+            sha256_finish(&digest->ctx.sha256, sum);
+            return (digest->type == POLARSSL_MD_SHA224) ? 28 : 32;
+        case POLARSSL_MD_SHA384:
+        case POLARSSL_MD_SHA512:
+            sha512_finish(&digest->ctx.sha512, sum);
+            return (digest->type == POLARSSL_MD_SHA384) ? 48 : 64;
+        default:
+            ripemd160_finish(&digest->ctx.ripemd160, sum);
+            return 20;
+    }
+}
+
+
+/*
+ * The parts of the algorithm specific contexts making up the state; the 32 bit word
+ * algorithms (all but SHA-384/512) share a layout apart from the number of state words.
+ */
+typedef struct {
+    uint32_t*      total;
+    uint32_t*      state;
+    size_t         words;
+    unsigned char* buffer;
+} s_digest32_view;
+
+
+static s_digest32_view digest_view32(s_digest* digest)
+{
+    s_digest32_view view;
+    switch (digest->type) {
+        case POLARSSL_MD_MD5:
+            view.total  = digest->ctx.md5.total;
+            view.state  = digest->ctx.md5.state;
+            view.words  = 4;
+            view.buffer = digest->ctx.md5.buffer;
+            break;
+        case POLARSSL_MD_SHA1:
+            view.total  = digest->ctx.sha1.total;
+            view.state  = digest->ctx.sha1.state;
+            view.words  = 5;
+            view.buffer = digest->ctx.sha1.buffer;
+            break;
+        case POLARSSL_MD_SHA224:
+        case POLARSSL_MD_SHA256:
+            view.total  = digest->ctx.sha256.total;
+            view.state  = digest->ctx.sha256.state;
+            view.words  = 8;
+            view.buffer = digest->ctx.sha256.buffer;
+            break;
+        default:
+            view.total  = digest->ctx.ripemd160.total;
+            view.state  = digest->ctx.ripemd160.state;
+            view.words  = 5;
+            view.buffer = digest->ctx.ripemd160.buffer;
+            break;
+    }
+
+    return view;
+}
+
+
+static inline bool digest_is64(const md_type_t type)
+{
+    return type == POLARSSL_MD_SHA384 || type == POLARSSL_MD_SHA512;
+}
+
+
+/*
+ * Returns the number of bytes hashed (the low 64 bits for SHA-384/512).
+ */
+static uint64_t digest_length(s_digest* digest)
+{
+    if (digest_is64(digest->type)) {
+        return digest->ctx.sha512.total[0];
+    }
+
+    s_digest32_view view = digest_view32(digest);
+    return ((uint64_t)view.total[1] << 32) | view.total[0];
+}
+
+
+static void put_be(unsigned char* dst, const uint64_t x, const size_t bytes)
+{
+    for (size_t i = 0; i < bytes; ++i) {
+        dst[i] = (unsigned char)(x >> (8 * (bytes - 1 - i)));
+    }
+}
+
+
+static uint64_t get_be(const unsigned char* src, const size_t bytes)
+{
+    uint64_t x = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        x = (x << 8) | src[i];
+    }
+
+    return x;
+}
+
+
+/*
+ * Serializes the digest state into 'dst' (of at least 209 bytes) and returns its length.
+ */
+static size_t digest_save(s_digest* digest, unsigned char* dst)
+{
+    size_t p = 0;
+    dst[p++] = DIGEST_STATE_VERSION;
+    dst[p++] = (unsigned char)digest->type;
+
+    if (digest_is64(digest->type)) {
+        sha512_context* ctx = &digest->ctx.sha512;
+        put_be(dst + p, ctx->total[1], 8);
+        put_be(dst + p + 8, ctx->total[0], 8);
+        p += 16;
+        for (size_t i = 0; i < 8; ++i, p += 8) {
+            put_be(dst + p, ctx->state[i], 8);
+        }
+        const size_t pending = (size_t)(ctx->total[0] & 127);
+        memcpy(dst + p, ctx->buffer, pending);
+        p += pending;
+    } else {
+        s_digest32_view view = digest_view32(digest);
+        put_be(dst + p, view.total[1], 4);
+        put_be(dst + p + 4, view.total[0], 4);
+        p += 8;
+        for (size_t i = 0; i < view.words; ++i, p += 4) {
+            put_be(dst + p, view.state[i], 4);
+        }
+        const size_t pending = view.total[0] & 63;
+        memcpy(dst + p, view.buffer, pending);
+        p += pending;
+    }
+
+    return p;
+}
+
+
+/*
+ * Restores the digest from a state written by digest_save().
+ */
+static int digest_restore(s_digest* digest, const unsigned char* src, const size_t length)
+{
+    if (length < 2 || src[0] != DIGEST_STATE_VERSION || !digest_supported(src[1])) {
+        return POLARSSL_ERR_MD_BAD_INPUT_DATA;
+    }
+
+    const md_type_t type = (md_type_t)src[1];
+    size_t p = 2;
+    digest_starts(digest, type);
+
+    if (digest_is64(type)) {
+        sha512_context* ctx = &digest->ctx.sha512;
+        if (length < p + 16 + 64) {
+            return POLARSSL_ERR_MD_BAD_INPUT_DATA;
+        }
+        ctx->total[1] = get_be(src + p, 8);
+        ctx->total[0] = get_be(src + p + 8, 8);
+        p += 16;
+        for (size_t i = 0; i < 8; ++i, p += 8) {
+            ctx->state[i] = get_be(src + p, 8);
+        }
+        const size_t pending = (size_t)(ctx->total[0] & 127);
+        if (length != p + pending) {
+            return POLARSSL_ERR_MD_BAD_INPUT_DATA;
+        }
+        memcpy(ctx->buffer, src + p, pending);
+    } else {
+        s_digest32_view view = digest_view32(digest);
+        if (length < p + 8 + 4 * view.words) {
+            return POLARSSL_ERR_MD_BAD_INPUT_DATA;
+        }
+        view.total[1] = (uint32_t)get_be(src + p, 4);
+        view.total[0] = (uint32_t)get_be(src + p + 4, 4);
+        p += 8;
+        for (size_t i = 0; i < view.words; ++i, p += 4) {
+            view.state[i] = (uint32_t)get_be(src + p, 4);
+        }
+        const size_t pending = view.total[0] & 63;
+        if (length != p + pending) {
+            return POLARSSL_ERR_MD_BAD_INPUT_DATA;
+        }
+        memcpy(view.buffer, src + p, pending);
+    }
+
+    return 0;
+}
+
+
+/*
+ * Hashes the file from 'offset' on and stores the number of bytes read in 'hashed'.
+ */
+static int digest_update_file(s_digest* digest, const char* path, const uint64_t offset, uint64_t* hashed)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return POLARSSL_ERR_MD_FILE_IO_ERROR;
+    }
+
+#if defined(_WIN32)
+    int ret = _fseeki64(file, (__int64)offset, SEEK_SET);
+#else
+    int ret = fseeko(file, (off_t)offset, SEEK_SET);
+#endif
+    if (ret != 0) {
+        fclose(file);
+        return POLARSSL_ERR_MD_FILE_IO_ERROR;
+    }
+
+    std::vector<unsigned char> buf(DIGEST_FILE_CHUNK);
+    size_t n;
+    *hashed = 0;
+    while ((n = fread(&buf[0], 1, buf.size(), file)) > 0) {
+        digest_update(digest, &buf[0], n);
+        *hashed += n;
+    }
+
+    ret = ferror(file) ? POLARSSL_ERR_MD_FILE_IO_ERROR : 0;
+    fclose(file);
+
+    return ret;
+}
+
+
+extern "C" {
+
+DEFINE_KIND(k_digest_context);
+
+
+value hx_digest_clone(value digest)
+{
+    val_check_digest_context(digest);
+
+    s_digest* copy = malloc_digest_context();
+    memcpy(copy, val_digest_context(digest), sizeof(s_digest));
+
+    value val = alloc_digest_context(copy);
+    val_gc(val, finalize_digest_context);
+
+    return val;
+}
+DEFINE_PRIM(hx_digest_clone, 1);
+
+
+value hx_digest_finish(value digest)
+{
+    val_check_digest_context(digest);
+
+    s_digest* _digest = val_digest_context(digest);
+    unsigned char sum[64];
+    const size_t length = digest_finish(_digest, sum);
+    digest_starts(_digest, _digest->type);
+
+    return value_fromBytes(sum, length);
+}
+DEFINE_PRIM(hx_digest_finish, 1);
+
+
+value hx_digest_init(value type)
+{
+    val_check(type, int);
+
+    if (!digest_supported(val_int(type))) {
+        throw_err(POLARSSL_ERR_MD_FEATURE_UNAVAILABLE);
+        return alloc_int(POLARSSL_ERR_MD_FEATURE_UNAVAILABLE);
+    }
+
+    s_digest* digest = malloc_digest_context();
+    digest_starts(digest, (md_type_t)val_int(type));
+
+    value val = alloc_digest_context(digest);
+    val_gc(val, finalize_digest_context);
+
+    return val;
+}
+DEFINE_PRIM(hx_digest_init, 1);
+
+
+value hx_digest_length(value digest)
+{
+    val_check_digest_context(digest);
+
+    return alloc_float((double)digest_length(val_digest_context(digest)));
+}
+DEFINE_PRIM(hx_digest_length, 1);
+
+
+value hx_digest_restore(value state, value length)
+{
+    s_bytes* cstate = bytes_fromHaxe(state, length);
+
+    s_digest* digest = malloc_digest_context();
+    int ret = digest_restore(digest, cstate->data, cstate->length);
+    if (ret != 0) {
+        memset(digest, 0, sizeof(s_digest));
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    value val = alloc_digest_context(digest);
+    val_gc(val, finalize_digest_context);
+
+    return val;
+}
+DEFINE_PRIM(hx_digest_restore, 2);
+
+
+value hx_digest_save(value digest)
+{
+    val_check_digest_context(digest);
+
+    unsigned char state[2 + 16 + 64 + 128];
+    const size_t length = digest_save(val_digest_context(digest), state);
+
+    return value_fromBytes(state, length);
+}
+DEFINE_PRIM(hx_digest_save, 1);
+
+
+value hx_digest_update(value digest, value bytes, value pos, value length)
+{
+    val_check_digest_context(digest);
+    val_check(pos, int);
+    val_check(length, int);
+
+    digest_update(val_digest_context(digest), data_fromHaxe(bytes) + val_int(pos), val_int(length));
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_digest_update, 4);
+
+
+value hx_digest_update_file(value digest, value path, value offset)
+{
+    val_check_digest_context(digest);
+    val_check(path, string);
+    val_check(offset, number);
+
+    // hash into a copy; the GC may run (and move the context) while the file is read
+    const std::string cpath(val_string(path));
+    const uint64_t coffset = (uint64_t)val_number(offset);
+    s_digest copy;
+    memcpy(&copy, val_digest_context(digest), sizeof(s_digest));
+
+    uint64_t hashed = 0;
+    gc_enter_blocking();
+    int ret = digest_update_file(&copy, cpath.c_str(), coffset, &hashed);
+    gc_exit_blocking();
+
+    if (ret != 0) {
+        memset(&copy, 0, sizeof(s_digest));
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    memcpy(val_digest_context(digest), &copy, sizeof(s_digest));
+    memset(&copy, 0, sizeof(s_digest));
+
+    return alloc_float((double)hashed);
+}
+DEFINE_PRIM(hx_digest_update_file, 3);
+
+
+void finalize_digest_context(value digest)
+{
+    val_check_digest_context(digest);
+
+    if (digest != NULL) {
+        s_digest* _digest = val_digest_context(digest);
+        memset(_digest, 0, sizeof(s_digest));
+        _digest = NULL;
+    }
+}
+
+} // extern "C"
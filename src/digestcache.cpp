@@ -0,0 +1,474 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/file.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+#include <polarssl/md.h>
+
+#include "hxpolarssl/utils.hpp"
+#include "hxpolarssl/digestcache.hpp"
+
+/*
+ * Identity of a file as seen by stat(); a cached sum is only valid while all fields match.
+ */
+typedef struct {
+    uint64_t dev;
+    uint64_t ino;
+    uint64_t size;
+    int64_t  mtime_ns;
+    int64_t  ctime_ns;
+} s_file_key;
+
+
+#ifndef _WIN32
+
+static int digestcache_stat(const char* path, s_file_key* key)
+{
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return POLARSSL_ERR_MD_FILE_IO_ERROR;
+    }
+
+    key->dev  = (uint64_t)st.st_dev;
+    key->ino  = (uint64_t)st.st_ino;
+    key->size = (uint64_t)st.st_size;
+#if defined(__APPLE__)
+    key->mtime_ns = (int64_t)st.st_mtimespec.tv_sec * 1000000000LL + st.st_mtimespec.tv_nsec;
+    key->ctime_ns = (int64_t)st.st_ctimespec.tv_sec * 1000000000LL + st.st_ctimespec.tv_nsec;
+#else
+    key->mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    key->ctime_ns = (int64_t)st.st_ctim.tv_sec * 1000000000LL + st.st_ctim.tv_nsec;
+#endif
+
+    return 0;
+}
+
+
+/*
+ * Returns true if the file was modified so recently that a further write could leave
+ * its size, mtime and ctime unchanged.
+ */
+static bool digestcache_racy(const s_file_key* key)
+{
+    struct timespec now;
+    if (clock_gettime(CLOCK_REALTIME, &now) != 0) {
+        return true;
+    }
+
+    const int64_t latest = (key->ctime_ns > key->mtime_ns) ? key->ctime_ns : key->mtime_ns;
+
+    return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec - latest < DIGESTCACHE_RACY_NS;
+}
+
+
+/*
+ * Takes (or releases) the exclusive lock on the index file serializing writers, also
+ * across processes.
+ */
+static inline void digestcache_lock(const s_digestcache* cache)
+{
+    while (flock(cache->fd, LOCK_EX) != 0 && errno == EINTR) {}
+}
+
+static inline void digestcache_unlock(const s_digestcache* cache)
+{
+    flock(cache->fd, LOCK_UN);
+}
+
+#endif /* _WIN32 */
+
+
+/*
+ * FNV-1a over the slot fields (except 'check' itself) as a cheap guard against slots
+ * torn by a crash in the middle of an update.
+ */
+static uint32_t digestcache_check(const s_digestcache_slot* slot)
+{
+    uint32_t hash = 2166136261u;
+    const unsigned char* p = (const unsigned char*)slot;
+    for (size_t i = 0; i < offsetof(s_digestcache_slot, check); ++i) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    hash = (hash ^ slot->type) * 16777619u;
+    hash = (hash ^ slot->sum_len) * 16777619u;
+    for (size_t i = 0; i < slot->sum_len && i < sizeof(slot->sum); ++i) {
+        hash = (hash ^ slot->sum[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+
+static inline uint32_t digestcache_home(const s_file_key* key, const uint8_t type, const uint32_t capacity)
+{
+    uint64_t h = key->ino * 0x9E3779B97F4A7C15ULL ^ key->dev * 0xC2B2AE3D27D4EB4FULL ^ type;
+    h ^= h >> 29;
+
+    return (uint32_t)(h & (capacity - 1));
+}
+
+
+static inline bool digestcache_same_file(const s_digestcache_slot* slot, const s_file_key* key)
+{
+    return slot->type != 0 && slot->dev == key->dev && slot->ino == key->ino;
+}
+
+
+static void digestcache_reset(s_digestcache* cache, const uint32_t capacity)
+{
+    memset(cache->map, 0, cache->map_size);
+    cache->header->magic     = DIGESTCACHE_MAGIC;
+    cache->header->version   = DIGESTCACHE_VERSION;
+    cache->header->capacity  = capacity;
+    cache->header->entries   = 0;
+    cache->header->slot_size = sizeof(s_digestcache_slot);
+}
+
+
+/*
+ * Returns the slot holding a valid sum of the file for 'type' or NULL.
+ */
+static s_digestcache_slot* digestcache_find(s_digestcache* cache, const s_file_key* key, const uint8_t type)
+{
+    const uint32_t capacity = cache->header->capacity;
+    const uint32_t home     = digestcache_home(key, type, capacity);
+
+    for (uint32_t i = 0; i < DIGESTCACHE_PROBES && i < capacity; ++i) {
+        s_digestcache_slot* slot = &cache->slots[(home + i) & (capacity - 1)];
+        if (slot->type == type && digestcache_same_file(slot, key)) {
+            if (slot->size == key->size && slot->mtime_ns == key->mtime_ns && slot->ctime_ns == key->ctime_ns
+                    && slot->check == digestcache_check(slot)) {
+                return slot;
+            }
+            return NULL;
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Stores the sum of the file for 'type', replacing a stale entry of the same file,
+ * else taking the first free slot, else evicting the key's home slot.
+ *
+ * The caller must hold the index lock.
+ */
+static void digestcache_store(s_digestcache* cache, const s_file_key* key, const uint8_t type,
+                              const unsigned char* sum, const uint8_t sum_len)
+{
+    const uint32_t capacity   = cache->header->capacity;
+    const uint32_t home       = digestcache_home(key, type, capacity);
+    s_digestcache_slot* found = NULL;
+
+    for (uint32_t i = 0; i < DIGESTCACHE_PROBES && i < capacity; ++i) {
+        s_digestcache_slot* slot = &cache->slots[(home + i) & (capacity - 1)];
+        if (slot->type == type && digestcache_same_file(slot, key)) {
+            found = slot;
+            break;
+        }
+        if (slot->type == 0 && found == NULL) {
+            found = slot;
+        }
+    }
+
+    if (found == NULL) {
+        found = &cache->slots[home];
+        ++cache->evictions;
+    } else if (found->type == 0) {
+        ++cache->header->entries;
+    }
+
+    // invalidate first, so a crash halfway leaves a slot that fails the check
+    found->check    = ~digestcache_check(found);
+    found->dev      = key->dev;
+    found->ino      = key->ino;
+    found->size     = key->size;
+    found->mtime_ns = key->mtime_ns;
+    found->ctime_ns = key->ctime_ns;
+    found->type     = type;
+    found->sum_len  = sum_len;
+    memset(found->sum, 0, sizeof(found->sum));
+    memcpy(found->sum, sum, sum_len);
+    found->check    = digestcache_check(found);
+}
+
+
+static void digestcache_close(s_digestcache* cache)
+{
+#ifndef _WIN32
+    if (cache->map != NULL) {
+        msync(cache->map, cache->map_size, MS_ASYNC);
+        munmap(cache->map, cache->map_size);
+    }
+    if (cache->fd >= 0) {
+        close(cache->fd);
+    }
+#endif
+    cache->fd       = -1;
+    cache->map      = NULL;
+    cache->map_size = 0;
+    cache->header   = NULL;
+    cache->slots    = NULL;
+}
+
+
+static int digestcache_open(s_digestcache* cache, const char* path, uint32_t capacity)
+{
+#ifdef _WIN32
+    return POLARSSL_ERR_MD_FEATURE_UNAVAILABLE;
+#else
+    cache->fd = open(path, O_RDWR | O_CREAT, 0600);
+    if (cache->fd < 0) {
+        return POLARSSL_ERR_MD_FILE_IO_ERROR;
+    }
+
+    // an existing, intact index keeps its capacity; hold the lock until it is mapped (and reset)
+    digestcache_lock(cache);
+    s_digestcache_header header;
+    bool valid = pread(cache->fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header)
+        && header.magic == DIGESTCACHE_MAGIC && header.version == DIGESTCACHE_VERSION
+        && header.slot_size == sizeof(s_digestcache_slot)
+        && header.capacity >= 64 && header.capacity <= DIGESTCACHE_MAX_CAPACITY
+        && (header.capacity & (header.capacity - 1)) == 0;
+    if (valid) {
+        capacity = header.capacity;
+    }
+
+    const size_t size = sizeof(s_digestcache_header) + (size_t)capacity * sizeof(s_digestcache_slot);
+    struct stat st;
+    if (fstat(cache->fd, &st) != 0) {
+        digestcache_unlock(cache);
+        digestcache_close(cache);
+        return POLARSSL_ERR_MD_FILE_IO_ERROR;
+    }
+    if ((uint64_t)st.st_size != size) {
+        valid = false;
+        if (ftruncate(cache->fd, (off_t)size) != 0) {
+            digestcache_unlock(cache);
+            digestcache_close(cache);
+            return POLARSSL_ERR_MD_FILE_IO_ERROR;
+        }
+    }
+
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, cache->fd, 0);
+    if (map == MAP_FAILED) {
+        digestcache_unlock(cache);
+        digestcache_close(cache);
+        return POLARSSL_ERR_MD_FILE_IO_ERROR;
+    }
+    cache->map      = (unsigned char*)map;
+    cache->map_size = size;
+    cache->header   = (s_digestcache_header*)cache->map;
+    cache->slots    = (s_digestcache_slot*)(cache->map + sizeof(s_digestcache_header));
+
+    if (!valid) {
+        digestcache_reset(cache, capacity);
+    }
+    digestcache_unlock(cache);
+
+    return 0;
+#endif
+}
+
+
+extern "C" {
+
+DEFINE_KIND(k_digestcache);
+
+
+value hx_digestcache_clear(value cache)
+{
+    val_check_digestcache(cache);
+
+    s_digestcache* _cache = val_digestcache(cache);
+#ifndef _WIN32
+    if (_cache->map != NULL) {
+        digestcache_lock(_cache);
+        digestcache_reset(_cache, _cache->header->capacity);
+        digestcache_unlock(_cache);
+    }
+#endif
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_digestcache_clear, 1);
+
+
+value hx_digestcache_close(value cache)
+{
+    val_check_digestcache(cache);
+
+    digestcache_close(val_digestcache(cache));
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_digestcache_close, 1);
+
+
+value hx_digestcache_invalidate(value cache, value path)
+{
+    val_check_digestcache(cache);
+    val_check(path, string);
+
+    s_digestcache* _cache = val_digestcache(cache);
+    int removed = 0;
+#ifndef _WIN32
+    s_file_key key;
+    if (_cache->map == NULL || digestcache_stat(val_string(path), &key) != 0) {
+        return alloc_int(0);
+    }
+
+    digestcache_lock(_cache);
+    const uint32_t capacity = _cache->header->capacity;
+    for (int type = POLARSSL_MD_MD2; type <= POLARSSL_MD_RIPEMD160; ++type) {
+        const uint32_t home = digestcache_home(&key, (uint8_t)type, capacity);
+        for (uint32_t i = 0; i < DIGESTCACHE_PROBES && i < capacity; ++i) {
+            s_digestcache_slot* slot = &_cache->slots[(home + i) & (capacity - 1)];
+            if (slot->type == type && digestcache_same_file(slot, &key)) {
+                memset(slot, 0, sizeof(s_digestcache_slot));
+                --_cache->header->entries;
+                ++removed;
+                break;
+            }
+        }
+    }
+    digestcache_unlock(_cache);
+#endif
+
+    return alloc_int(removed);
+}
+DEFINE_PRIM(hx_digestcache_invalidate, 2);
+
+
+value hx_digestcache_open(value path, value capacity)
+{
+    val_check(path, string);
+    val_check(capacity, int);
+
+    uint32_t slots = 64;
+    while (slots < (uint32_t)val_int(capacity) && slots < DIGESTCACHE_MAX_CAPACITY) {
+        slots <<= 1;
+    }
+
+    s_digestcache* cache = malloc_digestcache();
+    memset(cache, 0, sizeof(s_digestcache));
+    cache->fd = -1;
+
+    int ret = digestcache_open(cache, val_string(path), slots);
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    value val = alloc_digestcache(cache);
+    val_gc(val, finalize_digestcache);
+
+    return val;
+}
+DEFINE_PRIM(hx_digestcache_open, 2);
+
+
+value hx_digestcache_stats(value cache)
+{
+    val_check_digestcache(cache);
+
+    s_digestcache* _cache = val_digestcache(cache);
+    const bool opened     = _cache->map != NULL;
+
+    value arr = alloc_array(5);
+    val_array_set_i(arr, 0, alloc_int((int)_cache->hits));
+    val_array_set_i(arr, 1, alloc_int((int)_cache->misses));
+    val_array_set_i(arr, 2, alloc_int((int)_cache->evictions));
+    val_array_set_i(arr, 3, alloc_int(opened ? (int)_cache->header->entries : 0));
+    val_array_set_i(arr, 4, alloc_int(opened ? (int)_cache->header->capacity : 0));
+
+    return arr;
+}
+DEFINE_PRIM(hx_digestcache_stats, 1);
+
+
+value hx_digestcache_sum_file(value cache, value path, value type)
+{
+    val_check_digestcache(cache);
+    val_check(path, string);
+    val_check(type, int);
+
+#ifdef _WIN32
+    throw_err(POLARSSL_ERR_MD_FEATURE_UNAVAILABLE);
+    return alloc_int(POLARSSL_ERR_MD_FEATURE_UNAVAILABLE);
+#else
+    const md_info_t* info = md_info_from_type((md_type_t)val_int(type));
+    if (info == NULL || val_digestcache(cache)->map == NULL) {
+        throw_err(POLARSSL_ERR_MD_BAD_INPUT_DATA);
+        return alloc_int(POLARSSL_ERR_MD_BAD_INPUT_DATA);
+    }
+
+    const std::string cpath(val_string(path));
+    const uint8_t ctype = (uint8_t)val_int(type);
+    s_file_key key;
+    int ret = digestcache_stat(cpath.c_str(), &key);
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    s_digestcache_slot* slot = digestcache_find(val_digestcache(cache), &key, ctype);
+    if (slot != NULL) {
+        ++val_digestcache(cache)->hits;
+        return value_fromBytes(slot->sum, slot->sum_len);
+    }
+
+    // the GC may run (and move the context) while the file is read
+    unsigned char sum[POLARSSL_MD_MAX_SIZE];
+    s_file_key after;
+    gc_enter_blocking();
+    ret = md_file(info, cpath.c_str(), sum);
+    if (ret == 0) {
+        ret = digestcache_stat(cpath.c_str(), &after);
+    }
+    gc_exit_blocking();
+
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    s_digestcache* _cache = val_digestcache(cache);
+    ++_cache->misses;
+    // only cache sums of files that did not change while (or just before) being read
+    if (_cache->map != NULL && memcmp(&key, &after, sizeof(s_file_key)) == 0 && !digestcache_racy(&key)) {
+        digestcache_lock(_cache);
+        digestcache_store(_cache, &key, ctype, sum, md_get_size(info));
+        digestcache_unlock(_cache);
+    }
+
+    return value_fromBytes(sum, md_get_size(info));
+#endif
+}
+DEFINE_PRIM(hx_digestcache_sum_file, 3);
+
+
+void finalize_digestcache(value cache)
+{
+    val_check_digestcache(cache);
+
+    if (cache != NULL) {
+        s_digestcache* _cache = val_digestcache(cache);
+        digestcache_close(_cache);
+        memset(_cache, 0, sizeof(s_digestcache));
+        _cache = NULL;
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,153 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <stdlib.h>
+#include <polarssl/ecp.h>
+#include <polarssl/ecdh.h>
+#include <polarssl/ctr_drbg.h>
+#include <polarssl/entropy.h>
+#include <polarssl/havege.h>
+
+#include "hxpolarssl/ctr_drbg.hpp"
+#include "hxpolarssl/ecdh.hpp"
+#include "hxpolarssl/utils.hpp"
+
+extern "C" {
+
+DEFINE_KIND(k_ecdh_context);
+
+
+/*
+ * Binds the context to the curve 'id'.
+ *
+ * PolarSSL caches the comb table for the generator inside the group the first
+ * time it is used, so the group is only replaced if the curve actually changes.
+ */
+static int ecdh_use_group(ecdh_context* context, const ecp_group_id id)
+{
+    if (context->grp.id == id) {
+        return 0;
+    }
+
+    ecp_group_free(&(context->grp));
+
+    return ecp_use_known_dp(&(context->grp), id);
+}
+
+
+value hx_ecdh_compute_shared(value context, value point, value length, value rng)
+{
+    val_check_ecdh_context(context);
+
+    ecdh_context* _context = val_ecdh_context(context);
+    s_bytes* bytes         = bytes_fromHaxe(point, length);
+    const size_t size      = (_context->grp.pbits + 7) / 8;
+    unsigned char buffer[POLARSSL_ECP_MAX_BYTES];
+    s_rng _rng;
+    rng_fromHaxe(rng, &_rng);
+
+    value val;
+    int ret = ecp_point_read_binary(&(_context->grp), &(_context->Qp), bytes->data, bytes->length);
+    if (ret == 0) {
+        ret = ecp_check_pubkey(&(_context->grp), &(_context->Qp));
+    }
+    if (ret == 0) {
+        ret = ecdh_compute_shared(&(_context->grp), &(_context->z), &(_context->Qp), &(_context->d), _rng.f_rng, _rng.p_rng);
+    }
+    if (ret == 0) {
+        ret = mpi_write_binary(&(_context->z), buffer, size);
+    }
+    rng_free(&_rng);
+    if (ret == 0) {
+        val = value_fromBytes(buffer, size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_ecdh_compute_shared, 4);
+
+
+value hx_ecdh_free(value context)
+{
+    val_check_ecdh_context(context);
+
+    ecdh_free(val_ecdh_context(context));
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_ecdh_free, 1);
+
+
+value hx_ecdh_gen_public(value context, value grp_id, value rng)
+{
+    val_check_ecdh_context(context);
+    val_check(grp_id, int);
+
+    ecdh_context* _context = val_ecdh_context(context);
+    unsigned char buffer[POLARSSL_ECP_MAX_PT_LEN];
+    size_t size;
+    s_rng _rng;
+    rng_fromHaxe(rng, &_rng);
+
+    value val;
+    int ret = ecdh_use_group(_context, (ecp_group_id)val_int(grp_id));
+    if (ret == 0) {
+        ret = ecdh_gen_public(&(_context->grp), &(_context->d), &(_context->Q), _rng.f_rng, _rng.p_rng);
+    }
+    if (ret == 0) {
+        ret = ecp_point_write_binary(&(_context->grp), &(_context->Q), POLARSSL_ECP_PF_UNCOMPRESSED, &size, buffer, sizeof(buffer));
+    }
+    rng_free(&_rng);
+    if (ret == 0) {
+        val = value_fromBytes(buffer, size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_ecdh_gen_public, 3);
+
+
+value hx_ecdh_init(void)
+{
+    ecdh_context* context = malloc_ecdh_context();
+    ecdh_init(context);
+
+    value val = alloc_ecdh_context(context);
+    val_gc(val, finalize_ecdh_context);
+
+    return val;
+}
+DEFINE_PRIM(hx_ecdh_init, 0);
+
+
+value hx_ecdh_self_test(value verbose)
+{
+    val_check(verbose, bool);
+
+    int ret = ecdh_self_test(val_bool(verbose));
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_ecdh_self_test, 1);
+
+
+void finalize_ecdh_context(value context)
+{
+    val_check_ecdh_context(context);
+
+    if (context != NULL) {
+        ecdh_context* _context = val_ecdh_context(context);
+        ecdh_free(_context);
+        _context = NULL;
+    }
+}
+
+} // extern "C"
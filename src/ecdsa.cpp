@@ -0,0 +1,248 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <stdlib.h>
+#include <polarssl/ecp.h>
+#include <polarssl/ecdsa.h>
+#include <polarssl/ctr_drbg.h>
+#include <polarssl/entropy.h>
+#include <polarssl/havege.h>
+#include <polarssl/md.h>
+
+#include "hxpolarssl/ctr_drbg.hpp"
+#include "hxpolarssl/ecdsa.hpp"
+#include "hxpolarssl/utils.hpp"
+
+extern "C" {
+
+DEFINE_KIND(k_ecdsa_context);
+
+
+/*
+ * Binds the context to the curve 'id'.
+ *
+ * PolarSSL caches the comb table for the generator inside the group the first
+ * time it is used, so the group is only replaced if the curve actually changes.
+ */
+static int ecdsa_use_group(ecdsa_context* context, const ecp_group_id id)
+{
+    if (context->grp.id == id) {
+        return 0;
+    }
+
+    ecp_group_free(&(context->grp));
+
+    return ecp_use_known_dp(&(context->grp), id);
+}
+
+
+value hx_ecdsa_free(value context)
+{
+    val_check_ecdsa_context(context);
+
+    ecdsa_free(val_ecdsa_context(context));
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_ecdsa_free, 1);
+
+
+value hx_ecdsa_genkey(value context, value grp_id, value rng)
+{
+    val_check_ecdsa_context(context);
+    val_check(grp_id, int);
+
+    ecdsa_context* _context = val_ecdsa_context(context);
+    s_rng _rng;
+    rng_fromHaxe(rng, &_rng);
+
+    int ret = ecdsa_use_group(_context, (ecp_group_id)val_int(grp_id));
+    if (ret == 0) {
+        ret = ecp_gen_keypair(&(_context->grp), &(_context->d), &(_context->Q), _rng.f_rng, _rng.p_rng);
+    }
+    rng_free(&_rng);
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_ecdsa_genkey, 3);
+
+
+value hx_ecdsa_get_private(value context)
+{
+    val_check_ecdsa_context(context);
+
+    ecdsa_context* _context = val_ecdsa_context(context);
+    const size_t size       = mpi_size(&(_context->d));
+    unsigned char buffer[size];
+
+    value val;
+    int ret = mpi_write_binary(&(_context->d), buffer, size);
+    if (ret == 0) {
+        val = value_fromBytes(buffer, size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_ecdsa_get_private, 1);
+
+
+value hx_ecdsa_get_public(value context)
+{
+    val_check_ecdsa_context(context);
+
+    ecdsa_context* _context = val_ecdsa_context(context);
+    unsigned char buffer[POLARSSL_ECP_MAX_PT_LEN];
+    size_t size;
+
+    value val;
+    int ret = ecp_point_write_binary(&(_context->grp), &(_context->Q), POLARSSL_ECP_PF_UNCOMPRESSED, &size, buffer, sizeof(buffer));
+    if (ret == 0) {
+        val = value_fromBytes(buffer, size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_ecdsa_get_public, 1);
+
+
+value hx_ecdsa_init(void)
+{
+    ecdsa_context* context = malloc_ecdsa_context();
+    ecdsa_init(context);
+
+    value val = alloc_ecdsa_context(context);
+    val_gc(val, finalize_ecdsa_context);
+
+    return val;
+}
+DEFINE_PRIM(hx_ecdsa_init, 0);
+
+
+value hx_ecdsa_self_test(value verbose)
+{
+    val_check(verbose, bool);
+
+    int ret = ecp_self_test(val_bool(verbose));
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_ecdsa_self_test, 1);
+
+
+value hx_ecdsa_set_private(value context, value grp_id, value key, value length, value rng)
+{
+    val_check_ecdsa_context(context);
+    val_check(grp_id, int);
+
+    ecdsa_context* _context = val_ecdsa_context(context);
+    s_bytes* bytes          = bytes_fromHaxe(key, length);
+    s_rng _rng;
+    rng_fromHaxe(rng, &_rng);
+
+    int ret = ecdsa_use_group(_context, (ecp_group_id)val_int(grp_id));
+    if (ret == 0) {
+        ret = mpi_read_binary(&(_context->d), bytes->data, bytes->length);
+    }
+    if (ret == 0) {
+        ret = ecp_check_privkey(&(_context->grp), &(_context->d));
+    }
+    if (ret == 0) {
+        ret = ecp_mul(&(_context->grp), &(_context->Q), &(_context->d), &(_context->grp.G), _rng.f_rng, _rng.p_rng);
+    }
+    rng_free(&_rng);
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_ecdsa_set_private, 5);
+
+
+value hx_ecdsa_set_public(value context, value grp_id, value point, value length)
+{
+    val_check_ecdsa_context(context);
+    val_check(grp_id, int);
+
+    ecdsa_context* _context = val_ecdsa_context(context);
+    s_bytes* bytes          = bytes_fromHaxe(point, length);
+
+    int ret = ecdsa_use_group(_context, (ecp_group_id)val_int(grp_id));
+    if (ret == 0) {
+        ret = ecp_point_read_binary(&(_context->grp), &(_context->Q), bytes->data, bytes->length);
+    }
+    if (ret == 0) {
+        ret = ecp_check_pubkey(&(_context->grp), &(_context->Q));
+    }
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_ecdsa_set_public, 4);
+
+
+value hx_ecdsa_sign(value context, value md_alg, value hash, value hashlen)
+{
+    val_check_ecdsa_context(context);
+    val_check(md_alg, int);
+
+    s_bytes* bytes = bytes_fromHaxe(hash, hashlen);
+    unsigned char sigbuffer[ECDSA_SIGNATURE_MAXSIZE];
+    size_t size;
+
+    value val;
+    int ret = ecdsa_write_signature_det(val_ecdsa_context(context), bytes->data, bytes->length, sigbuffer, &size, (md_type_t)val_int(md_alg));
+    if (ret == 0) {
+        val = value_fromBytes(sigbuffer, size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_ecdsa_sign, 4);
+
+
+value hx_ecdsa_verify(value context, value hash, value hashlen, value sig, value siglen)
+{
+    val_check_ecdsa_context(context);
+
+    s_bytes* hash_bytes = bytes_fromHaxe(hash, hashlen);
+    s_bytes* sig_bytes  = bytes_fromHaxe(sig, siglen);
+
+    int ret = ecdsa_read_signature(val_ecdsa_context(context), hash_bytes->data, hash_bytes->length, sig_bytes->data, sig_bytes->length);
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_ecdsa_verify, 5);
+
+
+void finalize_ecdsa_context(value context)
+{
+    val_check_ecdsa_context(context);
+
+    if (context != NULL) {
+        ecdsa_context* _context = val_ecdsa_context(context);
+        ecdsa_free(_context);
+        _context = NULL;
+    }
+}
+
+} // extern "C"
@@ -1,5 +1,7 @@
 #define  NEKO_COMPATIBLE
 #include <hx/CFFI.h>
+#include <stdint.h>
+#include <string.h>
 #include <polarssl/havege.h>
 
 #include "hxpolarssl/utils.hpp"
@@ -10,11 +12,53 @@ extern "C" {
 DEFINE_KIND(k_havege_state);
 
 
+/*
+ * Copies 'length' random bytes into 'out', served from the prefetched pool.
+ *
+ * Requests larger than the pool bypass it and are written directly.
+ */
+static void havege_pool_read(s_havege* hs, unsigned char* out, size_t length)
+{
+    if (length >= HAVEGE_POOL_SIZE) {
+        havege_random(&(hs->hs), out, length);
+        return;
+    }
+
+    size_t available = HAVEGE_POOL_SIZE - hs->pos;
+    if (length > available) {
+        memcpy(out, hs->pool + hs->pos, available);
+        out    += available;
+        length -= available;
+        havege_random(&(hs->hs), hs->pool, HAVEGE_POOL_SIZE);
+        hs->pos = 0;
+    }
+
+    memcpy(out, hs->pool + hs->pos, length);
+    hs->pos += length;
+}
+
+
+value hx_havege_fill(value hs, value bytes, value pos, value length)
+{
+    val_check_havege_state(hs);
+    val_check(pos, int);
+    val_check(length, int);
+
+    havege_pool_read(val_havege_state(hs), data_fromHaxe(bytes) + val_int(pos), val_int(length));
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_havege_fill, 4);
+
+
 value hx_havege_free(value hs)
 {
     val_check_havege_state(hs);
 
-    havege_free(val_havege_state(hs));
+    s_havege* _hs = val_havege_state(hs);
+    havege_free(&(_hs->hs));
+    memset(_hs->pool, 0, HAVEGE_POOL_SIZE);
+    _hs->pos = HAVEGE_POOL_SIZE;
 
     return alloc_null();
 }
@@ -23,8 +67,9 @@ DEFINE_PRIM(hx_havege_free, 1);
 
 value hx_havege_init(void)
 {
-    havege_state* hs = malloc_havege_state();
-    havege_init(hs);
+    s_havege* hs = malloc_havege_state();
+    havege_init(&(hs->hs));
+    hs->pos = HAVEGE_POOL_SIZE; // filled on first use
 
     value val = alloc_havege_state(hs);
     val_gc(val, finalize_havege_state);
@@ -34,6 +79,31 @@ value hx_havege_init(void)
 DEFINE_PRIM(hx_havege_init, 0);
 
 
+value hx_havege_next_float(value hs)
+{
+    val_check_havege_state(hs);
+
+    uint64_t rnd;
+    havege_pool_read(val_havege_state(hs), (unsigned char*)&rnd, sizeof(rnd));
+
+    // the upper 53 bits fill the double's mantissa
+    return alloc_float((double)(rnd >> 11) * (1.0 / 9007199254740992.0));
+}
+DEFINE_PRIM(hx_havege_next_float, 1);
+
+
+value hx_havege_next_int(value hs)
+{
+    val_check_havege_state(hs);
+
+    uint32_t rnd;
+    havege_pool_read(val_havege_state(hs), (unsigned char*)&rnd, sizeof(rnd));
+
+    return alloc_int((int)(rnd & HAVEGE_INT_MASK));
+}
+DEFINE_PRIM(hx_havege_next_int, 1);
+
+
 value hx_havege_random(value hs, value length)
 {
     val_check_havege_state(hs);
@@ -41,7 +111,7 @@ value hx_havege_random(value hs, value length)
 
     const size_t size = val_int(length);
     unsigned char buffer[size];
-    havege_random(val_havege_state(hs), buffer, size);
+    havege_pool_read(val_havege_state(hs), buffer, size);
 
     return value_fromBytes(buffer, size);
 }
@@ -53,8 +123,10 @@ void finalize_havege_state(value hs)
     val_check_havege_state(hs);
 
     if (hs != NULL) {
-        havege_state* _hs = val_havege_state(hs);
-        havege_free(_hs);
+        s_havege* _hs = val_havege_state(hs);
+        havege_free(&(_hs->hs));
+        memset(_hs->pool, 0, HAVEGE_POOL_SIZE);
+        _hs->pos = HAVEGE_POOL_SIZE;
         _hs = NULL;
     }
 }
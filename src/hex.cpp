@@ -0,0 +1,35 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <vector>
+#include <polarssl/bignum.h>
+
+#include "hxpolarssl/utils.hpp"
+#include "hxpolarssl/hex.hpp"
+
+extern "C" {
+
+value hx_hex_decode(value str)
+{
+    val_check(str, string);
+
+    const size_t length = val_strlen(str);
+    std::vector<unsigned char> decoded(length / 2 + 1);
+    if (hex_decode(val_string(str), length, &decoded[0]) != 0) {
+        throw_err(POLARSSL_ERR_MPI_INVALID_CHARACTER);
+        return alloc_int(POLARSSL_ERR_MPI_INVALID_CHARACTER);
+    }
+
+    return value_fromBytes(&decoded[0], length / 2);
+}
+DEFINE_PRIM(hx_hex_decode, 1);
+
+
+value hx_hex_encode(value bytes, value length)
+{
+    s_bytes* cbytes = bytes_fromHaxe(bytes, length);
+
+    return value_hexFromBytes(cbytes->data, cbytes->length);
+}
+DEFINE_PRIM(hx_hex_encode, 2);
+
+} // extern "C"
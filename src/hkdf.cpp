@@ -0,0 +1,289 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <polarssl/md.h>
+
+#include "hxpolarssl/hkdf.hpp"
+#include "hxpolarssl/utils.hpp"
+
+/*
+ * Extracts the pseudorandom key from the input keying material (RFC 5869, section 2.2).
+ */
+static int hkdf_extract(const md_info_t* md_info, const unsigned char* salt, const size_t salt_len,
+    const unsigned char* ikm, const size_t ikm_len, unsigned char* prk)
+{
+    // an empty salt equals HashLen zero bytes, as HMAC zero-pads its key anyway
+    return md_hmac(md_info, salt, salt_len, ikm, ikm_len, prk);
+}
+
+
+/*
+ * Expands the pseudorandom key into 'okm_len' bytes of output keying material (RFC 5869, section 2.3).
+ *
+ * The HMAC context must already be keyed with the PRK; it is only reset between blocks.
+ */
+static int hkdf_expand(md_context_t* ctx, const unsigned char* info, const size_t info_len,
+    unsigned char* okm, const size_t okm_len)
+{
+    const size_t hlen = md_get_size(ctx->md_info);
+    if (okm_len > 255 * hlen) {
+        return POLARSSL_ERR_MD_BAD_INPUT_DATA;
+    }
+
+    unsigned char T[POLARSSL_MD_MAX_SIZE];
+    size_t offset = 0;
+    for (unsigned char i = 1; offset < okm_len; ++i) {
+        md_hmac_reset(ctx);
+        if (i > 1) {
+            md_hmac_update(ctx, T, hlen);
+        }
+        md_hmac_update(ctx, info, info_len);
+        md_hmac_update(ctx, &i, 1);
+        md_hmac_finish(ctx, T);
+
+        const size_t chunk = (okm_len - offset < hlen) ? okm_len - offset : hlen;
+        memcpy(okm + offset, T, chunk);
+        offset += chunk;
+    }
+    memset(T, 0, sizeof(T));
+
+    return 0;
+}
+
+
+/*
+ * Resolves the md_info_t for the Haxe MDType value, raising a Neko error if unsupported.
+ */
+static const md_info_t* hkdf_md_info(value md_alg)
+{
+    const md_info_t* md_info = md_info_from_type((md_type_t)val_int(md_alg));
+    if (md_info == NULL) {
+        throw_err(POLARSSL_ERR_MD_FEATURE_UNAVAILABLE);
+    }
+
+    return md_info;
+}
+
+
+extern "C" {
+
+value hx_hkdf(value md_alg, value saltArr, value ikmArr, value infos, value lengths)
+{
+    val_check(md_alg, int);
+    val_check(saltArr, array);
+    val_check(val_array_i(saltArr, 0), int);
+    val_check(ikmArr, array);
+    val_check(val_array_i(ikmArr, 0), int);
+    val_check(infos, array);
+    val_check(lengths, array);
+
+    const md_info_t* md_info = hkdf_md_info(md_alg);
+    if (md_info == NULL) {
+        return alloc_int(POLARSSL_ERR_MD_FEATURE_UNAVAILABLE);
+    }
+
+    // reject each length above 255 * HashLen before summing them up
+    const int count   = val_array_size(infos);
+    const size_t hlen = md_get_size(md_info);
+    size_t size       = 0;
+    for (int i = 0; i < count; ++i) {
+        val_check(val_array_i(lengths, i), int);
+        const int length = val_int(val_array_i(lengths, i));
+        if (length < 0 || (size_t)length > 255 * hlen) {
+            throw_err(POLARSSL_ERR_MD_BAD_INPUT_DATA);
+            return alloc_int(POLARSSL_ERR_MD_BAD_INPUT_DATA);
+        }
+        size += length;
+    }
+
+    s_bytes* salt = bytes_fromHaxe(val_array_i(saltArr, 1), val_array_i(saltArr, 0));
+    s_bytes* ikm  = bytes_fromHaxe(val_array_i(ikmArr, 1), val_array_i(ikmArr, 0));
+    unsigned char prk[POLARSSL_MD_MAX_SIZE];
+    std::vector<unsigned char> okm(size);
+    md_context_t ctx;
+    md_init(&ctx);
+
+    int ret = hkdf_extract(md_info, salt->data, salt->length, ikm->data, ikm->length, prk);
+    if (ret == 0) {
+        ret = md_init_ctx(&ctx, md_info);
+    }
+    if (ret == 0) {
+        ret = md_hmac_starts(&ctx, prk, hlen);
+    }
+
+    size_t offset = 0;
+    for (int i = 0; ret == 0 && i < count; ++i) {
+        value infoArr = val_array_i(infos, i);
+        val_check(infoArr, array);
+        val_check(val_array_i(infoArr, 0), int);
+
+        s_bytes* info       = bytes_fromHaxe(val_array_i(infoArr, 1), val_array_i(infoArr, 0));
+        const size_t length = val_int(val_array_i(lengths, i));
+        ret     = hkdf_expand(&ctx, info->data, info->length, okm.data() + offset, length);
+        offset += length;
+    }
+    md_free(&ctx);
+    memset(prk, 0, sizeof(prk));
+
+    value val;
+    if (ret == 0) {
+        val = value_fromBytes(okm.data(), size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+    if (!okm.empty()) {
+        memset(okm.data(), 0, size);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_hkdf, 5);
+
+
+value hx_hkdf_expand(value md_alg, value prkArr, value infoArr, value length)
+{
+    val_check(md_alg, int);
+    val_check(prkArr, array);
+    val_check(val_array_i(prkArr, 0), int);
+    val_check(infoArr, array);
+    val_check(val_array_i(infoArr, 0), int);
+    val_check(length, int);
+
+    const md_info_t* md_info = hkdf_md_info(md_alg);
+    if (md_info == NULL) {
+        return alloc_int(POLARSSL_ERR_MD_FEATURE_UNAVAILABLE);
+    }
+
+    if (val_int(length) < 0 || (size_t)val_int(length) > 255 * md_get_size(md_info)) {
+        throw_err(POLARSSL_ERR_MD_BAD_INPUT_DATA);
+        return alloc_int(POLARSSL_ERR_MD_BAD_INPUT_DATA);
+    }
+
+    s_bytes* prk      = bytes_fromHaxe(val_array_i(prkArr, 1), val_array_i(prkArr, 0));
+    s_bytes* info     = bytes_fromHaxe(val_array_i(infoArr, 1), val_array_i(infoArr, 0));
+    const size_t size = val_int(length);
+    std::vector<unsigned char> okm(size);
+    md_context_t ctx;
+    md_init(&ctx);
+
+    int ret = md_init_ctx(&ctx, md_info);
+    if (ret == 0) {
+        ret = md_hmac_starts(&ctx, prk->data, prk->length);
+    }
+    if (ret == 0) {
+        ret = hkdf_expand(&ctx, info->data, info->length, okm.data(), size);
+    }
+    md_free(&ctx);
+
+    value val;
+    if (ret == 0) {
+        val = value_fromBytes(okm.data(), size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+    if (!okm.empty()) {
+        memset(okm.data(), 0, size);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_hkdf_expand, 4);
+
+
+value hx_hkdf_extract(value md_alg, value saltArr, value ikmArr)
+{
+    val_check(md_alg, int);
+    val_check(saltArr, array);
+    val_check(val_array_i(saltArr, 0), int);
+    val_check(ikmArr, array);
+    val_check(val_array_i(ikmArr, 0), int);
+
+    const md_info_t* md_info = hkdf_md_info(md_alg);
+    if (md_info == NULL) {
+        return alloc_int(POLARSSL_ERR_MD_FEATURE_UNAVAILABLE);
+    }
+
+    s_bytes* salt = bytes_fromHaxe(val_array_i(saltArr, 1), val_array_i(saltArr, 0));
+    s_bytes* ikm  = bytes_fromHaxe(val_array_i(ikmArr, 1), val_array_i(ikmArr, 0));
+    unsigned char prk[POLARSSL_MD_MAX_SIZE];
+
+    value val;
+    int ret = hkdf_extract(md_info, salt->data, salt->length, ikm->data, ikm->length, prk);
+    if (ret == 0) {
+        val = value_fromBytes(prk, md_get_size(md_info));
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+    memset(prk, 0, sizeof(prk));
+
+    return val;
+}
+DEFINE_PRIM(hx_hkdf_extract, 3);
+
+
+value hx_hkdf_self_test(value verbose)
+{
+    val_check(verbose, bool);
+
+    // RFC 5869, test case 1
+    static const unsigned char ikm[22] = {
+        0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+        0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b
+    };
+    static const unsigned char salt[13] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c
+    };
+    static const unsigned char info[10] = {
+        0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9
+    };
+    static const unsigned char expected[42] = {
+        0x3c, 0xb2, 0x5f, 0x25, 0xfa, 0xac, 0xd5, 0x7a, 0x90, 0x43, 0x4f, 0x64, 0xd0, 0x36,
+        0x2f, 0x2a, 0x2d, 0x2d, 0x0a, 0x90, 0xcf, 0x1a, 0x5a, 0x4c, 0x5d, 0xb0, 0x2d, 0x56,
+        0xec, 0xc4, 0xc5, 0xbf, 0x34, 0x00, 0x72, 0x08, 0xd5, 0xb8, 0x87, 0x18, 0x58, 0x65
+    };
+
+    if (val_bool(verbose)) {
+        printf("  HKDF-SHA-256 test #1: ");
+    }
+
+    const md_info_t* md_info = md_info_from_type(POLARSSL_MD_SHA256);
+    unsigned char prk[POLARSSL_MD_MAX_SIZE];
+    unsigned char okm[sizeof(expected)];
+    md_context_t ctx;
+    md_init(&ctx);
+
+    int ret = (md_info == NULL) ? POLARSSL_ERR_MD_FEATURE_UNAVAILABLE : 0;
+    if (ret == 0) {
+        ret = hkdf_extract(md_info, salt, sizeof(salt), ikm, sizeof(ikm), prk);
+    }
+    if (ret == 0) {
+        ret = md_init_ctx(&ctx, md_info);
+    }
+    if (ret == 0) {
+        ret = md_hmac_starts(&ctx, prk, md_get_size(md_info));
+    }
+    if (ret == 0) {
+        ret = hkdf_expand(&ctx, info, sizeof(info), okm, sizeof(okm));
+    }
+    if (ret == 0 && memcmp(okm, expected, sizeof(expected)) != 0) {
+        ret = 1;
+    }
+    md_free(&ctx);
+
+    if (val_bool(verbose)) {
+        printf((ret == 0) ? "passed\n\n" : "failed\n");
+    }
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_hkdf_self_test, 1);
+
+} // extern "C"
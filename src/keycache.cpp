@@ -0,0 +1,484 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <polarssl/aes.h>
+#include <polarssl/camellia.h>
+#include <polarssl/entropy.h>
+
+#include "hxpolarssl/aes.hpp"
+#include "hxpolarssl/camellia.hpp"
+#include "hxpolarssl/keycache.hpp"
+#include "hxpolarssl/utils.hpp"
+
+/*
+ * Lookup key of a cached schedule: the 128 bit SipHash-2-4 (under a per-process secret)
+ * of the raw key or of the caller-supplied key ID, plus the cipher, mode, key length
+ * and the kind of the hashed input.
+ */
+struct s_keycache_id {
+    uint64_t hash[2];
+    uint32_t tag;
+
+    bool operator==(const s_keycache_id& other) const
+    {
+        return hash[0] == other.hash[0] && hash[1] == other.hash[1] && tag == other.tag;
+    }
+};
+
+struct s_keycache_id_hash {
+    size_t operator()(const s_keycache_id& id) const
+    {
+        return (size_t)id.hash[0];
+    }
+};
+
+struct s_keycache_entry;
+typedef std::list<s_keycache_entry*> keycache_list;
+
+/*
+ * A cached expanded key schedule, shared read-only by all contexts handed out for it.
+ *
+ * 'ctx' must stay the first member: the handed out context values point at it and the
+ * finalizer gets back to the entry from there. The cache holds one reference while the
+ * entry is indexed, each handed out context another one.
+ */
+struct s_keycache_entry {
+    union {
+        aes_context      aes;
+        camellia_context camellia;
+    } ctx;
+    s_keycache_id           id;
+    std::atomic<int>        refs;
+    keycache_list::iterator lru;
+};
+
+/*
+ * One shard of the LRU cache; the most recently used entry is at the front of the list.
+ */
+struct s_keycache_shard {
+    std::mutex    mutex;
+    keycache_list lru;
+    std::unordered_map<s_keycache_id, s_keycache_entry*, s_keycache_id_hash> index;
+    size_t        hits;
+    size_t        misses;
+    size_t        evictions;
+};
+
+static s_keycache_shard keycache_shards[KEYCACHE_SHARDS];
+static std::atomic<size_t> keycache_capacity(KEYCACHE_DEFAULT_CAPACITY);
+
+/*
+ * Per-process secret keying the lookup ids, generated on first use.
+ */
+static uint64_t keycache_secret[2];
+static std::atomic<bool> keycache_seeded(false);
+static std::mutex keycache_seed_mutex;
+
+
+#define KEYCACHE_ROTL64(v, n)  (((v) << (n)) | ((v) >> (64 - (n))))
+
+#define KEYCACHE_SIPROUND(v0, v1, v2, v3)                                            \
+    v0 += v1; v1 = KEYCACHE_ROTL64(v1, 13); v1 ^= v0; v0 = KEYCACHE_ROTL64(v0, 32);  \
+    v2 += v3; v3 = KEYCACHE_ROTL64(v3, 16); v3 ^= v2;                                \
+    v0 += v3; v3 = KEYCACHE_ROTL64(v3, 21); v3 ^= v0;                                \
+    v2 += v1; v1 = KEYCACHE_ROTL64(v1, 17); v1 ^= v2; v2 = KEYCACHE_ROTL64(v2, 32);
+
+/*
+ * SipHash-2-4 with 128 bit output of 'length' bytes under the 128 bit key 'k'.
+ *
+ * See:
+ *   https://131002.net/siphash/siphash.pdf
+ */
+static void keycache_siphash128(const uint64_t k[2], const unsigned char* data, const size_t length, uint64_t out[2])
+{
+    uint64_t v0 = 0x736F6D6570736575ULL ^ k[0];
+    uint64_t v1 = 0x646F72616E646F6DULL ^ k[1] ^ 0xEE;
+    uint64_t v2 = 0x6C7967656E657261ULL ^ k[0];
+    uint64_t v3 = 0x7465646279746573ULL ^ k[1];
+
+    const size_t end = length - length % 8;
+    for (size_t i = 0; i < end; i += 8) {
+        uint64_t m = 0;
+        for (int j = 0; j < 8; ++j) {
+            m |= (uint64_t)data[i + j] << (8 * j);
+        }
+        v3 ^= m;
+        KEYCACHE_SIPROUND(v0, v1, v2, v3);
+        KEYCACHE_SIPROUND(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    uint64_t b = (uint64_t)length << 56;
+    for (size_t j = 0; j < length % 8; ++j) {
+        b |= (uint64_t)data[end + j] << (8 * j);
+    }
+    v3 ^= b;
+    KEYCACHE_SIPROUND(v0, v1, v2, v3);
+    KEYCACHE_SIPROUND(v0, v1, v2, v3);
+    v0 ^= b;
+
+    v2 ^= 0xEE;
+    for (int i = 0; i < 4; ++i) {
+        KEYCACHE_SIPROUND(v0, v1, v2, v3);
+    }
+    out[0] = v0 ^ v1 ^ v2 ^ v3;
+
+    v1 ^= 0xDD;
+    for (int i = 0; i < 4; ++i) {
+        KEYCACHE_SIPROUND(v0, v1, v2, v3);
+    }
+    out[1] = v0 ^ v1 ^ v2 ^ v3;
+}
+
+
+static int keycache_seed(void)
+{
+    if (keycache_seeded.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(keycache_seed_mutex);
+    if (!keycache_seeded.load(std::memory_order_relaxed)) {
+        entropy_context entropy;
+        entropy_init(&entropy);
+        int ret = entropy_func(&entropy, (unsigned char*)keycache_secret, sizeof(keycache_secret));
+        entropy_free(&entropy);
+        if (ret != 0) {
+            return ret;
+        }
+        keycache_seeded.store(true, std::memory_order_release);
+    }
+
+    return 0;
+}
+
+
+/*
+ * Builds the lookup id from 'data' (the raw key or, if 'key_id' is set, the caller's key ID).
+ */
+static int keycache_id(const int cipher, const int mode, const unsigned int keylen,
+                       const unsigned char* data, const size_t length, const bool key_id, s_keycache_id* id)
+{
+    int ret = keycache_seed();
+    if (ret != 0) {
+        return ret;
+    }
+
+    keycache_siphash128(keycache_secret, data, length, id->hash);
+    id->tag     = (uint32_t)cipher | ((uint32_t)mode << 4) | ((key_id ? 1u : 0u) << 8) | (keylen << 16);
+
+    return 0;
+}
+
+
+/*
+ * Drops a reference, wiping and freeing the entry once it was the last one.
+ */
+static void keycache_release(s_keycache_entry* entry)
+{
+    if (entry->refs.fetch_sub(1) == 1) {
+        memset(&(entry->ctx), 0, sizeof(entry->ctx));
+        delete entry;
+    }
+}
+
+
+static inline size_t keycache_shard_capacity(void)
+{
+    const size_t capacity = keycache_capacity.load();
+
+    return (capacity + KEYCACHE_SHARDS - 1) / KEYCACHE_SHARDS;
+}
+
+
+/*
+ * Evicts least recently used entries until at most 'capacity' are left in the shard.
+ *
+ * The caller must hold the shard mutex.
+ */
+static void keycache_shrink(s_keycache_shard* shard, const size_t capacity)
+{
+    while (shard->lru.size() > capacity) {
+        s_keycache_entry* entry = shard->lru.back();
+        shard->index.erase(entry->id);
+        shard->lru.pop_back();
+        keycache_release(entry);
+        ++shard->evictions;
+    }
+}
+
+
+static int keycache_setkey(s_keycache_entry* entry, const int cipher, const int mode,
+                           const unsigned char* key, const unsigned int keylen)
+{
+    if (cipher == KEYCACHE_AES) {
+        aes_init(&(entry->ctx.aes));
+        if (mode == AES_ENCRYPT) {
+            return aes_setkey_enc(&(entry->ctx.aes), key, keylen);
+        }
+        return aes_setkey_dec(&(entry->ctx.aes), key, keylen);
+    }
+
+    camellia_init(&(entry->ctx.camellia));
+    if (mode == CAMELLIA_ENCRYPT) {
+        return camellia_setkey_enc(&(entry->ctx.camellia), key, keylen);
+    }
+    return camellia_setkey_dec(&(entry->ctx.camellia), key, keylen);
+}
+
+
+/*
+ * Returns a referenced entry for 'id', expanding (and caching) the key on a miss.
+ *
+ * The expansion runs without holding the shard lock; if another thread cached the
+ * same key meanwhile, its entry is used and the fresh one dropped.
+ */
+static s_keycache_entry* keycache_acquire(const s_keycache_id& id, const int cipher, const int mode,
+                                          const unsigned char* key, const unsigned int keylen, int* ret)
+{
+    s_keycache_shard* shard = &keycache_shards[id.hash[1] % KEYCACHE_SHARDS];
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        auto it = shard->index.find(id);
+        if (it != shard->index.end()) {
+            s_keycache_entry* entry = it->second;
+            shard->lru.splice(shard->lru.begin(), shard->lru, entry->lru);
+            ++entry->refs;
+            ++shard->hits;
+            return entry;
+        }
+        ++shard->misses;
+    }
+
+    s_keycache_entry* entry = new s_keycache_entry();
+    entry->id   = id;
+    entry->refs = 1;
+    *ret = keycache_setkey(entry, cipher, mode, key, keylen);
+    if (*ret != 0) {
+        keycache_release(entry);
+        return NULL;
+    }
+
+    const size_t capacity = keycache_shard_capacity();
+    if (capacity == 0) {
+        return entry; // not cached, only referenced by the caller
+    }
+
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    auto it = shard->index.find(id);
+    if (it != shard->index.end()) {
+        keycache_release(entry);
+        ++it->second->refs;
+        return it->second;
+    }
+
+    shard->lru.push_front(entry);
+    entry->lru = shard->lru.begin();
+    shard->index[id] = entry;
+    ++entry->refs;
+    keycache_shrink(shard, capacity);
+
+    return entry;
+}
+
+
+/*
+ * Shared implementation of hx_keycache_aes() and hx_keycache_camellia().
+ */
+static s_keycache_entry* keycache_lookup(const int cipher, value key, value keylen, value mode, value key_id, int* ret)
+{
+    const unsigned int size  = val_int(keylen);
+    const unsigned char* raw = data_fromHaxe(key);
+    s_keycache_id id;
+
+    // hash outside of any lock
+    if (val_is_null(key_id)) {
+        *ret = keycache_id(cipher, val_int(mode), size, raw, size / 8, false, &id);
+    } else {
+        *ret = keycache_id(cipher, val_int(mode), size, (const unsigned char*)val_string(key_id), val_strlen(key_id), true, &id);
+    }
+    if (*ret != 0) {
+        return NULL;
+    }
+
+    return keycache_acquire(id, cipher, val_int(mode), raw, size, ret);
+}
+
+
+extern "C" {
+
+value hx_keycache_aes(value key, value keylen, value mode, value key_id)
+{
+    val_check(keylen, int);
+    val_check(mode, int);
+    if (!val_is_null(key_id)) {
+        val_check(key_id, string);
+    }
+
+    int ret = 0;
+    s_keycache_entry* entry = keycache_lookup(KEYCACHE_AES, key, keylen, mode, key_id, &ret);
+    if (entry == NULL) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    value val = alloc_aes_context(&(entry->ctx.aes));
+    val_gc(val, finalize_keycache_entry);
+
+    return val;
+}
+DEFINE_PRIM(hx_keycache_aes, 4);
+
+
+value hx_keycache_benchmark(value iterations)
+{
+    val_check(iterations, int);
+
+    const int rounds = (val_int(iterations) > 0) ? val_int(iterations) : 1;
+
+    unsigned char key[32];
+    for (size_t i = 0; i < sizeof(key); ++i) {
+        key[i] = (unsigned char)i;
+    }
+
+    s_keycache_id id;
+    int ret = keycache_id(KEYCACHE_AES, AES_DECRYPT, 256, key, sizeof(key), false, &id);
+    s_keycache_entry* entry = (ret == 0) ? keycache_acquire(id, KEYCACHE_AES, AES_DECRYPT, key, 256, &ret) : NULL;
+    if (entry == NULL) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+    keycache_release(entry); // warm
+
+    gc_enter_blocking();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds && ret == 0; ++i) {
+        ret = keycache_id(KEYCACHE_AES, AES_DECRYPT, 256, key, sizeof(key), false, &id);
+        if (ret == 0 && (entry = keycache_acquire(id, KEYCACHE_AES, AES_DECRYPT, key, 256, &ret)) != NULL) {
+            keycache_release(entry);
+        }
+    }
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds && ret == 0; ++i) {
+        aes_context ctx;
+        aes_init(&ctx);
+        ret = aes_setkey_dec(&ctx, key, 256);
+        aes_free(&ctx);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    gc_exit_blocking();
+
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    value arr = alloc_array(2);
+    val_array_set_i(arr, 0, alloc_float(std::chrono::duration<double, std::nano>(middle - start).count() / rounds));
+    val_array_set_i(arr, 1, alloc_float(std::chrono::duration<double, std::nano>(end - middle).count() / rounds));
+
+    return arr;
+}
+DEFINE_PRIM(hx_keycache_benchmark, 1);
+
+
+value hx_keycache_camellia(value key, value keylen, value mode, value key_id)
+{
+    val_check(keylen, int);
+    val_check(mode, int);
+    if (!val_is_null(key_id)) {
+        val_check(key_id, string);
+    }
+
+    int ret = 0;
+    s_keycache_entry* entry = keycache_lookup(KEYCACHE_CAMELLIA, key, keylen, mode, key_id, &ret);
+    if (entry == NULL) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    value val = alloc_camellia_context(&(entry->ctx.camellia));
+    val_gc(val, finalize_keycache_entry);
+
+    return val;
+}
+DEFINE_PRIM(hx_keycache_camellia, 4);
+
+
+value hx_keycache_clear(void)
+{
+    for (size_t i = 0; i < KEYCACHE_SHARDS; ++i) {
+        s_keycache_shard* shard = &keycache_shards[i];
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        for (keycache_list::iterator it = shard->lru.begin(); it != shard->lru.end(); ++it) {
+            keycache_release(*it);
+        }
+        shard->index.clear();
+        shard->lru.clear();
+    }
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_keycache_clear, 0);
+
+
+value hx_keycache_set_capacity(value capacity)
+{
+    val_check(capacity, int);
+
+    keycache_capacity = (val_int(capacity) > 0) ? val_int(capacity) : 0;
+    const size_t per_shard = keycache_shard_capacity();
+    for (size_t i = 0; i < KEYCACHE_SHARDS; ++i) {
+        std::lock_guard<std::mutex> lock(keycache_shards[i].mutex);
+        keycache_shrink(&keycache_shards[i], per_shard);
+    }
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_keycache_set_capacity, 1);
+
+
+value hx_keycache_stats(void)
+{
+    size_t hits      = 0;
+    size_t misses    = 0;
+    size_t evictions = 0;
+    size_t size      = 0;
+    for (size_t i = 0; i < KEYCACHE_SHARDS; ++i) {
+        s_keycache_shard* shard = &keycache_shards[i];
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        hits      += shard->hits;
+        misses    += shard->misses;
+        evictions += shard->evictions;
+        size      += shard->lru.size();
+    }
+
+    value arr = alloc_array(5);
+    val_array_set_i(arr, 0, alloc_int(hits));
+    val_array_set_i(arr, 1, alloc_int(misses));
+    val_array_set_i(arr, 2, alloc_int(evictions));
+    val_array_set_i(arr, 3, alloc_int(size));
+    val_array_set_i(arr, 4, alloc_int(keycache_capacity.load()));
+
+    return arr;
+}
+DEFINE_PRIM(hx_keycache_stats, 0);
+
+
+void finalize_keycache_entry(value context)
+{
+    if (context != NULL) {
+        // 'ctx' is the first member of the entry
+        keycache_release((s_keycache_entry*)val_data(context));
+    }
+}
+
+} // extern "C"
@@ -37,6 +37,17 @@ value hx_md2_file(value path)
 DEFINE_PRIM(hx_md2_file, 1);
 
 
+value hx_md2_hex(value bytes, value length)
+{
+    s_bytes* cbytes = bytes_fromHaxe(bytes, length);
+    unsigned char sum[16];
+    md2(cbytes->data, cbytes->length, sum);
+
+    return value_hexFromBytes(sum, sizeof(sum));
+}
+DEFINE_PRIM(hx_md2_hex, 2);
+
+
 value hx_md24_self_test(value verbose)
 {
     val_check(verbose, bool);
@@ -37,6 +37,17 @@ value hx_md4_file(value path)
 DEFINE_PRIM(hx_md4_file, 1);
 
 
+value hx_md4_hex(value bytes, value length)
+{
+    s_bytes* cbytes = bytes_fromHaxe(bytes, length);
+    unsigned char sum[16];
+    md4(cbytes->data, cbytes->length, sum);
+
+    return value_hexFromBytes(sum, sizeof(sum));
+}
+DEFINE_PRIM(hx_md4_hex, 2);
+
+
 value hx_md4_self_test(value verbose)
 {
     val_check(verbose, bool);
@@ -37,6 +37,17 @@ value hx_md5_file(value path)
 DEFINE_PRIM(hx_md5_file, 1);
 
 
+value hx_md5_hex(value bytes, value length)
+{
+    s_bytes* cbytes = bytes_fromHaxe(bytes, length);
+    unsigned char sum[16];
+    md5(cbytes->data, cbytes->length, sum);
+
+    return value_hexFromBytes(sum, sizeof(sum));
+}
+DEFINE_PRIM(hx_md5_hex, 2);
+
+
 value hx_md5_self_test(value verbose)
 {
     val_check(verbose, bool);
@@ -50,4 +61,27 @@ value hx_md5_self_test(value verbose)
 }
 DEFINE_PRIM(hx_md5_self_test, 1);
 
+
+value hx_md5v(value segments)
+{
+    val_check(segments, array);
+
+    size_t count;
+    size_t total;
+    s_bytes* parts = segments_fromHaxe(segments, &count, &total);
+    unsigned char sum[16];
+
+    md5_context ctx;
+    md5_init(&ctx);
+    md5_starts(&ctx);
+    for (size_t i = 0; i < count; ++i) {
+        md5_update(&ctx, parts[i].data, parts[i].length);
+    }
+    md5_finish(&ctx, sum);
+    md5_free(&ctx);
+
+    return value_fromBytes(sum, sizeof(sum));
+}
+DEFINE_PRIM(hx_md5v, 1);
+
 } // extern "C"
@@ -0,0 +1,356 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+#include <polarssl/md.h>
+
+#include "hxpolarssl/utils.hpp"
+#include "hxpolarssl/merkle.hpp"
+
+/*
+ * Minimum amount of work (input bytes for leaves, nodes for inner levels) per worker
+ * thread; below it the tree level is hashed on the calling thread.
+ */
+#define MERKLE_BYTES_PER_THREAD  (1 << 20)
+#define MERKLE_NODES_PER_THREAD  4096
+
+/*
+ * Inputs up to this many bytes are hashed in place without leaving the GC; larger ones
+ * are copied first and hashed in a blocking region, so other threads are not stalled.
+ */
+#define MERKLE_BYTES_IN_PLACE  (64 * 1024)
+
+
+typedef std::vector<std::vector<unsigned char> > merkle_levels;
+
+
+/*
+ * Splits [0, count) into contiguous ranges and runs 'fn(begin, end)' for each of them
+ * on up to 'workers' threads (including the calling one).
+ */
+template<class F>
+static void merkle_parallel(size_t workers, const size_t count, const F& fn)
+{
+    if (workers > count) {
+        workers = count;
+    }
+    if (workers <= 1) {
+        fn(0, count);
+        return;
+    }
+
+    const size_t per = (count + workers - 1) / workers;
+    std::vector<std::thread> pool;
+    for (size_t begin = per; begin < count; begin += per) {
+        const size_t end = (begin + per < count) ? begin + per : count;
+        try {
+            pool.push_back(std::thread(fn, begin, end));
+        } catch (...) { // out of threads
+            fn(begin, end);
+        }
+    }
+    fn(0, per);
+
+    for (size_t i = 0; i < pool.size(); ++i) {
+        pool[i].join();
+    }
+}
+
+
+static size_t merkle_workers(const s_merkle* merkle, const size_t work, const size_t per_thread)
+{
+    size_t threads = (merkle->threads > 0) ? merkle->threads : std::thread::hardware_concurrency();
+    if (threads == 0) {
+        threads = 1;
+    }
+    const size_t useful = work / per_thread + 1;
+
+    return (useful < threads) ? useful : threads;
+}
+
+
+static int merkle_hash_leaves(const s_merkle* merkle, const unsigned char* data, const size_t length,
+                              const size_t begin, const size_t end, unsigned char* out)
+{
+    const size_t size          = md_get_size(merkle->md_info);
+    const unsigned char prefix = MERKLE_LEAF_PREFIX;
+    md_context_t ctx;
+    md_init(&ctx);
+
+    int ret = md_init_ctx(&ctx, merkle->md_info);
+    for (size_t i = begin; ret == 0 && i < end; ++i) {
+        const size_t offset = i * merkle->leaf_size;
+        const size_t n      = (length - offset < merkle->leaf_size) ? length - offset : merkle->leaf_size;
+
+        ret = md_starts(&ctx);
+        if (ret == 0 && merkle->prefixed) {
+            ret = md_update(&ctx, &prefix, 1);
+        }
+        if (ret == 0) {
+            ret = md_update(&ctx, data + offset, n);
+        }
+        if (ret == 0) {
+            ret = md_finish(&ctx, out + i * size);
+        }
+    }
+    md_free(&ctx);
+
+    return ret;
+}
+
+
+/*
+ * Hashes the pairs [begin, end) of the level 'below' (the two children are adjacent).
+ */
+static int merkle_hash_nodes(const s_merkle* merkle, const unsigned char* below,
+                             const size_t begin, const size_t end, unsigned char* out)
+{
+    const size_t size          = md_get_size(merkle->md_info);
+    const unsigned char prefix = MERKLE_NODE_PREFIX;
+    md_context_t ctx;
+    md_init(&ctx);
+
+    int ret = md_init_ctx(&ctx, merkle->md_info);
+    for (size_t i = begin; ret == 0 && i < end; ++i) {
+        ret = md_starts(&ctx);
+        if (ret == 0 && merkle->prefixed) {
+            ret = md_update(&ctx, &prefix, 1);
+        }
+        if (ret == 0) {
+            ret = md_update(&ctx, below + 2 * i * size, 2 * size);
+        }
+        if (ret == 0) {
+            ret = md_finish(&ctx, out + i * size);
+        }
+    }
+    md_free(&ctx);
+
+    return ret;
+}
+
+
+/*
+ * Builds all levels of the tree, from the leaves (an empty input is one empty leaf)
+ * up to the root; an odd last node is promoted to the next level unchanged.
+ */
+static int merkle_build(const s_merkle* merkle, const unsigned char* data, const size_t length, merkle_levels* levels)
+{
+    const size_t size = md_get_size(merkle->md_info);
+    size_t count      = (length == 0) ? 1 : (length - 1) / merkle->leaf_size + 1;
+    std::atomic<int> error(0);
+
+    levels->push_back(std::vector<unsigned char>(count * size));
+    unsigned char* leaves = &levels->back()[0];
+    merkle_parallel(merkle_workers(merkle, length, MERKLE_BYTES_PER_THREAD), count, [&](size_t begin, size_t end) {
+        int ret = merkle_hash_leaves(merkle, data, length, begin, end, leaves);
+        if (ret != 0) {
+            error = ret;
+        }
+    });
+
+    while (count > 1 && error == 0) {
+        const size_t pairs = count / 2;
+        levels->push_back(std::vector<unsigned char>((count + 1) / 2 * size));
+
+        const unsigned char* below = &(*levels)[levels->size() - 2][0];
+        unsigned char* above       = &levels->back()[0];
+        merkle_parallel(merkle_workers(merkle, pairs, MERKLE_NODES_PER_THREAD), pairs, [&](size_t begin, size_t end) {
+            int ret = merkle_hash_nodes(merkle, below, begin, end, above);
+            if (ret != 0) {
+                error = ret;
+            }
+        });
+        if (count % 2 != 0) {
+            memcpy(above + pairs * size, below + (count - 1) * size, size);
+        }
+        count = (count + 1) / 2;
+    }
+
+    return error;
+}
+
+
+static int merkle_build_file(const s_merkle* merkle, const char* path, merkle_levels* levels)
+{
+#ifdef _WIN32
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return POLARSSL_ERR_MD_FILE_IO_ERROR;
+    }
+
+    std::vector<unsigned char> data;
+    unsigned char buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), file)) > 0) {
+        data.insert(data.end(), buf, buf + n);
+    }
+    const bool failed = ferror(file) != 0;
+    fclose(file);
+    if (failed) {
+        return POLARSSL_ERR_MD_FILE_IO_ERROR;
+    }
+
+    return merkle_build(merkle, data.empty() ? NULL : &data[0], data.size(), levels);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return POLARSSL_ERR_MD_FILE_IO_ERROR;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size > (uint64_t)SIZE_MAX) {
+        close(fd);
+        return POLARSSL_ERR_MD_FILE_IO_ERROR;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return merkle_build(merkle, NULL, 0, levels);
+    }
+
+    const size_t length = (size_t)st.st_size;
+    void* map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return POLARSSL_ERR_MD_FILE_IO_ERROR;
+    }
+    madvise(map, length, MADV_WILLNEED);
+
+    int ret = merkle_build(merkle, (const unsigned char*)map, length, levels);
+    munmap(map, length);
+
+    return ret;
+#endif
+}
+
+
+/*
+ * Converts the levels into a Haxe array (all of them or only the root).
+ */
+static value merkle_toHaxe(const merkle_levels& levels, const bool all)
+{
+    const size_t first = all ? 0 : levels.size() - 1;
+
+    value arr = alloc_array(levels.size() - first);
+    for (size_t i = first; i < levels.size(); ++i) {
+        val_array_set_i(arr, i - first, value_fromBytes(&levels[i][0], levels[i].size()));
+    }
+
+    return arr;
+}
+
+
+extern "C" {
+
+DEFINE_KIND(k_merkle);
+
+
+value hx_merkle_bytes(value merkle, value bytes, value pos, value length, value levels)
+{
+    val_check_merkle(merkle);
+    val_check(pos, int);
+    val_check(length, int);
+    val_check(levels, bool);
+
+    const unsigned char* data = data_fromHaxe(bytes) + val_int(pos);
+    const size_t size         = val_int(length);
+    merkle_levels clevels;
+
+    int ret;
+    if (size <= MERKLE_BYTES_IN_PLACE) {
+        // small input: hashed in place, the GC cannot run (and move it) meanwhile
+        ret = merkle_build(val_merkle(merkle), data, size, &clevels);
+    } else {
+        // build with copies; the GC may run (and move the input and context) while hashing
+        const s_merkle params = *val_merkle(merkle);
+        const std::vector<unsigned char> cdata(data, data + size);
+
+        gc_enter_blocking();
+        ret = merkle_build(&params, &cdata[0], size, &clevels);
+        gc_exit_blocking();
+    }
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    return merkle_toHaxe(clevels, val_bool(levels));
+}
+DEFINE_PRIM(hx_merkle_bytes, 5);
+
+
+value hx_merkle_file(value merkle, value path, value levels)
+{
+    val_check_merkle(merkle);
+    val_check(path, string);
+    val_check(levels, bool);
+
+    // build with copies; the GC may run (and move the context) while the file is read
+    const s_merkle params = *val_merkle(merkle);
+    const std::string cpath(val_string(path));
+    merkle_levels clevels;
+
+    gc_enter_blocking();
+    int ret = merkle_build_file(&params, cpath.c_str(), &clevels);
+    gc_exit_blocking();
+
+    if (ret != 0) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    return merkle_toHaxe(clevels, val_bool(levels));
+}
+DEFINE_PRIM(hx_merkle_file, 3);
+
+
+value hx_merkle_init(value leaf_size, value type, value prefixed, value threads)
+{
+    val_check(leaf_size, int);
+    val_check(type, int);
+    val_check(prefixed, bool);
+    val_check(threads, int);
+
+    const md_info_t* md_info = md_info_from_type((md_type_t)val_int(type));
+    if (md_info == NULL || val_int(leaf_size) < MERKLE_MIN_LEAF_SIZE || val_int(leaf_size) > MERKLE_MAX_LEAF_SIZE
+            || val_int(threads) < 0 || val_int(threads) > MERKLE_MAX_THREADS) {
+        throw_err(POLARSSL_ERR_MD_BAD_INPUT_DATA);
+        return alloc_int(POLARSSL_ERR_MD_BAD_INPUT_DATA);
+    }
+
+    s_merkle* merkle  = malloc_merkle();
+    merkle->leaf_size = val_int(leaf_size);
+    merkle->md_info   = md_info;
+    merkle->prefixed  = val_bool(prefixed);
+    merkle->threads   = val_int(threads);
+
+    value val = alloc_merkle(merkle);
+    val_gc(val, finalize_merkle);
+
+    return val;
+}
+DEFINE_PRIM(hx_merkle_init, 4);
+
+
+void finalize_merkle(value merkle)
+{
+    val_check_merkle(merkle);
+
+    if (merkle != NULL) {
+        s_merkle* _merkle = val_merkle(merkle);
+        memset(_merkle, 0, sizeof(s_merkle));
+        _merkle = NULL;
+    }
+}
+
+} // extern "C"
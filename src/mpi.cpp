@@ -0,0 +1,336 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <stdlib.h>
+#include <polarssl/bignum.h>
+
+#include "hxpolarssl/mpi.hpp"
+#include "hxpolarssl/utils.hpp"
+
+extern "C" {
+
+DEFINE_KIND(k_mpi);
+
+
+/*
+ * Returns the return code and raises a Neko error if it indicates a failure.
+ */
+static value mpi_result(const int ret)
+{
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+
+
+value hx_mpi_add(value X, value A, value B)
+{
+    val_check_mpi(X);
+    val_check_mpi(A);
+    val_check_mpi(B);
+
+    return mpi_result(mpi_add_mpi(val_mpi(X), val_mpi(A), val_mpi(B)));
+}
+DEFINE_PRIM(hx_mpi_add, 3);
+
+
+value hx_mpi_add_int(value X, value A, value b)
+{
+    val_check_mpi(X);
+    val_check_mpi(A);
+    val_check(b, int);
+
+    return mpi_result(mpi_add_int(val_mpi(X), val_mpi(A), val_int(b)));
+}
+DEFINE_PRIM(hx_mpi_add_int, 3);
+
+
+value hx_mpi_bitlen(value X)
+{
+    val_check_mpi(X);
+
+    return alloc_int(mpi_msb(val_mpi(X)));
+}
+DEFINE_PRIM(hx_mpi_bitlen, 1);
+
+
+value hx_mpi_cmp(value X, value Y)
+{
+    val_check_mpi(X);
+    val_check_mpi(Y);
+
+    return alloc_int(mpi_cmp_mpi(val_mpi(X), val_mpi(Y)));
+}
+DEFINE_PRIM(hx_mpi_cmp, 2);
+
+
+value hx_mpi_copy(value X, value Y)
+{
+    val_check_mpi(X);
+    val_check_mpi(Y);
+
+    return mpi_result(mpi_copy(val_mpi(X), val_mpi(Y)));
+}
+DEFINE_PRIM(hx_mpi_copy, 2);
+
+
+value hx_mpi_exp_mod(value X, value A, value E, value N)
+{
+    val_check_mpi(X);
+    val_check_mpi(A);
+    val_check_mpi(E);
+    val_check_mpi(N);
+
+    mpi* _X = val_mpi(X);
+    mpi* _E = val_mpi(E);
+    mpi* _N = val_mpi(N);
+
+    // PolarSSL overwrites X before it is done reading E and N
+    int ret;
+    if (_X == _E || _X == _N) {
+        mpi T;
+        mpi_init(&T);
+        ret = mpi_exp_mod(&T, val_mpi(A), _E, _N, NULL);
+        if (ret == 0) {
+            mpi_swap(_X, &T);
+        }
+        mpi_free(&T);
+    } else {
+        ret = mpi_exp_mod(_X, val_mpi(A), _E, _N, NULL);
+    }
+
+    return mpi_result(ret);
+}
+DEFINE_PRIM(hx_mpi_exp_mod, 4);
+
+
+value hx_mpi_free(value X)
+{
+    val_check_mpi(X);
+
+    mpi_free(val_mpi(X));
+
+    return alloc_null();
+}
+DEFINE_PRIM(hx_mpi_free, 1);
+
+
+value hx_mpi_gcd(value X, value A, value B)
+{
+    val_check_mpi(X);
+    val_check_mpi(A);
+    val_check_mpi(B);
+
+    return mpi_result(mpi_gcd(val_mpi(X), val_mpi(A), val_mpi(B)));
+}
+DEFINE_PRIM(hx_mpi_gcd, 3);
+
+
+value hx_mpi_init(void)
+{
+    mpi* X = malloc_mpi();
+    mpi_init(X);
+
+    value val = alloc_mpi(X);
+    val_gc(val, finalize_mpi);
+
+    return val;
+}
+DEFINE_PRIM(hx_mpi_init, 0);
+
+
+value hx_mpi_inv_mod(value X, value A, value N)
+{
+    val_check_mpi(X);
+    val_check_mpi(A);
+    val_check_mpi(N);
+
+    return mpi_result(mpi_inv_mod(val_mpi(X), val_mpi(A), val_mpi(N)));
+}
+DEFINE_PRIM(hx_mpi_inv_mod, 3);
+
+
+value hx_mpi_lset(value X, value z)
+{
+    val_check_mpi(X);
+    val_check(z, int);
+
+    return mpi_result(mpi_lset(val_mpi(X), val_int(z)));
+}
+DEFINE_PRIM(hx_mpi_lset, 2);
+
+
+value hx_mpi_mod(value X, value A, value B)
+{
+    val_check_mpi(X);
+    val_check_mpi(A);
+    val_check_mpi(B);
+
+    mpi* _X = val_mpi(X);
+    mpi* _B = val_mpi(B);
+
+    // the result is normalized against B after X has been written
+    int ret;
+    if (_X == _B) {
+        mpi T;
+        mpi_init(&T);
+        ret = mpi_mod_mpi(&T, val_mpi(A), _B);
+        if (ret == 0) {
+            mpi_swap(_X, &T);
+        }
+        mpi_free(&T);
+    } else {
+        ret = mpi_mod_mpi(_X, val_mpi(A), _B);
+    }
+
+    return mpi_result(ret);
+}
+DEFINE_PRIM(hx_mpi_mod, 3);
+
+
+value hx_mpi_mul(value X, value A, value B)
+{
+    val_check_mpi(X);
+    val_check_mpi(A);
+    val_check_mpi(B);
+
+    return mpi_result(mpi_mul_mpi(val_mpi(X), val_mpi(A), val_mpi(B)));
+}
+DEFINE_PRIM(hx_mpi_mul, 3);
+
+
+value hx_mpi_mul_int(value X, value A, value b)
+{
+    val_check_mpi(X);
+    val_check_mpi(A);
+    val_check(b, int);
+
+    return mpi_result(mpi_mul_int(val_mpi(X), val_mpi(A), (t_uint)val_int(b)));
+}
+DEFINE_PRIM(hx_mpi_mul_int, 3);
+
+
+value hx_mpi_read_binary(value X, value bytes, value length)
+{
+    val_check_mpi(X);
+
+    s_bytes* cbytes = bytes_fromHaxe(bytes, length);
+
+    return mpi_result(mpi_read_binary(val_mpi(X), cbytes->data, cbytes->length));
+}
+DEFINE_PRIM(hx_mpi_read_binary, 3);
+
+
+value hx_mpi_read_string(value X, value radix, value str)
+{
+    val_check_mpi(X);
+    val_check(radix, int);
+    val_check(str, string);
+
+    return mpi_result(mpi_read_string(val_mpi(X), val_int(radix), val_string(str)));
+}
+DEFINE_PRIM(hx_mpi_read_string, 3);
+
+
+value hx_mpi_self_test(value verbose)
+{
+    val_check(verbose, bool);
+
+    int ret = mpi_self_test(val_bool(verbose));
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_mpi_self_test, 1);
+
+
+value hx_mpi_sub(value X, value A, value B)
+{
+    val_check_mpi(X);
+    val_check_mpi(A);
+    val_check_mpi(B);
+
+    return mpi_result(mpi_sub_mpi(val_mpi(X), val_mpi(A), val_mpi(B)));
+}
+DEFINE_PRIM(hx_mpi_sub, 3);
+
+
+value hx_mpi_sub_int(value X, value A, value b)
+{
+    val_check_mpi(X);
+    val_check_mpi(A);
+    val_check(b, int);
+
+    return mpi_result(mpi_sub_int(val_mpi(X), val_mpi(A), val_int(b)));
+}
+DEFINE_PRIM(hx_mpi_sub_int, 3);
+
+
+value hx_mpi_write_binary(value X)
+{
+    val_check_mpi(X);
+
+    mpi* _X           = val_mpi(X);
+    const size_t size = mpi_size(_X);
+    unsigned char buffer[size];
+
+    value val;
+    int ret = mpi_write_binary(_X, buffer, size);
+    if (ret == 0) {
+        val = value_fromBytes(buffer, size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_mpi_write_binary, 1);
+
+
+value hx_mpi_write_string(value X, value radix)
+{
+    val_check_mpi(X);
+    val_check(radix, int);
+
+    mpi* _X     = val_mpi(X);
+    size_t size = 0;
+
+    // a zero-sized buffer makes PolarSSL report the required length
+    int ret = mpi_write_string(_X, val_int(radix), NULL, &size);
+    if (ret != POLARSSL_ERR_MPI_BUFFER_TOO_SMALL) {
+        throw_err(ret);
+        return alloc_int(ret);
+    }
+
+    char buffer[size];
+    ret = mpi_write_string(_X, val_int(radix), buffer, &size);
+
+    value val;
+    if (ret == 0) {
+        val = alloc_string(buffer);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+
+    return val;
+}
+DEFINE_PRIM(hx_mpi_write_string, 2);
+
+
+void finalize_mpi(value X)
+{
+    val_check_mpi(X);
+
+    if (X != NULL) {
+        mpi* _X = val_mpi(X);
+        mpi_free(_X);
+        _X = NULL;
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,170 @@
+#define  NEKO_COMPATIBLE
+#include <hx/CFFI.h>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include <polarssl/md.h>
+#include <polarssl/pkcs5.h>
+
+#include "hxpolarssl/pbkdf2.hpp"
+#include "hxpolarssl/utils.hpp"
+
+/*
+ * Computes the PBKDF2 output blocks first, first + step, ... (1-based) and writes
+ * them to their position within 'out'.
+ *
+ * Each call sets up its own HMAC context, so calls can run on separate threads.
+ */
+static int pbkdf2_blocks(const md_info_t* md_info, const std::vector<unsigned char>* pwd,
+    const std::vector<unsigned char>* salt, const unsigned int iterations,
+    const uint32_t first, const uint32_t step, unsigned char* out, const size_t key_length)
+{
+    const size_t hlen = md_get_size(md_info);
+    unsigned char U[POLARSSL_MD_MAX_SIZE];
+    unsigned char T[POLARSSL_MD_MAX_SIZE];
+    unsigned char counter[4];
+    md_context_t ctx;
+
+    md_init(&ctx);
+    int ret = md_init_ctx(&ctx, md_info);
+    if (ret == 0) {
+        ret = md_hmac_starts(&ctx, pwd->data(), pwd->size());
+    }
+
+    for (uint32_t block = first; ret == 0 && (size_t)(block - 1) * hlen < key_length; block += step) {
+        counter[0] = (unsigned char)(block >> 24);
+        counter[1] = (unsigned char)(block >> 16);
+        counter[2] = (unsigned char)(block >> 8);
+        counter[3] = (unsigned char)(block);
+
+        md_hmac_reset(&ctx);
+        md_hmac_update(&ctx, salt->data(), salt->size());
+        md_hmac_update(&ctx, counter, sizeof(counter));
+        md_hmac_finish(&ctx, U);
+        memcpy(T, U, hlen);
+
+        for (unsigned int i = 1; i < iterations; ++i) {
+            md_hmac_reset(&ctx);
+            md_hmac_update(&ctx, U, hlen);
+            md_hmac_finish(&ctx, U);
+            for (size_t j = 0; j < hlen; ++j) {
+                T[j] ^= U[j];
+            }
+        }
+
+        const size_t offset = (size_t)(block - 1) * hlen;
+        memcpy(out + offset, T, (key_length - offset < hlen) ? key_length - offset : hlen);
+    }
+
+    md_free(&ctx);
+    memset(U, 0, sizeof(U));
+    memset(T, 0, sizeof(T));
+
+    return ret;
+}
+
+
+extern "C" {
+
+value hx_pbkdf2_hmac(value md_alg, value pwdArr, value saltArr, value iterations, value key_length)
+{
+    val_check(md_alg, int);
+    val_check(pwdArr, array);
+    val_check(val_array_i(pwdArr, 0), int);
+    val_check(saltArr, array);
+    val_check(val_array_i(saltArr, 0), int);
+    val_check(iterations, int);
+    val_check(key_length, int);
+
+    const md_info_t* md_info = md_info_from_type((md_type_t)val_int(md_alg));
+    if (md_info == NULL) {
+        throw_err(POLARSSL_ERR_MD_FEATURE_UNAVAILABLE);
+        return alloc_int(POLARSSL_ERR_MD_FEATURE_UNAVAILABLE);
+    }
+
+    // copy the inputs; the Haxe buffers may move once the GC lock is released
+    s_bytes* pwd_bytes  = bytes_fromHaxe(val_array_i(pwdArr, 1), val_array_i(pwdArr, 0));
+    s_bytes* salt_bytes = bytes_fromHaxe(val_array_i(saltArr, 1), val_array_i(saltArr, 0));
+    std::vector<unsigned char> pwd(pwd_bytes->data, pwd_bytes->data + pwd_bytes->length);
+    std::vector<unsigned char> salt(salt_bytes->data, salt_bytes->data + salt_bytes->length);
+
+    const unsigned int rounds = val_int(iterations);
+    const size_t size         = val_int(key_length);
+    const size_t hlen         = md_get_size(md_info);
+    const size_t blocks       = (size + hlen - 1) / hlen;
+    std::vector<unsigned char> key(size);
+
+    int ret = 0;
+    gc_enter_blocking();
+    if (blocks <= 1) {
+        md_context_t ctx;
+        md_init(&ctx);
+        ret = md_init_ctx(&ctx, md_info);
+        if (ret == 0) {
+            ret = pkcs5_pbkdf2_hmac(&ctx, pwd.data(), pwd.size(), salt.data(), salt.size(), rounds, (uint32_t)size, key.data());
+        }
+        md_free(&ctx);
+    } else {
+        size_t nthreads = std::thread::hardware_concurrency();
+        if (nthreads == 0) {
+            nthreads = 1;
+        }
+        if (nthreads > blocks) {
+            nthreads = blocks;
+        }
+
+        // the calling thread takes the first share itself (and those it cannot spawn a thread for)
+        std::vector<int> rets(nthreads, 0);
+        std::vector<std::thread> workers;
+        workers.reserve(nthreads - 1);
+        for (size_t t = 1; t < nthreads; ++t) {
+            auto share = [&, t]() {
+                rets[t] = pbkdf2_blocks(md_info, &pwd, &salt, rounds, (uint32_t)(t + 1), (uint32_t)nthreads, key.data(), size);
+            };
+            try {
+                workers.push_back(std::thread(share));
+            } catch (...) { // out of threads
+                share();
+            }
+        }
+        rets[0] = pbkdf2_blocks(md_info, &pwd, &salt, rounds, 1, (uint32_t)nthreads, key.data(), size);
+        for (size_t t = 0; t < workers.size(); ++t) {
+            workers[t].join();
+        }
+        for (size_t t = 0; t < nthreads && ret == 0; ++t) {
+            ret = rets[t];
+        }
+    }
+    gc_exit_blocking();
+
+    memset(pwd.data(), 0, pwd.size());
+
+    value val;
+    if (ret == 0) {
+        val = value_fromBytes(key.data(), size);
+    } else {
+        throw_err(ret);
+        val = alloc_int(ret);
+    }
+    memset(key.data(), 0, size);
+
+    return val;
+}
+DEFINE_PRIM(hx_pbkdf2_hmac, 5);
+
+
+value hx_pbkdf2_self_test(value verbose)
+{
+    val_check(verbose, bool);
+
+    int ret = pkcs5_self_test(val_bool(verbose));
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_pbkdf2_self_test, 1);
+
+} // extern "C"
@@ -37,6 +37,17 @@ value hx_ripemd160_file(value path)
 DEFINE_PRIM(hx_ripemd160_file, 1);
 
 
+value hx_ripemd160_hex(value bytes, value length)
+{
+    s_bytes* cbytes = bytes_fromHaxe(bytes, length);
+    unsigned char sum[20];
+    ripemd160(cbytes->data, cbytes->length, sum);
+
+    return value_hexFromBytes(sum, sizeof(sum));
+}
+DEFINE_PRIM(hx_ripemd160_hex, 2);
+
+
 value hx_ripemd160_self_test(value verbose)
 {
     val_check(verbose, bool);
@@ -50,4 +61,27 @@ value hx_ripemd160_self_test(value verbose)
 }
 DEFINE_PRIM(hx_ripemd160_self_test, 1);
 
+
+value hx_ripemd160v(value segments)
+{
+    val_check(segments, array);
+
+    size_t count;
+    size_t total;
+    s_bytes* parts = segments_fromHaxe(segments, &count, &total);
+    unsigned char sum[20];
+
+    ripemd160_context ctx;
+    ripemd160_init(&ctx);
+    ripemd160_starts(&ctx);
+    for (size_t i = 0; i < count; ++i) {
+        ripemd160_update(&ctx, parts[i].data, parts[i].length);
+    }
+    ripemd160_finish(&ctx, sum);
+    ripemd160_free(&ctx);
+
+    return value_fromBytes(sum, sizeof(sum));
+}
+DEFINE_PRIM(hx_ripemd160v, 1);
+
 } // extern "C"
@@ -1,10 +1,13 @@
 #define  NEKO_COMPATIBLE
 #include <hx/CFFI.h>
 #include <stdlib.h>
+#include <polarssl/ctr_drbg.h>
+#include <polarssl/entropy.h>
 #include <polarssl/md.h>
 #include <polarssl/havege.h>
 #include <polarssl/rsa.h>
 
+#include "hxpolarssl/ctr_drbg.hpp"
 #include "hxpolarssl/rsa.hpp"
 #include "hxpolarssl/utils.hpp"
 
@@ -104,22 +107,23 @@ value hx_rsa_free(value context)
 DEFINE_PRIM(hx_rsa_free, 1);
 
 
-value hx_rsa_gen_key(value context, value nbits, value exponent)
+value hx_rsa_gen_key(value context, value nbits, value exponent, value rng)
 {
     val_check_rsa_context(context);
     val_check(nbits, int);
     val_check(exponent, int);
 
-    havege_state state;
-    havege_init(&state);
-    int ret = rsa_gen_key(val_rsa_context(context), havege_random, &state, val_int(nbits), val_int(exponent));
+    s_rng _rng;
+    rng_fromHaxe(rng, &_rng);
+    int ret = rsa_gen_key(val_rsa_context(context), _rng.f_rng, _rng.p_rng, val_int(nbits), val_int(exponent));
+    rng_free(&_rng);
     if (ret != 0) {
         throw_err(ret);
     }
 
     return alloc_int(ret);
 }
-DEFINE_PRIM(hx_rsa_gen_key, 3);
+DEFINE_PRIM(hx_rsa_gen_key, 4);
 
 
 value hx_rsa_get_D(value context)
@@ -248,7 +252,7 @@ value hx_rsa_init(value padding, value hash_id)
 DEFINE_PRIM(hx_rsa_init, 2);
 
 
-value hx_rsa_pkcs1_decrypt(value context, value mode, value input)
+value hx_rsa_pkcs1_decrypt(value context, value mode, value input, value rng)
 {
     val_check_rsa_context(context);
     val_check(mode, int);
@@ -258,11 +262,12 @@ value hx_rsa_pkcs1_decrypt(value context, value mode, value input)
     const size_t bufsize  = (const size_t)((_context->N.n) * 8);
     unsigned char outbuffer[bufsize];
     size_t outlen;
-    havege_state state;
-    havege_init(&state);
+    s_rng _rng;
+    rng_fromHaxe(rng, &_rng);
 
     value val;
-    int ret = rsa_pkcs1_decrypt(_context, havege_random, &state, val_int(mode), &outlen, bytes->data, outbuffer, bufsize);
+    int ret = rsa_pkcs1_decrypt(_context, _rng.f_rng, _rng.p_rng, val_int(mode), &outlen, bytes->data, outbuffer, bufsize);
+    rng_free(&_rng);
     if (ret == 0) {
         val = value_fromBytes(outbuffer, outlen);
     } else {
@@ -272,10 +277,10 @@ value hx_rsa_pkcs1_decrypt(value context, value mode, value input)
 
     return val;
 }
-DEFINE_PRIM(hx_rsa_pkcs1_decrypt, 3);
+DEFINE_PRIM(hx_rsa_pkcs1_decrypt, 4);
 
 
-value hx_rsa_pkcs1_encrypt(value context, value mode, value input, value length)
+value hx_rsa_pkcs1_encrypt(value context, value mode, value input, value length, value rng)
 {
     val_check_rsa_context(context);
     val_check(mode, int);
@@ -284,11 +289,12 @@ value hx_rsa_pkcs1_encrypt(value context, value mode, value input, value length)
     rsa_context* _context = val_rsa_context(context);
     const size_t size     = (const size_t)((_context->N.n) * 8);
     unsigned char outbuffer[size];
-    havege_state state;
-    havege_init(&state);
+    s_rng _rng;
+    rng_fromHaxe(rng, &_rng);
 
     value val;
-    int ret = rsa_pkcs1_encrypt(_context, havege_random, &state, val_int(mode), bytes->length, bytes->data, outbuffer);
+    int ret = rsa_pkcs1_encrypt(_context, _rng.f_rng, _rng.p_rng, val_int(mode), bytes->length, bytes->data, outbuffer);
+    rng_free(&_rng);
     if (ret == 0) {
         val = value_fromBytes(outbuffer, size);
     } else {
@@ -298,25 +304,27 @@ value hx_rsa_pkcs1_encrypt(value context, value mode, value input, value length)
 
     return val;
 }
-DEFINE_PRIM(hx_rsa_pkcs1_encrypt, 4);
+DEFINE_PRIM(hx_rsa_pkcs1_encrypt, 5);
 
 
-value hx_rsa_pkcs1_sign(value context, value mode, value md_alg, value hashlen, value hash)
+value hx_rsa_pkcs1_sign(value context, value mode, value md_alg, value hashArr, value rng)
 {
     val_check_rsa_context(context);
     val_check(mode, int);
     val_check(md_alg, int);
-    val_check(hashlen, int);
+    val_check(hashArr, array);
+    val_check(val_array_i(hashArr, 0), int);
 
-    s_bytes* bytes        = bytes_fromHaxe(hash, hashlen);
+    s_bytes* bytes        = bytes_fromHaxe(val_array_i(hashArr, 1), val_array_i(hashArr, 0));
     rsa_context* _context = val_rsa_context(context);
     const size_t size     = (const size_t)((_context->N.n) * 8);
     unsigned char sigbuffer[size];
-    havege_state state;
-    havege_init(&state);
+    s_rng _rng;
+    rng_fromHaxe(rng, &_rng);
 
     value val;
-    int ret = rsa_pkcs1_sign(_context, havege_random, &state, val_int(mode), (md_type_t)val_int(md_alg), /*(unsigned int)*/bytes->length, bytes->data, sigbuffer);
+    int ret = rsa_pkcs1_sign(_context, _rng.f_rng, _rng.p_rng, val_int(mode), (md_type_t)val_int(md_alg), /*(unsigned int)*/bytes->length, bytes->data, sigbuffer);
+    rng_free(&_rng);
     if (ret == 0) {
         val = value_fromBytes(sigbuffer, size);
     } else {
@@ -37,6 +37,17 @@ value hx_sha1_file(value path)
 DEFINE_PRIM(hx_sha1_file, 1);
 
 
+value hx_sha1_hex(value bytes, value length)
+{
+    s_bytes* cbytes = bytes_fromHaxe(bytes, length);
+    unsigned char sum[20];
+    sha1(cbytes->data, cbytes->length, sum);
+
+    return value_hexFromBytes(sum, sizeof(sum));
+}
+DEFINE_PRIM(hx_sha1_hex, 2);
+
+
 value hx_sha1_self_test(value verbose)
 {
     val_check(verbose, bool);
@@ -50,4 +61,27 @@ value hx_sha1_self_test(value verbose)
 }
 DEFINE_PRIM(hx_sha1_self_test, 1);
 
+
+value hx_sha1v(value segments)
+{
+    val_check(segments, array);
+
+    size_t count;
+    size_t total;
+    s_bytes* parts = segments_fromHaxe(segments, &count, &total);
+    unsigned char sum[20];
+
+    sha1_context ctx;
+    sha1_init(&ctx);
+    sha1_starts(&ctx);
+    for (size_t i = 0; i < count; ++i) {
+        sha1_update(&ctx, parts[i].data, parts[i].length);
+    }
+    sha1_finish(&ctx, sum);
+    sha1_free(&ctx);
+
+    return value_fromBytes(sum, sizeof(sum));
+}
+DEFINE_PRIM(hx_sha1v, 1);
+
 } // extern "C"
@@ -40,6 +40,19 @@ value hx_sha256_file(value path, value is224)
 DEFINE_PRIM(hx_sha256_file, 2);
 
 
+value hx_sha256_hex(value bytes, value length, value is224)
+{
+    val_check(is224, int);
+
+    s_bytes* cbytes = bytes_fromHaxe(bytes, length);
+    unsigned char sum[32];
+    sha256(cbytes->data, cbytes->length, sum, val_int(is224));
+
+    return value_hexFromBytes(sum, (val_int(is224)) ? 28 : sizeof(sum));
+}
+DEFINE_PRIM(hx_sha256_hex, 3);
+
+
 value hx_sha256_self_test(value verbose)
 {
     val_check(verbose, bool);
@@ -53,4 +66,28 @@ value hx_sha256_self_test(value verbose)
 }
 DEFINE_PRIM(hx_sha256_self_test, 1);
 
+
+value hx_sha256v(value segments, value is224)
+{
+    val_check(segments, array);
+    val_check(is224, int);
+
+    size_t count;
+    size_t total;
+    s_bytes* parts = segments_fromHaxe(segments, &count, &total);
+    unsigned char sum[32];
+
+    sha256_context ctx;
+    sha256_init(&ctx);
+    sha256_starts(&ctx, val_int(is224));
+    for (size_t i = 0; i < count; ++i) {
+        sha256_update(&ctx, parts[i].data, parts[i].length);
+    }
+    sha256_finish(&ctx, sum);
+    sha256_free(&ctx);
+
+    return value_fromBytes(sum, (val_int(is224)) ? 28 : sizeof(sum));
+}
+DEFINE_PRIM(hx_sha256v, 2);
+
 } // extern "C"
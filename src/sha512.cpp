@@ -40,6 +40,19 @@ value hx_sha512_file(value path, value is384)
 DEFINE_PRIM(hx_sha512_file, 2);
 
 
+value hx_sha512_hex(value bytes, value length, value is384)
+{
+    val_check(is384, int);
+
+    s_bytes* cbytes = bytes_fromHaxe(bytes, length);
+    unsigned char sum[64];
+    sha512(cbytes->data, cbytes->length, sum, val_int(is384));
+
+    return value_hexFromBytes(sum, (val_int(is384)) ? 48 : sizeof(sum));
+}
+DEFINE_PRIM(hx_sha512_hex, 3);
+
+
 value hx_sha512_self_test(value verbose)
 {
     val_check(verbose, bool);
@@ -53,4 +66,28 @@ value hx_sha512_self_test(value verbose)
 }
 DEFINE_PRIM(hx_sha512_self_test, 1);
 
+
+value hx_sha512v(value segments, value is384)
+{
+    val_check(segments, array);
+    val_check(is384, int);
+
+    size_t count;
+    size_t total;
+    s_bytes* parts = segments_fromHaxe(segments, &count, &total);
+    unsigned char sum[64];
+
+    sha512_context ctx;
+    sha512_init(&ctx);
+    sha512_starts(&ctx, val_int(is384));
+    for (size_t i = 0; i < count; ++i) {
+        sha512_update(&ctx, parts[i].data, parts[i].length);
+    }
+    sha512_finish(&ctx, sum);
+    sha512_free(&ctx);
+
+    return value_fromBytes(sum, (val_int(is384)) ? 48 : sizeof(sum));
+}
+DEFINE_PRIM(hx_sha512v, 2);
+
 } // extern "C"
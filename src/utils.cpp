@@ -1,10 +1,93 @@
 #define  IMPLEMENT_API
 #define  NEKO_COMPATIBLE
 #include <hx/CFFI.h>
+#include <vector>
+#if defined(__SSE2__)
+    #define HEX_HAVE_SSE2
+    #include <emmintrin.h>
+#endif
 #include <polarssl/error.h>
 
 #include "hxpolarssl/utils.hpp"
 
+static const char hex_digits[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
+
+/*
+ * Returns the value of the hex digit 'c' or -1 if it is none.
+ */
+static inline int hex_value(const unsigned char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+        return (c | 0x20) - 'a' + 10;
+    }
+
+    return -1;
+}
+
+
+#ifdef HEX_HAVE_SSE2
+
+/*
+ * Maps 16 nibbles (0 - 15) to their lowercase hex digits.
+ */
+static inline __m128i hex_digits_sse2(const __m128i nibbles)
+{
+    const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+
+/*
+ * Encodes 16 bytes of 'src' into 32 hex digits.
+ */
+static inline void hex_encode16_sse2(const unsigned char* src, char* dst)
+{
+    const __m128i in = _mm_loadu_si128((const __m128i*)src);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(0x0F));
+    const __m128i lo = _mm_and_si128(in, _mm_set1_epi8(0x0F));
+
+    _mm_storeu_si128((__m128i*)dst, hex_digits_sse2(_mm_unpacklo_epi8(hi, lo)));
+    _mm_storeu_si128((__m128i*)(dst + 16), hex_digits_sse2(_mm_unpackhi_epi8(hi, lo)));
+}
+
+
+/*
+ * Decodes 16 hex digits (either case) of 'src' into 8 bytes.
+ *
+ * Returns false, without writing anything, if any of them is not a hex digit.
+ */
+static inline bool hex_decode16_sse2(const char* src, unsigned char* dst)
+{
+    const __m128i in     = _mm_loadu_si128((const __m128i*)src);
+    const __m128i digit  = _mm_sub_epi8(in, _mm_set1_epi8('0'));
+    const __m128i alpha  = _mm_sub_epi8(_mm_or_si128(in, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    // unsigned x < n  <=>  min(x, n - 1) == x
+    const __m128i is_dig = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    const __m128i is_hex = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+    if (_mm_movemask_epi8(_mm_or_si128(is_dig, is_hex)) != 0xFFFF) {
+        return false;
+    }
+
+    const __m128i values = _mm_or_si128(_mm_and_si128(is_dig, digit),
+                                        _mm_and_si128(is_hex, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+    // each 16 bit lane holds (high nibble, low nibble) in memory order
+    const __m128i bytes  = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0x00FF)), 4),
+                                        _mm_srli_epi16(values, 8));
+    _mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(bytes, bytes));
+
+    return true;
+}
+
+#endif /* HEX_HAVE_SSE2 */
+
+
 extern "C" {
 
 s_bytes* bytes_fromHaxe(const value bytes, const value length)
@@ -24,6 +107,79 @@ s_bytes* bytes_fromHaxe(const value bytes, const value length)
 }
 
 
+unsigned char* data_fromHaxe(const value bytes)
+{
+    unsigned char* data;
+    if (val_is_string(bytes)) { // Neko
+        data = (unsigned char*)val_string(bytes);
+    } else { // C++
+        buffer buf = val_to_buffer(bytes);
+        data       = (unsigned char*)buffer_data(buf);
+    }
+
+    return data;
+}
+
+
+int hex_decode(const char* src, const size_t length, unsigned char* dst)
+{
+    size_t i = 0;
+    size_t p = 0;
+
+    if (length % 2 != 0) {
+        return -1;
+    }
+
+#ifdef HEX_HAVE_SSE2
+    for (; length - i >= 16 && hex_decode16_sse2(src + i, dst + p); i += 16, p += 8);
+#endif
+
+    for (; i < length; i += 2) {
+        const int hi = hex_value(src[i]);
+        const int lo = hex_value(src[i + 1]);
+        if (hi < 0 || lo < 0) {
+            return -1;
+        }
+        dst[p++] = (unsigned char)((hi << 4) | lo);
+    }
+
+    return 0;
+}
+
+
+void hex_encode(const unsigned char* src, const size_t length, char* dst)
+{
+    size_t i = 0;
+
+#ifdef HEX_HAVE_SSE2
+    for (; length - i >= 16; i += 16) {
+        hex_encode16_sse2(src + i, dst + 2 * i);
+    }
+#endif
+
+    for (; i < length; ++i) {
+        dst[2 * i]     = hex_digits[src[i] >> 4];
+        dst[2 * i + 1] = hex_digits[src[i] & 0x0F];
+    }
+}
+
+
+s_bytes* segments_fromHaxe(const value segments, size_t* count, size_t* total)
+{
+    *count = val_array_size(segments) / 3;
+    *total = 0;
+
+    s_bytes* parts = (s_bytes*)alloc_private(sizeof(s_bytes) * (*count + 1));
+    for (size_t i = 0; i < *count; ++i) {
+        parts[i].data   = data_fromHaxe(val_array_i(segments, 3 * i)) + val_int(val_array_i(segments, 3 * i + 1));
+        parts[i].length = val_int(val_array_i(segments, 3 * i + 2));
+        *total         += parts[i].length;
+    }
+
+    return parts;
+}
+
+
 void throw_err(int errnum)
 {
     char buffer[ERROR_BUFFER_SIZE];
@@ -41,4 +197,17 @@ value value_fromBytes(const unsigned char* bytes, const size_t length)
     return buffer_val(buf);
 }
 
+
+value value_hexFromBytes(const unsigned char* bytes, const size_t length)
+{
+    // digests fit on the stack, so the String is the only allocation
+    char small[2 * 64];
+    std::vector<char> large((length > 64) ? 2 * length : 0);
+    char* hex = (length > 64) ? &large[0] : small;
+
+    hex_encode(bytes, length, hex);
+
+    return alloc_string_len(hex, (int)(2 * length));
+}
+
 } // extern "C"
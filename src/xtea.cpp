@@ -1,6 +1,7 @@
 #define  NEKO_COMPATIBLE
 #include <hx/CFFI.h>
 #include <stdlib.h>
+#include <string.h>
 #include <polarssl/xtea.h>
 
 #include "hxpolarssl/xtea.hpp"
@@ -34,6 +35,59 @@ value hx_xtea_crypt_cbc(value context, value mode, value length, value iv, value
 DEFINE_PRIM(hx_xtea_crypt_cbc, 5);
 
 
+value hx_xtea_crypt_cbc_batch(value context, value mode, value lengths, value ivArr, value ioArr)
+{
+    val_check_xtea_context(context);
+    val_check(mode, int);
+    val_check(lengths, array);
+    val_check(ivArr, array);
+    val_check(val_array_i(ivArr, 1), int);
+    val_check(ioArr, array);
+    val_check(val_array_i(ioArr, 0), int);
+    val_check(val_array_i(ioArr, 2), int);
+    val_check(val_array_i(ioArr, 4), int);
+
+    const int count            = val_array_size(lengths);
+    const unsigned char* ivs   = data_fromHaxe(val_array_i(ivArr, 0)) + val_int(val_array_i(ivArr, 1));
+    const size_t total         = val_int(val_array_i(ioArr, 0));
+    const unsigned char* input = data_fromHaxe(val_array_i(ioArr, 1)) + val_int(val_array_i(ioArr, 2));
+    unsigned char* output      = data_fromHaxe(val_array_i(ioArr, 3)) + val_int(val_array_i(ioArr, 4));
+
+    // validate all frames first, so nothing is written for a malformed batch
+    size_t sum = 0;
+    for (int i = 0; i < count; ++i) {
+        val_check(val_array_i(lengths, i), int);
+        const int length = val_int(val_array_i(lengths, i));
+        if (length < 0 || (length % 8) != 0) {
+            throw_err(POLARSSL_ERR_XTEA_INVALID_INPUT_LENGTH);
+            return alloc_int(POLARSSL_ERR_XTEA_INVALID_INPUT_LENGTH);
+        }
+        sum += length;
+    }
+    if (sum != total) {
+        throw_err(POLARSSL_ERR_XTEA_INVALID_INPUT_LENGTH);
+        return alloc_int(POLARSSL_ERR_XTEA_INVALID_INPUT_LENGTH);
+    }
+
+    xtea_context* _context = val_xtea_context(context);
+    unsigned char iv[8];
+    size_t offset = 0;
+    int ret       = 0;
+    for (int i = 0; i < count && ret == 0; ++i) {
+        const size_t length = val_int(val_array_i(lengths, i));
+        memcpy(iv, ivs + 8 * i, 8); // xtea_crypt_cbc() updates the IV
+        ret     = xtea_crypt_cbc(_context, val_int(mode), length, iv, input + offset, output + offset);
+        offset += length;
+    }
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_xtea_crypt_cbc_batch, 5);
+
+
 value hx_xtea_crypt_ecb(value context, value mode, value input)
 {
     val_check_xtea_context(context);
@@ -56,6 +110,38 @@ value hx_xtea_crypt_ecb(value context, value mode, value input)
 DEFINE_PRIM(hx_xtea_crypt_ecb, 3);
 
 
+value hx_xtea_crypt_ecb_into(value context, value mode, value ioArr)
+{
+    val_check_xtea_context(context);
+    val_check(mode, int);
+    val_check(ioArr, array);
+    val_check(val_array_i(ioArr, 0), int);
+    val_check(val_array_i(ioArr, 2), int);
+    val_check(val_array_i(ioArr, 4), int);
+
+    const size_t length        = val_int(val_array_i(ioArr, 0));
+    const unsigned char* input = data_fromHaxe(val_array_i(ioArr, 1)) + val_int(val_array_i(ioArr, 2));
+    unsigned char* output      = data_fromHaxe(val_array_i(ioArr, 3)) + val_int(val_array_i(ioArr, 4));
+
+    if ((length % 8) != 0) {
+        throw_err(POLARSSL_ERR_XTEA_INVALID_INPUT_LENGTH);
+        return alloc_int(POLARSSL_ERR_XTEA_INVALID_INPUT_LENGTH);
+    }
+
+    xtea_context* _context = val_xtea_context(context);
+    int ret = 0;
+    for (size_t offset = 0; offset < length && ret == 0; offset += 8) {
+        ret = xtea_crypt_ecb(_context, val_int(mode), input + offset, output + offset);
+    }
+    if (ret != 0) {
+        throw_err(ret);
+    }
+
+    return alloc_int(ret);
+}
+DEFINE_PRIM(hx_xtea_crypt_ecb_into, 3);
+
+
 value hx_xtea_free(value context)
 {
     val_check_xtea_context(context);